@@ -659,31 +659,32 @@ void CameraView::setLandmarksData(kwiver::vital::landmark_map const& lm)
 }
 
 //-----------------------------------------------------------------------------
-void CameraView::addFeatureTrack(kwiver::vital::track const& track)
+void CameraView::addFeatureTrack(
+  kwiver::maptk::feature_track_pool::track_view const& track)
 {
-  QTE_D();
-
   auto const id = track.id();
 
-  foreach (auto const& state, track)
+  for (auto const& state : track)
+  {
+    this->addFeatureTrackState(id, state);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void CameraView::addFeatureTrackState(
+  kwiver::vital::track_id_t id,
+  kwiver::maptk::feature_track_pool::state const& state)
+{
+  QTE_D();
+
+  auto const& loc = state.loc;
+  if (state.descriptor)
+  {
+    d->featureRep->AddTrackWithDescPoint(id, state.frame, loc[0], loc[1]);
+  }
+  else
   {
-    auto const& fts =
-      std::dynamic_pointer_cast<kwiver::vital::feature_track_state>(state);
-    if ( !fts )
-    {
-      continue;
-    }
-    auto const& loc = fts->feature->loc();
-    if (fts->descriptor)
-    {
-      d->featureRep->AddTrackWithDescPoint(
-        id, state->frame(), loc[0], loc[1]);
-    }
-    else
-    {
-      d->featureRep->AddTrackWithoutDescPoint(
-        id, state->frame(), loc[0], loc[1]);
-    }
+    d->featureRep->AddTrackWithoutDescPoint(id, state.frame, loc[0], loc[1]);
   }
 
   d->updateFeatures(this);
@@ -31,6 +31,8 @@
 #ifndef TELESCULPTOR_CAMERAVIEW_H_
 #define TELESCULPTOR_CAMERAVIEW_H_
 
+#include <maptk/feature_track_pool.h>
+
 #include <vital/vital_types.h>
 
 #include <qtGlobal.h>
@@ -40,7 +42,6 @@
 class vtkImageData;
 
 namespace kwiver { namespace vital { class landmark_map; } }
-namespace kwiver { namespace vital { class track; } }
 
 class vtkMaptkCamera;
 class GroundControlPointsWidget;
@@ -56,7 +57,9 @@ public:
   explicit CameraView(QWidget* parent = 0, Qt::WindowFlags flags = 0);
   ~CameraView() override;
 
-  void addFeatureTrack(kwiver::vital::track const&);
+  void addFeatureTrack(kwiver::maptk::feature_track_pool::track_view const&);
+  void addFeatureTrackState(kwiver::vital::track_id_t,
+                            kwiver::maptk::feature_track_pool::state const&);
   GroundControlPointsWidget* groundControlPointsWidget() const;
   RulerWidget* rulerWidget() const;
 
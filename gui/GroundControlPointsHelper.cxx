@@ -38,6 +38,8 @@
 #include "vtkMaptkPointPicker.h"
 #include "vtkMaptkPointPlacer.h"
 
+#include <maptk/geo_transform.h>
+
 #include <vital/types/geodesy.h>
 
 #include <vtkHandleWidget.h>
@@ -161,7 +163,8 @@ kv::ground_control_point_sptr extractGroundControlPoint(QJsonObject const& f)
 }
 
 //-----------------------------------------------------------------------------
-QJsonValue buildFeature(kv::ground_control_point_sptr const& gcpp)
+QJsonValue buildFeature(kv::ground_control_point_sptr const& gcpp,
+                        kv::vector_3d const* worldLocation = nullptr)
 {
   if (!gcpp)
   {
@@ -178,7 +181,8 @@ QJsonValue buildFeature(kv::ground_control_point_sptr const& gcpp)
   geom.insert(TAG_TYPE, TAG_POINT);
   if (!wl.is_empty())
   {
-    auto const& rwl = wl.location(kv::SRID::lat_lon_WGS84);
+    auto const& rwl = (worldLocation ? *worldLocation
+                                     : wl.location(kv::SRID::lat_lon_WGS84));
     geom.insert(TAG_COORDINATES, QJsonArray{rwl[0], rwl[1], gcp.elevation()});
   }
 
@@ -872,13 +876,36 @@ bool GroundControlPointsHelper::writeGroundControlPoints(
 {
   QTE_D();
 
+  // Convert all geodetic locations up front; if that fails, each point is
+  // converted again while it is written so that errors are reported per
+  // point
+  std::vector<kv::geo_point> geoLocations;
+  for (auto const& gcpi : d->groundControlPoints)
+  {
+    geoLocations.push_back(
+      gcpi.second ? gcpi.second->geo_loc() : kv::geo_point{});
+  }
+  std::vector<kv::vector_3d> worldLocations;
+  try
+  {
+    worldLocations = kwiver::maptk::convert_geo_points(
+      geoLocations, kv::SRID::lat_lon_WGS84);
+  }
+  catch (...)
+  {
+    worldLocations.clear();
+  }
+
   QJsonArray features;
   QStringList errors;
+  size_t i = 0;
   for (auto const& gcpi : d->groundControlPoints)
   {
+    auto const* const worldLocation =
+      (worldLocations.empty() ? nullptr : &worldLocations[i++]);
     try
     {
-      auto const& f = buildFeature(gcpi.second);
+      auto const& f = buildFeature(gcpi.second, worldLocation);
       if (f.isObject())
       {
         features.append(f);
@@ -30,6 +30,8 @@
 
 #include "GuiCommon.h"
 
+#include <maptk/config_cache.h>
+#include <maptk/plugin_manifest.h>
 #include <maptk/version.h>
 
 #include <vital/io/metadata_io.h>
@@ -90,11 +92,16 @@ kwiver::vital::config_block_sptr readConfig(std::string const& name)
 {
   try
   {
-    using kwiver::vital::read_config_file;
+    using kwiver::maptk::read_config_file_cached;
 
     auto const exeDir = QDir(QApplication::applicationDirPath());
     auto const prefix = stdString(exeDir.absoluteFilePath(".."));
-    return read_config_file(name, "telesculptor", TELESCULPTOR_VERSION, prefix);
+    auto const config = read_config_file_cached(
+      name, "telesculptor", TELESCULPTOR_VERSION, prefix);
+
+    // Make sure the algorithms named by the configuration can be created
+    kwiver::maptk::load_plugins_for_config(config);
+    return config;
   }
   catch (...)
   {
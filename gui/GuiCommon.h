@@ -60,6 +60,7 @@ std::string frameName(kwiver::vital::frame_id_t frame,
 
 
 // Loads config file from installed config location
+// This also loads the plugins providing the algorithms named in the config
 kwiver::vital::config_block_sptr readConfig(std::string const& name);
 
 
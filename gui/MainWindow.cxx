@@ -41,6 +41,7 @@
 #include "tools/FuseDepthTool.h"
 #include "tools/InitCamerasLandmarksTool.h"
 #include "tools/NeckerReversalTool.h"
+#include "tools/ReprojectionFilterTool.h"
 #include "tools/SaveFrameTool.h"
 #include "tools/SaveKeyFrameTool.h"
 #include "tools/TrackFeaturesTool.h"
@@ -52,11 +53,15 @@
 #include "MatchMatrixWindow.h"
 #include "Project.h"
 #include "RulerHelper.h"
+#include "ToolJobScheduler.h"
+#include "ToolUpdateScheduler.h"
 #include "VideoImport.h"
 #include "vtkMaptkCamera.h"
 #include "vtkMaptkImageDataGeometryFilter.h"
 #include "vtkMaptkImageUnprojectDepth.h"
 
+#include <maptk/feature_track_frame_index.h>
+#include <maptk/feature_track_pool.h>
 #include <maptk/version.h>
 #include <maptk/write_pdal.h>
 
@@ -293,6 +298,8 @@ public:
 
   std::shared_ptr<std::map<kwiver::vital::frame_id_t, std::string>>
   depthLookup() const;
+  void addDepthMaps(
+    std::map<kwiver::vital::frame_id_t, std::string> const& depthMaps);
 
   void setActiveCamera(int);
   void updateCameraView();
@@ -304,7 +311,8 @@ public:
 
   void loadDepthMap(QString const& imagePath);
 
-  void setActiveTool(AbstractTool* tool);
+  void startTool(AbstractTool* tool);
+  void finishTool(AbstractTool* tool);
   void updateProgress(QObject* object,
                       const QString& description = QString(""),
                       int value = 0);
@@ -333,8 +341,7 @@ public:
 
   QAction* toolSeparator = nullptr;
   QMenu* toolMenu = nullptr;
-  AbstractTool* activeTool = nullptr;
-  QList<AbstractTool*> tools;
+  ToolJobScheduler toolJobScheduler;
   int toolUpdateActiveFrame = -1;
   kv::camera_map_sptr toolUpdateCameras;
   kv::landmark_map_sptr toolUpdateLandmarks;
@@ -342,7 +349,7 @@ public:
   kv::feature_track_set_changes_sptr toolUpdateTrackChanges;
   vtkSmartPointer<vtkImageData> toolUpdateDepth;
   vtkSmartPointer<vtkStructuredGrid> toolUpdateVolume;
-  bool toolSaveDepthFlag = false;
+  ToolUpdateScheduler toolUpdateScheduler;
 
   kv::config_block_sptr freestandingConfig = kv::config_block::empty_config();
 
@@ -356,6 +363,8 @@ public:
 
   QMap<kv::frame_id_t, FrameData> frames;
   kv::feature_track_set_sptr tracks;
+  kwiver::maptk::feature_track_pool trackPool;
+  kwiver::maptk::feature_track_frame_index trackFrameIndex;
   kv::landmark_map_sptr landmarks;
   vtkSmartPointer<vtkImageData> activeDepth;
   int activeDepthFrame = -1;
@@ -517,9 +526,7 @@ void MainWindowPrivate::addTool(AbstractTool* tool, MainWindow* mainWindow)
   QObject::connect(tool, &AbstractTool::failed,
                    mainWindow, &MainWindow::reportToolError);
 
-  tool->setEnabled(false);
-
-  this->tools.append(tool);
+  this->toolJobScheduler.addTool(tool);
 }
 
 //-----------------------------------------------------------------------------
@@ -593,10 +600,7 @@ void MainWindowPrivate::addVideoSource(
       this->videoSource->open(stdString(videoPath));
     }
 
-    foreach (auto const& tool, this->tools)
-    {
-      tool->setEnabled(false);
-    }
+    this->toolJobScheduler.setToolsAvailable(false);
 
     videoImporter.start();
   }
@@ -800,10 +804,7 @@ void MainWindowPrivate::updateFrames(
 
   if (this->project)
   {
-    for (auto const& tool : this->tools)
-    {
-      tool->setEnabled(true);
-    }
+    this->toolJobScheduler.setToolsAvailable(true);
   }
 }
 
@@ -842,6 +843,34 @@ MainWindowPrivate::depthLookup() const
   return lookup;
 }
 
+//-----------------------------------------------------------------------------
+void MainWindowPrivate::addDepthMaps(
+  std::map<kwiver::vital::frame_id_t, std::string> const& depthMaps)
+{
+  if (depthMaps.empty())
+  {
+    return;
+  }
+
+  for (auto const& dm : depthMaps)
+  {
+    if (auto* const frame = qtGet(this->frames, dm.first))
+    {
+      frame->depthMapPath = qtString(dm.second);
+    }
+
+    // A newly written depth map supersedes the one cached in memory
+    if (dm.first == this->activeDepthFrame)
+    {
+      this->activeDepthFrame = -1;
+    }
+  }
+
+  this->project->config->set_value("output_depth_dir", kvPath(
+    this->project->getContingentRelativePath(this->project->depthPath)));
+  this->project->config->set_value("ROI", this->roiToString());
+}
+
 //-----------------------------------------------------------------------------
 void MainWindowPrivate::updateCameras(
   kv::camera_map_sptr const& cameras)
@@ -1059,18 +1088,31 @@ void MainWindowPrivate::updateCameraView()
   this->UI.cameraView->clearLandmarks();
   if (this->landmarks)
   {
-    // Map landmarks to camera space
+    // Map landmarks to camera space, projecting them all at once
     auto const& landmarks = this->landmarks->landmarks();
-    foreach (auto const& lm, landmarks)
+    std::vector<kv::vector_3d> points;
+    points.reserve(landmarks.size());
+    for (auto const& lm : landmarks)
     {
-      double pp[2];
-      if (activeFrame->camera->ProjectPoint(lm.second->loc(), pp))
+      points.push_back(lm.second->loc());
+    }
+
+    std::vector<kv::vector_2d> projected;
+    std::vector<unsigned char> valid;
+    activeFrame->camera->ProjectPoints(points, projected, valid);
+
+    size_t i = 0;
+    for (auto const& lm : landmarks)
+    {
+      if (valid[i])
       {
         // Add projected landmark to camera view
         auto const id = lm.first;
+        auto const& pp = projected[i];
         this->UI.cameraView->addLandmark(id, pp[0], pp[1]);
-        landmarkPoints.insert(id, kv::vector_2d(pp[0], pp[1]));
+        landmarkPoints.insert(id, pp);
       }
+      ++i;
     }
   }
 
@@ -1078,24 +1120,17 @@ void MainWindowPrivate::updateCameraView()
   this->UI.cameraView->clearResiduals();
   if (this->tracks)
   {
-    auto const& tracks = this->tracks->tracks();
-    foreach (auto const& track, tracks)
+    for (auto const& e :
+         this->trackFrameIndex.frame_states(this->activeCameraIndex))
     {
-      auto const& state = track->find(this->activeCameraIndex);
-      if (state == track->end())
-      {
-        continue;
-      }
-      auto fts = std::dynamic_pointer_cast<kv::feature_track_state>(*state);
-      if (fts && fts->feature)
+      auto const lpi = landmarkPoints.constFind(e.track_id);
+      if (lpi != landmarkPoints.constEnd())
       {
-        auto const id = track->id();
-        if (landmarkPoints.contains(id))
-        {
-          auto const& fp = fts->feature->loc();
-          auto const& lp = landmarkPoints[id];
-          this->UI.cameraView->addResidual(id, fp[0], fp[1], lp[0], lp[1], fts->inlier);
-        }
+        auto const& state = this->trackPool.state_at(e.state);
+        auto const& fp = state.loc;
+        auto const& lp = lpi.value();
+        this->UI.cameraView->addResidual(e.track_id, fp[0], fp[1],
+                                         lp[0], lp[1], state.inlier);
       }
     }
   }
@@ -1251,37 +1286,24 @@ void MainWindowPrivate::loadDepthMap(QString const& imagePath)
 }
 
 //-----------------------------------------------------------------------------
-void MainWindowPrivate::setActiveTool(AbstractTool* tool)
+void MainWindowPrivate::startTool(AbstractTool* tool)
 {
-  // Disconnect cancel action
-  QObject::disconnect(this->UI.actionCancelComputation, nullptr,
-                      this->activeTool, nullptr);
+  QObject::connect(this->UI.actionQuit, &QAction::triggered,
+                   tool, &AbstractTool::cancel);
 
-  // Update current tool
-  this->activeTool = tool;
+  this->toolJobScheduler.start(tool);
+  this->UI.actionOpenProject->setEnabled(false);
+  // FIXME disable import actions
+}
 
-  // Connect actions
-  if (tool)
-  {
-    QObject::connect(this->UI.actionCancelComputation, &QAction::triggered,
-                     tool, &AbstractTool::cancel);
-    QObject::connect(this->UI.actionCancelComputation, &QAction::triggered,
-                     project.data(), &Project::write);
-    QObject::connect(this->UI.actionQuit, &QAction::triggered,
-                     tool, &AbstractTool::cancel);
-    QObject::connect(tool, &AbstractTool::completed,
-                     project.data(), &Project::write);
-  }
+//-----------------------------------------------------------------------------
+void MainWindowPrivate::finishTool(AbstractTool* tool)
+{
+  QObject::disconnect(this->UI.actionQuit, &QAction::triggered,
+                      tool, &AbstractTool::cancel);
 
-  auto const enableTools = !tool;
-  auto const enableCancel = tool && tool->isCancelable();
-  foreach (auto const& tool, this->tools)
-  {
-    tool->setEnabled(enableTools);
-  }
-  this->UI.actionCancelComputation->setEnabled(enableCancel);
-  this->UI.actionOpenProject->setEnabled(enableTools);
-  // FIXME disable import actions
+  this->toolJobScheduler.finish(tool);
+  this->UI.actionOpenProject->setEnabled(this->toolJobScheduler.isIdle());
 }
 
 //-----------------------------------------------------------------------------
@@ -1398,9 +1420,17 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags flags)
     std::bind(&MainWindowPrivate::handleLogMessage, d, _1, _2, _3, _4);
   kv::kwiver_logger::set_global_callback(cb);
 
+  // Replace the cancel action with a menu of the running tools
+  auto* const cancelMenu = d->toolJobScheduler.cancelMenu();
+  cancelMenu->setTitle(d->UI.actionCancelComputation->text());
+  cancelMenu->setIcon(d->UI.actionCancelComputation->icon());
+  cancelMenu->setToolTip(d->UI.actionCancelComputation->toolTip());
+  d->UI.menuCompute->insertMenu(d->UI.actionCancelComputation, cancelMenu);
+  d->UI.menuCompute->removeAction(d->UI.actionCancelComputation);
+
   d->toolMenu = d->UI.menuCompute;
   d->toolSeparator =
-    d->UI.menuCompute->insertSeparator(d->UI.actionCancelComputation);
+    d->UI.menuCompute->insertSeparator(cancelMenu->menuAction());
 
   d->addTool(new TrackFeaturesTool(this), this);
   d->addTool(new InitCamerasLandmarksTool(this), this);
@@ -1412,8 +1442,10 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags flags)
   d->toolSeparator =
     d->UI.menuAdvanced->addSeparator();
   d->addTool(new TrackFilterTool(this), this);
+  d->addTool(new ReprojectionFilterTool(this), this);
   d->addTool(new TriangulateTool(this), this);
   d->addTool(new BundleAdjustTool(this), this);
+  d->addTool(new BundleAdjustTool(BundleAdjustTool::Local, this), this);
   d->addTool(new NeckerReversalTool(this), this);
   d->addTool(new CanonicalTransformTool(this), this);
   d->addTool(new SaveKeyFrameTool(this), this);
@@ -1476,6 +1508,13 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags flags)
 
   connect(&d->toolDispatcher, QOverload<QObject*>::of(&QSignalMapper::mapped),
           this, &MainWindow::executeTool);
+  connect(&d->toolJobScheduler, &ToolJobScheduler::toolCanceled,
+          this, [d]() {
+            if (d->project)
+            {
+              d->project->write();
+            }
+          });
 
   connect(d->UI.actionSetBackgroundColor, &QAction::triggered,
           this, &MainWindow::setViewBackroundColor);
@@ -1486,6 +1525,8 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags flags)
           this, &MainWindow::showUserManual);
 
   connect(&d->slideTimer, &QTimer::timeout, this, &MainWindow::nextSlide);
+  connect(&d->toolUpdateScheduler, &ToolUpdateScheduler::updateRequested,
+          this, &MainWindow::updateToolResults, Qt::DirectConnection);
   connect(d->UI.actionSlideshowPlay, &QAction::toggled,
           this, &MainWindow::setSlideshowPlaying);
   connect(d->UI.slideSpeed, &QAbstractSlider::valueChanged,
@@ -1737,10 +1778,7 @@ void MainWindow::newProject()
     d->project->write();
   }
 
-  foreach (auto const& tool, d->tools)
-  {
-    tool->setEnabled(true);
-  }
+  d->toolJobScheduler.setToolsAvailable(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -1827,10 +1865,7 @@ void MainWindow::loadProject(QString const& path)
 
   d->UI.worldView->queueResetView();
 
-  foreach (auto const& tool, d->tools)
-  {
-    tool->setEnabled(true);
-  }
+  d->toolJobScheduler.setToolsAvailable(true);
 
   d->setActiveCamera(d->activeCameraIndex);
 
@@ -2038,10 +2073,13 @@ void MainWindow::loadTracks(QString const& path)
       }
 
       d->tracks = tracks;
+      d->trackPool = kwiver::maptk::feature_track_pool(*tracks);
+      d->trackFrameIndex =
+        kwiver::maptk::feature_track_frame_index(d->trackPool);
       d->updateCameraView();
-      for (auto const& track : tracks->tracks())
+      for (size_t i = 0; i < d->trackPool.size(); ++i)
       {
-        d->UI.cameraView->addFeatureTrack(*track);
+        d->UI.cameraView->addFeatureTrack(d->trackPool.track(i));
       }
 
       d->UI.actionExportTracks->setEnabled(
@@ -2616,7 +2654,7 @@ void MainWindow::executeTool(QObject* object)
   QTE_D();
 
   auto const tool = qobject_cast<AbstractTool*>(object);
-  if (tool && !d->activeTool)
+  if (tool && d->toolJobScheduler.canStart(tool))
   {
     // try to reset the ROI if invalid
     kv::vector_3d min_pt, max_pt;
@@ -2628,7 +2666,7 @@ void MainWindow::executeTool(QObject* object)
       d->project->config->set_value("ROI", d->roiToString());
     }
 
-    d->setActiveTool(tool);
+    d->startTool(tool);
     tool->setActiveFrame(d->activeCameraIndex);
     tool->setTracks(d->tracks);
     tool->setCameras(d->cameraMap());
@@ -2636,6 +2674,7 @@ void MainWindow::executeTool(QObject* object)
     tool->setSfmConstraints(d->sfmConstraints);
     tool->setVideoPath(stdString(d->videoPath));
     tool->setMaskPath(stdString(d->maskPath));
+    tool->setDepthPath(stdString(d->project->depthPath));
     tool->setConfig(d->project->config);
     tool->setROI(d->roi.Get());
     tool->setDepthLookup(d->depthLookup());
@@ -2646,7 +2685,7 @@ void MainWindow::executeTool(QObject* object)
 
     if (!tool->execute())
     {
-      d->setActiveTool(0);
+      d->finishTool(tool);
     }
     else
     {
@@ -2666,7 +2705,11 @@ void MainWindow::reportToolError(QString const& msg)
 //-----------------------------------------------------------------------------
 void MainWindow::acceptToolInterimResults(std::shared_ptr<ToolData> data)
 {
-  this->acceptToolResults(data, false);
+  auto const tool = qobject_cast<AbstractTool*>(this->sender());
+  if (tool)
+  {
+    this->acceptToolResults(tool, data, false);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -2674,62 +2717,63 @@ void MainWindow::acceptToolFinalResults()
 {
   QTE_D();
 
-  if (d->activeTool)
+  auto const tool = qobject_cast<AbstractTool*>(this->sender());
+  if (tool)
   {
-    this->acceptToolResults(d->activeTool->data(), true);
-    this->saveToolResults();
+    this->acceptToolResults(tool, tool->data(), true);
+    this->saveToolResults(tool);
     // Signal tool execution as complete to the progress widget
-    d->updateProgress(d->activeTool,
-                      d->activeTool->description(),
-                      100);
+    d->updateProgress(tool, tool->description(), 100);
+    d->finishTool(tool);
   }
-  d->setActiveTool(0);
 }
 
 //-----------------------------------------------------------------------------
 void MainWindow::acceptToolResults(
-  std::shared_ptr<ToolData> data, bool isFinal)
+  AbstractTool* tool, std::shared_ptr<ToolData> data, bool isFinal)
 {
   QTE_D();
-  // if all the update variables are Null then trigger a GUI update after
-  // extracting the data otherwise we've already triggered an update that
-  // hasn't happened yet, so don't trigger another
-  bool updateNeeded = !d->toolUpdateCameras &&
-                      !d->toolUpdateLandmarks &&
-                      !d->toolUpdateTracks &&
-                      !d->toolUpdateTrackChanges &&
-                      !d->toolUpdateDepth &&
-                      !d->toolUpdateVolume &&
-                      d->toolUpdateActiveFrame < 0;
 
-  if (d->activeTool)
+  // Merge the results into those still waiting to be shown; each output
+  // replaces only the pending results of the same type, so results that
+  // arrive between view updates are not lost.  Tools running at the same
+  // time never write the same project data (see AbstractTool::canRunWith),
+  // and at most one of them produces the active frame, so each type of
+  // result comes from a single tool.
+  if (d->toolJobScheduler.runningTools().contains(tool))
   {
-    auto const outputs = d->activeTool->outputs();
+    auto const outputs = tool->outputs();
 
-    d->toolUpdateCameras = NULL;
-    d->toolUpdateLandmarks = NULL;
-    d->toolUpdateTracks = NULL;
-    d->toolUpdateTrackChanges = NULL;
-    d->toolUpdateActiveFrame = -1;
-    d->toolUpdateDepth = NULL;
-    d->toolUpdateVolume = NULL;
-    if (outputs.testFlag(AbstractTool::Cameras))
+    if (outputs.testFlag(AbstractTool::Cameras) && data->cameras)
     {
       d->toolUpdateCameras = data->cameras;
     }
-    if (outputs.testFlag(AbstractTool::Landmarks))
+    if (outputs.testFlag(AbstractTool::Landmarks) && data->landmarks)
     {
       d->toolUpdateLandmarks = data->landmarks;
     }
-    if (outputs.testFlag(AbstractTool::Tracks))
+    if (outputs.testFlag(AbstractTool::Tracks) && data->tracks)
     {
       d->toolUpdateTracks = data->tracks;
     }
-    if (outputs.testFlag(AbstractTool::TrackChanges))
+    if (outputs.testFlag(AbstractTool::TrackChanges) && data->track_changes)
     {
-      d->toolUpdateTrackChanges = data->track_changes;
+      if (d->toolUpdateTrackChanges)
+      {
+        // Track changes are incremental, so accumulate them
+        auto merged = std::make_shared<kv::feature_track_set_changes>(
+          *d->toolUpdateTrackChanges);
+        auto const& changes = data->track_changes->m_changes;
+        merged->m_changes.insert(merged->m_changes.end(),
+                                 changes.begin(), changes.end());
+        d->toolUpdateTrackChanges = merged;
+      }
+      else
+      {
+        d->toolUpdateTrackChanges = data->track_changes;
+      }
     }
-    if (outputs.testFlag(AbstractTool::Depth))
+    if (outputs.testFlag(AbstractTool::Depth) && data->active_depth)
     {
       d->toolUpdateDepth = data->active_depth;
     }
@@ -2737,18 +2781,24 @@ void MainWindow::acceptToolResults(
     {
       d->toolUpdateActiveFrame = static_cast<int>(data->activeFrame);
     }
-    if (outputs.testFlag(AbstractTool::BatchDepth))
+    if (outputs.testFlag(AbstractTool::BatchDepth) && data->depthLookup)
     {
-      d->toolSaveDepthFlag = true;
+      // Batch depth maps are written by the tool, so record them right away
+      // rather than waiting for the next view update
+      d->addDepthMaps(*data->depthLookup);
     }
-    if (outputs.testFlag(AbstractTool::Fusion))
+    if (outputs.testFlag(AbstractTool::Fusion) && data->volume)
     {
       d->toolUpdateVolume = data->volume;
     }
-    // Update tool progress
-    d->updateProgress(d->activeTool,
-                      d->activeTool->description(),
-                      d->activeTool->progress());
+    // Update tool progress, showing how far the views lag behind the tools
+    auto description = tool->description();
+    if (d->toolUpdateScheduler.updateCount() > 0)
+    {
+      description += QString{" (view latency %1 ms)"}.arg(
+        d->toolUpdateScheduler.latency());
+    }
+    d->updateProgress(tool, description, tool->progress());
   }
 
   if (isFinal)
@@ -2756,7 +2806,7 @@ void MainWindow::acceptToolResults(
     bool update_origin = d->toolUpdateLandmarks != nullptr;
 
     // Force immediate update on tool finish so we ensure update before saving
-    updateToolResults();
+    d->toolUpdateScheduler.flush();
 
     // If the landmarks changed, then update the geo coordinate system
     if (update_origin)
@@ -2770,48 +2820,45 @@ void MainWindow::acceptToolResults(
       }
     }
   }
-  else if (updateNeeded)
+  else
   {
-    QTimer::singleShot(1000, this, &MainWindow::updateToolResults);
+    d->toolUpdateScheduler.schedule();
   }
 }
 
 //-----------------------------------------------------------------------------
-void MainWindow::saveToolResults()
+void MainWindow::saveToolResults(AbstractTool* tool)
 {
   QTE_D();
 
-  if (d->activeTool)
-  {
-    auto const outputs = d->activeTool->outputs();
+  auto const outputs = tool->outputs();
 
-    if (outputs.testFlag(AbstractTool::Cameras))
-    {
-      saveCameras(d->project->cameraPath);
-    }
-    if (outputs.testFlag(AbstractTool::Landmarks))
-    {
-      saveLandmarks(d->project->landmarksPath);
-    }
-    if (outputs.testFlag(AbstractTool::Tracks))
-    {
-      saveTracks(d->project->tracksPath);
-    }
-
-    if (!d->sfmConstraints->get_local_geo_cs().origin().is_empty() &&
-        !d->project->geoOriginFile.isEmpty())
-    {
-      saveGeoOrigin(d->project->geoOriginFile);
-    }
+  if (outputs.testFlag(AbstractTool::Cameras))
+  {
+    saveCameras(d->project->cameraPath);
+  }
+  if (outputs.testFlag(AbstractTool::Landmarks))
+  {
+    saveLandmarks(d->project->landmarksPath);
+  }
+  if (outputs.testFlag(AbstractTool::Tracks))
+  {
+    saveTracks(d->project->tracksPath);
+  }
 
-    if (!outputs.testFlag(AbstractTool::BatchDepth) &&
-        outputs.testFlag(AbstractTool::Depth))
-    {
-      saveDepthImage(d->project->depthPath);
-    }
+  if (!d->sfmConstraints->get_local_geo_cs().origin().is_empty() &&
+      !d->project->geoOriginFile.isEmpty())
+  {
+    saveGeoOrigin(d->project->geoOriginFile);
+  }
 
-    d->project->write();
+  if (!outputs.testFlag(AbstractTool::BatchDepth) &&
+      outputs.testFlag(AbstractTool::Depth))
+  {
+    saveDepthImage(d->project->depthPath);
   }
+
+  d->project->write();
 }
 
 //-----------------------------------------------------------------------------
@@ -2836,10 +2883,29 @@ void MainWindow::updateToolResults()
   if (d->toolUpdateTracks)
   {
     d->tracks = d->toolUpdateTracks;
-    d->UI.cameraView->clearFeatureTracks();
-    foreach (auto const& track, d->tracks->tracks())
+
+    // Tools that track features report the whole track set after each
+    // frame; when only later frames were added, add just their states
+    std::vector<kwiver::maptk::feature_track_pool::added_state> added;
+    if (d->trackPool.append_new_frames(*d->tracks, added))
     {
-      d->UI.cameraView->addFeatureTrack(*track);
+      for (auto const& a : added)
+      {
+        auto const& state = d->trackPool.state_at(a.state);
+        d->trackFrameIndex.append(state.frame, a.track_id, a.state);
+        d->UI.cameraView->addFeatureTrackState(a.track_id, state);
+      }
+    }
+    else
+    {
+      d->trackPool = kwiver::maptk::feature_track_pool(*d->tracks);
+      d->trackFrameIndex =
+        kwiver::maptk::feature_track_frame_index(d->trackPool);
+      d->UI.cameraView->clearFeatureTracks();
+      for (size_t i = 0; i < d->trackPool.size(); ++i)
+      {
+        d->UI.cameraView->addFeatureTrack(d->trackPool.track(i));
+      }
     }
     d->UI.actionExportTracks->setEnabled(
       d->tracks && d->tracks->size());
@@ -2867,6 +2933,12 @@ void MainWindow::updateToolResults()
             {
               fts->inlier = change.inlier_;
             }
+            auto const state = d->trackPool.find_state(change.track_id_,
+                                                       change.frame_id_);
+            if (state)
+            {
+              state->inlier = change.inlier_;
+            }
           }
         }
       }
@@ -2879,15 +2951,6 @@ void MainWindow::updateToolResults()
     d->activeDepth = d->toolUpdateDepth;
     d->activeDepthFrame = d->toolUpdateActiveFrame;
     d->currentDepthFrame = d->toolUpdateActiveFrame;
-
-    // In batch depth, each update is a full depth map from a different ref
-    // frame that must be saved
-    if (d->toolSaveDepthFlag)
-    {
-      saveDepthImage(d->project->depthPath);
-      d->toolSaveDepthFlag = false;
-    }
-
     d->toolUpdateDepth = NULL;
   }
   if (d->toolUpdateVolume)
@@ -41,6 +41,7 @@
 #include <vital/types/metadata_map.h>
 
 class CameraView;
+class AbstractTool;
 class ToolData;
 class WorldView;
 class vtkMaptkCamera;
@@ -95,7 +96,6 @@ public slots:
   void saveDepthPoints(QString const& path);
   void saveDepthImage(QString const& path);
   void saveGeoOrigin(QString const& path);
-  void saveToolResults();
 
 
   void saveWebGLScene();
@@ -132,7 +132,9 @@ protected slots:
   void enableAntiAliasing(bool enable);
 
 private:
-  void acceptToolResults(std::shared_ptr<ToolData> data, bool isFinal);
+  void acceptToolResults(AbstractTool* tool, std::shared_ptr<ToolData> data,
+                         bool isFinal);
+  void saveToolResults(AbstractTool* tool);
 
   QTE_DECLARE_PRIVATE_RPTR(MainWindow)
   QTE_DECLARE_PRIVATE(MainWindow)
@@ -30,6 +30,7 @@
 
 #include "Project.h"
 
+#include <maptk/plugin_manifest.h>
 #include <maptk/version.h>
 
 #include <qtStlUtil.h>
@@ -105,6 +106,7 @@ bool Project::read(QString const& path)
     auto const prefix = stdString(exeDir.absoluteFilePath(".."));
     this->config = kwiver::vital::read_config_file(
       qPrintable(path), "telesculptor", TELESCULPTOR_VERSION, prefix);
+    kwiver::maptk::load_plugins_for_config(this->config);
 
     if (config->has_value("working_directory"))
     {
@@ -0,0 +1,201 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ToolJobScheduler.h"
+
+#include "tools/AbstractTool.h"
+
+#include <vital/logger/logger.h>
+
+#include <qtStlUtil.h>
+
+#include <QMenu>
+
+//-----------------------------------------------------------------------------
+class ToolJobSchedulerPrivate
+{
+public:
+  void updateTools(ToolJobScheduler* q);
+
+  QList<AbstractTool*> tools;
+  QList<AbstractTool*> running;
+  bool available = false;
+
+  QMenu cancelMenu;
+
+  kwiver::vital::logger_handle_t logger =
+    kwiver::vital::get_logger("telesculptor.tool_jobs");
+};
+
+QTE_IMPLEMENT_D_FUNC(ToolJobScheduler)
+
+//-----------------------------------------------------------------------------
+void ToolJobSchedulerPrivate::updateTools(ToolJobScheduler* q)
+{
+  foreach (auto const& tool, this->tools)
+  {
+    tool->setEnabled(this->available && q->canStart(tool));
+  }
+
+  // Rebuild the menu of cancelable tools
+  this->cancelMenu.clear();
+  auto cancelable = 0;
+  foreach (auto const& tool, this->running)
+  {
+    if (tool->isCancelable())
+    {
+      auto text = tool->text();
+      text.replace('&', "");
+      auto* const action = this->cancelMenu.addAction(text);
+      QObject::connect(action, &QAction::triggered, q, [q, tool]() {
+                         tool->cancel();
+                         emit q->toolCanceled(tool);
+                       });
+      ++cancelable;
+    }
+  }
+  if (cancelable > 1)
+  {
+    this->cancelMenu.addSeparator();
+    this->cancelMenu.addAction("Cancel &All", q, &ToolJobScheduler::cancelAll);
+  }
+  this->cancelMenu.setEnabled(cancelable > 0);
+  this->cancelMenu.menuAction()->setEnabled(cancelable > 0);
+}
+
+//-----------------------------------------------------------------------------
+ToolJobScheduler::ToolJobScheduler(QObject* parent)
+  : QObject{parent}, d_ptr{new ToolJobSchedulerPrivate}
+{
+  QTE_D();
+  d->cancelMenu.menuAction()->setEnabled(false);
+}
+
+//-----------------------------------------------------------------------------
+ToolJobScheduler::~ToolJobScheduler()
+{
+}
+
+//-----------------------------------------------------------------------------
+void ToolJobScheduler::addTool(AbstractTool* tool)
+{
+  QTE_D();
+  d->tools.append(tool);
+  tool->setEnabled(d->available && this->canStart(tool));
+}
+
+//-----------------------------------------------------------------------------
+void ToolJobScheduler::setToolsAvailable(bool available)
+{
+  QTE_D();
+  d->available = available;
+  d->updateTools(this);
+}
+
+//-----------------------------------------------------------------------------
+QList<AbstractTool*> ToolJobScheduler::runningTools() const
+{
+  QTE_D();
+  return d->running;
+}
+
+//-----------------------------------------------------------------------------
+bool ToolJobScheduler::isIdle() const
+{
+  QTE_D();
+  return d->running.isEmpty();
+}
+
+//-----------------------------------------------------------------------------
+bool ToolJobScheduler::canStart(AbstractTool* tool) const
+{
+  QTE_D();
+
+  if (d->running.contains(tool))
+  {
+    return false;
+  }
+  foreach (auto const& other, d->running)
+  {
+    if (!tool->canRunWith(other))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void ToolJobScheduler::start(AbstractTool* tool)
+{
+  QTE_D();
+
+  d->running.append(tool);
+  LOG_DEBUG(d->logger, "Started " << stdString(tool->text()) << "; "
+                       << d->running.size() << " tools running");
+  d->updateTools(this);
+  emit this->runningToolsChanged();
+}
+
+//-----------------------------------------------------------------------------
+void ToolJobScheduler::finish(AbstractTool* tool)
+{
+  QTE_D();
+
+  if (d->running.removeOne(tool))
+  {
+    LOG_DEBUG(d->logger, "Finished " << stdString(tool->text()) << "; "
+                         << d->running.size() << " tools running");
+    d->updateTools(this);
+    emit this->runningToolsChanged();
+  }
+}
+
+//-----------------------------------------------------------------------------
+QMenu* ToolJobScheduler::cancelMenu() const
+{
+  QTE_D();
+  return &d->cancelMenu;
+}
+
+//-----------------------------------------------------------------------------
+void ToolJobScheduler::cancelAll()
+{
+  QTE_D();
+
+  foreach (auto const& tool, d->running)
+  {
+    if (tool->isCancelable())
+    {
+      tool->cancel();
+      emit this->toolCanceled(tool);
+    }
+  }
+}
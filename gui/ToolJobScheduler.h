@@ -0,0 +1,103 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TELESCULPTOR_TOOLJOBSCHEDULER_H_
+#define TELESCULPTOR_TOOLJOBSCHEDULER_H_
+
+#include <qtGlobal.h>
+
+#include <QList>
+#include <QObject>
+
+class AbstractTool;
+class ToolJobSchedulerPrivate;
+
+class QMenu;
+
+/// Tracks the running tools and which tools may start alongside them.
+///
+/// Each tool declares the project data it reads and modifies. A tool may run
+/// while other tools are running as long as neither modifies data the other
+/// reads or modifies, so for example key frames can be exported while depth
+/// maps are computed. The scheduler enables the actions of the tools that
+/// can currently start and maintains a menu for canceling running tools.
+class ToolJobScheduler : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit ToolJobScheduler(QObject* parent = nullptr);
+  ~ToolJobScheduler() override;
+
+  /// Add a tool whose action is enabled by the scheduler.
+  void addTool(AbstractTool* tool);
+
+  /// Set whether tools may be started at all.
+  ///
+  /// This is used to disable all tools while no project is loaded or the
+  /// video is being imported.
+  void setToolsAvailable(bool available);
+
+  /// Get the running tools, in the order they were started.
+  QList<AbstractTool*> runningTools() const;
+
+  /// Test if no tools are running.
+  bool isIdle() const;
+
+  /// Test if a tool may start given the tools that are running.
+  bool canStart(AbstractTool* tool) const;
+
+  /// Record that a tool has started.
+  void start(AbstractTool* tool);
+
+  /// Record that a tool has finished.
+  void finish(AbstractTool* tool);
+
+  /// Get the menu of running tools that can be canceled.
+  QMenu* cancelMenu() const;
+
+signals:
+  /// Emitted when a tool starts or finishes.
+  void runningToolsChanged();
+
+  /// Emitted when the user requests that a tool be canceled.
+  void toolCanceled(AbstractTool* tool);
+
+public slots:
+  /// Request that every running tool be canceled.
+  void cancelAll();
+
+private:
+  QTE_DECLARE_PRIVATE_RPTR(ToolJobScheduler)
+  QTE_DECLARE_PRIVATE(ToolJobScheduler)
+  QTE_DISABLE_COPY(ToolJobScheduler)
+};
+
+#endif
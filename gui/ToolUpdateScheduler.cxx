@@ -0,0 +1,159 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ToolUpdateScheduler.h"
+
+#include <vital/logger/logger.h>
+
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <algorithm>
+
+namespace
+{
+// Bounds on the delay between an update request and the update
+static int const MIN_INTERVAL = 50;
+static int const MAX_INTERVAL = 2000;
+
+// Ratio of idle time to update time; a value of 4 lets the views spend at
+// most about 20% of the time redrawing tool results
+static double const IDLE_RATIO = 4.0;
+
+// Weight of the most recent measurement in the update cost estimate
+static double const COST_SMOOTHING = 0.5;
+}
+
+//-----------------------------------------------------------------------------
+class ToolUpdateSchedulerPrivate
+{
+public:
+  void update(ToolUpdateScheduler* q);
+
+  QTimer timer;
+  QElapsedTimer pendingTime;
+
+  double cost = 0.0;
+  int latency = 0;
+  int updateCount = 0;
+
+  kwiver::vital::logger_handle_t logger =
+    kwiver::vital::get_logger("telesculptor.tool_updates");
+};
+
+QTE_IMPLEMENT_D_FUNC(ToolUpdateScheduler)
+
+//-----------------------------------------------------------------------------
+void ToolUpdateSchedulerPrivate::update(ToolUpdateScheduler* q)
+{
+  this->timer.stop();
+
+  QElapsedTimer updateTime;
+  updateTime.start();
+  emit q->updateRequested();
+  auto const elapsed = static_cast<double>(updateTime.elapsed());
+
+  this->cost = (this->updateCount == 0
+                ? elapsed
+                : COST_SMOOTHING * elapsed +
+                  (1.0 - COST_SMOOTHING) * this->cost);
+  this->latency = static_cast<int>(this->pendingTime.elapsed());
+  ++this->updateCount;
+
+  auto const interval = static_cast<int>(IDLE_RATIO * this->cost);
+  this->timer.setInterval(
+    std::min(std::max(interval, MIN_INTERVAL), MAX_INTERVAL));
+
+  LOG_DEBUG(this->logger, "Tool update " << this->updateCount
+                          << " took " << elapsed << " ms, latency "
+                          << this->latency << " ms, next interval "
+                          << this->timer.interval() << " ms");
+}
+
+//-----------------------------------------------------------------------------
+ToolUpdateScheduler::ToolUpdateScheduler(QObject* parent)
+  : QObject{parent}, d_ptr{new ToolUpdateSchedulerPrivate}
+{
+  QTE_D();
+
+  d->timer.setSingleShot(true);
+  d->timer.setInterval(MIN_INTERVAL);
+  connect(&d->timer, &QTimer::timeout, this, [d, this]{ d->update(this); });
+}
+
+//-----------------------------------------------------------------------------
+ToolUpdateScheduler::~ToolUpdateScheduler()
+{
+}
+
+//-----------------------------------------------------------------------------
+int ToolUpdateScheduler::interval() const
+{
+  QTE_D();
+  return d->timer.interval();
+}
+
+//-----------------------------------------------------------------------------
+int ToolUpdateScheduler::latency() const
+{
+  QTE_D();
+  return d->latency;
+}
+
+//-----------------------------------------------------------------------------
+int ToolUpdateScheduler::updateCount() const
+{
+  QTE_D();
+  return d->updateCount;
+}
+
+//-----------------------------------------------------------------------------
+void ToolUpdateScheduler::schedule()
+{
+  QTE_D();
+
+  if (!d->timer.isActive())
+  {
+    d->pendingTime.start();
+    d->timer.start();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void ToolUpdateScheduler::flush()
+{
+  QTE_D();
+
+  if (!d->timer.isActive())
+  {
+    d->pendingTime.start();
+  }
+  d->update(this);
+}
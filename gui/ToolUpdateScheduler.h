@@ -0,0 +1,92 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TELESCULPTOR_TOOLUPDATESCHEDULER_H_
+#define TELESCULPTOR_TOOLUPDATESCHEDULER_H_
+
+#include <qtGlobal.h>
+
+#include <QObject>
+
+class ToolUpdateSchedulerPrivate;
+
+/// Schedules view updates for interim tool results.
+///
+/// Rather than refreshing at a fixed rate, the scheduler measures how long
+/// each update takes and spaces subsequent updates so that the views spend
+/// only a bounded fraction of time redrawing. Fast updates are shown with
+/// little delay, while expensive updates are throttled to keep the user
+/// interface responsive.
+class ToolUpdateScheduler : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit ToolUpdateScheduler(QObject* parent = nullptr);
+  ~ToolUpdateScheduler() override;
+
+  /// Get the current delay in milliseconds between an update request and the
+  /// update being performed.
+  int interval() const;
+
+  /// Get the latency in milliseconds of the most recent update.
+  ///
+  /// This is the time from the first request of an update until the update
+  /// finished, including the time spent performing it. It is shown with the
+  /// progress of running tools.
+  int latency() const;
+
+  /// Get the number of updates performed.
+  int updateCount() const;
+
+signals:
+  /// Emitted when the views should be updated.
+  ///
+  /// Receivers must be connected directly, so that the time spent in the
+  /// update is included in the cost measurement.
+  void updateRequested();
+
+public slots:
+  /// Request an update.
+  ///
+  /// If an update is already pending, this does nothing; the pending update
+  /// will pick up the new results.
+  void schedule();
+
+  /// Perform any pending update immediately.
+  void flush();
+
+private:
+  QTE_DECLARE_PRIVATE_RPTR(ToolUpdateScheduler)
+  QTE_DECLARE_PRIVATE(ToolUpdateScheduler)
+  QTE_DISABLE_COPY(ToolUpdateScheduler)
+};
+
+#endif
@@ -32,6 +32,7 @@
 #include "tools/AbstractTool.h"
 #include "VideoImport.h"
 
+#include <maptk/plugin_manifest.h>
 #include <maptk/version.h>
 
 #include <vital/plugin_loader/plugin_manager.h>
@@ -99,12 +100,12 @@ int main(int argc, char** argv)
   QApplication app(args.qtArgc(), args.qtArgv());
   qtUtil::setApplicationIcon("telesculptor");
 
-  // Load KWIVER plugins
+  // Set up KWIVER plugin search paths; algorithm plugins are loaded on demand
+  // as configurations naming their algorithms are read (see readConfig)
   auto const exeDir = QDir{QApplication::applicationDirPath()};
   auto& vpm = kwiver::vital::plugin_manager::instance();
   vpm.add_search_path(stdString(exeDir.absoluteFilePath("../lib/kwiver/modules")));
   vpm.add_search_path(stdString(exeDir.absoluteFilePath("../lib/kwiver/processes")));
-  vpm.load_all_plugins();
 
   // Tell PROJ where to find its data files
   auto projDataDir = exeDir.absoluteFilePath("../share/proj");
@@ -120,6 +121,11 @@ int main(int argc, char** argv)
     qputenv("GDAL_DATA", gdalDataDir.toLocal8Bit());
   }
 
+  // Load the plugins that provide services rather than algorithms, such as
+  // the geographic conversion, so that cameras and ground control points can
+  // be imported before a project or tool configuration is read
+  kwiver::maptk::load_plugins_for_config(nullptr);
+
   // Create and show main window
   MainWindow window;
   window.show();
@@ -234,6 +234,51 @@ AbstractTool::sfm_constraints_sptr AbstractTool::sfmConstraints() const
 }
 
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources AbstractTool::writes() const
+{
+  auto const out = this->outputs();
+  Resources result;
+  if (out & (Tracks | TrackChanges))
+  {
+    result |= TrackData;
+  }
+  if (out.testFlag(Cameras))
+  {
+    result |= CameraData;
+  }
+  if (out.testFlag(Landmarks))
+  {
+    // New landmarks may recenter the geographic origin, which also moves
+    // the cameras
+    result |= LandmarkData | CameraData;
+  }
+  if (out & (Depth | BatchDepth))
+  {
+    result |= DepthData;
+  }
+  if (out.testFlag(Fusion))
+  {
+    result |= VolumeData;
+  }
+  if (out.testFlag(ActiveFrame))
+  {
+    // The active frame also identifies the frame of a tool's depth map, so
+    // only one tool at a time may drive it
+    result |= ActiveFrameData;
+  }
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+bool AbstractTool::canRunWith(AbstractTool const* other) const
+{
+  auto const writes = this->writes();
+  auto const otherWrites = other->writes();
+  return !(writes & (other->reads() | otherWrites)) &&
+         !(this->reads() & otherWrites);
+}
+
 //-----------------------------------------------------------------------------
 void AbstractTool::cancel()
 {
@@ -325,6 +370,13 @@ void AbstractTool::setMaskPath(std::string const& path)
   d->data->maskPath = path;
 }
 
+//-----------------------------------------------------------------------------
+void AbstractTool::setDepthPath(std::string const& path)
+{
+  QTE_D();
+  d->data->depthPath = path;
+}
+
 //-----------------------------------------------------------------------------
 void AbstractTool::setConfig(config_block_sptr& config)
 {
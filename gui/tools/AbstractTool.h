@@ -86,6 +86,7 @@ public:
   unsigned int activeFrame;
   std::string videoPath;
   std::string maskPath;
+  std::string depthPath;
   feature_track_set_sptr tracks;
   feature_track_set_changes_sptr track_changes;
   depth_sptr active_depth;
@@ -130,12 +131,41 @@ public:
   };
   Q_DECLARE_FLAGS(Outputs, Output)
 
+  /// Project data that a tool may read or modify.
+  enum Resource
+  {
+    TrackData = 0x1,
+    CameraData = 0x2,
+    LandmarkData = 0x4,
+    DepthData = 0x8,
+    VolumeData = 0x10,
+    /// The frame the view follows while a tool runs
+    ActiveFrameData = 0x20
+  };
+  Q_DECLARE_FLAGS(Resources, Resource)
+
   explicit AbstractTool(QObject* parent = 0);
   ~AbstractTool() override;
 
   /// Get the types of output produced by the tool.
   virtual Outputs outputs() const = 0;
 
+  /// Get the project data read by the tool.
+  ///
+  /// This method must be overridden by tool implementations. Together with
+  /// writes(), it determines which tools may run at the same time.
+  virtual Resources reads() const = 0;
+
+  /// Get the project data modified by the tool.
+  ///
+  /// The default implementation derives this from outputs().
+  virtual Resources writes() const;
+
+  /// Test if the tool can run while another tool is running.
+  ///
+  /// Two tools conflict if either modifies data the other reads or modifies.
+  bool canRunWith(AbstractTool const* other) const;
+
   /// Get if the tool can be canceled.
   ///
   /// This method must be overridden by tool implementations. It should return
@@ -185,6 +215,9 @@ public:
   /// Set the mask video source path.
   void setMaskPath(std::string const&);
 
+  /// Set the directory to which depth maps are written.
+  void setDepthPath(std::string const&);
+
   /// Set the config file if any
   void setConfig(config_block_sptr&);
 
@@ -368,5 +401,6 @@ private:
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(AbstractTool::Outputs)
+Q_DECLARE_OPERATORS_FOR_FLAGS(AbstractTool::Resources)
 
 #endif
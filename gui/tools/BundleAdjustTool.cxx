@@ -32,34 +32,228 @@
 #include "GuiCommon.h"
 
 #include <vital/algo/bundle_adjust.h>
+#include <vital/types/camera_perspective_map.h>
 
 #include <QMessageBox>
 
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
 using kwiver::vital::algo::bundle_adjust;
 using kwiver::vital::algo::bundle_adjust_sptr;
 
+namespace kv = kwiver::vital;
+
 namespace
 {
 static char const* const BLOCK = "bundle_adjuster";
+static char const* const LOCAL_BLOCK = "local_bundle_adjust";
+
+//-----------------------------------------------------------------------------
+// Return a copy of a map with the entries of another map replacing its own
+template <typename Map>
+Map mergeMaps(Map all, Map const& updated)
+{
+  for (auto const& item : updated)
+  {
+    all[item.first] = item.second;
+  }
+  return all;
+}
+
+//-----------------------------------------------------------------------------
+// Return true if two configuration blocks hold the same values
+bool sameValues(kv::config_block_sptr const& a, kv::config_block_sptr const& b)
+{
+  if (!a || !b)
+  {
+    return false;
+  }
+
+  auto const keys = a->available_values();
+  if (keys.size() != b->available_values().size())
+  {
+    return false;
+  }
+  for (auto const& key : keys)
+  {
+    if (!b->has_value(key) ||
+        a->get_value<std::string>(key) != b->get_value<std::string>(key))
+    {
+      return false;
+    }
+  }
+  return true;
+}
 }
 
 //-----------------------------------------------------------------------------
 class BundleAdjustToolPrivate
 {
 public:
+  void selectNeighborhood(kv::frame_id_t activeFrame,
+                          kv::feature_track_set_sptr const& tracks);
+
+  BundleAdjustTool::Scope scope = BundleAdjustTool::Global;
   bundle_adjust_sptr algorithm;
+  kv::config_block_sptr algorithmConfig;
+
+  // Local refinement neighborhood size
+  int frameWindow = 10;
+  unsigned covisibleCameras = 0;
+
+  // Full solution into which local results are merged
+  kv::camera_map::map_camera_t allCameras;
+  kv::landmark_map::map_landmark_t allLandmarks;
+
+  // Local problem
+  std::set<kv::frame_id_t> variableCameras;
+  std::set<kv::frame_id_t> fixedCameras;
+  kv::simple_camera_perspective_map localCameras;
+  kv::landmark_map::map_landmark_t localLandmarks;
+  kv::feature_track_set_sptr localTracks;
 };
 
 QTE_IMPLEMENT_D_FUNC(BundleAdjustTool)
 
+//-----------------------------------------------------------------------------
+void BundleAdjustToolPrivate::selectNeighborhood(
+  kv::frame_id_t active, kv::feature_track_set_sptr const& tp)
+{
+  auto const perspective = [this](kv::frame_id_t frame)
+  {
+    auto const i = this->allCameras.find(frame);
+    return (i == this->allCameras.end()
+            ? kv::camera_perspective_sptr{}
+            : std::dynamic_pointer_cast<kv::camera_perspective>(i->second));
+  };
+
+  // Optimize the cameras within the frame window of the active frame
+  this->variableCameras.clear();
+  for (auto const& c : this->allCameras)
+  {
+    if (std::llabs(c.first - active) <= this->frameWindow &&
+        perspective(c.first))
+    {
+      this->variableCameras.insert(c.first);
+    }
+  }
+
+  // Also optimize the cameras sharing the most landmarks with the active
+  // frame
+  if (this->covisibleCameras > 0)
+  {
+    std::map<kv::frame_id_t, size_t> shared;
+    for (auto const& t : tp->active_tracks(active))
+    {
+      if (!this->allLandmarks.count(t->id()))
+      {
+        continue;
+      }
+      for (auto const& ts : *t)
+      {
+        if (!this->variableCameras.count(ts->frame()) &&
+            perspective(ts->frame()))
+        {
+          ++shared[ts->frame()];
+        }
+      }
+    }
+    std::vector<std::pair<size_t, kv::frame_id_t>> ranked;
+    for (auto const& s : shared)
+    {
+      ranked.emplace_back(s.second, s.first);
+    }
+    auto const n = std::min<size_t>(this->covisibleCameras, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + n, ranked.end(),
+                      std::greater<std::pair<size_t, kv::frame_id_t>>());
+    for (size_t i = 0; i < n; ++i)
+    {
+      this->variableCameras.insert(ranked[i].second);
+    }
+  }
+
+  if (this->variableCameras.empty())
+  {
+    throw std::runtime_error("There are no cameras near the current frame");
+  }
+
+  // Optimize the landmarks those cameras observe
+  std::vector<kv::track_sptr> tracks;
+  this->localLandmarks.clear();
+  for (auto const f : this->variableCameras)
+  {
+    for (auto const& t : tp->active_tracks(f))
+    {
+      auto const i = this->allLandmarks.find(t->id());
+      if (i != this->allLandmarks.end() && i->second &&
+          this->localLandmarks.emplace(i->first, i->second).second)
+      {
+        tracks.push_back(t);
+      }
+    }
+  }
+
+  // Hold fixed the other cameras observing those landmarks, so that the
+  // landmarks stay tied to the rest of the solution
+  this->localCameras = kv::simple_camera_perspective_map{};
+  this->fixedCameras.clear();
+  for (auto const& t : tracks)
+  {
+    for (auto const& ts : *t)
+    {
+      auto const f = ts->frame();
+      if (this->localCameras.find(f))
+      {
+        continue;
+      }
+      if (auto const cam = perspective(f))
+      {
+        this->localCameras.insert(f, cam);
+        if (!this->variableCameras.count(f))
+        {
+          this->fixedCameras.insert(f);
+        }
+      }
+    }
+  }
+
+  this->localTracks = std::make_shared<kv::feature_track_set>(tracks);
+}
+
 //-----------------------------------------------------------------------------
 BundleAdjustTool::BundleAdjustTool(QObject* parent)
+  : BundleAdjustTool(Global, parent)
+{
+}
+
+//-----------------------------------------------------------------------------
+BundleAdjustTool::BundleAdjustTool(Scope scope, QObject* parent)
   : AbstractTool(parent), d_ptr(new BundleAdjustToolPrivate)
 {
-  this->setText("&Refine Solution");
-  this->setToolTip(
-    "<nobr>Apply bundle adjustment to the cameras and landmarks in order to"
-    "</nobr> refine the quality of the 3D reconstruction");
+  QTE_D();
+  d->scope = scope;
+
+  if (scope == Local)
+  {
+    this->setText("Refine &Local Solution");
+    this->setToolTip(
+      "<nobr>Apply bundle adjustment to the cameras near the current frame"
+      "</nobr> and the landmarks they observe, holding the rest of the"
+      " solution fixed");
+  }
+  else
+  {
+    this->setText("&Refine Solution");
+    this->setToolTip(
+      "<nobr>Apply bundle adjustment to the cameras and landmarks in order to"
+      "</nobr> refine the quality of the 3D reconstruction");
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -73,6 +267,12 @@ AbstractTool::Outputs BundleAdjustTool::outputs() const
   return Cameras | Landmarks;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources BundleAdjustTool::reads() const
+{
+  return TrackData | CameraData | LandmarkData;
+}
+
 //-----------------------------------------------------------------------------
 bool BundleAdjustTool::execute(QWidget* window)
 {
@@ -108,8 +308,19 @@ bool BundleAdjustTool::execute(QWidget* window)
     return false;
   }
 
-  // Create algorithm from configuration
-  bundle_adjust::set_nested_algo_configuration(BLOCK, config, d->algorithm);
+  // Create algorithm from configuration, reusing the one from the previous
+  // run if its configuration has not changed
+  auto const algorithmConfig = config->subblock(BLOCK);
+  if (!d->algorithm || !sameValues(algorithmConfig, d->algorithmConfig))
+  {
+    bundle_adjust::set_nested_algo_configuration(BLOCK, config, d->algorithm);
+    d->algorithmConfig = algorithmConfig;
+  }
+
+  d->frameWindow = config->get_value<int>(
+    std::string{LOCAL_BLOCK} + ":frame_window", 10);
+  d->covisibleCameras = config->get_value<unsigned>(
+    std::string{LOCAL_BLOCK} + ":covisible_cameras", 0);
 
   // Set the callback to receive updates
   using std::placeholders::_1;
@@ -127,6 +338,28 @@ void BundleAdjustTool::run()
 {
   QTE_D();
 
+  if (d->scope == Local)
+  {
+    d->allCameras = this->cameras()->cameras();
+    d->allLandmarks = this->landmarks()->landmarks();
+    d->selectNeighborhood(this->activeFrame(), this->tracks());
+
+    this->setDescription(
+      QString("Refining %1 cameras and %2 landmarks (%3 cameras fixed)")
+      .arg(d->variableCameras.size()).arg(d->localLandmarks.size())
+      .arg(d->fixedCameras.size()));
+
+    d->algorithm->optimize(d->localCameras, d->localLandmarks,
+                           d->localTracks, d->fixedCameras, {},
+                           this->sfmConstraints());
+
+    this->updateCameras(std::make_shared<kv::simple_camera_map>(
+      mergeMaps(d->allCameras, d->localCameras.cameras())));
+    this->updateLandmarks(std::make_shared<kv::simple_landmark_map>(
+      mergeMaps(d->allLandmarks, d->localLandmarks)));
+    return;
+  }
+
   auto cp = this->cameras();
   auto lp = this->landmarks();
   auto tp = this->tracks();
@@ -142,6 +375,17 @@ void BundleAdjustTool::run()
 bool BundleAdjustTool::callback_handler(camera_map_sptr cameras,
                                         landmark_map_sptr landmarks)
 {
+  QTE_D();
+
+  // Interim local results cover only part of the solution
+  if (d->scope == Local)
+  {
+    cameras = std::make_shared<kv::simple_camera_map>(
+      mergeMaps(d->allCameras, cameras->cameras()));
+    landmarks = std::make_shared<kv::simple_landmark_map>(
+      mergeMaps(d->allLandmarks, landmarks->landmarks()));
+  }
+
   // make a copy of the tool data
   auto data = std::make_shared<ToolData>();
   data->copyCameras(cameras);
@@ -40,10 +40,22 @@ class BundleAdjustTool : public AbstractTool
   Q_OBJECT
 
 public:
+  /// Which cameras and landmarks the tool optimizes
+  enum Scope
+  {
+    /// Optimize all cameras and landmarks
+    Global,
+    /// Optimize the cameras near the active frame and the landmarks they
+    /// observe, holding everything else fixed
+    Local
+  };
+
   explicit BundleAdjustTool(QObject* parent = 0);
+  explicit BundleAdjustTool(Scope scope, QObject* parent = 0);
   ~BundleAdjustTool() override;
 
   Outputs outputs() const override;
+  Resources reads() const override;
 
   /// Get if the tool can be canceled.
   bool isCancelable() const override { return true; }
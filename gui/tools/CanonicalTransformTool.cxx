@@ -31,9 +31,9 @@
 #include "CanonicalTransformTool.h"
 #include "GuiCommon.h"
 
-#include <vital/algo/estimate_canonical_transform.h>
+#include <maptk/canonical_transform.h>
 
-#include <arrows/core/transform.h>
+#include <vital/algo/estimate_canonical_transform.h>
 
 #include <QMessageBox>
 
@@ -77,6 +77,12 @@ AbstractTool::Outputs CanonicalTransformTool::outputs() const
   return Cameras | Landmarks;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources CanonicalTransformTool::reads() const
+{
+  return CameraData | LandmarkData;
+}
+
 //-----------------------------------------------------------------------------
 bool CanonicalTransformTool::execute(QWidget* window)
 {
@@ -122,9 +128,18 @@ void CanonicalTransformTool::run()
 {
   QTE_D();
 
-  auto const& xf =
-    d->algorithm->estimate_transform(this->cameras(), this->landmarks());
+  auto const cp = this->cameras();
+  auto const lp = this->landmarks();
+  auto const& xf = d->algorithm->estimate_transform(cp, lp);
+
+  // The tool data holds copies of the cameras and landmarks, so they can be
+  // transformed in place
+  if (cp)
+  {
+    kwiver::maptk::transform_inplace(*cp, xf);
+  }
+  kwiver::maptk::transform_inplace(*lp, xf);
 
-  this->updateCameras(kwiver::arrows::core::transform(this->cameras(), xf));
-  this->updateLandmarks(kwiver::arrows::core::transform(this->landmarks(), xf));
+  this->updateCameras(cp);
+  this->updateLandmarks(lp);
 }
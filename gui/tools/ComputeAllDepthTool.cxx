@@ -32,17 +32,24 @@
 #include "ComputeAllDepthTool.h"
 #include "GuiCommon.h"
 
+#include <maptk/depth_map_io.h>
+
 #include <arrows/core/depth_utils.h>
 #include <vital/algo/compute_depth.h>
 #include <vital/algo/image_io.h>
 #include <vital/algo/video_input.h>
 #include <vital/config/config_block_io.h>
 #include <vital/types/metadata.h>
+#include <vital/util/thread_pool.h>
 
+#include <QDir>
 #include <QMessageBox>
 #include <qtStlUtil.h>
 
 #include <algorithm>
+#include <deque>
+#include <future>
+#include <mutex>
 
 #include <vtkDoubleArray.h>
 #include <vtkImageData.h>
@@ -51,6 +58,7 @@
 #include <vtkPointData.h>
 #include <vtkSmartPointer.h>
 #include <vtkUnsignedCharArray.h>
+#include <vtkXMLImageDataWriter.h>
 
 using kwiver::vital::algo::compute_depth;
 using kwiver::vital::algo::compute_depth_sptr;
@@ -69,14 +77,76 @@ static char const* const BLOCK_CD = "compute_depth";
 class ComputeAllDepthToolPrivate
 {
 public:
+  void queueDepthWrite(ComputeAllDepthTool* q,
+                       kwiver::vital::frame_id_t frame,
+                       std::string const& filepath,
+                       vtkSmartPointer<vtkImageData> const& depth);
+  void waitForDepthWrites(size_t maxPending = 0);
 
   video_input_sptr video_reader;
   compute_depth_sptr depth_algo;
   int start_frame, end_frame, num_depth, num_support;
+
+  // Depth maps that have been handed off but may not yet be on disk
+  std::deque<std::future<void>> pendingWrites;
+  std::mutex lookupMutex;
 };
 
 QTE_IMPLEMENT_D_FUNC(ComputeAllDepthTool)
 
+//-----------------------------------------------------------------------------
+void ComputeAllDepthToolPrivate::queueDepthWrite(
+  ComputeAllDepthTool* q, kwiver::vital::frame_id_t frame,
+  std::string const& filepath, vtkSmartPointer<vtkImageData> const& depth)
+{
+  auto const lookup = q->depthLookup();
+  auto const logger = q->data()->logger;
+
+  auto writeDepth = [=]()
+  {
+    vtkNew<vtkXMLImageDataWriter> writer;
+    writer->SetFileName(filepath.c_str());
+    writer->AddInputDataObject(depth.Get());
+    writer->SetDataModeToBinary();
+    if (!writer->Write())
+    {
+      LOG_ERROR(logger, "Failed to write depth map for frame "
+                        << frame << " to " << filepath);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(this->lookupMutex);
+      (*lookup)[frame] = filepath;
+    }
+
+    // Notify the GUI that the map is available; the depth image itself is
+    // not sent, the GUI loads it from disk if and when it is displayed
+    auto data = std::make_shared<ToolData>();
+    data->activeFrame = static_cast<unsigned int>(frame);
+    data->depthLookup =
+      std::make_shared<std::map<kwiver::vital::frame_id_t, std::string>>();
+    data->depthLookup->emplace(frame, filepath);
+    emit q->updated(data);
+  };
+
+  auto& pool = kwiver::vital::thread_pool::instance();
+  this->pendingWrites.push_back(pool.enqueue(writeDepth));
+
+  // Bound the number of depth maps held in memory waiting to be written
+  this->waitForDepthWrites(pool.num_threads());
+}
+
+//-----------------------------------------------------------------------------
+void ComputeAllDepthToolPrivate::waitForDepthWrites(size_t maxPending)
+{
+  while (this->pendingWrites.size() > maxPending)
+  {
+    this->pendingWrites.front().wait();
+    this->pendingWrites.pop_front();
+  }
+}
+
 //-----------------------------------------------------------------------------
 ComputeAllDepthTool::ComputeAllDepthTool(QObject* parent)
   : AbstractTool(parent), d_ptr(new ComputeAllDepthToolPrivate)
@@ -96,7 +166,13 @@ ComputeAllDepthTool::~ComputeAllDepthTool()
 //-----------------------------------------------------------------------------
 AbstractTool::Outputs ComputeAllDepthTool::outputs() const
 {
-  return Depth | ActiveFrame | BatchDepth;
+  return ActiveFrame | BatchDepth;
+}
+
+//-----------------------------------------------------------------------------
+AbstractTool::Resources ComputeAllDepthTool::reads() const
+{
+  return CameraData | LandmarkData;
 }
 
 //-----------------------------------------------------------------------------
@@ -152,6 +228,15 @@ bool ComputeAllDepthTool::execute(QWidget* window)
 
   d->num_support = config->get_value<int>("compute_depth:num_support", 10);
 
+  // Depth maps are written by the tool as they are computed
+  if (this->data()->depthPath.empty() ||
+      !QDir().mkpath(qtString(this->data()->depthPath)))
+  {
+    QMessageBox::critical(
+      window, "Output error",
+      "Unable to create the depth map output directory.");
+    return false;
+  }
 
   return AbstractTool::execute(window);
 }
@@ -224,6 +309,7 @@ void ComputeAllDepthTool::run()
     std::vector<kwiver::vital::image_container_sptr> frames_out;
     std::vector<kwiver::vital::camera_perspective_sptr> cameras_out;
     std::vector<kwiver::vital::frame_id_t> frame_ids;
+    kwiver::vital::metadata_vector ref_mdv;
     int ref_frame = 0; //local ref frame
 
     kwiver::vital::timestamp currentTimestamp;
@@ -255,6 +341,7 @@ void ComputeAllDepthTool::run()
       if (*f == *fitr)
       {
         ref_frame = static_cast<int>(frames_out.size());
+        ref_mdv = mdv;
       }
       frames_out.push_back(image);
       cameras_out.push_back(std::dynamic_pointer_cast<camera_perspective>(cam->second));
@@ -282,16 +369,24 @@ void ComputeAllDepthTool::run()
     auto depth = d->depth_algo->compute(frames_out, cameras_out,
                                         height_min, height_max,
                                         ref_frame, crop);
-    auto image_data = depth_to_vtk(depth, frames_out[ref_frame], crop.min_x(), crop.width(),
+    auto image_data = kwiver::maptk::depth_to_vtk(depth, frames_out[ref_frame], crop.min_x(), crop.width(),
                                    crop.min_y(), crop.height());
 
-    auto data = std::make_shared<ToolData>();
-    data->copyDepth(image_data);
-    data->activeFrame = *fitr;
-    emit updated(data);
+    // Hand the depth map off to be written in the background; the GUI is
+    // notified once it has been saved
+    auto const filename = frameName(*fitr, ref_mdv) + ".vti";
+    auto const filepath =
+      stdString(QDir{qtString(this->data()->depthPath)}.filePath(
+        qtString(filename)));
+    d->queueDepthWrite(this, *fitr, filepath, image_data);
+
     if (this->isCanceled())
-      return;
-    //this->updateDepth(image_data);
+    {
+      break;
+    }
   }
+
+  // Make sure every computed depth map is on disk before finishing
+  d->waitForDepthWrites();
 }
 
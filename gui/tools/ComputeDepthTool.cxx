@@ -31,6 +31,8 @@
 #include "ComputeDepthTool.h"
 #include "GuiCommon.h"
 
+#include <maptk/depth_map_io.h>
+
 #include <arrows/core/depth_utils.h>
 #include <vital/algo/image_io.h>
 #include <vital/algo/compute_depth.h>
@@ -44,13 +46,8 @@
 
 #include <algorithm>
 
-#include <vtkDoubleArray.h>
 #include <vtkImageData.h>
-#include <vtkNew.h>
-#include <vtkPointData.h>
 #include <vtkSmartPointer.h>
-#include <vtkUnsignedCharArray.h>
-#include <vtkIntArray.h>
 
 using kwiver::vital::algo::image_io;
 using kwiver::vital::algo::image_io_sptr;
@@ -103,6 +100,12 @@ AbstractTool::Outputs ComputeDepthTool::outputs() const
   return Depth | ActiveFrame;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources ComputeDepthTool::reads() const
+{
+  return CameraData | LandmarkData;
+}
+
 //-----------------------------------------------------------------------------
 bool ComputeDepthTool::execute(QWidget* window)
 {
@@ -165,68 +168,6 @@ bool ComputeDepthTool::execute(QWidget* window)
   return AbstractTool::execute(window);
 }
 
-//-----------------------------------------------------------------------------
-vtkSmartPointer<vtkImageData>
-depth_to_vtk(kwiver::vital::image_container_sptr depth_img,
-             kwiver::vital::image_container_sptr color_img,
-             int i0, int ni, int j0, int nj)
-{
-  vtkNew<vtkDoubleArray> uniquenessRatios;
-  uniquenessRatios->SetName("Uniqueness Ratios");
-  uniquenessRatios->SetNumberOfValues(ni*nj);
-
-  vtkNew<vtkDoubleArray> bestCost;
-  bestCost->SetName("Best Cost Values");
-  bestCost->SetNumberOfValues(ni*nj);
-
-  vtkNew<vtkUnsignedCharArray> color;
-  color->SetName("Color");
-  color->SetNumberOfComponents(3);
-  color->SetNumberOfTuples(ni*nj);
-
-  vtkNew<vtkDoubleArray> depths;
-  depths->SetName("Depths");
-  depths->SetNumberOfComponents(1);
-  depths->SetNumberOfTuples(ni*nj);
-
-  vtkNew<vtkIntArray> crop;
-  crop->SetName("Crop");
-  crop->SetNumberOfComponents(1);
-  crop->SetNumberOfValues(4);
-  crop->SetValue(0, i0);  crop->SetValue(1, ni);
-  crop->SetValue(2, j0);  crop->SetValue(3, nj);
-
-  vtkIdType pt_id = 0;
-
-  auto dep_im = depth_img->get_image();
-  auto col_im = color_img->get_image();
-
-  for (int y = nj - 1; y >= 0; y--)
-  {
-    for (int x = 0; x < ni; x++)
-    {
-      uniquenessRatios->SetValue(pt_id, 0);
-      bestCost->SetValue(pt_id, 0);
-      depths->SetValue(pt_id, dep_im.at<double>(x, y));
-      color->SetTuple3(pt_id, (int)col_im.at<unsigned char>(x + i0, y + j0, 0),
-                              (int)col_im.at<unsigned char>(x + i0, y + j0, 1),
-                              (int)col_im.at<unsigned char>(x + i0, y + j0, 2));
-      pt_id++;
-    }
-  }
-
-  vtkSmartPointer<vtkImageData> imageData = vtkSmartPointer<vtkImageData>::New();
-  imageData->SetSpacing(1, 1, 1);
-  imageData->SetOrigin(0, 0, 0);
-  imageData->SetDimensions(ni , nj, 1);
-  imageData->GetPointData()->AddArray(depths.Get());
-  imageData->GetPointData()->AddArray(color.Get());
-  imageData->GetPointData()->AddArray(uniquenessRatios.Get());
-  imageData->GetPointData()->AddArray(bestCost.Get());
-  imageData->GetFieldData()->AddArray(crop.Get());
-  return imageData;
-}
-
 //-----------------------------------------------------------------------------
 void ComputeDepthTool::run()
 {
@@ -357,7 +298,7 @@ void ComputeDepthTool::run()
   auto depth = d->depth_algo->compute(frames_out, cameras_out,
                                       height_min, height_max,
                                       ref_frame, d->crop);
-  auto image_data = depth_to_vtk(depth, frames_out[ref_frame], d->crop.min_x(), d->crop.width(),
+  auto image_data = kwiver::maptk::depth_to_vtk(depth, frames_out[ref_frame], d->crop.min_x(), d->crop.width(),
                                  d->crop.min_y(), d->crop.height());
 
   this->updateDepth(image_data);
@@ -371,7 +312,7 @@ ComputeDepthTool::callback_handler(kwiver::vital::image_container_sptr depth,
   QTE_D();
   // make a copy of the tool data
   auto data = std::make_shared<ToolData>();
-  auto depthData = depth_to_vtk(depth, d->ref_img, d->crop.min_x(), d->crop.width(),
+  auto depthData = kwiver::maptk::depth_to_vtk(depth, d->ref_img, d->crop.min_x(), d->crop.width(),
                                 d->crop.min_y(), d->crop.height());
 
   data->copyDepth(depthData);
@@ -44,6 +44,7 @@ public:
   ~ComputeDepthTool() override;
 
   Outputs outputs() const override;
+  Resources reads() const override;
 
   /// Get if the tool can be canceled.
   bool isCancelable() const override { return true; }
@@ -62,8 +63,4 @@ private:
   QTE_DISABLE_COPY(ComputeDepthTool)
 };
 
-vtkSmartPointer<vtkImageData>
-depth_to_vtk(kwiver::vital::image_container_sptr depth_img, kwiver::vital::image_container_sptr color_img,
-             int i0, int ni, int j0, int nj);
-
 #endif
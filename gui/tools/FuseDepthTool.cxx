@@ -31,6 +31,9 @@
 #include "FuseDepthTool.h"
 #include "GuiCommon.h"
 
+#include <maptk/depth_fusion.h>
+#include <maptk/depth_map_io.h>
+
 #include <vital/algo/image_io.h>
 #include <vital/algo/integrate_depth_maps.h>
 #include <vital/algo/video_input.h>
@@ -43,14 +46,11 @@
 
 #include <algorithm>
 
-#include <vtkIntArray.h>
 #include <vtkDoubleArray.h>
 #include <vtkImageData.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkSmartPointer.h>
-#include <vtkUnsignedCharArray.h>
-#include <vtkXMLImageDataReader.h>
 #include <vtkStructuredGrid.h>
 #include <vtkCellData.h>
 #include <vtkCellDataToPointData.h>
@@ -96,6 +96,12 @@ AbstractTool::Outputs FuseDepthTool::outputs() const
   return Fusion;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources FuseDepthTool::reads() const
+{
+  return CameraData | DepthData;
+}
+
 //-----------------------------------------------------------------------------
 bool FuseDepthTool::execute(QWidget* window)
 {
@@ -146,47 +152,8 @@ bool FuseDepthTool::execute(QWidget* window)
 }
 
 //-----------------------------------------------------------------------------
-kwiver::vital::image_container_sptr load_depth_map(const std::string &filename, int &i0, int &ni, int &j0, int &nj)
-{
-  vtkNew<vtkXMLImageDataReader> depthReader;
-  depthReader->SetFileName(filename.c_str());
-  depthReader->Update();
-  vtkImageData *img = depthReader->GetOutput();
-
-  vtkIntArray* crop = static_cast<vtkIntArray*>(img->GetFieldData()->GetArray("Crop"));
-  if (crop)
-  {
-    i0 = crop->GetValue(0);    ni = crop->GetValue(1);
-    j0 = crop->GetValue(2);    nj = crop->GetValue(3);
-  }
-  else
-  {
-    i0 = j0 = 0;
-    ni = img->GetDimensions()[0];    nj = img->GetDimensions()[1];
-  }
-
-  vtkDoubleArray *depths = dynamic_cast<vtkDoubleArray *>(img->GetPointData()->GetArray("Depths"));
-
-  int dims[3];
-  img->GetDimensions(dims);
-
-  kwiver::vital::image depth(dims[0], dims[1], dims[2], false,
-                             kwiver::vital::image_pixel_traits(kwiver::vital::image_pixel_traits::FLOAT, 8));
-
-  vtkIdType pt_id = 0;
-  for (int x = 0; x < dims[0]; x++)
-  {
-    for (int y = 0; y < dims[1]; y++)
-    {
-      depth.at<double>(x, y) = depths->GetValue(pt_id);
-      pt_id++;
-    }
-  }
-
-  return std::shared_ptr<kwiver::vital::image_container>(new kwiver::vital::simple_image_container(depth));
-}
-
-//-----------------------------------------------------------------------------
+// Voxel (i, j, k) of the volume is the cell spanning origin + [i, i+1] *
+// spacing along each axis, with its value at the cell center
 vtkSmartPointer<vtkStructuredGrid>
 volume_to_vtk(kwiver::vital::image_container_sptr volume, kwiver::vital::vector_3d const& origin, kwiver::vital::vector_3d const& spacing)
 {
@@ -230,26 +197,6 @@ volume_to_vtk(kwiver::vital::image_container_sptr volume, kwiver::vital::vector_
   return vtkSmartPointer<vtkStructuredGrid>(output);
 }
 
-//-----------------------------------------------------------------------------
-
-kwiver::vital::camera_perspective_sptr crop_camera(const kwiver::vital::camera_perspective_sptr& cam,
-                                                  int i0, int ni, int j0, int nj)
-{
-  kwiver::vital::simple_camera_intrinsics newIntrinsics(*cam->intrinsics());
-  kwiver::vital::vector_2d pp = newIntrinsics.principal_point();
-
-  pp[0] -= i0;
-  pp[1] -= j0;
-
-  newIntrinsics.set_principal_point(pp);
-
-  kwiver::vital::simple_camera_perspective cropCam(cam->center(),
-                                                   cam->rotation(),
-                                                   newIntrinsics);
-
-  return std::dynamic_pointer_cast<kwiver::vital::camera_perspective>(cropCam.clone());
-}
-
 //-----------------------------------------------------------------------------
 void FuseDepthTool::run()
 {
@@ -268,10 +215,13 @@ void FuseDepthTool::run()
     if (camitr == cameras.end())
       continue;
     kwiver::vital::camera_perspective_sptr cam = std::dynamic_pointer_cast<kwiver::vital::camera_perspective>(camitr->second);
-    int i0, ni, j0, nj;
-    kwiver::vital::image_container_sptr depth = load_depth_map(itr->second, i0, ni, j0, nj);
+    int i0, j0;
+    kwiver::vital::image_container_sptr depth =
+      kwiver::maptk::load_depth_map(itr->second, i0, j0);
+    if (!cam || !depth)
+      continue;
     depths_out.push_back(depth);
-    cameras_out.push_back(crop_camera(cam, i0, ni, j0, nj));
+    cameras_out.push_back(kwiver::maptk::crop_camera(*cam, i0, j0));
   }
 
   double minptd[3];
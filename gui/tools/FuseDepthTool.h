@@ -44,6 +44,7 @@ public:
   virtual ~FuseDepthTool();
 
   virtual Outputs outputs() const QTE_OVERRIDE;
+  virtual Resources reads() const QTE_OVERRIDE;
 
   /// Get if the tool can be canceled.
   virtual bool isCancelable() const QTE_OVERRIDE { return true; }
@@ -35,6 +35,9 @@
 
 #include <QMessageBox>
 
+#include <algorithm>
+#include <vector>
+
 using kwiver::vital::algo::initialize_cameras_landmarks;
 using kwiver::vital::algo::initialize_cameras_landmarks_sptr;
 
@@ -42,6 +45,27 @@ namespace
 {
 static char const* const BLOCK = "initializer";
 static char const* const CONFIG_FILE = "gui_initialize.conf";
+
+//-----------------------------------------------------------------------------
+// Add null entries to a map for requested IDs that have no entry.
+//
+// The IDs must be sorted. They are merged with the map in a single pass, so
+// each insertion is placed using a hint rather than searching the map.
+// Existing entries are kept.
+template <typename Map, typename Ids>
+void addPlaceholders(Map& map, Ids const& ids)
+{
+  auto hint = map.begin();
+  for (auto const id : ids)
+  {
+    while (hint != map.end() && hint->first < id)
+    {
+      ++hint;
+    }
+    hint = map.emplace_hint(hint, id, nullptr);
+    ++hint;
+  }
+}
 }
 
 //-----------------------------------------------------------------------------
@@ -73,6 +97,12 @@ AbstractTool::Outputs InitCamerasLandmarksTool::outputs() const
   return Cameras | Landmarks | TrackChanges | Tracks;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources InitCamerasLandmarksTool::reads() const
+{
+  return TrackData | CameraData | LandmarkData;
+}
+
 //-----------------------------------------------------------------------------
 bool InitCamerasLandmarksTool::execute(QWidget* window)
 {
@@ -135,44 +165,43 @@ void InitCamerasLandmarksTool::run()
   auto tp = this->tracks();
   auto sp = this->sfmConstraints();
 
-  // If cp is Null the initialize algorithm will create all cameras.
-  // If not Null it will only create cameras if they are in the map but Null.
-  // So we need to add placeholders for missing cameras to the map
-  if (cp)
+  // The initialize algorithm creates the cameras and landmarks whose map
+  // entries are null, or all of them if the map itself is null. When there
+  // are none yet, pass null maps rather than building maps full of null
+  // entries; otherwise add placeholders only for the missing IDs.
+  if (cp && cp->size() == 0)
   {
-    using kwiver::vital::frame_id_t;
-    using kwiver::vital::camera_map;
-    std::set<frame_id_t> frame_ids = tp->all_frame_ids();
-    camera_map::map_camera_t all_cams = cp->cameras();
-
-    for (auto const& id : frame_ids)
-    {
-      if (all_cams.find(id) == all_cams.end())
-      {
-        all_cams[id] = kwiver::vital::camera_sptr();
-      }
-    }
-    cp = std::make_shared<kwiver::vital::simple_camera_map>(all_cams);
+    cp = nullptr;
   }
-
-  // If lp is Null the initialize algorithm will create all landmarks.
-  // If not Null it will only create landmarks if they are in the map but Null.
-  // So we need to add placeholders for missing landmarks to the map
-  if (lp)
+  else if (cp)
   {
-    using kwiver::vital::track_id_t;
-    using kwiver::vital::landmark_map;
-    std::set<track_id_t> track_ids = tp->all_track_ids();
-    landmark_map::map_landmark_t all_lms = lp->landmarks();
+    auto all_cams = cp->cameras();
+    addPlaceholders(all_cams, tp->all_frame_ids());
+    cp = std::make_shared<kwiver::vital::simple_camera_map>(
+      std::move(all_cams));
+  }
 
-    for (auto const& id : track_ids)
+  if (lp && lp->size() == 0)
+  {
+    lp = nullptr;
+  }
+  else if (lp)
+  {
+    // Collect the track IDs in a vector; a set of every ID would cost a node
+    // allocation per track
+    auto const& tracks = tp->tracks();
+    std::vector<kwiver::vital::track_id_t> track_ids;
+    track_ids.reserve(tracks.size());
+    for (auto const& t : tracks)
     {
-      if (all_lms.find(id) == all_lms.end())
-      {
-        all_lms[id] = kwiver::vital::landmark_sptr();
-      }
+      track_ids.push_back(t->id());
     }
-    lp = std::make_shared<kwiver::vital::simple_landmark_map>(all_lms);
+    std::sort(track_ids.begin(), track_ids.end());
+
+    auto all_lms = lp->landmarks();
+    addPlaceholders(all_lms, track_ids);
+    lp = std::make_shared<kwiver::vital::simple_landmark_map>(
+      std::move(all_lms));
   }
 
   d->algorithm->initialize(cp, lp, tp, sp);
@@ -44,6 +44,7 @@ public:
   ~InitCamerasLandmarksTool() override;
 
   Outputs outputs() const override;
+  Resources reads() const override;
 
   /// Get if the tool can be canceled.
   bool isCancelable() const override { return true; }
@@ -30,6 +30,8 @@
 
 #include "MeshColoration.h"
 
+#include <maptk/projection_kernels.h>
+
 #include <kwiversys/SystemTools.hxx>
 
 // VTK includes
@@ -56,6 +58,10 @@ static char const* const BLOCK_VR = "video_reader";
 namespace
 {
 
+//----------------------------------------------------------------------------
+/// Number of mesh points projected into the cameras at a time
+vtkIdType const ProjectionBlockSize = 1024;
+
 //----------------------------------------------------------------------------
 /// Compute median of a vector
 template <typename T>
@@ -177,44 +183,67 @@ bool MeshColoration::ProcessColoration(int frame)
   std::vector<double> list1;
   std::vector<double> list2;
 
+  // Points are projected a block at a time, so that the projection kernel
+  // of each camera is chosen once per block instead of once per point
+  std::vector<kwiver::vital::vector_3d> blockPoints;
+  std::vector<kwiver::vital::vector_2d> blockPixels(
+    numFrames * ProjectionBlockSize);
+  std::vector<unsigned char> blockVisible(numFrames * ProjectionBlockSize);
+  auto projectBlock = [&](vtkIdType first)
+  {
+    auto const last = std::min(first + ProjectionBlockSize, nbMeshPoint);
+    blockPoints.resize(static_cast<size_t>(last - first));
+    for (vtkIdType id = first; id < last; ++id)
+    {
+      meshPointList->GetPoint(id, blockPoints[id - first].data());
+    }
+    for (int idData = 0; idData < numFrames; idData++)
+    {
+      auto const& colorImage = this->DataList[idData].first;
+      auto const offset = idData * ProjectionBlockSize;
+      kwiver::maptk::cull_points(
+        *this->DataList[idData].second, blockPoints.data(),
+        blockPoints.size(), colorImage.width(), colorImage.height(), 0.0,
+        blockPixels.data() + offset, blockVisible.data() + offset);
+    }
+  };
+
   for (vtkIdType id = 0; id < nbMeshPoint; id++)
   {
+    auto const blockIndex = id % ProjectionBlockSize;
+    if (blockIndex == 0)
+    {
+      projectBlock(id);
+    }
+
     list0.reserve(numFrames);
     list1.reserve(numFrames);
     list2.reserve(numFrames);
 
     // Get mesh position from id
-    kwiver::vital::vector_3d position;
-    meshPointList->GetPoint(id, position.data());
+    kwiver::vital::vector_3d const& position = blockPoints[blockIndex];
     kwiver::vital::vector_3d pointNormal;
     OutputMesh->GetPointData()->GetArray("Normals")->GetTuple(id, pointNormal.data());
 
     for (int idData = 0; idData < numFrames; idData++)
     {
-      kwiver::vital::camera_perspective_sptr camera = this->DataList[idData].second;
-      // Check if the 3D point is in front of the camera
-      if (camera->depth(position) <= 0.0)
+      // Check if the 3D point is in front of the camera and in its image
+      auto const k = idData * ProjectionBlockSize + blockIndex;
+      if (!blockVisible[k])
       {
         continue;
       }
 
       // test that we are viewing the front side of the mesh
+      kwiver::vital::camera_perspective_sptr camera = this->DataList[idData].second;
       kwiver::vital::vector_3d cameraPointVec = position - camera->center();
       if (cameraPointVec.dot(pointNormal)>0.0)
       {
         continue;
       }
 
-      // project 3D point to pixel coordinates
-      auto pixelPosition = camera->project(position);
+      auto const& pixelPosition = blockPixels[k];
       kwiver::vital::image_of<uint8_t> const& colorImage = this->DataList[idData].first;
-      if (pixelPosition[0] < 0.0 ||
-          pixelPosition[1] < 0.0 ||
-          pixelPosition[0] >= colorImage.width() ||
-          pixelPosition[1] >= colorImage.height())
-      {
-        continue;
-      }
       try
       {
         unsigned i = static_cast<unsigned>(pixelPosition[0]);
@@ -59,6 +59,12 @@ AbstractTool::Outputs NeckerReversalTool::outputs() const
   return Cameras | Landmarks;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources NeckerReversalTool::reads() const
+{
+  return CameraData | LandmarkData;
+}
+
 //-----------------------------------------------------------------------------
 bool NeckerReversalTool::execute(QWidget* window)
 {
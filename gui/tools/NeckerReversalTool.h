@@ -42,6 +42,7 @@ public:
   ~NeckerReversalTool() override;
 
   Outputs outputs() const override;
+  Resources reads() const override;
 
   /// Get if the tool can be canceled.
   bool isCancelable() const override { return false; }
@@ -0,0 +1,140 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ReprojectionFilterTool.h"
+#include "GuiCommon.h"
+
+#include <maptk/reprojection_filter.h>
+
+#include <QMessageBox>
+
+namespace
+{
+static char const* const BLOCK = "reprojection_filter";
+}
+
+//-----------------------------------------------------------------------------
+class ReprojectionFilterToolPrivate
+{
+public:
+  double maxError = 4.0;
+  unsigned minTrackLength = 2;
+  unsigned numThreads = 0;
+};
+
+QTE_IMPLEMENT_D_FUNC(ReprojectionFilterTool)
+
+//-----------------------------------------------------------------------------
+ReprojectionFilterTool::ReprojectionFilterTool(QObject* parent)
+  : AbstractTool(parent), d_ptr(new ReprojectionFilterToolPrivate)
+{
+  this->setText("Filter &Reprojection Outliers");
+  this->setToolTip(
+    "<nobr>Remove feature track points that are far from the projection of "
+    "</nobr>their landmark, and tracks left too short");
+}
+
+//-----------------------------------------------------------------------------
+ReprojectionFilterTool::~ReprojectionFilterTool()
+{
+}
+
+//-----------------------------------------------------------------------------
+AbstractTool::Outputs ReprojectionFilterTool::outputs() const
+{
+  return Tracks;
+}
+
+//-----------------------------------------------------------------------------
+AbstractTool::Resources ReprojectionFilterTool::reads() const
+{
+  return TrackData | CameraData | LandmarkData;
+}
+
+//-----------------------------------------------------------------------------
+bool ReprojectionFilterTool::execute(QWidget* window)
+{
+  QTE_D();
+
+  if (!this->hasTracks() || !this->hasCameras() || !this->hasLandmarks())
+  {
+    QMessageBox::information(
+      window, "Insufficient data",
+      "This operation requires feature tracks, cameras and landmarks.");
+    return false;
+  }
+
+  // Merge project config with default config file
+  auto const config = readConfig("gui_filter_reprojection.conf");
+
+  // Check configuration
+  if (!config)
+  {
+    QMessageBox::critical(
+      window, "Configuration error",
+      "No configuration data was found. Please check your installation.");
+    return false;
+  }
+
+  config->merge_config(this->data()->config);
+  d->maxError = config->get_value<double>(
+    std::string{BLOCK} + ":max_error", 4.0);
+  d->minTrackLength = config->get_value<unsigned>(
+    std::string{BLOCK} + ":min_track_length", 2);
+  d->numThreads = config->get_value<unsigned>(
+    std::string{BLOCK} + ":num_threads", 0);
+  if (d->maxError <= 0.0)
+  {
+    QMessageBox::critical(
+      window, "Configuration error",
+      "The maximum reprojection error must be positive.");
+    return false;
+  }
+
+  return AbstractTool::execute(window);
+}
+
+//-----------------------------------------------------------------------------
+void ReprojectionFilterTool::run()
+{
+  QTE_D();
+
+  kwiver::maptk::reprojection_filter_stats stats;
+  auto const ftp = kwiver::maptk::filter_tracks_by_reprojection_error(
+    this->tracks(), this->cameras(), this->landmarks(),
+    d->maxError, d->minTrackLength, d->numThreads, &stats);
+
+  this->setDescription(
+    QString("Removed %1 of %2 track points (%3 tracks removed)")
+    .arg(stats.states_removed).arg(stats.states_checked)
+    .arg(stats.tracks_removed));
+
+  this->updateTracks(ftp);
+}
@@ -87,6 +87,12 @@ AbstractTool::Outputs SaveFrameTool::outputs() const
   return KeyFrames;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources SaveFrameTool::reads() const
+{
+  return {};
+}
+
 //-----------------------------------------------------------------------------
 bool SaveFrameTool::execute(QWidget* window)
 {
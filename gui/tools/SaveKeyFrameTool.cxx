@@ -87,6 +87,12 @@ AbstractTool::Outputs SaveKeyFrameTool::outputs() const
   return KeyFrames;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources SaveKeyFrameTool::reads() const
+{
+  return TrackData;
+}
+
 //-----------------------------------------------------------------------------
 bool SaveKeyFrameTool::execute(QWidget* window)
 {
@@ -101,6 +101,12 @@ AbstractTool::Outputs TrackFeaturesSprokitTool::outputs() const
   return Tracks | ActiveFrame;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources TrackFeaturesSprokitTool::reads() const
+{
+  return {};
+}
+
 //-----------------------------------------------------------------------------
 bool TrackFeaturesSprokitTool::execute(QWidget* window)
 {
@@ -113,6 +113,12 @@ AbstractTool::Outputs TrackFeaturesTool::outputs() const
   return Tracks | ActiveFrame;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources TrackFeaturesTool::reads() const
+{
+  return TrackData;
+}
+
 //-----------------------------------------------------------------------------
 bool TrackFeaturesTool::execute(QWidget* window)
 {
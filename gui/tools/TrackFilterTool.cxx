@@ -73,6 +73,12 @@ AbstractTool::Outputs TrackFilterTool::outputs() const
   return Tracks;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources TrackFilterTool::reads() const
+{
+  return TrackData;
+}
+
 //-----------------------------------------------------------------------------
 bool TrackFilterTool::execute(QWidget* window)
 {
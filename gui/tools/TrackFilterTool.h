@@ -44,6 +44,7 @@ public:
   ~TrackFilterTool() override;
 
   Outputs outputs() const override;
+  Resources reads() const override;
 
   /// Get if the tool can be canceled.
   bool isCancelable() const override { return false; }
@@ -76,6 +76,12 @@ AbstractTool::Outputs TriangulateTool::outputs() const
   return Landmarks | Tracks;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::Resources TriangulateTool::reads() const
+{
+  return TrackData | CameraData;
+}
+
 //-----------------------------------------------------------------------------
 bool TriangulateTool::execute(QWidget* window)
 {
@@ -30,6 +30,8 @@
 
 #include "vtkMaptkCamera.h"
 
+#include <maptk/projection_kernels.h>
+
 #include <vital/io/camera_io.h>
 #include <vital/types/vector.h>
 
@@ -99,11 +101,26 @@ void vtkMaptkCamera::SetCamera(kwiver::vital::camera_perspective_sptr const& cam
   this->MaptkCamera = camera;
 }
 
+//-----------------------------------------------------------------------------
+bool vtkMaptkCamera::IsNearImage(kwiver::vital::vector_2d const& ppos) const
+{
+  // Ignore points that are very far from the image.
+  // Including points that are too far away can degrade the precision
+  // of location of points in the image.
+  double const w_max = 10.0 * this->ImageDimensions[0];
+  double const h_max = 10.0 * this->ImageDimensions[1];
+  return ppos[0] >= -w_max && ppos[0] <= w_max &&
+         ppos[1] >= -h_max && ppos[1] <= h_max;
+}
+
 //-----------------------------------------------------------------------------
 bool vtkMaptkCamera::ProjectPoint(kwiver::vital::vector_3d const& in,
                                   double (&out)[2])
 {
-  if (this->MaptkCamera->depth(in) < 0.0)
+  kwiver::vital::vector_2d ppos;
+  double depth;
+  kwiver::maptk::project_points(*this->MaptkCamera, &in, 1, &ppos, &depth);
+  if (depth < 0.0)
   {
     // if the projection is invalid, move the point to infinity
     // so that it doesn't render in the camera view
@@ -112,14 +129,7 @@ bool vtkMaptkCamera::ProjectPoint(kwiver::vital::vector_3d const& in,
     return false;
   }
 
-  auto const& ppos = this->MaptkCamera->project(in);
-  // Ignore points that are very far from the image.
-  // Including points that are too far away can degrade the precision
-  // of location of points in the image.
-  int const& w_max = 10 * this->ImageDimensions[0];
-  int const& h_max = 10 * this->ImageDimensions[1];
-  if (ppos[0] < -w_max || ppos[0] > w_max ||
-    ppos[1] < -h_max || ppos[1] > h_max)
+  if (!this->IsNearImage(ppos))
   {
     return false;
   }
@@ -128,6 +138,7 @@ bool vtkMaptkCamera::ProjectPoint(kwiver::vital::vector_3d const& in,
   out[1] = ppos[1];
   return true;
 }
+
 /**
   *
   * WARNING: The convention here is that depth is NOT the distance between the
@@ -135,6 +146,30 @@ bool vtkMaptkCamera::ProjectPoint(kwiver::vital::vector_3d const& in,
   * the 3D point on the optical axis and the optical center.
 */
 
+//-----------------------------------------------------------------------------
+size_t vtkMaptkCamera::ProjectPoints(
+  std::vector<kwiver::vital::vector_3d> const& points,
+  std::vector<kwiver::vital::vector_2d>& projPoints,
+  std::vector<unsigned char>& valid)
+{
+  projPoints.resize(points.size());
+  valid.resize(points.size());
+
+  std::vector<double> depths(points.size());
+  kwiver::maptk::project_points(*this->MaptkCamera, points.data(),
+                                points.size(), projPoints.data(),
+                                depths.data());
+
+  // Apply the same tests as ProjectPoint
+  size_t numValid = 0;
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    valid[i] = depths[i] >= 0.0 && this->IsNearImage(projPoints[i]);
+    numValid += valid[i];
+  }
+  return numValid;
+}
+
 //-----------------------------------------------------------------------------
 kwiver::vital::vector_3d vtkMaptkCamera::UnprojectPoint(
   double pixel[2], double depth)
@@ -144,7 +179,7 @@ kwiver::vital::vector_3d vtkMaptkCamera::UnprojectPoint(
   auto const R = this->MaptkCamera->rotation().matrix();
 
   auto const inPoint = kwiver::vital::vector_2d{pixel[0], pixel[1]};
-  auto const normPoint = this->MaptkCamera->intrinsics()->unmap(inPoint);
+  auto const normPoint = this->GetDistortion().unmap(inPoint);
 
   auto const homogenousPoint = kwiver::vital::vector_3d{normPoint[0] * depth,
                                                         normPoint[1] * depth,
@@ -301,6 +336,20 @@ void vtkMaptkCamera::DeepCopy(vtkMaptkCamera* source)
   this->MaptkCamera = source->MaptkCamera;
 }
 
+//-----------------------------------------------------------------------------
+kwiver::maptk::distortion_map const& vtkMaptkCamera::GetDistortion()
+{
+  // The grids are shared by all cameras with the same intrinsics, so only
+  // look them up again when the intrinsics change
+  auto const& intrinsics = this->MaptkCamera->intrinsics();
+  if (!this->Distortion || intrinsics != this->DistortionIntrinsics)
+  {
+    this->Distortion = kwiver::maptk::distortion_map::shared(*intrinsics);
+    this->DistortionIntrinsics = intrinsics;
+  }
+  return *this->Distortion;
+}
+
 //-----------------------------------------------------------------------------
 void vtkMaptkCamera::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -31,11 +31,15 @@
 #ifndef TELESCULPTOR_VTKMAPTKCAMERA_H_
 #define TELESCULPTOR_VTKMAPTKCAMERA_H_
 
+#include <maptk/distortion_map.h>
+
 #include <vital/types/camera_perspective.h>
 
 #include <vtkCamera.h>
 #include <vtkSmartPointer.h>
 
+#include <vector>
+
 class vtkMaptkCamera : public vtkCamera
 {
 public:
@@ -50,10 +54,18 @@ public:
   void SetCamera(kwiver::vital::camera_perspective_sptr const& camera);
 
   // Description:
-  // Project 3D point to 2D using the internal maptk camera
+  // Project 3D point to 2D using the internal maptk camera; points behind
+  // the camera or more than ten image sizes from the image are rejected
   bool ProjectPoint(kwiver::vital::vector_3d const& point,
                     double (&projPoint)[2]);
 
+  // Description:
+  // Project a block of 3D points to 2D using the internal maptk camera;
+  // valid is set to nonzero for the points that ProjectPoint would accept
+  size_t ProjectPoints(std::vector<kwiver::vital::vector_3d> const& points,
+                       std::vector<kwiver::vital::vector_2d>& projPoints,
+                       std::vector<unsigned char>& valid);
+
   // Description:
   // Reverse project 2D point to 3D using the internal maptk camera and
   // specified depth
@@ -102,14 +114,24 @@ protected:
 
   using vtkCamera::GetFrustumPlanes; // Hide overloaded virtual
 
+  // Description:
+  // Get the distortion lookup grids of the current camera intrinsics
+  kwiver::maptk::distortion_map const& GetDistortion();
+
 private:
   vtkMaptkCamera(vtkMaptkCamera const&) = delete;
   void operator=(vtkMaptkCamera const&) = delete;
 
+  // Description:
+  // Test if a projected point is near enough to the image to be used
+  bool IsNearImage(kwiver::vital::vector_2d const& projPoint) const;
+
   int ImageDimensions[2];
   double AspectRatio;
 
   kwiver::vital::camera_perspective_sptr MaptkCamera;
+  kwiver::vital::camera_intrinsics_sptr DistortionIntrinsics;
+  kwiver::maptk::distortion_map_sptr Distortion;
 };
 
 #endif
@@ -31,6 +31,8 @@
 
 #include "vtkMaptkCamera.h"
 
+#include <maptk/projection_kernels.h>
+
 #include <vtkDoubleArray.h>
 #include <vtkFloatArray.h>
 #include <vtkImageData.h>
@@ -135,18 +137,30 @@ void vtkMaptkImageUnprojectDepth::SimpleExecute(vtkImageData* input,
   output->GetPointData()->AddArray(points);
   points->FastDelete();
 
-  // loop over each point / depth in the image, computing the unprojected point
+  // unproject the image a row at a time, so that the projection kernel of
+  // the camera is chosen once per row instead of once per pixel
+  auto const& camera = *scaledCamera->GetCamera();
+  auto const rowSize = static_cast<size_t>(extents[1] - extents[0] + 1);
+  std::vector<kwiver::vital::vector_2d> pixels(rowSize);
+  std::vector<kwiver::vital::vector_3d> rowPoints(rowSize);
+
   double* depthPtr = depths->GetPointer(0);
   float* pointsPtr = points->GetPointer(0);
-  double pixel[2];
   for (int row = extents[2]; row <= extents[3]; ++row)
   {
-    pixel[1] = height - 1 - (origin[1] + row * spacing[1]);
-    for (int column = extents[0]; column <= extents[1]; ++column, ++depthPtr)
+    double const y = height - 1 - (origin[1] + row * spacing[1]);
+    for (int column = extents[0]; column <= extents[1]; ++column)
     {
-      pixel[0] = origin[0] + column * spacing[0];
+      pixels[column - extents[0]] =
+        kwiver::vital::vector_2d(origin[0] + column * spacing[0], y);
+    }
 
-      auto const p = scaledCamera->UnprojectPoint(pixel, *depthPtr);
+    kwiver::maptk::unproject_points(camera, pixels.data(), depthPtr,
+                                    rowSize, rowPoints.data());
+    depthPtr += rowSize;
+
+    for (auto const& p : rowPoints)
+    {
       *pointsPtr = p[0];
       *(++pointsPtr) = p[1];
       *(++pointsPtr) = p[2];
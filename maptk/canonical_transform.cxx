@@ -0,0 +1,347 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of canonical transform estimation and in-place
+ *        transforms
+ */
+
+#include "canonical_transform.h"
+#include "parallel_for.h"
+
+#include <vital/exceptions.h>
+#include <vital/types/camera_perspective.h>
+#include <vital/types/landmark.h>
+
+#include <Eigen/Eigenvalues>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+/// Transform a covariance by a similarity transform
+vital::covariance_3d
+transform_covariance(vital::covariance_3d const& covar,
+                     vital::similarity_d const& xform)
+{
+  vital::matrix_3x3d const R = xform.rotation().matrix();
+  double const s2 = xform.scale() * xform.scale();
+  return vital::covariance_3d(
+    vital::matrix_3x3d(s2 * R * covar.matrix() * R.transpose()));
+}
+
+
+/// Transform a landmark in place
+template <typename T>
+void
+transform_landmark(vital::landmark_<T>& lm, vital::similarity_d const& xform)
+{
+  typedef Eigen::Matrix<T, 3, 1> vector_t;
+  typedef Eigen::Matrix<T, 3, 3> matrix_t;
+
+  lm.set_loc(vector_t((xform * lm.loc()).template cast<T>()));
+  lm.set_scale(static_cast<T>(lm.scale() * xform.scale()));
+  lm.set_normal(vector_t((xform.rotation() * lm.normal()).template cast<T>()));
+  auto const covar = transform_covariance(lm.covar(), xform);
+  lm.set_covar(vital::covariance_<3, T>(
+    matrix_t(covar.matrix().template cast<T>())));
+}
+
+
+/// Transform some landmarks of one type in place, in parallel
+template <typename T>
+void
+transform_landmarks(std::vector<vital::landmark_<T>*> const& landmarks,
+                    vital::similarity_d const& xform, unsigned num_threads)
+{
+  static size_t const block_size = 4096;
+  parallel_for_blocks(landmarks.size(), block_size,
+                      [&](size_t first, size_t last)
+  {
+    for (size_t i = first; i < last; ++i)
+    {
+      transform_landmark(*landmarks[i], xform);
+    }
+  }, num_threads);
+}
+
+} // end anonymous namespace
+
+
+/// Add a point
+void
+point_statistics
+::add(vital::vector_3d const& p)
+{
+  ++n_;
+  vital::vector_3d const delta = p - mean_;
+  mean_ += delta / static_cast<double>(n_);
+  m2_ += delta * (p - mean_).transpose();
+}
+
+
+/// Add the points summarized by another set of statistics
+void
+point_statistics
+::merge(point_statistics const& other)
+{
+  if (other.n_ == 0)
+  {
+    return;
+  }
+  if (n_ == 0)
+  {
+    *this = other;
+    return;
+  }
+
+  double const na = static_cast<double>(n_);
+  double const nb = static_cast<double>(other.n_);
+  double const n = na + nb;
+  vital::vector_3d const delta = other.mean_ - mean_;
+  mean_ += delta * (nb / n);
+  m2_ += other.m2_ + delta * delta.transpose() * (na * nb / n);
+  n_ += other.n_;
+}
+
+
+/// Covariance of the points, normalized by the number of points
+vital::matrix_3x3d
+point_statistics
+::covariance() const
+{
+  if (n_ == 0)
+  {
+    return vital::matrix_3x3d::Zero();
+  }
+  return m2_ / static_cast<double>(n_);
+}
+
+
+/// Compute the statistics of a set of points in parallel
+point_statistics
+compute_point_statistics(std::vector<vital::vector_3d> const& points,
+                         unsigned num_threads)
+{
+  // Each block is summarized separately and the blocks are merged in order,
+  // so the result does not depend on the number of threads
+  static size_t const block_size = 65536;
+  std::vector<point_statistics> blocks(
+    (points.size() + block_size - 1) / block_size);
+  parallel_for_blocks(points.size(), block_size,
+                      [&](size_t first, size_t last)
+  {
+    auto& stats = blocks[first / block_size];
+    for (size_t i = first; i < last; ++i)
+    {
+      stats.add(points[i]);
+    }
+  }, num_threads);
+
+  point_statistics result;
+  for (auto const& stats : blocks)
+  {
+    result.merge(stats);
+  }
+  return result;
+}
+
+
+/// Estimate a canonical transform of the landmarks
+vital::similarity_d
+estimate_canonical_transform(vital::camera_map_sptr const& cameras,
+                             vital::landmark_map_sptr const& landmarks,
+                             bool estimate_scale,
+                             double height_percentile,
+                             unsigned num_threads)
+{
+  std::vector<vital::vector_3d> points;
+  if (landmarks)
+  {
+    auto const lms = landmarks->landmarks();
+    points.reserve(lms.size());
+    for (auto const& p : lms)
+    {
+      if (p.second)
+      {
+        points.push_back(p.second->loc());
+      }
+    }
+  }
+  if (points.size() < 3)
+  {
+    throw vital::invalid_value("At least three landmarks are required to "
+                               "estimate a canonical transform");
+  }
+
+  auto const stats = compute_point_statistics(points, num_threads);
+  vital::vector_3d const& center = stats.mean();
+  vital::matrix_3x3d const covar = stats.covariance();
+
+  // The eigenvalues are in increasing order, so the first eigenvector is the
+  // normal of the best fit plane
+  Eigen::SelfAdjointEigenSolver<vital::matrix_3x3d> eig(covar);
+  vital::vector_3d const x_axis = eig.eigenvectors().col(2);
+  vital::vector_3d z_axis = eig.eigenvectors().col(0);
+
+  // Point the normal toward the cameras
+  if (cameras)
+  {
+    vital::vector_3d cam_center = vital::vector_3d::Zero();
+    size_t num_cams = 0;
+    for (auto const& p : cameras->cameras())
+    {
+      auto const cam =
+        std::dynamic_pointer_cast<vital::camera_perspective>(p.second);
+      if (cam)
+      {
+        cam_center += cam->center();
+        ++num_cams;
+      }
+    }
+    if (num_cams > 0 &&
+        (cam_center / static_cast<double>(num_cams) - center).dot(z_axis) < 0.0)
+    {
+      z_axis = -z_axis;
+    }
+  }
+
+  vital::matrix_3x3d R;
+  R.row(0) = x_axis.transpose();
+  R.row(1) = z_axis.cross(x_axis).transpose();
+  R.row(2) = z_axis.transpose();
+
+  double scale = 1.0;
+  if (estimate_scale && covar.trace() > 0.0)
+  {
+    scale = 1.0 / std::sqrt(covar.trace());
+  }
+  vital::vector_3d translation = -scale * (R * center);
+
+  // Move the ground plane down to the requested fraction of the landmarks
+  if (height_percentile >= 0.0 && height_percentile < 1.0)
+  {
+    std::vector<double> heights(points.size());
+    static size_t const block_size = 65536;
+    parallel_for_blocks(points.size(), block_size,
+                        [&](size_t first, size_t last)
+    {
+      for (size_t i = first; i < last; ++i)
+      {
+        heights[i] = scale * z_axis.dot(points[i] - center);
+      }
+    }, num_threads);
+    auto const nth = heights.begin() + static_cast<ptrdiff_t>(
+      height_percentile * static_cast<double>(heights.size() - 1));
+    std::nth_element(heights.begin(), nth, heights.end());
+    translation.z() -= *nth;
+  }
+
+  return vital::similarity_d(scale, vital::rotation_d(R), translation);
+}
+
+
+/// Apply a similarity transform to cameras in place
+void
+transform_inplace(vital::camera_map const& cameras,
+                  vital::similarity_d const& xform)
+{
+  // Check every camera first so that a failure leaves them all unchanged
+  std::vector<vital::simple_camera_perspective*> cams;
+  for (auto const& p : cameras.cameras())
+  {
+    if (!p.second)
+    {
+      continue;
+    }
+    auto const cam =
+      dynamic_cast<vital::simple_camera_perspective*>(p.second.get());
+    if (!cam)
+    {
+      throw vital::invalid_value("Only simple perspective cameras can be "
+                                 "transformed in place");
+    }
+    cams.push_back(cam);
+  }
+
+  vital::rotation_d const R_inv = xform.rotation().inverse();
+  for (auto const cam : cams)
+  {
+    cam->set_center(xform * cam->center());
+    cam->set_rotation(cam->rotation() * R_inv);
+    cam->set_center_covar(transform_covariance(cam->center_covar(), xform));
+  }
+}
+
+
+/// Apply a similarity transform to landmarks in place
+void
+transform_inplace(vital::landmark_map const& landmarks,
+                  vital::similarity_d const& xform,
+                  unsigned num_threads)
+{
+  // Check every landmark first so that a failure leaves them all unchanged
+  std::vector<vital::landmark_d*> lms_d;
+  std::vector<vital::landmark_f*> lms_f;
+  auto const lms = landmarks.landmarks();
+  lms_d.reserve(lms.size());
+  for (auto const& p : lms)
+  {
+    if (!p.second)
+    {
+      continue;
+    }
+    if (auto const lm = dynamic_cast<vital::landmark_d*>(p.second.get()))
+    {
+      lms_d.push_back(lm);
+    }
+    else if (auto const lm = dynamic_cast<vital::landmark_f*>(p.second.get()))
+    {
+      lms_f.push_back(lm);
+    }
+    else
+    {
+      throw vital::invalid_value("Only double and float landmarks can be "
+                                 "transformed in place");
+    }
+  }
+
+  transform_landmarks(lms_d, xform, num_threads);
+  transform_landmarks(lms_f, xform, num_threads);
+}
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,158 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for canonical transform estimation and in-place transforms
+ */
+
+#ifndef MAPTK_CANONICAL_TRANSFORM_H_
+#define MAPTK_CANONICAL_TRANSFORM_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/camera_map.h>
+#include <vital/types/landmark_map.h>
+#include <vital/types/matrix.h>
+#include <vital/types/similarity.h>
+#include <vital/types/vector.h>
+
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Running mean and covariance of a set of 3D points
+/**
+ * Points are added one at a time with Welford's update, and partial
+ * statistics of disjoint subsets can be merged, so a large point set can be
+ * summarized in one pass split across threads.
+ */
+class MAPTK_EXPORT point_statistics
+{
+public:
+  /// Add a point
+  void add(vital::vector_3d const& p);
+
+  /// Add the points summarized by another set of statistics
+  void merge(point_statistics const& other);
+
+  /// Number of points added
+  size_t count() const { return n_; }
+
+  /// Mean of the points
+  vital::vector_3d const& mean() const { return mean_; }
+
+  /// Covariance of the points, normalized by the number of points
+  vital::matrix_3x3d covariance() const;
+
+private:
+  size_t n_ = 0;
+  vital::vector_3d mean_ = vital::vector_3d::Zero();
+  vital::matrix_3x3d m2_ = vital::matrix_3x3d::Zero();
+};
+
+
+/// Compute the statistics of a set of points in parallel
+/**
+ * \param [in] points       The points to summarize.
+ * \param [in] num_threads  Number of threads to use, or 0 for one per core.
+ */
+MAPTK_EXPORT
+point_statistics
+compute_point_statistics(std::vector<vital::vector_3d> const& points,
+                         unsigned num_threads = 0);
+
+
+/// Estimate a canonical transform of the landmarks
+/**
+ * The transform moves the landmark centroid to the origin and rotates the
+ * principal axes of the landmarks onto the coordinate axes, with the axis
+ * of least variance along Z and pointing toward the mean camera center.
+ * If \p estimate_scale is set, the landmarks are scaled to unit variance,
+ * i.e. unit mean squared distance from the centroid.
+ *
+ * If \p height_percentile is in [0, 1), the transform is then shifted along
+ * Z so that this fraction of the landmarks is below the ground plane.
+ * Otherwise the mean height of the landmarks is zero.
+ *
+ * \param [in] cameras            Cameras, used to choose the up direction.
+ *                                May be null.
+ * \param [in] landmarks          The landmarks to align.
+ * \param [in] estimate_scale     Whether to normalize the scale.
+ * \param [in] height_percentile  Fraction of landmarks below the ground.
+ * \param [in] num_threads        Number of threads, or 0 for one per core.
+ *
+ * \throws vital::invalid_value if there are too few landmarks
+ */
+MAPTK_EXPORT
+vital::similarity_d
+estimate_canonical_transform(vital::camera_map_sptr const& cameras,
+                             vital::landmark_map_sptr const& landmarks,
+                             bool estimate_scale = true,
+                             double height_percentile = 0.05,
+                             unsigned num_threads = 0);
+
+
+/// Apply a similarity transform to cameras in place
+/**
+ * Unlike arrows::core::transform, this modifies the cameras themselves
+ * rather than transformed copies, so the caller must own them.
+ *
+ * \throws vital::invalid_value if a camera is not a
+ *         vital::simple_camera_perspective
+ */
+MAPTK_EXPORT
+void
+transform_inplace(vital::camera_map const& cameras,
+                  vital::similarity_d const& xform);
+
+
+/// Apply a similarity transform to landmarks in place
+/**
+ * Unlike arrows::core::transform, this modifies the landmarks themselves
+ * rather than transformed copies, so the caller must own them.  The
+ * landmarks are transformed in parallel.
+ *
+ * \throws vital::invalid_value if a landmark is not a vital::landmark_d or
+ *         vital::landmark_f
+ */
+MAPTK_EXPORT
+void
+transform_inplace(vital::landmark_map const& landmarks,
+                  vital::similarity_d const& xform,
+                  unsigned num_threads = 0);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif
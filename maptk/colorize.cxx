@@ -98,32 +98,55 @@ extract_feature_colors(
 }
 
 
+/// Extract feature colors from a frame image
+void
+extract_feature_colors(
+  feature_track_pool& pool,
+  feature_track_frame_index const& index,
+  vital::image_container const& image,
+  vital::frame_id_t frame_id)
+{
+  const vital::image_of<uint8_t> image_data(image.get_image());
+
+  for (auto const& e : index.frame_states(frame_id))
+  {
+    auto& state = pool.state_at(e.state);
+    state.color = image_data.at(static_cast<unsigned>(state.loc[0]),
+                                static_cast<unsigned>(state.loc[1]));
+  }
+}
+
+
 /// Compute colors for landmarks
 vital::landmark_map_sptr compute_landmark_colors(
   vital::landmark_map const& landmarks,
   vital::feature_track_set const& tracks)
+{
+  return compute_landmark_colors(landmarks, feature_track_pool(tracks));
+}
+
+
+/// Compute colors for landmarks
+vital::landmark_map_sptr compute_landmark_colors(
+  vital::landmark_map const& landmarks,
+  feature_track_pool const& tracks)
 {
   auto colored_landmarks = landmarks.landmarks();
   auto const no_such_landmark = colored_landmarks.end();
 
-  for (auto const track : tracks.tracks())
+  for (size_t i = 0; i < tracks.size(); ++i)
   {
-    auto const lmid = static_cast<vital::landmark_id_t>(track->id());
+    auto const track = tracks.track(i);
+    auto const lmid = static_cast<vital::landmark_id_t>(track.id());
     auto lmi = colored_landmarks.find(lmid);
     if (lmi != no_such_landmark)
     {
       int ra = 0, ga = 0, ba = 0, k = 0; // accumulators
-      for (auto const& ts : *track)
+      for (auto const& s : track)
       {
-        auto fts = std::dynamic_pointer_cast<vital::feature_track_state>(ts);
-        if( !fts )
-        {
-          continue;
-        }
-        auto const& color = fts->feature->color();
-        ra += color.r;
-        ga += color.g;
-        ba += color.b;
+        ra += s.color.r;
+        ga += s.color.g;
+        ba += s.color.b;
         ++k;
       }
 
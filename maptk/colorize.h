@@ -37,6 +37,8 @@
 #define MAPTK_COLORIZE_H_
 
 #include <maptk/maptk_export.h>
+#include <maptk/feature_track_frame_index.h>
+#include <maptk/feature_track_pool.h>
 
 #include <vital/types/feature_set.h>
 #include <vital/types/image_container.h>
@@ -79,6 +81,24 @@ vital::feature_track_set_sptr extract_feature_colors(
   vital::image_container const& image,
   vital::frame_id_t frame_id);
 
+/// Extract feature colors from a frame image
+/**
+ * This function sets the color of each state of a track pool on a frame by
+ * sampling the image at its location.  The states are found through a frame
+ * index of the pool, so only the states on the frame are visited.
+ *
+ *  \param [in,out] pool a pool of feature tracks to colorize
+ *  \param [in] index the frame index of \p pool
+ *  \param [in] image the image from which to take colors
+ *  \param [in] frame_id the frame number of the image
+ */
+MAPTK_EXPORT
+void extract_feature_colors(
+  feature_track_pool& pool,
+  feature_track_frame_index const& index,
+  vital::image_container const& image,
+  vital::frame_id_t frame_id);
+
 /// Compute colors for landmarks
 /**
  * This function computes landmark colors by taking the average color of all
@@ -93,6 +113,20 @@ vital::landmark_map_sptr compute_landmark_colors(
   vital::landmark_map const& landmarks,
   vital::feature_track_set const& tracks);
 
+/// Compute colors for landmarks
+/**
+ * This function computes landmark colors by taking the average color of all
+ * states of the track with the same ID as each landmark.
+ *
+ *  \param [in] landmarks a set of landmarks to be colored
+ *  \param [in] tracks feature tracks to be used for computing landmark colors
+ *  \return a set of colored landmarks
+ */
+MAPTK_EXPORT
+vital::landmark_map_sptr compute_landmark_colors(
+  vital::landmark_map const& landmarks,
+  feature_track_pool const& tracks);
+
 } // end namespace maptk
 } // end namespace kwiver
 
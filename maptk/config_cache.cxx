@@ -0,0 +1,204 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of maptk configuration cache functions
+ */
+
+#include "config_cache.h"
+
+#include <vital/config/config_block_io.h>
+#include <vital/logger/logger.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+
+typedef kwiversys::SystemTools ST;
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+/// Modification time and size of a file, both zero if it does not exist
+typedef std::pair<long, unsigned long> file_stamp;
+
+/// A parsed configuration and the files it depends on
+struct cache_entry
+{
+  vital::config_block_sptr config;
+  std::map<std::string, file_stamp> files;
+};
+
+/// Arguments identifying a read, plus the working directory for relative paths
+typedef std::tuple<std::string, std::string, std::string, std::string,
+                   std::string> cache_key;
+
+/// Guards the cache below
+std::mutex cache_mutex;
+/// Configurations read so far
+std::map<cache_key, cache_entry> cache;
+
+
+/// Get the current stamp of a file
+file_stamp
+stamp_file(std::string const& path)
+{
+  if (!ST::FileExists(path, true))
+  {
+    return { 0, 0 };
+  }
+  return { ST::ModifiedTime(path), ST::FileLength(path) };
+}
+
+
+/// Make a deep copy of a configuration
+vital::config_block_sptr
+copy_config(vital::config_block_sptr const& config)
+{
+  auto copy = vital::config_block::empty_config(config->get_name());
+  copy->merge_config(config);
+  return copy;
+}
+
+
+/// Check whether any file a cache entry depends on has changed
+bool
+entry_is_current(cache_entry const& entry)
+{
+  for (auto const& f : entry.files)
+  {
+    if (stamp_file(f.first) != f.second)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/// Collect the files a configuration was built from
+/**
+ * These are the files that would be found for \p file_path on the search
+ * path, whether or not they currently exist, and every file that supplied
+ * a value to \p config.
+ */
+std::set<std::string>
+config_dependencies(vital::config_block_sptr const& config,
+                    vital::config_path_t const& file_path,
+                    vital::config_path_list_t const& search_paths)
+{
+  std::set<std::string> files;
+  if (ST::FileIsFullPath(file_path))
+  {
+    files.insert(file_path);
+  }
+  else
+  {
+    files.insert(ST::CollapseFullPath(file_path));
+    for (auto const& dir : search_paths)
+    {
+      files.insert(dir + "/" + file_path);
+    }
+  }
+
+  for (auto const& key : config->available_values())
+  {
+    std::string file;
+    int line;
+    if (config->get_location(key, file, line) && !file.empty())
+    {
+      files.insert(file);
+    }
+  }
+  return files;
+}
+
+} // end anonymous namespace
+
+
+/// Read a configuration file, reusing the result of an earlier read
+vital::config_block_sptr
+read_config_file_cached(vital::config_path_t const& file_path,
+                        std::string const& application_name,
+                        std::string const& application_version,
+                        vital::config_path_t const& install_prefix)
+{
+  auto const key = cache_key{ file_path, application_name,
+                              application_version, install_prefix,
+                              ST::GetCurrentWorkingDirectory() };
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+
+  auto const i = cache.find(key);
+  if (i != cache.end() && entry_is_current(i->second))
+  {
+    return copy_config(i->second.config);
+  }
+
+  static auto logger = vital::get_logger("maptk.config_cache");
+  LOG_DEBUG(logger, "Reading configuration " << file_path);
+
+  auto const config =
+    vital::read_config_file(file_path, application_name, application_version,
+                            install_prefix);
+  auto const search_paths =
+    vital::application_config_file_paths(application_name,
+                                          application_version,
+                                          install_prefix);
+
+  cache_entry entry;
+  entry.config = config;
+  for (auto const& f : config_dependencies(config, file_path, search_paths))
+  {
+    entry.files.emplace(f, stamp_file(f));
+  }
+  cache[key] = entry;
+
+  return copy_config(config);
+}
+
+
+/// Discard all cached configurations
+void
+clear_config_cache()
+{
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  cache.clear();
+}
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,83 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for maptk configuration cache functions
+ */
+
+#ifndef MAPTK_CONFIG_CACHE_H_
+#define MAPTK_CONFIG_CACHE_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/config/config_block.h>
+
+#include <string>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Read a configuration file, reusing the result of an earlier read
+/**
+ * This behaves like vital::read_config_file, with merging enabled, but keeps
+ * the fully resolved configuration of each file in a process-wide cache.
+ * A cached configuration is reused as long as none of the files it was built
+ * from, including files pulled in by \c include directives, has changed its
+ * modification time or size, and no file that would take precedence on the
+ * configuration search path has appeared.  Otherwise the file is read again.
+ *
+ * The returned configuration is a copy that the caller is free to modify.
+ *
+ * \param [in] file_path            Path or name of the configuration file.
+ * \param [in] application_name     Application name used for searching.
+ * \param [in] application_version  Application version used for searching.
+ * \param [in] install_prefix       Installation prefix used for searching.
+ *
+ * \throws vital::config_file_not_found_exception
+ *   if the file does not exist or cannot be found on the search path.
+ */
+MAPTK_EXPORT
+vital::config_block_sptr
+read_config_file_cached(vital::config_path_t const& file_path,
+                        std::string const& application_name = {},
+                        std::string const& application_version = {},
+                        vital::config_path_t const& install_prefix = {});
+
+/// Discard all cached configurations
+MAPTK_EXPORT
+void clear_config_cache();
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif // MAPTK_CONFIG_CACHE_H_
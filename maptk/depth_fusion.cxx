@@ -0,0 +1,216 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of CPU fusion of depth maps into a volume
+ */
+
+#include "depth_fusion.h"
+#include "parallel_for.h"
+
+#include <vital/logger/logger.h>
+#include <vital/types/camera_intrinsics.h>
+#include <vital/types/matrix.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Estimate the world size of one pixel near the center of a region
+double
+pixel_to_world_scale(vital::vector_3d const& min_pt,
+                     vital::vector_3d const& max_pt,
+                     std::vector<vital::camera_perspective_sptr> const& cameras)
+{
+  vital::vector_3d const center = 0.5 * (min_pt + max_pt);
+  std::vector<double> scales;
+  for (auto const& cam : cameras)
+  {
+    if (!cam)
+    {
+      continue;
+    }
+    double const depth = cam->depth(center);
+    double const focal = cam->intrinsics()->focal_length();
+    if (depth > 0.0 && focal > 0.0)
+    {
+      scales.push_back(depth / focal);
+    }
+  }
+  if (scales.empty())
+  {
+    return 0.0;
+  }
+  auto const mid = scales.begin() + scales.size() / 2;
+  std::nth_element(scales.begin(), mid, scales.end());
+  return *mid;
+}
+
+
+/// Choose the grid of voxels covering a region
+voxel_grid
+make_voxel_grid(vital::vector_3d const& min_pt,
+                vital::vector_3d const& max_pt,
+                vital::vector_3d const& spacing)
+{
+  voxel_grid grid;
+  grid.spacing = spacing;
+  for (int a = 0; a < 3; ++a)
+  {
+    double const extent = max_pt[a] - min_pt[a];
+    grid.dims[a] = static_cast<size_t>(
+      std::max(std::ceil(extent / spacing[a]), 1.0));
+    // Center the voxels in the region
+    grid.origin[a] = min_pt[a] +
+      0.5 * (extent - (grid.dims[a] - 1) * spacing[a]);
+  }
+  return grid;
+}
+
+
+/// Return the part of a grid covering a range of voxels
+voxel_grid
+sub_grid(voxel_grid const& grid, std::array<size_t, 3> const& first,
+         std::array<size_t, 3> const& dims)
+{
+  voxel_grid part;
+  part.origin = grid.center(first[0], first[1], first[2]);
+  part.spacing = grid.spacing;
+  part.dims = dims;
+  return part;
+}
+
+
+/// Shift the principal point of a camera to match a cropped image
+vital::camera_perspective_sptr
+crop_camera(vital::camera_perspective const& camera, int i0, int j0)
+{
+  vital::simple_camera_intrinsics intrinsics(*camera.intrinsics());
+  intrinsics.set_principal_point(intrinsics.principal_point() -
+                                 vital::vector_2d(i0, j0));
+  return std::make_shared<vital::simple_camera_perspective>(
+    camera.center(), camera.rotation(), intrinsics);
+}
+
+
+/// Accumulate the ray potentials of depth maps in a grid of voxels
+void
+integrate_depth_maps(voxel_grid const& grid, ray_potential const& potential,
+                     std::vector<vital::image_container_sptr> const& depth_maps,
+                     std::vector<vital::camera_perspective_sptr> const& cameras,
+                     std::vector<double>& volume, unsigned num_threads)
+{
+  struct depth_view
+  {
+    vital::matrix_3x4d P;
+    double const* data;
+    ptrdiff_t w_step;
+    ptrdiff_t h_step;
+    double width;
+    double height;
+  };
+
+  // Gather the projection and pixel layout of each depth map once
+  std::vector<depth_view> views;
+  for (size_t m = 0; m < depth_maps.size() && m < cameras.size(); ++m)
+  {
+    if (!depth_maps[m] || !cameras[m])
+    {
+      continue;
+    }
+    auto const& img = depth_maps[m]->get_image();
+    if (img.pixel_traits() != vital::image_pixel_traits_of<double>())
+    {
+      auto logger = vital::get_logger("maptk.depth_fusion");
+      LOG_WARN(logger, "Skipping depth map " << m << " which is not of "
+                       "type double");
+      continue;
+    }
+    depth_view v;
+    v.P = cameras[m]->as_matrix();
+    v.data = static_cast<double const*>(img.first_pixel());
+    v.w_step = img.w_step();
+    v.h_step = img.h_step();
+    v.width = static_cast<double>(img.width());
+    v.height = static_cast<double>(img.height());
+    views.push_back(v);
+  }
+
+  volume.assign(grid.size(), 0.0);
+  size_t const nx = grid.dims[0];
+  size_t const num_rows = grid.dims[1] * grid.dims[2];
+
+  // Work is handed out a few rows of voxels along the first axis at a time;
+  // along a row the projection of the voxel center changes linearly
+  static size_t const rows_per_task = 16;
+  parallel_for_blocks(num_rows, rows_per_task, [&](size_t r0, size_t r1)
+  {
+    for (size_t r = r0; r < r1; ++r)
+    {
+      size_t const j = r % grid.dims[1];
+      size_t const k = r / grid.dims[1];
+      double* row = volume.data() + r * nx;
+      vital::vector_4d const X0(grid.center(0, j, k).homogeneous());
+
+      for (auto const& v : views)
+      {
+        vital::vector_3d const p0 = v.P * X0;
+        vital::vector_3d const dp = v.P.col(0) * grid.spacing[0];
+        for (size_t i = 0; i < nx; ++i)
+        {
+          vital::vector_3d const p = p0 + static_cast<double>(i) * dp;
+          if (p[2] <= 0.0)
+          {
+            continue;
+          }
+          double const u = std::floor(p[0] / p[2] + 0.5);
+          double const w = std::floor(p[1] / p[2] + 0.5);
+          if (u < 0.0 || w < 0.0 || u >= v.width || w >= v.height)
+          {
+            continue;
+          }
+          double const d = v.data[static_cast<ptrdiff_t>(u) * v.w_step +
+                                  static_cast<ptrdiff_t>(w) * v.h_step];
+          if (d > 0.0 && std::isfinite(d))
+          {
+            row[i] += potential(p[2] - d);
+          }
+        }
+      }
+    }
+  }, num_threads);
+}
+
+} // end namespace maptk
+} // end namespace kwiver
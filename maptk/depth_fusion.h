@@ -0,0 +1,179 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for CPU fusion of depth maps into a volume
+ */
+
+#ifndef MAPTK_DEPTH_FUSION_H_
+#define MAPTK_DEPTH_FUSION_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/camera_perspective.h>
+#include <vital/types/image_container.h>
+#include <vital/types/vector.h>
+
+#include <array>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// The signed contribution of a depth measurement to a voxel
+/**
+ * The potential is a function of the depth of the voxel minus the depth
+ * measured along the same ray.  It is zero on the measured surface,
+ * negative in front of it, where the ray passed through free space, and
+ * positive behind it, so the fused surface is the zero level set of the
+ * accumulated potentials.
+ *
+ * Within \c thickness of the surface the potential is linear, reaching
+ * \c rho behind the surface and \c -eta*rho in front of it.  Beyond
+ * \c delta on either side it is zero, since occluded voxels are unknown and
+ * distant free space is poorly localized.  Distances are in world units.
+ */
+struct MAPTK_EXPORT ray_potential
+{
+  double thickness = 3.0;
+  double rho = 1.0;
+  double eta = 1.0;
+  double delta = 10.0;
+
+  /// Evaluate the potential of a voxel \p diff behind the measured depth
+  double operator()(double diff) const
+  {
+    if (diff > delta || diff < -delta)
+    {
+      return 0.0;
+    }
+    double const s = diff > 0.0 ? rho : eta * rho;
+    return diff > thickness || diff < -thickness ? (diff > 0.0 ? s : -s)
+                                                 : s * diff / thickness;
+  }
+};
+
+
+/// A regular grid of voxel centers
+struct MAPTK_EXPORT voxel_grid
+{
+  /// Center of the first voxel
+  vital::vector_3d origin;
+  /// Distance between voxel centers along each axis
+  vital::vector_3d spacing;
+  /// Number of voxels along each axis
+  std::array<size_t, 3> dims;
+
+  /// Number of voxels in the grid
+  size_t size() const { return dims[0] * dims[1] * dims[2]; }
+
+  /// Center of voxel (i, j, k)
+  vital::vector_3d center(size_t i, size_t j, size_t k) const
+  {
+    return origin + spacing.cwiseProduct(
+      vital::vector_3d(static_cast<double>(i), static_cast<double>(j),
+                       static_cast<double>(k)));
+  }
+};
+
+
+/// Estimate the world size of one pixel near the center of a region
+/**
+ * This is the median over the cameras of the depth of the region center
+ * divided by the focal length, and is used to choose a voxel size that
+ * matches the resolution of the depth maps.
+ */
+MAPTK_EXPORT
+double
+pixel_to_world_scale(vital::vector_3d const& min_pt,
+                     vital::vector_3d const& max_pt,
+                     std::vector<vital::camera_perspective_sptr> const& cameras);
+
+
+/// Choose the grid of voxels covering a region
+/**
+ * \param [in] min_pt   Minimum corner of the region.
+ * \param [in] max_pt   Maximum corner of the region.
+ * \param [in] spacing  Distance between voxel centers along each axis.
+ */
+MAPTK_EXPORT
+voxel_grid
+make_voxel_grid(vital::vector_3d const& min_pt,
+                vital::vector_3d const& max_pt,
+                vital::vector_3d const& spacing);
+
+
+/// Return the part of a grid covering a range of voxels
+/**
+ * \param [in] grid   The full grid.
+ * \param [in] first  Index of the first voxel of the part along each axis.
+ * \param [in] dims   Number of voxels of the part along each axis.
+ */
+MAPTK_EXPORT
+voxel_grid
+sub_grid(voxel_grid const& grid, std::array<size_t, 3> const& first,
+         std::array<size_t, 3> const& dims);
+
+
+/// Shift the principal point of a camera to match a cropped image
+MAPTK_EXPORT
+vital::camera_perspective_sptr
+crop_camera(vital::camera_perspective const& camera, int i0, int j0);
+
+
+/// Accumulate the ray potentials of depth maps in a grid of voxels
+/**
+ * Each voxel center is projected into every depth map and the potential of
+ * its depth relative to the depth of the nearest pixel is added to the
+ * voxel.  Pixels that are not positive finite depths are ignored.
+ *
+ * \param [in]  grid        The voxels to fill.
+ * \param [in]  potential   The ray potential function.
+ * \param [in]  depth_maps  Depth images of \c double, indexed by column and
+ *                          row of the image of the matching camera.
+ * \param [in]  cameras     Camera of each depth map.
+ * \param [out] volume      Accumulated potential of each voxel, with the
+ *                          first axis varying fastest.
+ * \param [in]  num_threads Number of threads, or zero for one per core.
+ */
+MAPTK_EXPORT
+void
+integrate_depth_maps(voxel_grid const& grid, ray_potential const& potential,
+                     std::vector<vital::image_container_sptr> const& depth_maps,
+                     std::vector<vital::camera_perspective_sptr> const& cameras,
+                     std::vector<double>& volume, unsigned num_threads = 0);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif // MAPTK_DEPTH_FUSION_H_
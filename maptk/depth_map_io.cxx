@@ -0,0 +1,163 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of reading and writing depth maps as VTK image data
+ */
+
+#include "depth_map_io.h"
+
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFieldData.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkXMLImageDataReader.h>
+
+#include <algorithm>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Convert a cropped depth image and its color image to VTK image data
+vtkSmartPointer<vtkImageData>
+depth_to_vtk(vital::image_container_sptr depth_img,
+             vital::image_container_sptr color_img,
+             int i0, int ni, int j0, int nj)
+{
+  vtkNew<vtkDoubleArray> uniquenessRatios;
+  uniquenessRatios->SetName("Uniqueness Ratios");
+  uniquenessRatios->SetNumberOfValues(ni * nj);
+
+  vtkNew<vtkDoubleArray> bestCost;
+  bestCost->SetName("Best Cost Values");
+  bestCost->SetNumberOfValues(ni * nj);
+
+  vtkNew<vtkUnsignedCharArray> color;
+  color->SetName("Color");
+  color->SetNumberOfComponents(3);
+  color->SetNumberOfTuples(ni * nj);
+
+  vtkNew<vtkDoubleArray> depths;
+  depths->SetName("Depths");
+  depths->SetNumberOfComponents(1);
+  depths->SetNumberOfTuples(ni * nj);
+
+  vtkNew<vtkIntArray> crop;
+  crop->SetName("Crop");
+  crop->SetNumberOfComponents(1);
+  crop->SetNumberOfValues(4);
+  crop->SetValue(0, i0);  crop->SetValue(1, ni);
+  crop->SetValue(2, j0);  crop->SetValue(3, nj);
+
+  auto const dep_im = depth_img->get_image();
+  auto const col_im = color_img->get_image();
+  // Gray images are replicated into each color channel
+  size_t const last_channel = col_im.depth() - 1;
+
+  vtkIdType pt_id = 0;
+  for (int y = nj - 1; y >= 0; y--)
+  {
+    for (int x = 0; x < ni; x++)
+    {
+      uniquenessRatios->SetValue(pt_id, 0);
+      bestCost->SetValue(pt_id, 0);
+      depths->SetValue(pt_id, dep_im.at<double>(x, y));
+      for (size_t c = 0; c < 3; ++c)
+      {
+        color->SetTypedComponent(
+          pt_id, static_cast<int>(c),
+          col_im.at<unsigned char>(x + i0, y + j0, std::min(c, last_channel)));
+      }
+      pt_id++;
+    }
+  }
+
+  auto imageData = vtkSmartPointer<vtkImageData>::New();
+  imageData->SetSpacing(1, 1, 1);
+  imageData->SetOrigin(0, 0, 0);
+  imageData->SetDimensions(ni, nj, 1);
+  imageData->GetPointData()->AddArray(depths.Get());
+  imageData->GetPointData()->AddArray(color.Get());
+  imageData->GetPointData()->AddArray(uniquenessRatios.Get());
+  imageData->GetPointData()->AddArray(bestCost.Get());
+  imageData->GetFieldData()->AddArray(crop.Get());
+  return imageData;
+}
+
+
+/// Load a depth map written by depth_to_vtk
+vital::image_container_sptr
+load_depth_map(std::string const& path, int& i0, int& j0)
+{
+  vtkNew<vtkXMLImageDataReader> reader;
+  reader->SetFileName(path.c_str());
+  reader->Update();
+  vtkImageData* img = reader->GetOutput();
+  vtkDataArray* depths =
+    img ? img->GetPointData()->GetArray("Depths") : nullptr;
+  if (!depths)
+  {
+    return nullptr;
+  }
+
+  int dims[3];
+  img->GetDimensions(dims);
+  int const ni = dims[0];
+  int const nj = dims[1];
+
+  i0 = j0 = 0;
+  vtkDataArray* crop = img->GetFieldData()->GetArray("Crop");
+  if (crop && crop->GetNumberOfTuples() >= 4)
+  {
+    i0 = static_cast<int>(crop->GetTuple1(0));
+    j0 = static_cast<int>(crop->GetTuple1(2));
+  }
+
+  // Rows are stored bottom to top
+  vital::image depth(ni, nj, 1, false,
+                     vital::image_pixel_traits_of<double>());
+  vtkIdType pt_id = 0;
+  for (int y = nj - 1; y >= 0; y--)
+  {
+    for (int x = 0; x < ni; x++)
+    {
+      depth.at<double>(x, y) = depths->GetTuple1(pt_id++);
+    }
+  }
+  return std::make_shared<vital::simple_image_container>(depth);
+}
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,88 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for reading and writing depth maps as VTK image data
+ */
+
+#ifndef MAPTK_DEPTH_MAP_IO_H_
+#define MAPTK_DEPTH_MAP_IO_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/image_container.h>
+
+#include <vtkImageData.h>
+#include <vtkSmartPointer.h>
+
+#include <string>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Convert a cropped depth image and its color image to VTK image data
+/**
+ * This is the layout of the depth maps saved by the GUI and the depth map
+ * tools: point arrays "Depths", "Color", "Uniqueness Ratios" and
+ * "Best Cost Values" with rows stored bottom to top, and a field array
+ * "Crop" holding i0, ni, j0 and nj.
+ *
+ * \param [in] depth_img  Depth image covering the crop region.
+ * \param [in] color_img  Full color image of the reference frame.  Gray
+ *                        images are replicated into each color channel.
+ * \param [in] i0, ni     Column offset and width of the crop region.
+ * \param [in] j0, nj     Row offset and height of the crop region.
+ */
+MAPTK_EXPORT
+vtkSmartPointer<vtkImageData>
+depth_to_vtk(vital::image_container_sptr depth_img,
+             vital::image_container_sptr color_img,
+             int i0, int ni, int j0, int nj);
+
+
+/// Load a depth map written by depth_to_vtk
+/**
+ * \param [in]  path  The VTK image file.
+ * \param [out] i0    Column offset of the depth map in the full image.
+ * \param [out] j0    Row offset of the depth map in the full image.
+ * \returns the depth image, of \c double, or nullptr if it could not be
+ *          read.
+ */
+MAPTK_EXPORT
+vital::image_container_sptr
+load_depth_map(std::string const& path, int& i0, int& j0);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif // MAPTK_DEPTH_MAP_IO_H_
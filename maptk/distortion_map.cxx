@@ -0,0 +1,358 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of precomputed camera distortion lookup grids
+ */
+
+#include "distortion_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+/// Largest number of samples in the map grid, relative to the unmap grid
+size_t const max_map_grid_scale = 4;
+
+/// Largest number of distinct intrinsics kept by distortion_map::shared
+size_t const max_shared_maps = 256;
+
+/// Offsets within a cell at which interpolation is checked
+double const check_offsets[3][2] = { { 0.5, 0.5 }, { 0.5, 0.0 }, { 0.0, 0.5 } };
+
+} // end anonymous namespace
+
+
+/// Interpolate the samples at \p in; false if \p in must be exact
+bool
+distortion_map::grid
+::lookup(vital::vector_2d const& in, vital::vector_2d& out) const
+{
+  if (exact.empty())
+  {
+    return false;
+  }
+  double const u = (in[0] - x0) * inv_step;
+  double const v = (in[1] - y0) * inv_step;
+  // Written to also reject NaN
+  if (!(u >= 0.0 && v >= 0.0 &&
+        u < static_cast<double>(nx - 1) && v < static_cast<double>(ny - 1)))
+  {
+    return false;
+  }
+  size_t const i = static_cast<size_t>(u);
+  size_t const j = static_cast<size_t>(v);
+  if (exact[j * (nx - 1) + i])
+  {
+    return false;
+  }
+  out = interpolate(i, j, u - i, v - j);
+  return true;
+}
+
+
+/// Interpolate the samples at cell (i, j), fraction (u, v)
+vital::vector_2d
+distortion_map::grid
+::interpolate(size_t i, size_t j, double u, double v) const
+{
+  double const* p0 = &values[2 * (j * nx + i)];
+  double const* p1 = p0 + 2 * nx;
+  double const w00 = (1.0 - u) * (1.0 - v);
+  double const w10 = u * (1.0 - v);
+  double const w01 = (1.0 - u) * v;
+  double const w11 = u * v;
+  return vital::vector_2d(
+    w00 * p0[0] + w10 * p0[2] + w01 * p1[0] + w11 * p1[2],
+    w00 * p0[1] + w10 * p0[3] + w01 * p1[1] + w11 * p1[3]);
+}
+
+
+/// Build the lookup grids for the given intrinsics
+distortion_map
+::distortion_map(vital::camera_intrinsics const& intrinsics,
+                 double cell_size, double max_error)
+  : intrinsics_(intrinsics.clone()),
+    has_distortion_(false),
+    max_error_(0.0)
+{
+  for (double const c : intrinsics_->dist_coeffs())
+  {
+    if (c != 0.0)
+    {
+      has_distortion_ = true;
+      break;
+    }
+  }
+  if (!has_distortion_ || !(cell_size > 0.0))
+  {
+    return;
+  }
+
+  double width = static_cast<double>(intrinsics_->image_width());
+  double height = static_cast<double>(intrinsics_->image_height());
+  if (width <= 0.0 || height <= 0.0)
+  {
+    vital::vector_2d const s = intrinsics_->principal_point() * 2.0;
+    width = s[0];
+    height = s[1];
+  }
+  if (width <= 0.0 || height <= 0.0)
+  {
+    return;
+  }
+
+  build_unmap_grid(width, height, cell_size, max_error);
+  build_map_grid(cell_size, max_error);
+}
+
+
+/// Sample the unmap grid over an image of the given size
+void
+distortion_map
+::build_unmap_grid(double width, double height, double cell_size,
+                   double max_error)
+{
+  auto const& K = *intrinsics_;
+  auto& g = unmap_grid_;
+  g.x0 = 0.0;
+  g.y0 = 0.0;
+  g.step = cell_size;
+  g.inv_step = 1.0 / cell_size;
+  g.nx = static_cast<size_t>(std::ceil(width / cell_size)) + 1;
+  g.ny = static_cast<size_t>(std::ceil(height / cell_size)) + 1;
+  g.values.resize(2 * g.nx * g.ny);
+
+  // Sample, and reject samples where the iterative undistortion failed
+  std::vector<unsigned char> bad(g.nx * g.ny, 0);
+  for (size_t j = 0; j < g.ny; ++j)
+  {
+    for (size_t i = 0; i < g.nx; ++i)
+    {
+      size_t const n = j * g.nx + i;
+      vital::vector_2d const pt(g.x0 + i * g.step, g.y0 + j * g.step);
+      vital::vector_2d const norm_pt = K.unmap(pt);
+      g.values[2 * n] = norm_pt[0];
+      g.values[2 * n + 1] = norm_pt[1];
+      bad[n] = !norm_pt.allFinite() ||
+               (K.map(norm_pt) - pt).norm() > max_error;
+    }
+  }
+
+  // Check the interpolation by mapping it back to the image
+  g.exact.assign((g.nx - 1) * (g.ny - 1), 0);
+  for (size_t j = 0; j + 1 < g.ny; ++j)
+  {
+    for (size_t i = 0; i + 1 < g.nx; ++i)
+    {
+      size_t const n = j * g.nx + i;
+      unsigned char& exact = g.exact[j * (g.nx - 1) + i];
+      exact = bad[n] || bad[n + 1] || bad[n + g.nx] || bad[n + g.nx + 1];
+      for (auto const& o : check_offsets)
+      {
+        if (exact)
+        {
+          break;
+        }
+        vital::vector_2d const pt(g.x0 + (i + o[0]) * g.step,
+                                  g.y0 + (j + o[1]) * g.step);
+        double const err = (K.map(g.interpolate(i, j, o[0], o[1])) -
+                            pt).norm();
+        exact = !(err <= max_error);
+        if (!exact)
+        {
+          max_error_ = std::max(max_error_, err);
+        }
+      }
+    }
+  }
+}
+
+
+/// Sample the map grid over the normalized points covered by the unmap grid
+void
+distortion_map
+::build_map_grid(double cell_size, double max_error)
+{
+  auto const& K = *intrinsics_;
+  auto const& ug = unmap_grid_;
+  double const focal = K.focal_length();
+  if (!(focal > 0.0))
+  {
+    return;
+  }
+
+  // Find the normalized extent of the image
+  double lo[2] = { std::numeric_limits<double>::infinity(),
+                   std::numeric_limits<double>::infinity() };
+  double hi[2] = { -lo[0], -lo[1] };
+  for (size_t n = 0; n < ug.nx * ug.ny; ++n)
+  {
+    double const* p = &ug.values[2 * n];
+    if (std::isfinite(p[0]) && std::isfinite(p[1]))
+    {
+      lo[0] = std::min(lo[0], p[0]);
+      lo[1] = std::min(lo[1], p[1]);
+      hi[0] = std::max(hi[0], p[0]);
+      hi[1] = std::max(hi[1], p[1]);
+    }
+  }
+  if (!(lo[0] <= hi[0] && lo[1] <= hi[1]))
+  {
+    return;
+  }
+
+  // Use about the same spacing as the unmap grid, plus a one cell margin,
+  // but coarsen the grid if strong distortion makes the extent very large
+  double step = cell_size / focal;
+  size_t const max_samples = max_map_grid_scale * ug.nx * ug.ny;
+  auto const extent = [&](double s) {
+    return (static_cast<size_t>(std::ceil((hi[0] - lo[0]) / s)) + 3) *
+           (static_cast<size_t>(std::ceil((hi[1] - lo[1]) / s)) + 3);
+  };
+  while (extent(step) > max_samples)
+  {
+    step *= 2.0;
+  }
+
+  auto& g = map_grid_;
+  g.x0 = lo[0] - step;
+  g.y0 = lo[1] - step;
+  g.step = step;
+  g.inv_step = 1.0 / step;
+  g.nx = static_cast<size_t>(std::ceil((hi[0] - lo[0]) / step)) + 3;
+  g.ny = static_cast<size_t>(std::ceil((hi[1] - lo[1]) / step)) + 3;
+  g.values.resize(2 * g.nx * g.ny);
+
+  std::vector<unsigned char> bad(g.nx * g.ny, 0);
+  for (size_t j = 0; j < g.ny; ++j)
+  {
+    for (size_t i = 0; i < g.nx; ++i)
+    {
+      size_t const n = j * g.nx + i;
+      vital::vector_2d const pt =
+        K.map(vital::vector_2d(g.x0 + i * g.step, g.y0 + j * g.step));
+      g.values[2 * n] = pt[0];
+      g.values[2 * n + 1] = pt[1];
+      bad[n] = !pt.allFinite();
+    }
+  }
+
+  // Check the interpolation against the exact mapping
+  g.exact.assign((g.nx - 1) * (g.ny - 1), 0);
+  for (size_t j = 0; j + 1 < g.ny; ++j)
+  {
+    for (size_t i = 0; i + 1 < g.nx; ++i)
+    {
+      size_t const n = j * g.nx + i;
+      unsigned char& exact = g.exact[j * (g.nx - 1) + i];
+      exact = bad[n] || bad[n + 1] || bad[n + g.nx] || bad[n + g.nx + 1];
+      for (auto const& o : check_offsets)
+      {
+        if (exact)
+        {
+          break;
+        }
+        vital::vector_2d const norm_pt(g.x0 + (i + o[0]) * g.step,
+                                       g.y0 + (j + o[1]) * g.step);
+        double const err = (g.interpolate(i, j, o[0], o[1]) -
+                            K.map(norm_pt)).norm();
+        exact = !(err <= max_error);
+        if (!exact)
+        {
+          max_error_ = std::max(max_error_, err);
+        }
+      }
+    }
+  }
+}
+
+
+/// Fraction of grid cells that fall back to the exact intrinsics
+double
+distortion_map
+::fallback_fraction() const
+{
+  size_t const cells = map_grid_.exact.size() + unmap_grid_.exact.size();
+  if (cells == 0)
+  {
+    return 0.0;
+  }
+  size_t const exact =
+    std::count(map_grid_.exact.begin(), map_grid_.exact.end(), 1) +
+    std::count(unmap_grid_.exact.begin(), unmap_grid_.exact.end(), 1);
+  return static_cast<double>(exact) / static_cast<double>(cells);
+}
+
+
+/// Return the map shared by all intrinsics with the same parameters
+distortion_map_sptr
+distortion_map
+::shared(vital::camera_intrinsics const& intrinsics)
+{
+  static std::mutex cache_mutex;
+  static std::map<std::vector<double>, distortion_map_sptr> cache;
+
+  auto const pp = intrinsics.principal_point();
+  std::vector<double> key = {
+    intrinsics.focal_length(), pp[0], pp[1],
+    intrinsics.aspect_ratio(), intrinsics.skew(),
+    static_cast<double>(intrinsics.image_width()),
+    static_cast<double>(intrinsics.image_height()) };
+  auto const coeffs = intrinsics.dist_coeffs();
+  key.insert(key.end(), coeffs.begin(), coeffs.end());
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto& entry = cache[key];
+  if (!entry)
+  {
+    if (cache.size() > max_shared_maps)
+    {
+      cache.clear();
+      auto& new_entry = cache[key];
+      new_entry = std::make_shared<distortion_map const>(intrinsics);
+      return new_entry;
+    }
+    entry = std::make_shared<distortion_map const>(intrinsics);
+  }
+  return entry;
+}
+
+} // end namespace maptk
+} // end namespace kwiver
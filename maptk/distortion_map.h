@@ -0,0 +1,159 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for precomputed camera distortion lookup grids
+ */
+
+#ifndef MAPTK_DISTORTION_MAP_H_
+#define MAPTK_DISTORTION_MAP_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/camera_intrinsics.h>
+
+#include <memory>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Precomputed lookup grids for the lens distortion of camera intrinsics
+/**
+ * Mapping a normalized point to the image is a closed form, but unmapping
+ * an image point requires iteratively inverting the distortion, which
+ * dominates the cost of unprojecting many points.  This class samples both
+ * directions on regular grids once, and answers queries by bilinear
+ * interpolation of the grid.
+ *
+ * The unmap grid covers the image, in pixels.  The map grid covers the
+ * normalized points that unmap to the image, plus a margin.  When the grids
+ * are built, every cell is checked against the exact intrinsics, and cells
+ * where interpolation is off by more than the requested bound (in pixels)
+ * are marked for exact evaluation.  Queries outside a grid, and all queries
+ * on intrinsics without distortion, also use the exact intrinsics, so
+ * results are always within the bound of the exact result.
+ */
+class MAPTK_EXPORT distortion_map
+{
+public:
+  /// Build the lookup grids for the given intrinsics
+  /**
+   * If the intrinsics have no image size, the image is assumed to be
+   * centered on the principal point.
+   *
+   *  \param intrinsics the intrinsics to sample; they are copied
+   *  \param cell_size spacing of the unmap grid, in pixels
+   *  \param max_error largest interpolation error accepted, in pixels
+   */
+  explicit distortion_map(vital::camera_intrinsics const& intrinsics,
+                          double cell_size = 8.0, double max_error = 0.01);
+
+  /// Map a normalized image point to actual image coordinates
+  vital::vector_2d map(vital::vector_2d const& norm_pt) const
+  {
+    vital::vector_2d pt;
+    return map_grid_.lookup(norm_pt, pt) ? pt : intrinsics_->map(norm_pt);
+  }
+
+  /// Unmap an actual image point back into normalized image coordinates
+  vital::vector_2d unmap(vital::vector_2d const& pt) const
+  {
+    vital::vector_2d norm_pt;
+    return unmap_grid_.lookup(pt, norm_pt) ? norm_pt
+                                           : intrinsics_->unmap(pt);
+  }
+
+  /// The intrinsics the grids were built from
+  vital::camera_intrinsics_sptr intrinsics() const { return intrinsics_; }
+
+  /// Return true if the intrinsics have lens distortion
+  /**
+   * Without distortion, no grids are built and all queries are exact.
+   */
+  bool has_distortion() const { return has_distortion_; }
+
+  /// Largest interpolation error found in cells that use the grids, in pixels
+  double max_error() const { return max_error_; }
+
+  /// Fraction of grid cells that fall back to the exact intrinsics
+  double fallback_fraction() const;
+
+  /// Return the map shared by all intrinsics with the same parameters
+  /**
+   * Maps are built with the default grid spacing and error bound on first
+   * use and cached, so cameras sharing intrinsics, or having equal copies
+   * of them, build the grids once.  This function is thread safe.
+   */
+  static std::shared_ptr<distortion_map const>
+  shared(vital::camera_intrinsics const& intrinsics);
+
+private:
+  /// Regular grid of 2D samples with bilinear lookup
+  struct grid
+  {
+    /// Interpolate the samples at \p in; false if \p in must be exact
+    bool lookup(vital::vector_2d const& in, vital::vector_2d& out) const;
+
+    /// Interpolate the samples at cell (i, j), fraction (u, v)
+    vital::vector_2d interpolate(size_t i, size_t j,
+                                 double u, double v) const;
+
+    double x0 = 0.0;
+    double y0 = 0.0;
+    double step = 1.0;
+    double inv_step = 1.0;
+    size_t nx = 0; ///< number of samples per row
+    size_t ny = 0; ///< number of rows of samples
+    std::vector<double> values; ///< interleaved x, y samples
+    std::vector<unsigned char> exact; ///< per cell, nonzero to not use
+  };
+
+  void build_unmap_grid(double width, double height, double cell_size,
+                        double max_error);
+  void build_map_grid(double cell_size, double max_error);
+
+  vital::camera_intrinsics_sptr intrinsics_;
+  bool has_distortion_;
+  double max_error_;
+  grid map_grid_;
+  grid unmap_grid_;
+};
+
+/// Shared pointer to a const distortion_map
+typedef std::shared_ptr<distortion_map const> distortion_map_sptr;
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif
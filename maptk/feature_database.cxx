@@ -0,0 +1,1283 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of the single file feature and descriptor database
+ *
+ * The file starts with a 16 byte header: the magic string "TSFEATDB", a
+ * 32-bit format version and a 32-bit byte order mark.  It is followed by
+ * records, each made of a 24 byte header (a 32-bit record marker, the 32-bit
+ * length of the name, the 64-bit frame number and the 64-bit length of the
+ * payload), the name, and the payload.  The payload holds the features,
+ * each with its covariance and stored as doubles with a flag recording
+ * whether they were single or double precision, followed by the
+ * descriptors.  All values are in the byte order of the host
+ * that created the file; files created on a host of the other byte order are
+ * rejected.
+ */
+
+#include "feature_database.h"
+
+#include <vital/exceptions.h>
+#include <vital/logger/logger.h>
+#include <vital/types/descriptor.h>
+#include <vital/types/feature.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <share.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+typedef kwiversys::SystemTools ST;
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+static char const FILE_MAGIC[8] = { 'T', 'S', 'F', 'E', 'A', 'T', 'D', 'B' };
+static uint32_t const FILE_VERSION = 3;
+static uint32_t const BYTE_ORDER_MARK = 0x01020304;
+static uint64_t const FILE_HEADER_SIZE = 16;
+static uint32_t const RECORD_MARKER = 0x43455246; // "FREC"
+static uint64_t const RECORD_HEADER_SIZE = 24;
+static uint64_t const FEATURE_SIZE = 8 * sizeof(double) + 3;
+
+/// The precision of the features of a record
+enum feature_type : uint8_t
+{
+  FEATURES_DOUBLE = 0,
+  FEATURES_FLOAT = 1,
+};
+
+/// How the descriptor values of a record are stored
+enum descriptor_encoding : uint8_t
+{
+  DESCRIPTORS_NONE = 0,
+  DESCRIPTORS_UINT8 = 1,
+  DESCRIPTORS_FLOAT = 2,
+  DESCRIPTORS_DOUBLE = 3,
+  DESCRIPTORS_BITS = 4,
+  DESCRIPTORS_FLOAT16 = 5,
+  DESCRIPTORS_QUANTIZED8 = 6,
+};
+
+
+/// Location of a record payload in the file
+struct record_location
+{
+  uint64_t offset;
+  uint64_t size;
+};
+
+
+// ----------------------------------------------------------------------------
+/// Appends values to a byte buffer
+class byte_writer
+{
+public:
+  explicit byte_writer(std::string& buffer) : buffer_(buffer) {}
+
+  template <typename T>
+  void put(T value)
+  {
+    buffer_.append(reinterpret_cast<char const*>(&value), sizeof(T));
+  }
+
+  void put_bytes(void const* data, size_t size)
+  {
+    buffer_.append(static_cast<char const*>(data), size);
+  }
+
+private:
+  std::string& buffer_;
+};
+
+
+// ----------------------------------------------------------------------------
+/// Reads values from a byte buffer, throwing if it runs out
+class byte_reader
+{
+public:
+  byte_reader(char const* data, size_t size)
+    : pos_(data), end_(data + size) {}
+
+  template <typename T>
+  T get()
+  {
+    T value;
+    std::memcpy(&value, take(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  char const* take(size_t size)
+  {
+    if (static_cast<size_t>(end_ - pos_) < size)
+    {
+      throw vital::invalid_value("Truncated feature database record");
+    }
+    auto const p = pos_;
+    pos_ += size;
+    return p;
+  }
+
+private:
+  char const* pos_;
+  char const* end_;
+};
+
+
+// ----------------------------------------------------------------------------
+/// Copy the values of typed descriptors into a buffer
+template <typename T>
+bool
+put_descriptor_values(byte_writer& out,
+                      std::vector<vital::descriptor_sptr> const& descriptors,
+                      size_t dim)
+{
+  std::vector<T> zeros(dim, T(0));
+  for (auto const& d : descriptors)
+  {
+    auto const* typed = dynamic_cast<vital::descriptor_array_of<T> const*>(d.get());
+    if (d && !typed)
+    {
+      return false;
+    }
+    out.put_bytes(typed ? typed->raw_data() : zeros.data(), dim * sizeof(T));
+  }
+  return true;
+}
+
+
+/// Read typed descriptor values from a buffer
+template <typename T>
+std::vector<vital::descriptor_sptr>
+get_descriptor_values(byte_reader& in, uint32_t count, uint32_t dim)
+{
+  std::vector<vital::descriptor_sptr> descriptors;
+  descriptors.reserve(count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    auto d = std::make_shared<vital::descriptor_dynamic<T>>(dim);
+    std::memcpy(d->raw_data(), in.take(dim * sizeof(T)), dim * sizeof(T));
+    descriptors.push_back(d);
+  }
+  return descriptors;
+}
+
+
+// ----------------------------------------------------------------------------
+/// Get the common size of descriptors, or 0 if there are none
+/**
+ * \throws vital::invalid_value if the descriptors differ in size
+ */
+size_t
+descriptor_dimension(std::vector<vital::descriptor_sptr> const& descriptors)
+{
+  size_t dim = 0;
+  bool found = false;
+  for (auto const& d : descriptors)
+  {
+    if (!d)
+    {
+      continue;
+    }
+    if (!found)
+    {
+      dim = d->size();
+      found = true;
+    }
+    else if (d->size() != dim)
+    {
+      throw vital::invalid_value("Descriptors of one frame must all have the "
+                                 "same size to be stored in a feature "
+                                 "database");
+    }
+  }
+  return dim;
+}
+
+
+/// Check whether all descriptors are of one element type
+template <typename T>
+bool
+all_of_type(std::vector<vital::descriptor_sptr> const& descriptors)
+{
+  for (auto const& d : descriptors)
+  {
+    if (d && !dynamic_cast<vital::descriptor_array_of<T> const*>(d.get()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/// Check whether all values of byte descriptors are zero or one
+bool
+is_binary(std::vector<vital::descriptor_sptr> const& descriptors, size_t dim)
+{
+  for (auto const& d : descriptors)
+  {
+    if (!d)
+    {
+      continue;
+    }
+    auto const* v =
+      static_cast<vital::descriptor_array_of<uint8_t> const*>(d.get())->raw_data();
+    for (size_t i = 0; i < dim; ++i)
+    {
+      if (v[i] > 1)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+
+/// Convert a single precision float to half precision, rounding to nearest
+uint16_t
+float_to_half(float value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  uint16_t const sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+  int32_t const exponent = static_cast<int32_t>((bits >> 23) & 0xff) - 127 + 15;
+  uint32_t mantissa = bits & 0x7fffff;
+
+  if (((bits >> 23) & 0xff) == 0xff)
+  {
+    // infinity or NaN
+    return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+  }
+  if (exponent >= 0x1f)
+  {
+    // too large, so saturate to infinity
+    return sign | 0x7c00;
+  }
+  if (exponent <= 0)
+  {
+    // subnormal in half precision, or too small
+    if (exponent < -10)
+    {
+      return sign;
+    }
+    mantissa |= 0x800000;
+    auto const shift = static_cast<uint32_t>(14 - exponent);
+    auto half_mantissa = mantissa >> shift;
+    auto const rest = mantissa & ((1u << shift) - 1);
+    auto const halfway = 1u << (shift - 1);
+    if (rest > halfway || (rest == halfway && (half_mantissa & 1)))
+    {
+      ++half_mantissa;
+    }
+    return sign | static_cast<uint16_t>(half_mantissa);
+  }
+
+  auto half = static_cast<uint32_t>(sign) |
+              (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+  auto const rest = mantissa & 0x1fff;
+  if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+  {
+    // may carry into the exponent, which correctly rounds up to infinity
+    ++half;
+  }
+  return static_cast<uint16_t>(half);
+}
+
+
+/// Convert a half precision float to single precision
+float
+half_to_float(uint16_t half)
+{
+  uint32_t const sign = static_cast<uint32_t>(half & 0x8000) << 16;
+  uint32_t exponent = (half >> 10) & 0x1f;
+  uint32_t mantissa = half & 0x3ff;
+  uint32_t bits;
+
+  if (exponent == 0x1f)
+  {
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  }
+  else if (exponent == 0)
+  {
+    if (mantissa == 0)
+    {
+      bits = sign;
+    }
+    else
+    {
+      // normalize the subnormal value
+      exponent = 127 - 15 + 1;
+      while (!(mantissa & 0x400))
+      {
+        mantissa <<= 1;
+        --exponent;
+      }
+      bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+  }
+  else
+  {
+    bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+  }
+
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+
+/// Get the values of descriptors as doubles, with zeros for missing ones
+std::vector<double>
+descriptor_values(std::vector<vital::descriptor_sptr> const& descriptors,
+                  size_t dim)
+{
+  std::vector<double> values;
+  values.reserve(descriptors.size() * dim);
+  for (auto const& d : descriptors)
+  {
+    auto v = d ? d->as_double() : std::vector<double>{};
+    v.resize(dim, 0.0);
+    values.insert(values.end(), v.begin(), v.end());
+  }
+  return values;
+}
+
+
+/// Compute a quantization covering the values of floating point descriptors
+bool
+range_quantization(vital::descriptor_set_sptr const& desc,
+                   feature_database::quantization& q)
+{
+  auto const descriptors =
+    desc ? desc->descriptors() : std::vector<vital::descriptor_sptr>{};
+  auto const dim = descriptor_dimension(descriptors);
+  if (dim == 0 || all_of_type<uint8_t>(descriptors))
+  {
+    return false;
+  }
+
+  auto const values = descriptor_values(descriptors, dim);
+  auto const range = std::minmax_element(values.begin(), values.end());
+  auto const span = static_cast<float>(*range.second - *range.first);
+  q.offset = static_cast<float>(*range.first);
+  q.scale = span > 0.0f ? span / 255.0f : 1.0f;
+  return true;
+}
+
+
+// ----------------------------------------------------------------------------
+/// Serialize the features and descriptors of a frame
+std::string
+encode_payload(vital::feature_set_sptr const& feat,
+               vital::descriptor_set_sptr const& desc,
+               feature_database::descriptor_encoding encoding,
+               feature_database::quantization const& quant)
+{
+  typedef feature_database::descriptor_encoding encoding_t;
+
+  std::string buffer;
+  byte_writer out(buffer);
+
+  auto const features =
+    feat ? feat->features() : std::vector<vital::feature_sptr>{};
+  auto const all_float = !features.empty() &&
+    std::all_of(features.begin(), features.end(),
+                [](vital::feature_sptr const& f)
+                { return dynamic_cast<vital::feature_f const*>(f.get()); });
+  out.put(static_cast<uint32_t>(features.size()));
+  out.put(static_cast<uint8_t>(all_float ? FEATURES_FLOAT : FEATURES_DOUBLE));
+  vital::feature_d const empty_feature;
+  for (auto const& f : features)
+  {
+    vital::feature const& fr =
+      f ? static_cast<vital::feature const&>(*f) : empty_feature;
+    auto const loc = fr.loc();
+    auto const covar = fr.covar().matrix();
+    auto const color = fr.color();
+    out.put(static_cast<double>(loc[0]));
+    out.put(static_cast<double>(loc[1]));
+    out.put(static_cast<double>(fr.magnitude()));
+    out.put(static_cast<double>(fr.scale()));
+    out.put(static_cast<double>(fr.angle()));
+    out.put(static_cast<double>(covar(0, 0)));
+    out.put(static_cast<double>(covar(0, 1)));
+    out.put(static_cast<double>(covar(1, 1)));
+    out.put(color.r);
+    out.put(color.g);
+    out.put(color.b);
+  }
+
+  auto const descriptors =
+    desc ? desc->descriptors() : std::vector<vital::descriptor_sptr>{};
+  auto const dim = descriptor_dimension(descriptors);
+
+  auto const put_header = [&](descriptor_encoding stored)
+  {
+    out.put(static_cast<uint8_t>(stored));
+    out.put(static_cast<uint32_t>(descriptors.size()));
+    out.put(static_cast<uint32_t>(dim));
+  };
+
+  if (dim == 0)
+  {
+    put_header(DESCRIPTORS_NONE);
+    return buffer;
+  }
+
+  // byte descriptors are stored as they are, packed if they are binary
+  if (all_of_type<uint8_t>(descriptors))
+  {
+    if (!is_binary(descriptors, dim))
+    {
+      put_header(DESCRIPTORS_UINT8);
+      put_descriptor_values<uint8_t>(out, descriptors, dim);
+      return buffer;
+    }
+
+    put_header(DESCRIPTORS_BITS);
+    std::vector<uint8_t> packed((dim + 7) / 8);
+    for (auto const& d : descriptors)
+    {
+      std::fill(packed.begin(), packed.end(), 0);
+      if (d)
+      {
+        auto const* v =
+          static_cast<vital::descriptor_array_of<uint8_t> const*>(d.get())->raw_data();
+        for (size_t i = 0; i < dim; ++i)
+        {
+          packed[i / 8] |= static_cast<uint8_t>(v[i] << (i % 8));
+        }
+      }
+      out.put_bytes(packed.data(), packed.size());
+    }
+    return buffer;
+  }
+
+  if (encoding == encoding_t::float16)
+  {
+    put_header(DESCRIPTORS_FLOAT16);
+    for (auto const v : descriptor_values(descriptors, dim))
+    {
+      out.put(float_to_half(static_cast<float>(v)));
+    }
+    return buffer;
+  }
+
+  if (encoding == encoding_t::quantized8)
+  {
+    auto const values = descriptor_values(descriptors, dim);
+
+    put_header(DESCRIPTORS_QUANTIZED8);
+    out.put(quant.offset);
+    out.put(quant.scale);
+    for (auto const v : values)
+    {
+      auto const q = std::round((v - quant.offset) / quant.scale);
+      out.put(static_cast<uint8_t>(std::min(255.0, std::max(0.0, q))));
+    }
+    return buffer;
+  }
+
+  // otherwise keep the type produced by the extractor where possible
+  if (all_of_type<float>(descriptors))
+  {
+    put_header(DESCRIPTORS_FLOAT);
+    put_descriptor_values<float>(out, descriptors, dim);
+    return buffer;
+  }
+  if (all_of_type<double>(descriptors))
+  {
+    put_header(DESCRIPTORS_DOUBLE);
+    put_descriptor_values<double>(out, descriptors, dim);
+    return buffer;
+  }
+
+  // descriptors of mixed or other types are stored as doubles
+  put_header(DESCRIPTORS_DOUBLE);
+  auto const values = descriptor_values(descriptors, dim);
+  out.put_bytes(values.data(), values.size() * sizeof(double));
+  return buffer;
+}
+
+
+/// Deserialize the features and descriptors of a frame
+void
+decode_payload(char const* data, size_t size,
+               vital::feature_set_sptr& feat,
+               vital::descriptor_set_sptr& desc,
+               bool compact)
+{
+  byte_reader in(data, size);
+
+  auto const num_features = in.get<uint32_t>();
+  auto const type = in.get<uint8_t>();
+  std::vector<vital::feature_sptr> features;
+  features.reserve(num_features);
+  for (uint32_t i = 0; i < num_features; ++i)
+  {
+    vital::vector_2d loc;
+    loc[0] = in.get<double>();
+    loc[1] = in.get<double>();
+    auto const magnitude = in.get<double>();
+    auto const scale = in.get<double>();
+    auto const angle = in.get<double>();
+    Eigen::Matrix2d covar;
+    covar(0, 0) = in.get<double>();
+    covar(0, 1) = covar(1, 0) = in.get<double>();
+    covar(1, 1) = in.get<double>();
+    vital::rgb_color color;
+    color.r = in.get<uint8_t>();
+    color.g = in.get<uint8_t>();
+    color.b = in.get<uint8_t>();
+    if (type == FEATURES_FLOAT)
+    {
+      auto const f = std::make_shared<vital::feature_f>(
+        vital::vector_2f(loc.cast<float>()), static_cast<float>(magnitude),
+        static_cast<float>(scale), static_cast<float>(angle), color);
+      f->set_covar(vital::covariance_2f(Eigen::Matrix2f(covar.cast<float>())));
+      features.push_back(f);
+    }
+    else
+    {
+      auto const f = std::make_shared<vital::feature_d>(
+        loc, magnitude, scale, angle, color);
+      f->set_covar(vital::covariance_2d(covar));
+      features.push_back(f);
+    }
+  }
+  feat = std::make_shared<vital::simple_feature_set>(features);
+
+  auto const encoding = in.get<uint8_t>();
+  auto const count = in.get<uint32_t>();
+  auto const dim = in.get<uint32_t>();
+  std::vector<vital::descriptor_sptr> descriptors;
+  descriptors.reserve(count);
+  switch (encoding)
+  {
+    case DESCRIPTORS_NONE:
+      break;
+    case DESCRIPTORS_UINT8:
+      descriptors = get_descriptor_values<uint8_t>(in, count, dim);
+      break;
+    case DESCRIPTORS_FLOAT:
+      descriptors = get_descriptor_values<float>(in, count, dim);
+      break;
+    case DESCRIPTORS_DOUBLE:
+      descriptors = get_descriptor_values<double>(in, count, dim);
+      break;
+    case DESCRIPTORS_BITS:
+    {
+      auto const num_bytes = (dim + 7) / 8;
+      if (compact)
+      {
+        descriptors = get_descriptor_values<uint8_t>(in, count, num_bytes);
+        break;
+      }
+      for (uint32_t i = 0; i < count; ++i)
+      {
+        auto const* packed = reinterpret_cast<uint8_t const*>(in.take(num_bytes));
+        auto d = std::make_shared<vital::descriptor_dynamic<uint8_t>>(dim);
+        auto* v = d->raw_data();
+        for (uint32_t j = 0; j < dim; ++j)
+        {
+          v[j] = (packed[j / 8] >> (j % 8)) & 1;
+        }
+        descriptors.push_back(d);
+      }
+      break;
+    }
+    case DESCRIPTORS_FLOAT16:
+      for (uint32_t i = 0; i < count; ++i)
+      {
+        auto const* halves = in.take(dim * sizeof(uint16_t));
+        auto d = std::make_shared<vital::descriptor_dynamic<float>>(dim);
+        auto* v = d->raw_data();
+        for (uint32_t j = 0; j < dim; ++j)
+        {
+          uint16_t h;
+          std::memcpy(&h, halves + j * sizeof(uint16_t), sizeof(h));
+          v[j] = half_to_float(h);
+        }
+        descriptors.push_back(d);
+      }
+      break;
+    case DESCRIPTORS_QUANTIZED8:
+    {
+      auto const offset = in.get<float>();
+      auto const scale = in.get<float>();
+      if (compact)
+      {
+        descriptors = get_descriptor_values<uint8_t>(in, count, dim);
+        break;
+      }
+      for (uint32_t i = 0; i < count; ++i)
+      {
+        auto const* codes = reinterpret_cast<uint8_t const*>(in.take(dim));
+        auto d = std::make_shared<vital::descriptor_dynamic<float>>(dim);
+        auto* v = d->raw_data();
+        for (uint32_t j = 0; j < dim; ++j)
+        {
+          v[j] = offset + codes[j] * scale;
+        }
+        descriptors.push_back(d);
+      }
+      break;
+    }
+    default:
+      throw vital::invalid_value("Unknown descriptor encoding in feature "
+                                 "database record");
+  }
+  desc = std::make_shared<vital::simple_descriptor_set>(descriptors);
+}
+
+
+// ----------------------------------------------------------------------------
+/// Read-only view of part of the database file
+struct file_view
+{
+  std::shared_ptr<void const> owner;
+  char const* data = nullptr;
+};
+
+
+#ifndef _WIN32
+/// A read-only memory map of the database file
+struct file_mapping
+{
+  ~file_mapping()
+  {
+    if (data)
+    {
+      ::munmap(const_cast<char*>(data), size);
+    }
+  }
+
+  char const* data = nullptr;
+  size_t size = 0;
+};
+#endif
+
+
+/// Cut a file to a given size
+bool
+truncate_file(std::string const& path, uint64_t size)
+{
+#ifdef _WIN32
+  int fd;
+  if (_sopen_s(&fd, path.c_str(), _O_RDWR | _O_BINARY, _SH_DENYNO,
+               _S_IREAD | _S_IWRITE) != 0)
+  {
+    return false;
+  }
+  auto const result = _chsize_s(fd, static_cast<__int64>(size));
+  _close(fd);
+  return result == 0;
+#else
+  return ::truncate(path.c_str(), static_cast<off_t>(size)) == 0;
+#endif
+}
+
+} // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+/// Private implementation class
+class feature_database::priv
+{
+public:
+  /// Index the records of the file, returning the end of the last good one
+  uint64_t scan();
+
+  /// Take the quantization of the database from a record, if it has one
+  void read_quantization(std::ifstream& ifs, record_location const& loc);
+
+  /// Get a view of a record payload
+  file_view view(record_location const& loc) const;
+
+  /// Load the record at a location
+  void load(record_location const& loc, vital::feature_set_sptr& feat,
+            vital::descriptor_set_sptr& desc, bool compact) const;
+
+  vital::path_t path;
+  bool writable = false;
+  feature_database::descriptor_encoding encoding =
+    feature_database::descriptor_encoding::native;
+
+  // guards the members below
+  mutable std::mutex mutex;
+  std::map<vital::frame_id_t, record_location> by_frame;
+  std::map<std::string, record_location> by_name;
+  std::map<std::string, vital::frame_id_t> name_frames;
+  uint64_t file_size = 0;
+  std::ofstream out;
+  bool has_quantization = false;
+  feature_database::quantization quantization = { 0.0f, 1.0f };
+#ifndef _WIN32
+  mutable std::shared_ptr<file_mapping> mapping;
+#endif
+
+  vital::logger_handle_t logger = vital::get_logger("maptk.feature_database");
+};
+
+
+/// Index the records of the file, returning the end of the last good one
+uint64_t
+feature_database::priv
+::scan()
+{
+  std::ifstream ifs(path.c_str(), std::ios::binary);
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  if (!ifs.read(magic, 8) ||
+      !ifs.read(reinterpret_cast<char*>(&version), sizeof(version)) ||
+      !ifs.read(reinterpret_cast<char*>(&byte_order), sizeof(byte_order)) ||
+      std::memcmp(magic, FILE_MAGIC, 8) != 0)
+  {
+    throw vital::invalid_file(path, "Not a feature database");
+  }
+  if (byte_order != BYTE_ORDER_MARK && version >= 2)
+  {
+    throw vital::invalid_file(path, "Feature database was created on a host "
+                                    "with a different byte order");
+  }
+  if (version != FILE_VERSION)
+  {
+    throw vital::invalid_file(path, "Unsupported feature database version " +
+                                    std::to_string(version));
+  }
+
+  auto const size = static_cast<uint64_t>(ST::FileLength(path));
+  uint64_t pos = FILE_HEADER_SIZE;
+  while (pos + RECORD_HEADER_SIZE <= size)
+  {
+    char header[RECORD_HEADER_SIZE];
+    ifs.seekg(static_cast<std::streamoff>(pos));
+    if (!ifs.read(header, RECORD_HEADER_SIZE))
+    {
+      break;
+    }
+    byte_reader in(header, RECORD_HEADER_SIZE);
+    auto const marker = in.get<uint32_t>();
+    auto const name_size = in.get<uint32_t>();
+    auto const frame = in.get<int64_t>();
+    auto const payload_size = in.get<uint64_t>();
+    auto const end = pos + RECORD_HEADER_SIZE + name_size + payload_size;
+    if (marker != RECORD_MARKER || end > size)
+    {
+      break;
+    }
+
+    std::string name(name_size, '\0');
+    if (!ifs.read(&name[0], name_size))
+    {
+      break;
+    }
+
+    record_location const loc{ pos + RECORD_HEADER_SIZE + name_size,
+                               payload_size };
+    by_name[name] = loc;
+    if (frame >= 0)
+    {
+      by_frame[frame] = loc;
+      name_frames[name] = frame;
+    }
+    if (!has_quantization)
+    {
+      read_quantization(ifs, loc);
+    }
+    pos = end;
+  }
+
+  if (pos < size)
+  {
+    LOG_WARN(logger, "Ignoring " << (size - pos) << " bytes of incomplete "
+                     "records at the end of " << path);
+  }
+  return pos;
+}
+
+
+/// Take the quantization of the database from a record, if it has one
+void
+feature_database::priv
+::read_quantization(std::ifstream& ifs, record_location const& loc)
+{
+  uint32_t num_features;
+  ifs.seekg(static_cast<std::streamoff>(loc.offset));
+  if (!ifs.read(reinterpret_cast<char*>(&num_features), sizeof(num_features)))
+  {
+    ifs.clear();
+    return;
+  }
+
+  // descriptor encoding, count and dimension, then offset and scale
+  char header[17];
+  auto const header_offset =
+    sizeof(num_features) + sizeof(uint8_t) + num_features * FEATURE_SIZE;
+  if (header_offset + sizeof(header) > loc.size)
+  {
+    return;
+  }
+  ifs.seekg(static_cast<std::streamoff>(loc.offset + header_offset));
+  if (!ifs.read(header, sizeof(header)))
+  {
+    ifs.clear();
+    return;
+  }
+  byte_reader in(header, sizeof(header));
+  if (in.get<uint8_t>() == DESCRIPTORS_QUANTIZED8)
+  {
+    in.take(2 * sizeof(uint32_t));
+    quantization.offset = in.get<float>();
+    quantization.scale = in.get<float>();
+    has_quantization = true;
+  }
+}
+
+
+/// Get a view of a record payload
+file_view
+feature_database::priv
+::view(record_location const& loc) const
+{
+  file_view v;
+#ifndef _WIN32
+  std::shared_ptr<file_mapping> m;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!mapping || mapping->size < loc.offset + loc.size)
+    {
+      // map the whole file again now that it has grown
+      auto new_mapping = std::make_shared<file_mapping>();
+      int const fd = ::open(path.c_str(), O_RDONLY);
+      struct stat st;
+      if (fd >= 0 && ::fstat(fd, &st) == 0 && st.st_size > 0)
+      {
+        auto const p = ::mmap(nullptr, static_cast<size_t>(st.st_size),
+                              PROT_READ, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED)
+        {
+          new_mapping->data = static_cast<char const*>(p);
+          new_mapping->size = static_cast<size_t>(st.st_size);
+        }
+      }
+      if (fd >= 0)
+      {
+        ::close(fd);
+      }
+      if (!new_mapping->data || new_mapping->size < loc.offset + loc.size)
+      {
+        throw vital::file_not_read_exception(path, "Unable to map feature "
+                                             "database");
+      }
+      mapping = new_mapping;
+    }
+    m = mapping;
+  }
+  v.owner = m;
+  v.data = m->data + loc.offset;
+#else
+  auto buffer = std::make_shared<std::vector<char>>(loc.size);
+  std::ifstream ifs(path.c_str(), std::ios::binary);
+  ifs.seekg(static_cast<std::streamoff>(loc.offset));
+  if (!ifs.read(buffer->data(), static_cast<std::streamsize>(loc.size)))
+  {
+    throw vital::file_not_read_exception(path, "Unable to read feature "
+                                         "database record");
+  }
+  v.owner = buffer;
+  v.data = buffer->data();
+#endif
+  return v;
+}
+
+
+/// Load the record at a location
+void
+feature_database::priv
+::load(record_location const& loc, vital::feature_set_sptr& feat,
+       vital::descriptor_set_sptr& desc, bool compact) const
+{
+  auto const v = view(loc);
+  decode_payload(v.data, static_cast<size_t>(loc.size), feat, desc, compact);
+}
+
+
+// ----------------------------------------------------------------------------
+/// Open or create a database
+feature_database
+::feature_database(vital::path_t const& path, bool writable)
+  : d_(new priv)
+{
+  d_->path = path;
+  d_->writable = writable;
+
+  if (!ST::FileExists(path, true))
+  {
+    if (!writable)
+    {
+      throw vital::file_not_found_exception(path, "Feature database does "
+                                            "not exist");
+    }
+    std::ofstream ofs(path.c_str(), std::ios::binary);
+    ofs.write(FILE_MAGIC, 8);
+    ofs.write(reinterpret_cast<char const*>(&FILE_VERSION), sizeof(FILE_VERSION));
+    ofs.write(reinterpret_cast<char const*>(&BYTE_ORDER_MARK),
+              sizeof(BYTE_ORDER_MARK));
+    if (!ofs)
+    {
+      throw vital::file_write_exception(path, "Unable to create feature "
+                                        "database");
+    }
+  }
+
+  d_->file_size = d_->scan();
+
+  if (writable)
+  {
+    // drop incomplete records so that new records follow the last good one
+    if (static_cast<uint64_t>(ST::FileLength(path)) > d_->file_size &&
+        !truncate_file(path, d_->file_size))
+    {
+      throw vital::file_write_exception(path, "Unable to discard incomplete "
+                                        "feature database records");
+    }
+    d_->out.open(path.c_str(), std::ios::binary | std::ios::app);
+    if (!d_->out)
+    {
+      throw vital::file_write_exception(path, "Unable to open feature "
+                                        "database for writing");
+    }
+  }
+}
+
+
+/// Destructor
+feature_database
+::~feature_database()
+{
+}
+
+
+/// Append the features and descriptors of a frame
+void
+feature_database
+::append(std::string const& name, vital::frame_id_t frame,
+         vital::feature_set_sptr const& feat,
+         vital::descriptor_set_sptr const& desc)
+{
+  if (!d_->writable)
+  {
+    throw vital::file_write_exception(d_->path, "Feature database is open "
+                                      "for reading only");
+  }
+
+  // the first quantized frame fixes the quantization if it is not yet set
+  auto const encoding = get_descriptor_encoding();
+  quantization quant = { 0.0f, 1.0f };
+  if (encoding == descriptor_encoding::quantized8)
+  {
+    std::lock_guard<std::mutex> lock(d_->mutex);
+    if (!d_->has_quantization &&
+        range_quantization(desc, d_->quantization))
+    {
+      d_->has_quantization = true;
+    }
+    quant = d_->quantization;
+  }
+
+  // serialize before taking the lock so that threads only wait on the write
+  auto const payload = encode_payload(feat, desc, encoding, quant);
+
+  std::string header;
+  byte_writer out(header);
+  out.put(RECORD_MARKER);
+  out.put(static_cast<uint32_t>(name.size()));
+  out.put(static_cast<int64_t>(frame));
+  out.put(static_cast<uint64_t>(payload.size()));
+
+  std::lock_guard<std::mutex> lock(d_->mutex);
+  d_->out.write(header.data(), static_cast<std::streamsize>(header.size()));
+  d_->out.write(name.data(), static_cast<std::streamsize>(name.size()));
+  d_->out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+  d_->out.flush();
+  if (!d_->out)
+  {
+    throw vital::file_write_exception(d_->path, "Unable to append to feature "
+                                      "database");
+  }
+
+  record_location const loc{ d_->file_size + RECORD_HEADER_SIZE + name.size(),
+                             payload.size() };
+  d_->file_size = loc.offset + loc.size;
+  d_->by_name[name] = loc;
+  if (frame >= 0)
+  {
+    d_->by_frame[frame] = loc;
+    d_->name_frames[name] = frame;
+  }
+}
+
+
+/// Set the encoding of floating point descriptors appended from now on
+void
+feature_database
+::set_descriptor_encoding(descriptor_encoding encoding)
+{
+  std::lock_guard<std::mutex> lock(d_->mutex);
+  d_->encoding = encoding;
+}
+
+
+/// Get the encoding of floating point descriptors appended from now on
+feature_database::descriptor_encoding
+feature_database
+::get_descriptor_encoding() const
+{
+  std::lock_guard<std::mutex> lock(d_->mutex);
+  return d_->encoding;
+}
+
+
+/// Set the quantization of the database
+void
+feature_database
+::set_quantization(quantization const& q)
+{
+  if (!(q.scale > 0.0f))
+  {
+    throw vital::invalid_value("Quantization scale must be positive");
+  }
+
+  std::lock_guard<std::mutex> lock(d_->mutex);
+  if (d_->has_quantization &&
+      (d_->quantization.offset != q.offset ||
+       d_->quantization.scale != q.scale))
+  {
+    throw vital::invalid_value("Feature database already has a different "
+                               "quantization");
+  }
+  d_->quantization = q;
+  d_->has_quantization = true;
+}
+
+
+/// Get the quantization of the database
+bool
+feature_database
+::get_quantization(quantization& q) const
+{
+  std::lock_guard<std::mutex> lock(d_->mutex);
+  q = d_->quantization;
+  return d_->has_quantization;
+}
+
+
+/// Load the features and descriptors of a frame
+bool
+feature_database
+::load(vital::frame_id_t frame,
+       vital::feature_set_sptr& feat,
+       vital::descriptor_set_sptr& desc,
+       bool compact) const
+{
+  record_location loc;
+  {
+    std::lock_guard<std::mutex> lock(d_->mutex);
+    auto const i = d_->by_frame.find(frame);
+    if (i == d_->by_frame.end())
+    {
+      return false;
+    }
+    loc = i->second;
+  }
+  d_->load(loc, feat, desc, compact);
+  return true;
+}
+
+
+/// Load the features and descriptors recorded under a name
+bool
+feature_database
+::load(std::string const& name,
+       vital::feature_set_sptr& feat,
+       vital::descriptor_set_sptr& desc,
+       bool compact) const
+{
+  record_location loc;
+  {
+    std::lock_guard<std::mutex> lock(d_->mutex);
+    auto const i = d_->by_name.find(name);
+    if (i == d_->by_name.end())
+    {
+      return false;
+    }
+    loc = i->second;
+  }
+  d_->load(loc, feat, desc, compact);
+  return true;
+}
+
+
+/// Check whether the database has a record for a frame
+bool
+feature_database
+::contains(vital::frame_id_t frame) const
+{
+  std::lock_guard<std::mutex> lock(d_->mutex);
+  return d_->by_frame.count(frame) > 0;
+}
+
+
+/// Check whether the database has a record under a name
+bool
+feature_database
+::contains(std::string const& name) const
+{
+  std::lock_guard<std::mutex> lock(d_->mutex);
+  return d_->by_name.count(name) > 0;
+}
+
+
+/// Get the names of all records, keyed by frame number
+std::map<vital::frame_id_t, std::string>
+feature_database
+::frames() const
+{
+  std::lock_guard<std::mutex> lock(d_->mutex);
+  std::map<vital::frame_id_t, std::string> result;
+  for (auto const& nf : d_->name_frames)
+  {
+    result[nf.second] = nf.first;
+  }
+  return result;
+}
+
+
+/// Get the names of all records
+std::vector<std::string>
+feature_database
+::names() const
+{
+  std::lock_guard<std::mutex> lock(d_->mutex);
+  std::vector<std::string> result;
+  for (auto const& n : d_->by_name)
+  {
+    result.push_back(n.first);
+  }
+  return result;
+}
+
+
+/// Path of the database file
+vital::path_t const&
+feature_database
+::path() const
+{
+  return d_->path;
+}
+
+
+// ----------------------------------------------------------------------------
+/// Copy per-frame features files into a database
+size_t
+import_feature_files(feature_database& db,
+                     std::map<vital::frame_id_t, vital::path_t> const& files,
+                     vital::algo::feature_descriptor_io_sptr const& fd_io)
+{
+  size_t count = 0;
+  for (auto const& f : files)
+  {
+    if (!ST::FileExists(f.second, true))
+    {
+      continue;
+    }
+    vital::feature_set_sptr feat;
+    vital::descriptor_set_sptr desc;
+    fd_io->load(f.second, feat, desc);
+    db.append(ST::GetFilenameWithoutLastExtension(f.second), f.first,
+              feat, desc);
+    ++count;
+  }
+  return count;
+}
+
+
+/// Write every record of a database to a per-frame features file
+size_t
+export_feature_files(feature_database const& db, vital::path_t const& dir,
+                     vital::algo::feature_descriptor_io_sptr const& fd_io)
+{
+  if (!ST::FileIsDirectory(dir) && !ST::MakeDirectory(dir))
+  {
+    throw vital::file_write_exception(dir, "Unable to create features "
+                                      "directory");
+  }
+
+  size_t count = 0;
+  for (auto const& name : db.names())
+  {
+    vital::feature_set_sptr feat;
+    vital::descriptor_set_sptr desc;
+    if (db.load(name, feat, desc))
+    {
+      fd_io->save(dir + "/" + name + ".kwfd", feat, desc);
+      ++count;
+    }
+  }
+  return count;
+}
+
+} // end namespace maptk
+} // end namespace kwiver
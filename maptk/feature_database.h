@@ -0,0 +1,254 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for the single file feature and descriptor database
+ */
+
+#ifndef MAPTK_FEATURE_DATABASE_H_
+#define MAPTK_FEATURE_DATABASE_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/algo/feature_descriptor_io.h>
+#include <vital/types/descriptor_set.h>
+#include <vital/types/feature_set.h>
+#include <vital/vital_types.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// A file holding the features and descriptors of many frames
+/**
+ * The database replaces a directory of per-frame feature files with one
+ * append-only file.  Each record holds the features and descriptors of one
+ * frame together with the frame number and the name of the per-frame file it
+ * stands for.  Writing a frame again appends a new record which supersedes
+ * the old one.
+ *
+ * The offsets of the records are indexed in memory when the database is
+ * opened, and records are read through a memory map where the platform
+ * supports it.  A record left incomplete by an interrupted writer is
+ * discarded.  Appending is safe from several threads of one process, but
+ * only one process may write to a database at a time.
+ *
+ * Descriptors may be stored in a compact encoding.  Byte descriptors whose
+ * values are all zero or one, i.e. one bit per byte, are stored packed eight
+ * values to a byte.  Binary descriptors that are already packed, such as ORB
+ * or BRIEF, are stored as they are.  Floating point descriptors can be
+ * stored as 16-bit floats or as 8-bit integers with an offset and scale
+ * shared by the whole database.
+ *
+ * Features keep their covariance, and features stored from single precision
+ * features are loaded as vital::feature_f, others as vital::feature_d.
+ *
+ * The feature trackers read per-frame features files, so a database is
+ * converted to files with maptk_feature_database before tracking.
+ */
+class MAPTK_EXPORT feature_database
+{
+public:
+  /// How floating point descriptors are stored
+  enum class descriptor_encoding
+  {
+    /// The type produced by the extractor
+    native,
+    /// 16-bit floating point values
+    float16,
+    /// 8-bit integers with an offset and scale shared by the database
+    quantized8,
+  };
+
+  /// How quantized descriptor values map to their 8-bit codes
+  /**
+   * A value is stored as the code nearest to (value - offset) / scale,
+   * clamped to [0, 255].
+   */
+  struct quantization
+  {
+    float offset;
+    float scale;
+  };
+
+  /// Open or create a database
+  /**
+   * \param [in] path      Path of the database file.
+   * \param [in] writable  Whether to allow appending.  If true, the file is
+   *                       created if it does not exist.
+   *
+   * \throws vital::file_not_found_exception
+   *   if \p writable is false and the file does not exist.
+   * \throws vital::invalid_file
+   *   if the file is not a feature database.
+   */
+  explicit feature_database(vital::path_t const& path, bool writable = false);
+
+  /// Destructor
+  ~feature_database();
+
+  /// Append the features and descriptors of a frame
+  /**
+   * \param [in] name   Name of the per-frame features file, without
+   *                    directory or extension.
+   * \param [in] frame  Frame number, or -1 if it is not known.
+   * \param [in] feat   Features of the frame; may be null.
+   * \param [in] desc   Descriptors of the frame; may be null.
+   *
+   * \throws vital::invalid_value
+   *   if the descriptors of the frame differ in size.
+   */
+  void append(std::string const& name, vital::frame_id_t frame,
+              vital::feature_set_sptr const& feat,
+              vital::descriptor_set_sptr const& desc);
+
+  /// Set the encoding of floating point descriptors appended from now on
+  void set_descriptor_encoding(descriptor_encoding encoding);
+
+  /// Get the encoding of floating point descriptors appended from now on
+  descriptor_encoding get_descriptor_encoding() const;
+
+  /// Set the quantization of the database
+  /**
+   * All quantized records of a database share one quantization.  Unless set
+   * here, it is taken from the range of the descriptor values of the first
+   * frame appended with the quantized8 encoding, and values of later frames
+   * outside that range are clamped.
+   *
+   * \throws vital::invalid_value
+   *   if the database already holds quantized records with a different
+   *   quantization.
+   */
+  void set_quantization(quantization const& q);
+
+  /// Get the quantization of the database
+  /**
+   * \returns false if the quantization is not yet fixed.
+   */
+  bool get_quantization(quantization& q) const;
+
+  /// Load the features and descriptors of a frame
+  /**
+   * If \p compact is true, descriptors stored bit-packed or quantized are
+   * returned in their stored form as byte descriptors instead of being
+   * expanded.  Packed binary descriptors are then in the form taken by
+   * match_features_hamming, and have the same Hamming distances as the
+   * expanded ones.  Since all frames share the quantization of the
+   * database, quantized descriptors of any two frames can be compared by
+   * Euclidean distance, which is the original distance divided by the
+   * quantization scale, up to rounding and clamping.
+   *
+   * Compact loading is for callers that match descriptors read from the
+   * database themselves.  The feature trackers do not read the database
+   * (see above), so they still match the descriptors they extract.
+   *
+   * \returns false if the database has no record for \p frame.
+   */
+  bool load(vital::frame_id_t frame,
+            vital::feature_set_sptr& feat,
+            vital::descriptor_set_sptr& desc,
+            bool compact = false) const;
+
+  /// Load the features and descriptors recorded under a name
+  /**
+   * \see load(vital::frame_id_t, vital::feature_set_sptr&,
+   *           vital::descriptor_set_sptr&, bool) const
+   *
+   * \returns false if the database has no record for \p name.
+   */
+  bool load(std::string const& name,
+            vital::feature_set_sptr& feat,
+            vital::descriptor_set_sptr& desc,
+            bool compact = false) const;
+
+  /// Check whether the database has a record for a frame
+  bool contains(vital::frame_id_t frame) const;
+
+  /// Check whether the database has a record under a name
+  bool contains(std::string const& name) const;
+
+  /// Get the names of all records, keyed by frame number
+  /**
+   * Records written without a frame number are not included.
+   */
+  std::map<vital::frame_id_t, std::string> frames() const;
+
+  /// Get the names of all records
+  std::vector<std::string> names() const;
+
+  /// Path of the database file
+  vital::path_t const& path() const;
+
+private:
+  class priv;
+  std::unique_ptr<priv> const d_;
+};
+
+/// Copy per-frame features files into a database
+/**
+ * \param [in] db     The database to append to.
+ * \param [in] files  Features files, keyed by frame number.
+ * \param [in] fd_io  Algorithm used to read the features files.
+ *
+ * \returns the number of files copied.
+ */
+MAPTK_EXPORT
+size_t
+import_feature_files(feature_database& db,
+                     std::map<vital::frame_id_t, vital::path_t> const& files,
+                     vital::algo::feature_descriptor_io_sptr const& fd_io);
+
+/// Write every record of a database to a per-frame features file
+/**
+ * Each record is written to \c <name>.kwfd in \p dir, where \c name is the
+ * name under which the record was appended.
+ *
+ * \param [in] db     The database to read.
+ * \param [in] dir    Directory in which to write the features files.
+ * \param [in] fd_io  Algorithm used to write the features files.
+ *
+ * \returns the number of files written.
+ */
+MAPTK_EXPORT
+size_t
+export_feature_files(feature_database const& db, vital::path_t const& dir,
+                     vital::algo::feature_descriptor_io_sptr const& fd_io);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif // MAPTK_FEATURE_DATABASE_H_
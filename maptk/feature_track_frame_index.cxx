@@ -0,0 +1,190 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of a compressed frame index of pooled feature tracks
+ */
+
+#include "feature_track_frame_index.h"
+#include "parallel_for.h"
+
+#include <vital/util/thread_pool.h>
+
+#include <algorithm>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Create an empty index
+feature_track_frame_index
+::feature_track_frame_index()
+  : first_frame_(0),
+    offsets_(1, 0)
+{
+}
+
+
+/// Index the states of a pool
+feature_track_frame_index
+::feature_track_frame_index(feature_track_pool const& pool,
+                            unsigned num_threads)
+  : feature_track_frame_index()
+{
+  if (pool.num_states() == 0)
+  {
+    return;
+  }
+
+  // The states of each track are ordered by frame, so the frame range comes
+  // from the ends of the tracks
+  vital::frame_id_t min_frame = pool.state_at(0).frame;
+  vital::frame_id_t max_frame = min_frame;
+  for (size_t i = 0; i < pool.size(); ++i)
+  {
+    auto const& t = pool.track(i);
+    if (!t.empty())
+    {
+      min_frame = std::min(min_frame, t.front().frame);
+      max_frame = std::max(max_frame, t.back().frame);
+    }
+  }
+  first_frame_ = min_frame;
+  size_t const num_frames = static_cast<size_t>(max_frame - min_frame + 1);
+
+  if (num_threads == 0)
+  {
+    num_threads = static_cast<unsigned>(
+      vital::thread_pool::instance().num_threads());
+  }
+  size_t const num_ranges =
+    std::max<size_t>(std::min<size_t>(num_threads, pool.size()), 1);
+
+  // The tracks are split into fixed ranges, each handled by one task, so the
+  // entries of a frame end up in track order regardless of the scheduling
+  auto const tracks_begin = [&](size_t t)
+  {
+    return pool.size() * t / num_ranges;
+  };
+  // Count the states of each frame in each range of tracks
+  std::vector<std::vector<size_t>> cursors(num_ranges);
+  parallel_for_blocks(num_ranges, 1, [&](size_t t, size_t)
+  {
+    auto& counts = cursors[t];
+    counts.assign(num_frames, 0);
+    for (size_t i = tracks_begin(t); i < tracks_begin(t + 1); ++i)
+    {
+      for (auto const& s : pool.track(i))
+      {
+        ++counts[static_cast<size_t>(s.frame - first_frame_)];
+      }
+    }
+  }, num_threads);
+
+  // Turn the counts into the position where each range of tracks writes the
+  // entries of each frame
+  offsets_.assign(num_frames + 1, 0);
+  for (size_t f = 0; f < num_frames; ++f)
+  {
+    size_t pos = offsets_[f];
+    for (auto& counts : cursors)
+    {
+      size_t const n = counts[f];
+      counts[f] = pos;
+      pos += n;
+    }
+    offsets_[f + 1] = pos;
+  }
+
+  entries_.resize(pool.num_states());
+  parallel_for_blocks(num_ranges, 1, [&](size_t t, size_t)
+  {
+    auto& cursor = cursors[t];
+    for (size_t i = tracks_begin(t); i < tracks_begin(t + 1); ++i)
+    {
+      auto const& track = pool.track(i);
+      for (auto s = track.begin(); s != track.end(); ++s)
+      {
+        auto const f = static_cast<size_t>(s->frame - first_frame_);
+        entries_[cursor[f]++] = entry{ track.id(), s.index() };
+      }
+    }
+  }, num_threads);
+}
+
+
+/// Get the entries of the states on a frame
+feature_track_frame_index::slice
+feature_track_frame_index
+::frame_states(vital::frame_id_t frame) const
+{
+  if (entries_.empty() || frame < first_frame_ || frame > this->last_frame())
+  {
+    return slice();
+  }
+  auto const i = static_cast<size_t>(frame - first_frame_);
+  return slice(entries_.data() + offsets_[i], entries_.data() + offsets_[i + 1]);
+}
+
+
+/// Add a state to the index
+void
+feature_track_frame_index
+::append(vital::frame_id_t frame, vital::track_id_t track_id, size_t state)
+{
+  if (entries_.empty())
+  {
+    first_frame_ = frame;
+    offsets_.assign(2, 0);
+  }
+  else if (frame < first_frame_)
+  {
+    offsets_.insert(offsets_.begin(),
+                    static_cast<size_t>(first_frame_ - frame), 0);
+    first_frame_ = frame;
+  }
+  else if (frame > this->last_frame())
+  {
+    offsets_.resize(static_cast<size_t>(frame - first_frame_) + 2,
+                    entries_.size());
+  }
+
+  auto const i = static_cast<size_t>(frame - first_frame_);
+  entries_.insert(entries_.begin() + static_cast<ptrdiff_t>(offsets_[i + 1]),
+                  entry{ track_id, state });
+  for (size_t j = i + 1; j < offsets_.size(); ++j)
+  {
+    ++offsets_[j];
+  }
+}
+
+} // end namespace maptk
+} // end namespace kwiver
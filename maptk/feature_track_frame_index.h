@@ -0,0 +1,141 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for a compressed frame index of pooled feature tracks
+ */
+
+#ifndef MAPTK_FEATURE_TRACK_FRAME_INDEX_H_
+#define MAPTK_FEATURE_TRACK_FRAME_INDEX_H_
+
+#include <maptk/maptk_export.h>
+#include <maptk/feature_track_pool.h>
+
+#include <vital/vital_types.h>
+
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Index of the states of a feature track pool by frame
+/**
+ * The index is stored in compressed sparse row form: the entries of all
+ * frames are in one array, ordered by frame, and an array of offsets gives
+ * the range of each frame.  The states of a frame are therefore a single
+ * contiguous slice, found in constant time.
+ *
+ * Within a frame, entries are in the order of the tracks in the pool when
+ * the index is built from a pool, and in the order they were appended
+ * after that.  An index can follow a pool that is updated with
+ * feature_track_pool::append_new_frames() by appending the added states.
+ */
+class MAPTK_EXPORT feature_track_frame_index
+{
+public:
+  /// A reference to one state of the pool
+  struct entry
+  {
+    /// ID of the track of the state
+    vital::track_id_t track_id;
+    /// Index of the state in the pool, as given to state_at()
+    size_t state;
+  };
+
+  /// The entries of one frame
+  class slice
+  {
+  public:
+    slice() = default;
+    slice(entry const* begin, entry const* end)
+      : begin_(begin), end_(end) {}
+
+    size_t size() const { return static_cast<size_t>(end_ - begin_); }
+    bool empty() const { return begin_ == end_; }
+
+    entry const* begin() const { return begin_; }
+    entry const* end() const { return end_; }
+    entry const& operator[](size_t i) const { return begin_[i]; }
+
+  private:
+    entry const* begin_ = nullptr;
+    entry const* end_ = nullptr;
+  };
+
+  /// Create an empty index
+  feature_track_frame_index();
+
+  /// Index the states of a pool
+  /**
+   * \param [in] pool         The pool to index.
+   * \param [in] num_threads  Number of threads to use, or 0 for one per core.
+   */
+  explicit feature_track_frame_index(feature_track_pool const& pool,
+                                     unsigned num_threads = 0);
+
+  /// Number of indexed states
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  /// First frame with an indexed state; undefined if the index is empty
+  vital::frame_id_t first_frame() const { return first_frame_; }
+
+  /// Last frame with an indexed state; undefined if the index is empty
+  vital::frame_id_t last_frame() const
+  {
+    return first_frame_ + static_cast<vital::frame_id_t>(offsets_.size()) - 2;
+  }
+
+  /// Get the entries of the states on a frame
+  slice frame_states(vital::frame_id_t frame) const;
+
+  /// Add a state to the index
+  /**
+   * This is constant time when \p frame is not before the last frame of
+   * the index, which is the case when states are appended as frames are
+   * tracked.  Otherwise the entries of the later frames are moved.
+   */
+  void append(vital::frame_id_t frame, vital::track_id_t track_id,
+              size_t state);
+
+private:
+  vital::frame_id_t first_frame_;
+  // The entries of frame first_frame_ + i are [offsets_[i], offsets_[i + 1])
+  std::vector<size_t> offsets_;
+  std::vector<entry> entries_;
+};
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif
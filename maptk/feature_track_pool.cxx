@@ -0,0 +1,324 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of compact pooled storage of feature tracks
+ */
+
+#include "feature_track_pool.h"
+
+#include <vital/types/feature.h>
+
+#include <algorithm>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Index used for "no state"
+size_t const feature_track_pool::npos = static_cast<size_t>(-1);
+
+
+/// Find the state of the track on a frame, or null if there is none
+feature_track_pool::state const*
+feature_track_pool::track_view
+::find(vital::frame_id_t frame) const
+{
+  if (size_ == 0 || frame < this->front().frame || frame > this->back().frame)
+  {
+    return nullptr;
+  }
+  for (auto const& s : *this)
+  {
+    if (s.frame >= frame)
+    {
+      return s.frame == frame ? &s : nullptr;
+    }
+  }
+  return nullptr;
+}
+
+
+/// Create an empty pool
+feature_track_pool
+::feature_track_pool()
+  : last_frame_(0)
+{
+}
+
+
+/// Copy the feature tracks of a track set
+feature_track_pool
+::feature_track_pool(vital::feature_track_set const& tracks)
+  : feature_track_pool()
+{
+  auto all_tracks = tracks.tracks();
+  std::sort(all_tracks.begin(), all_tracks.end(),
+            [](vital::track_sptr const& a, vital::track_sptr const& b)
+            { return a->id() < b->id(); });
+
+  size_t num_states = 0;
+  for (auto const& t : all_tracks)
+  {
+    num_states += t->size();
+  }
+  this->reserve(all_tracks.size(), num_states);
+
+  // Tracks are added in order of ID, so each append is to the last track
+  for (auto const& t : all_tracks)
+  {
+    for (auto const& ts : *t)
+    {
+      auto const fts =
+        std::dynamic_pointer_cast<vital::feature_track_state>(ts);
+      if (fts && fts->feature)
+      {
+        this->append(t->id(), make_state(*fts));
+      }
+    }
+  }
+}
+
+
+/// Get the track at an index in [0, size())
+feature_track_pool::track_view
+feature_track_pool
+::track(size_t index) const
+{
+  auto const& e = tracks_[index];
+  return track_view(this, ids_[index], e.first, e.last, e.size);
+}
+
+
+/// Find a track by ID; the result is empty if there is no such track
+feature_track_pool::track_view
+feature_track_pool
+::find_track(vital::track_id_t id) const
+{
+  auto const i = std::lower_bound(ids_.begin(), ids_.end(), id);
+  if (i == ids_.end() || *i != id)
+  {
+    return track_view();
+  }
+  return this->track(static_cast<size_t>(i - ids_.begin()));
+}
+
+
+/// Find the state of a track on a frame, or null if there is none
+feature_track_pool::state*
+feature_track_pool
+::find_state(vital::track_id_t id, vital::frame_id_t frame)
+{
+  auto const t = this->find_track(id);
+  for (auto i = t.begin(); i != t.end(); ++i)
+  {
+    if (i->frame >= frame)
+    {
+      return i->frame == frame ? &states_[i.index()] : nullptr;
+    }
+  }
+  return nullptr;
+}
+
+
+/// Reserve space for a number of tracks and states
+void
+feature_track_pool
+::reserve(size_t num_tracks, size_t num_states)
+{
+  ids_.reserve(num_tracks);
+  tracks_.reserve(num_tracks);
+  next_.reserve(num_states);
+  states_.reserve(num_states);
+}
+
+
+/// Add a state to the end of a track, creating the track if needed
+bool
+feature_track_pool
+::append(vital::track_id_t id, state const& s)
+{
+  auto i = ids_.end();
+  if (ids_.empty() || ids_.back() != id)
+  {
+    i = std::lower_bound(ids_.begin(), ids_.end(), id);
+  }
+  else
+  {
+    --i;
+  }
+
+  size_t const index = states_.size();
+  if (i != ids_.end() && *i == id)
+  {
+    auto& e = tracks_[static_cast<size_t>(i - ids_.begin())];
+    if (s.frame <= states_[e.last].frame)
+    {
+      return false;
+    }
+    next_[e.last] = index;
+    e.last = index;
+    ++e.size;
+  }
+  else
+  {
+    tracks_.insert(tracks_.begin() + (i - ids_.begin()),
+                   track_entry{ index, index, 1 });
+    ids_.insert(i, id);
+  }
+
+  if (states_.empty() || s.frame > last_frame_)
+  {
+    last_frame_ = s.frame;
+  }
+  states_.push_back(s);
+  next_.push_back(npos);
+  return true;
+}
+
+
+/// Copy the states of a track set on frames after the last frame
+bool
+feature_track_pool
+::append_new_frames(vital::feature_track_set const& tracks,
+                    std::vector<added_state>& added)
+{
+  if (states_.empty())
+  {
+    return false;
+  }
+
+  // Collect the new states, checking that the old ones match the pool
+  std::vector<std::pair<vital::track_id_t,
+                        vital::feature_track_state const*>> new_states;
+  size_t num_old = 0;
+  for (auto const& t : tracks.tracks())
+  {
+    size_t track_old = 0;
+    for (auto const& ts : *t)
+    {
+      auto const fts =
+        dynamic_cast<vital::feature_track_state const*>(ts.get());
+      if (!fts || !fts->feature)
+      {
+        continue;
+      }
+      if (fts->frame() <= last_frame_)
+      {
+        ++track_old;
+      }
+      else
+      {
+        new_states.emplace_back(t->id(), fts);
+      }
+    }
+    if (track_old != this->find_track(t->id()).size())
+    {
+      return false;
+    }
+    num_old += track_old;
+  }
+  if (num_old != states_.size())
+  {
+    return false;
+  }
+
+  std::sort(new_states.begin(), new_states.end(),
+            [](std::pair<vital::track_id_t,
+                         vital::feature_track_state const*> const& a,
+               std::pair<vital::track_id_t,
+                         vital::feature_track_state const*> const& b)
+            {
+              auto const fa = a.second->frame();
+              auto const fb = b.second->frame();
+              return fa < fb || (fa == fb && a.first < b.first);
+            });
+
+  added.clear();
+  added.reserve(new_states.size());
+  for (auto const& n : new_states)
+  {
+    if (this->append(n.first, make_state(*n.second)))
+    {
+      added.push_back(added_state{ n.first, states_.size() - 1 });
+    }
+  }
+  return true;
+}
+
+
+/// Create a vital track set holding the same tracks
+vital::feature_track_set_sptr
+feature_track_pool
+::to_track_set() const
+{
+  std::vector<vital::track_sptr> tracks;
+  tracks.reserve(ids_.size());
+  for (size_t i = 0; i < ids_.size(); ++i)
+  {
+    auto const t = vital::track::create();
+    t->set_id(ids_[i]);
+    for (auto const& s : this->track(i))
+    {
+      auto const feat = std::make_shared<vital::feature_d>(
+        s.loc, s.magnitude, s.scale, s.angle, s.color);
+      feat->set_covar(s.covar);
+      auto const fts = std::make_shared<vital::feature_track_state>(
+        s.frame, feat, s.descriptor);
+      fts->inlier = s.inlier;
+      t->append(fts);
+    }
+    tracks.push_back(t);
+  }
+  return std::make_shared<vital::feature_track_set>(tracks);
+}
+
+
+/// Copy a vital feature track state into a pool state
+feature_track_pool::state
+feature_track_pool
+::make_state(vital::feature_track_state const& fts)
+{
+  state s;
+  s.frame = fts.frame();
+  s.loc = fts.feature->loc();
+  s.covar = fts.feature->covar();
+  s.magnitude = fts.feature->magnitude();
+  s.scale = fts.feature->scale();
+  s.angle = fts.feature->angle();
+  s.color = fts.feature->color();
+  s.inlier = fts.inlier;
+  s.descriptor = fts.descriptor;
+  return s;
+}
+
+} // end namespace maptk
+} // end namespace kwiver
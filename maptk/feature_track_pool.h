@@ -0,0 +1,287 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for compact pooled storage of feature tracks
+ */
+
+#ifndef MAPTK_FEATURE_TRACK_POOL_H_
+#define MAPTK_FEATURE_TRACK_POOL_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/color.h>
+#include <vital/types/covariance.h>
+#include <vital/types/descriptor.h>
+#include <vital/types/feature_track_set.h>
+#include <vital/types/vector.h>
+#include <vital/vital_types.h>
+
+#include <Eigen/Core>
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Compact storage of feature tracks
+/**
+ * The states of all tracks are stored by value in one array, without the
+ * separate heap allocations of a vital::feature_track_state and its
+ * feature, so iterating them needs no allocation or run-time type checks.
+ * Each track is a chain of states ordered by frame, and the tracks are
+ * ordered by ID.
+ *
+ * States are only ever appended, so the index of a state never changes.
+ * A state can be appended to any track, which lets a pool follow a track
+ * set as frames are tracked without being rebuilt; see append_new_frames().
+ * A pool built from a track set keeps the states of each track next to
+ * each other.
+ *
+ * A pool is a copy of the tracks it is built from.  It can be converted
+ * back with to_track_set() for use with algorithms that take vital track
+ * sets.
+ */
+class MAPTK_EXPORT feature_track_pool
+{
+public:
+  /// A feature track state stored by value
+  struct state
+  {
+    vital::frame_id_t frame;
+    vital::vector_2d loc;
+    vital::covariance_2d covar;
+    double magnitude;
+    double scale;
+    double angle;
+    vital::rgb_color color;
+    bool inlier;
+    vital::descriptor_sptr descriptor;
+  };
+
+  /// A state added to the pool, as reported by append_new_frames()
+  struct added_state
+  {
+    /// ID of the track of the state
+    vital::track_id_t track_id;
+    /// Index of the state in the pool, as given to state_at()
+    size_t state;
+  };
+
+  /// Index used for "no state"
+  static size_t const npos;
+
+  /// The states of one track, ordered by frame
+  class track_view
+  {
+  public:
+    /// Iterator over the states of a track
+    class iterator
+    {
+    public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef state value_type;
+      typedef ptrdiff_t difference_type;
+      typedef state const* pointer;
+      typedef state const& reference;
+
+      iterator() = default;
+
+      state const& operator*() const { return pool_->states_[index_]; }
+      state const* operator->() const { return &pool_->states_[index_]; }
+
+      iterator& operator++()
+      {
+        index_ = pool_->next_[index_];
+        return *this;
+      }
+      iterator operator++(int)
+      {
+        iterator const prev = *this;
+        ++*this;
+        return prev;
+      }
+
+      bool operator==(iterator const& other) const
+      { return index_ == other.index_; }
+      bool operator!=(iterator const& other) const
+      { return index_ != other.index_; }
+
+      /// Index of the state in the pool, as given to state_at()
+      size_t index() const { return index_; }
+
+    private:
+      friend class track_view;
+      iterator(feature_track_pool const* pool, size_t index)
+        : pool_(pool), index_(index) {}
+
+      feature_track_pool const* pool_ = nullptr;
+      size_t index_ = npos;
+    };
+
+    track_view() = default;
+
+    /// ID of the track
+    vital::track_id_t id() const { return id_; }
+
+    /// Number of states of the track
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    iterator begin() const { return iterator(pool_, first_); }
+    iterator end() const { return iterator(pool_, npos); }
+
+    /// First and last state of the track; undefined if the track is empty
+    state const& front() const { return pool_->states_[first_]; }
+    state const& back() const { return pool_->states_[last_]; }
+
+    /// Find the state of the track on a frame, or null if there is none
+    state const* find(vital::frame_id_t frame) const;
+
+  private:
+    friend class feature_track_pool;
+    track_view(feature_track_pool const* pool, vital::track_id_t id,
+               size_t first, size_t last, size_t size)
+      : pool_(pool), id_(id), first_(first), last_(last), size_(size) {}
+
+    feature_track_pool const* pool_ = nullptr;
+    vital::track_id_t id_ = -1;
+    size_t first_ = npos;
+    size_t last_ = npos;
+    size_t size_ = 0;
+  };
+
+  /// Create an empty pool
+  feature_track_pool();
+
+  /// Copy the feature tracks of a track set
+  /**
+   * States that are not feature track states with a feature are skipped.
+   */
+  explicit feature_track_pool(vital::feature_track_set const& tracks);
+
+  /// Number of tracks
+  size_t size() const { return ids_.size(); }
+  bool empty() const { return ids_.empty(); }
+
+  /// Number of states of all tracks
+  size_t num_states() const { return states_.size(); }
+
+  /// Last frame with a state; undefined if the pool has no states
+  vital::frame_id_t last_frame() const { return last_frame_; }
+
+  /// Get the track at an index in [0, size())
+  /**
+   * Tracks are indexed in order of ID, so the index of a track changes if a
+   * track with a lower ID is added.
+   */
+  track_view track(size_t index) const;
+
+  /// Get the state at an index in [0, num_states())
+  /**
+   * States are indexed in the order they were added.  The indices of
+   * existing states do not change as states are appended.
+   */
+  state const& state_at(size_t index) const { return states_[index]; }
+  state& state_at(size_t index) { return states_[index]; }
+
+  /// Find a track by ID; the result is empty if there is no such track
+  track_view find_track(vital::track_id_t id) const;
+
+  /// Find the state of a track on a frame, or null if there is none
+  state* find_state(vital::track_id_t id, vital::frame_id_t frame);
+
+  /// Reserve space for a number of tracks and states
+  void reserve(size_t num_tracks, size_t num_states);
+
+  /// Add a state to the end of a track, creating the track if needed
+  /**
+   * This is constant time when \p id is the ID of the last track, and
+   * logarithmic in the number of tracks otherwise, unless a track is
+   * created before the last one.
+   *
+   * \returns false, without adding the state, if \p s is not after the
+   *          last state of the track
+   */
+  bool append(vital::track_id_t id, state const& s);
+
+  /// Copy the states of a track set on frames after the last frame
+  /**
+   * This brings the pool up to date with a track set that has only gained
+   * states on later frames since the pool was built from it, as happens
+   * while a tracker adds frames.  Only the new states are read, in order of
+   * frame then track ID, and are reported in \p added in that order.
+   *
+   * If the track set differs from the pool up to the last frame of the
+   * pool, for example because tracks were merged, or if the pool is empty,
+   * nothing is changed and the pool must be rebuilt.
+   *
+   * \returns false if the pool was not updated
+   */
+  bool append_new_frames(vital::feature_track_set const& tracks,
+                         std::vector<added_state>& added);
+
+  /// Create a vital track set holding the same tracks
+  /**
+   * The states of the new track set share the descriptors of the pool.
+   * Features become vital::feature_d.
+   */
+  vital::feature_track_set_sptr to_track_set() const;
+
+  /// Copy a vital feature track state into a pool state
+  static state make_state(vital::feature_track_state const& fts);
+
+private:
+  /// The chain of states of a track
+  struct track_entry
+  {
+    size_t first;
+    size_t last;
+    size_t size;
+  };
+
+  std::vector<vital::track_id_t> ids_;
+  // The states of the track with ID ids_[i]
+  std::vector<track_entry> tracks_;
+  // The next state of the same track as each state, or npos
+  std::vector<size_t> next_;
+  std::vector<state, Eigen::aligned_allocator<state>> states_;
+  vital::frame_id_t last_frame_;
+};
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif
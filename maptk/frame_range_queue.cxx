@@ -0,0 +1,444 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of a shared frame range work queue
+ */
+
+#include "frame_range_queue.h"
+
+#include <vital/exceptions.h>
+#include <vital/logger/logger.h>
+
+#include <kwiversys/SystemInformation.hxx>
+#include <kwiversys/SystemTools.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+typedef kwiversys::SystemTools ST;
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+static char const* const MANIFEST_HEADER =
+  "# TeleSculptor frame range manifest v1";
+
+
+/// Create a file only if it does not already exist
+bool
+create_exclusive(std::string const& path, std::string const& contents)
+{
+  auto* f = std::fopen(path.c_str(), "wx");
+  if (!f)
+  {
+    return false;
+  }
+  std::fputs(contents.c_str(), f);
+  std::fclose(f);
+  return true;
+}
+
+
+/// Replace the contents of a file so that readers never see a partial file
+bool
+write_atomic(std::string const& path, std::string const& contents,
+             std::string const& worker_id)
+{
+  auto const tmp_path = path + "." + worker_id + ".tmp";
+  {
+    std::ofstream ofs(tmp_path.c_str());
+    if (!ofs)
+    {
+      return false;
+    }
+    ofs << contents;
+  }
+  if (!ST::RenameFile(tmp_path.c_str(), path.c_str()))
+  {
+    ST::RemoveFile(tmp_path);
+    return false;
+  }
+  return true;
+}
+
+
+/// Read the contents of a file
+std::string
+read_file(std::string const& path)
+{
+  std::ifstream ifs(path.c_str());
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  return ss.str();
+}
+
+} // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+/// Private implementation class
+class frame_range_queue::priv
+{
+public:
+  /// Path of a state file of a range
+  std::string range_path(size_t index, char const* suffix) const
+  {
+    std::ostringstream ss;
+    ss << queue_dir << "/range_" << std::setw(6) << std::setfill('0')
+       << index << suffix;
+    return ss.str();
+  }
+
+  /// Number of ranges in the queue
+  size_t num_ranges() const
+  {
+    return (frames.size() + range_size - 1) / range_size;
+  }
+
+  /// Current time according to the file system holding the queue
+  /**
+   * Claims are aged by comparing modification times set by the file server,
+   * so that clock differences between the hosts of the workers do not make
+   * live claims look stale.  This writes a file of this worker and returns
+   * its modification time, or 0 if it could not be written.
+   */
+  long file_system_time() const
+  {
+    auto const probe_path = queue_dir + "/.time." + file_token;
+    {
+      std::ofstream ofs(probe_path.c_str());
+      if (!ofs)
+      {
+        return 0;
+      }
+      ofs << worker_id << "\n";
+    }
+    return ST::ModifiedTime(probe_path);
+  }
+
+  /// Check whether a claim file was written by this worker
+  bool owns_claim(std::string const& claim_path) const
+  {
+    return read_file(claim_path) == worker_id + "\n";
+  }
+
+  /// Try to take over a claim that has not been refreshed in time
+  bool steal_stale_claim(std::string const& claim_path) const
+  {
+    auto const mtime = ST::ModifiedTime(claim_path);
+    auto const now = file_system_time();
+    if (mtime == 0 || now == 0 ||
+        static_cast<double>(now - mtime) < claim_timeout)
+    {
+      return false;
+    }
+    // only one worker can move the stale claim out of the way
+    auto const stale_path = claim_path + ".stale." + file_token;
+    if (!ST::RenameFile(claim_path.c_str(), stale_path.c_str()))
+    {
+      return false;
+    }
+    LOG_WARN(logger, "Reclaiming stale claim " << claim_path);
+    ST::RemoveFile(stale_path);
+    return true;
+  }
+
+  /// Start refreshing claims in the background, if not already started
+  void start_heartbeat()
+  {
+    if (heartbeat.joinable())
+    {
+      return;
+    }
+    auto const interval = std::chrono::duration<double>(claim_timeout / 4);
+    heartbeat = std::thread([this, interval]()
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (!stop)
+      {
+        if (cv.wait_for(lock, interval, [this]{ return stop; }))
+        {
+          break;
+        }
+        for (auto c = claims.begin(); c != claims.end(); )
+        {
+          // stop refreshing a claim that another worker has taken over, so
+          // that its new owner is not kept alive by this worker
+          if (!owns_claim(c->second))
+          {
+            LOG_WARN(logger, "Lost claim " << c->second);
+            c = claims.erase(c);
+            continue;
+          }
+          ST::Touch(c->second, false);
+          ++c;
+        }
+      }
+    });
+  }
+
+  /// Remove the lock file of a claim if it still belongs to this worker
+  void remove_claim_file(std::string const& claim_path) const
+  {
+    if (owns_claim(claim_path))
+    {
+      ST::RemoveFile(claim_path);
+    }
+    else
+    {
+      LOG_WARN(logger, "Claim " << claim_path << " was taken over by "
+                       "another worker; leaving it in place");
+    }
+  }
+
+  /// Drop a claim and remove its lock file
+  void drop_claim(size_t index)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto const c = claims.find(index);
+    if (c != claims.end())
+    {
+      remove_claim_file(c->second);
+      claims.erase(c);
+    }
+  }
+
+  vital::path_t queue_dir;
+  std::vector<vital::frame_id_t> frames;
+  size_t range_size = 1;
+  double claim_timeout = 600.0;
+  std::string worker_id;
+  std::string file_token;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::map<size_t, std::string> claims;
+  bool stop = false;
+  std::thread heartbeat;
+
+  vital::logger_handle_t logger = vital::get_logger("maptk.frame_range_queue");
+};
+
+
+// ----------------------------------------------------------------------------
+/// Constructor
+frame_range_queue
+::frame_range_queue(vital::path_t const& queue_dir,
+                    std::vector<vital::frame_id_t> const& frames,
+                    size_t range_size, double claim_timeout)
+  : d_(new priv)
+{
+  d_->queue_dir = queue_dir;
+  d_->frames = frames;
+  d_->range_size = std::max<size_t>(range_size, 1);
+  d_->claim_timeout = claim_timeout;
+
+  kwiversys::SystemInformation info;
+  d_->worker_id = std::string(info.GetHostname()) + ":" +
+                  std::to_string(info.GetProcessId());
+  d_->file_token = d_->worker_id;
+  std::replace(d_->file_token.begin(), d_->file_token.end(), ':', '.');
+
+  if (!ST::FileIsDirectory(queue_dir) && !ST::MakeDirectory(queue_dir))
+  {
+    throw vital::file_write_exception(queue_dir, "Unable to create work "
+                                      "queue directory");
+  }
+
+  // All workers must agree on how the frames are divided into ranges
+  std::ostringstream params;
+  params << "frames " << frames.size();
+  if (!frames.empty())
+  {
+    params << " " << frames.front() << " " << frames.back();
+  }
+  params << "\nrange_size " << d_->range_size << "\n";
+
+  auto const params_path = queue_dir + "/queue.txt";
+  if (!ST::FileExists(params_path))
+  {
+    write_atomic(params_path, params.str(), d_->file_token);
+  }
+  if (read_file(params_path) != params.str())
+  {
+    throw vital::invalid_value("Work queue " + queue_dir + " was created for "
+                               "a different set of frames or range size");
+  }
+}
+
+
+/// Destructor
+frame_range_queue
+::~frame_range_queue()
+{
+  {
+    std::lock_guard<std::mutex> lock(d_->mutex);
+    d_->stop = true;
+    for (auto const& c : d_->claims)
+    {
+      d_->remove_claim_file(c.second);
+    }
+    d_->claims.clear();
+  }
+  d_->cv.notify_all();
+  if (d_->heartbeat.joinable())
+  {
+    d_->heartbeat.join();
+  }
+  ST::RemoveFile(d_->queue_dir + "/.time." + d_->file_token);
+}
+
+
+/// Claim the next range that is neither completed nor claimed
+bool
+frame_range_queue
+::claim(frame_range& range)
+{
+  for (size_t i = 0; i < d_->num_ranges(); ++i)
+  {
+    auto const done_path = d_->range_path(i, ".done");
+    auto const claim_path = d_->range_path(i, ".claim");
+    if (ST::FileExists(done_path))
+    {
+      continue;
+    }
+
+    if (!create_exclusive(claim_path, d_->worker_id + "\n") &&
+        !(d_->steal_stale_claim(claim_path) &&
+          create_exclusive(claim_path, d_->worker_id + "\n")))
+    {
+      continue;
+    }
+
+    // the range may have been completed since it was checked above
+    if (ST::FileExists(done_path))
+    {
+      ST::RemoveFile(claim_path);
+      continue;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(d_->mutex);
+      d_->claims[i] = claim_path;
+      d_->start_heartbeat();
+    }
+
+    auto const begin = d_->frames.begin() + i * d_->range_size;
+    auto const end = d_->frames.begin() +
+      std::min(d_->frames.size(), (i + 1) * d_->range_size);
+    range.index = i;
+    range.frames.assign(begin, end);
+    LOG_INFO(d_->logger, "Worker " << d_->worker_id << " claimed frames "
+                         << range.frames.front() << " to "
+                         << range.frames.back());
+    return true;
+  }
+  return false;
+}
+
+
+/// Record the outputs of the claimed range and release its claim
+void
+frame_range_queue
+::complete(frame_range const& range,
+           std::vector<vital::path_t> const& outputs)
+{
+  std::ostringstream ss;
+  ss << "range " << range.index << " " << range.frames.front() << " "
+     << range.frames.back() << " " << d_->worker_id << "\n";
+  for (auto const& o : outputs)
+  {
+    ss << "output " << o << "\n";
+  }
+
+  auto const done_path = d_->range_path(range.index, ".done");
+  if (!write_atomic(done_path, ss.str(), d_->file_token))
+  {
+    throw vital::file_write_exception(done_path, "Unable to record "
+                                      "completed range");
+  }
+  d_->drop_claim(range.index);
+}
+
+
+/// Release the claim on a range without completing it
+void
+frame_range_queue
+::release(frame_range const& range)
+{
+  d_->drop_claim(range.index);
+}
+
+
+/// Write the combined manifest if every range is completed
+bool
+frame_range_queue
+::write_manifest()
+{
+  std::string contents = std::string(MANIFEST_HEADER) + "\n";
+  for (size_t i = 0; i < d_->num_ranges(); ++i)
+  {
+    auto const done_path = d_->range_path(i, ".done");
+    if (!ST::FileExists(done_path))
+    {
+      return false;
+    }
+    contents += read_file(done_path);
+  }
+
+  // every worker that finishes last writes the same manifest
+  write_atomic(d_->queue_dir + "/manifest.txt", contents, d_->file_token);
+  return true;
+}
+
+
+/// Identifier of this worker, recorded in claims and the manifest
+std::string const&
+frame_range_queue
+::worker_id() const
+{
+  return d_->worker_id;
+}
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,134 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for a shared frame range work queue
+ */
+
+#ifndef MAPTK_FRAME_RANGE_QUEUE_H_
+#define MAPTK_FRAME_RANGE_QUEUE_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/vital_types.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// A contiguous range of frames handed out by a frame_range_queue
+struct frame_range
+{
+  /// Index of the range in the queue
+  size_t index = 0;
+  /// The frames in the range, in order
+  std::vector<vital::frame_id_t> frames;
+};
+
+
+/// A work queue of frame ranges shared through a directory
+/**
+ * Several processes, possibly on different machines sharing a file system,
+ * split the frames of a video into fixed size ranges and claim them one at
+ * a time.  A claim is an exclusively created lock file in the queue
+ * directory whose modification time is refreshed while the range is being
+ * processed.  A claim not refreshed within the claim timeout is assumed to
+ * belong to a worker that died and is reclaimed by another worker.  Claims
+ * are aged against a file the checking worker writes in the queue
+ * directory, so only the clock of the file server matters.  A worker only
+ * refreshes and removes claims that still name it.
+ *
+ * A completed range is recorded with a file listing its outputs.  When the
+ * last range is completed the lists are combined into \c manifest.txt in
+ * the queue directory.
+ */
+class MAPTK_EXPORT frame_range_queue
+{
+public:
+  /// Constructor
+  /**
+   * \param [in] queue_dir      Directory holding the queue state.
+   * \param [in] frames         All frames to process, in order.
+   * \param [in] range_size     Number of frames in each range.
+   * \param [in] claim_timeout  Seconds after which a claim is stale.
+   *
+   * \throws vital::invalid_value
+   *   if the queue directory was set up with different frames or range size.
+   */
+  frame_range_queue(vital::path_t const& queue_dir,
+                    std::vector<vital::frame_id_t> const& frames,
+                    size_t range_size, double claim_timeout);
+
+  /// Destructor
+  /**
+   * Releases the claim on any range that was not completed.
+   */
+  ~frame_range_queue();
+
+  /// Claim the next range that is neither completed nor claimed
+  /**
+   * While a range is claimed, its claim is refreshed in the background.
+   *
+   * \param [out] range  The claimed range.
+   * \returns false if no range is left to claim.
+   */
+  bool claim(frame_range& range);
+
+  /// Record the outputs of the claimed range and release its claim
+  void complete(frame_range const& range,
+                std::vector<vital::path_t> const& outputs);
+
+  /// Release the claim on a range without completing it
+  void release(frame_range const& range);
+
+  /// Write the combined manifest if every range is completed
+  /**
+   * \returns true if every range is completed.
+   */
+  bool write_manifest();
+
+  /// Identifier of this worker, recorded in claims and the manifest
+  std::string const& worker_id() const;
+
+private:
+  class priv;
+  std::unique_ptr<priv> const d_;
+};
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif // MAPTK_FRAME_RANGE_QUEUE_H_
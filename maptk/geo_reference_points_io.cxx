@@ -34,6 +34,7 @@
  */
 
 #include "geo_reference_points_io.h"
+#include "geo_transform.h"
 #include <vital/exceptions.h>
 #include <vital/io/eigen_io.h>
 #include <vital/types/geodesy.h>
@@ -80,6 +81,10 @@ void load_reference_file(vital::path_t const& reference_file,
   vital::landmark_map::map_landmark_t reference_lms;
   std::vector<vital::track_sptr> reference_tracks;
 
+  // Locations as read, and the same points as lon/lat to convert
+  std::vector<vital::vector_3d> reference_locs;
+  std::vector<vital::geo_point> lon_lat_pts;
+
   // Mean position of all landmarks.
   vital::vector_3d mean(0,0,0);
 
@@ -97,23 +102,9 @@ void load_reference_file(vital::path_t const& reference_file,
 
     // input landmarks are given in lon/lat/alt format (ignoring alt for now)
     ss >> vec;
-
-    vital::vector_2d lon_lat(vec.x(), vec.y());
-    vital::geo_point gp(lon_lat, vital::SRID::lat_lon_WGS84);
-    if ( lgcs.origin().is_empty() )
-    {
-      auto zone = vital::utm_ups_zone( lon_lat );
-      crs = (zone.north ? vital::SRID::UTM_WGS84_north : vital::SRID::UTM_WGS84_south) + zone.number;
-      LOG_DEBUG(logger, "lgcs origin zone: " << zone.number );
-      lgcs.set_origin( vital::geo_point( gp.location( crs ), crs ) );
-    }
-    vital::vector_3d utm = gp.location(crs);
-
-    vec[0] = utm.x();
-    vec[1] = utm.y();
-    mean += vec;
-
-    reference_lms[cur_id] = vital::landmark_sptr(new vital::landmark_d(vec));
+    reference_locs.push_back(vec);
+    lon_lat_pts.push_back(vital::geo_point(vital::vector_2d(vec.x(), vec.y()),
+                                           vital::SRID::lat_lon_WGS84));
 
     // while there's still input left, read in track states
     vital::track_sptr lm_track = vital::track::create();
@@ -133,6 +124,34 @@ void load_reference_file(vital::path_t const& reference_file,
   }
   LOG_INFO(logger, "Loaded "<< reference_tracks.size() <<" ground control points");
 
+  if (!lon_lat_pts.empty())
+  {
+    if ( lgcs.origin().is_empty() )
+    {
+      auto zone = vital::utm_ups_zone( reference_locs[0].head<2>() );
+      crs = (zone.north ? vital::SRID::UTM_WGS84_north : vital::SRID::UTM_WGS84_south) + zone.number;
+      LOG_DEBUG(logger, "lgcs origin zone: " << zone.number );
+    }
+
+    // Convert all points to the origin coordinate system
+    auto const utm_pts = convert_geo_points(lon_lat_pts, crs);
+    if ( lgcs.origin().is_empty() )
+    {
+      lgcs.set_origin( vital::geo_point( utm_pts[0], crs ) );
+    }
+
+    cur_id = 1;
+    for (size_t i = 0; i < utm_pts.size(); ++i, ++cur_id)
+    {
+      vec = reference_locs[i];
+      vec[0] = utm_pts[i].x();
+      vec[1] = utm_pts[i].y();
+      mean += vec;
+
+      reference_lms[cur_id] = vital::landmark_sptr(new vital::landmark_d(vec));
+    }
+  }
+
   if (set_lgcs_origin)
   {
     // Initialize lgcs center
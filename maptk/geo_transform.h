@@ -0,0 +1,71 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for converting sets of geo points to one coordinate system
+ */
+
+#ifndef MAPTK_GEO_TRANSFORM_H_
+#define MAPTK_GEO_TRANSFORM_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/geo_point.h>
+
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Convert geo points, in any coordinate systems, to one coordinate system
+/**
+ * This is a convenience for callers that convert a whole set of points.
+ * Each point is converted on its own through the registered vital geo
+ * conversion, exactly as vital::geo_point::location() does, so there is no
+ * speed up over converting the points one at a time.  Empty points are
+ * converted to NaN.
+ *
+ *  \param [in] points the points to convert
+ *  \param [in] target_crs the coordinate system to convert to
+ *  \return the location of each point in \p target_crs
+ *  \throws std::runtime_error if a point cannot be converted
+ */
+MAPTK_EXPORT
+std::vector<vital::vector_3d>
+convert_geo_points(std::vector<vital::geo_point> const& points,
+                   int target_crs);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif
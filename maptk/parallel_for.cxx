@@ -0,0 +1,155 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of running loops over blocks of indices on the pool
+ */
+
+#include "parallel_for.h"
+
+#include <vital/util/thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+/// State shared between the calling thread and the pool tasks of a loop
+struct loop_state
+{
+  std::mutex mutex;
+  std::condition_variable finished;
+  std::atomic<size_t> next;
+  size_t count;
+  size_t block_size;
+  // Cleared when the loop returns; tasks that start later do nothing
+  std::function<void(size_t, size_t)> const* func;
+  unsigned running;
+  std::exception_ptr error;
+};
+
+
+/// Process blocks of a loop until none are left
+void
+run_blocks(std::shared_ptr<loop_state> const& state)
+{
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (!state->func)
+    {
+      return;
+    }
+    ++state->running;
+  }
+
+  try
+  {
+    auto const& func = *state->func;
+    for (size_t i0 = state->next.fetch_add(state->block_size);
+         i0 < state->count; i0 = state->next.fetch_add(state->block_size))
+    {
+      func(i0, std::min(i0 + state->block_size, state->count));
+    }
+  }
+  catch (...)
+  {
+    // Stop the other threads and report the error from the calling thread
+    state->next = state->count;
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (!state->error)
+    {
+      state->error = std::current_exception();
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(state->mutex);
+  if (--state->running == 0)
+  {
+    state->finished.notify_all();
+  }
+}
+
+} // end anonymous namespace
+
+
+/// Call a function on blocks of an index range using the vital thread pool
+void
+parallel_for_blocks(size_t count, size_t block_size,
+                    std::function<void(size_t, size_t)> const& func,
+                    unsigned num_threads)
+{
+  if (count == 0)
+  {
+    return;
+  }
+  block_size = std::max<size_t>(block_size, 1);
+
+  auto& pool = vital::thread_pool::instance();
+  if (num_threads == 0)
+  {
+    num_threads = static_cast<unsigned>(std::max<size_t>(pool.num_threads(), 1));
+  }
+  size_t const num_blocks = (count + block_size - 1) / block_size;
+  num_threads = static_cast<unsigned>(
+    std::max<size_t>(std::min<size_t>(num_threads, num_blocks), 1));
+
+  auto state = std::make_shared<loop_state>();
+  state->next = 0;
+  state->count = count;
+  state->block_size = block_size;
+  state->func = &func;
+  state->running = 0;
+
+  for (unsigned t = 1; t < num_threads; ++t)
+  {
+    pool.enqueue([state]() { run_blocks(state); });
+  }
+  run_blocks(state);
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->finished.wait(lock, [&]() { return state->running == 0; });
+  state->func = nullptr;
+  if (state->error)
+  {
+    std::rethrow_exception(state->error);
+  }
+}
+
+} // end namespace maptk
+} // end namespace kwiver
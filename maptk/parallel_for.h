@@ -0,0 +1,78 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for running loops over blocks of indices on the thread pool
+ */
+
+#ifndef MAPTK_PARALLEL_FOR_H_
+#define MAPTK_PARALLEL_FOR_H_
+
+#include <maptk/maptk_export.h>
+
+#include <cstddef>
+#include <functional>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Call a function on blocks of an index range using the vital thread pool
+/**
+ * The range [0, \p count) is split into blocks of \p block_size indices and
+ * \p func(first, last) is called once for each block.  Blocks are handed out
+ * to the calling thread and to tasks on kwiver::vital::thread_pool as they
+ * finish, so \p func must be safe to call concurrently on distinct blocks.
+ *
+ * The calling thread processes blocks too, and tasks that have not started
+ * when all blocks are done return without calling \p func.  It is therefore
+ * safe to call this from a task that is itself running on the pool.
+ *
+ * If \p func throws, the remaining blocks are skipped and the first
+ * exception is rethrown once all running calls have returned.
+ *
+ *  \param [in] count the number of indices
+ *  \param [in] block_size the number of indices per block
+ *  \param [in] func the function to call on each block
+ *  \param [in] num_threads the most threads to use, including the calling
+ *                          thread, or 0 for the size of the thread pool
+ */
+MAPTK_EXPORT
+void
+parallel_for_blocks(size_t count, size_t block_size,
+                    std::function<void(size_t, size_t)> const& func,
+                    unsigned num_threads = 0);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif
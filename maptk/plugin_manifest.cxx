@@ -0,0 +1,432 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of maptk plugin manifest functions
+ */
+
+#include "plugin_manifest.h"
+
+#include <vital/logger/logger.h>
+#include <vital/plugin_loader/plugin_factory.h>
+#include <vital/plugin_loader/plugin_loader.h>
+#include <vital/plugin_loader/plugin_manager.h>
+#include <vital/types/geodesy.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+typedef kwiversys::SystemTools ST;
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+static char const* const MANIFEST_HEADER = "# TeleSculptor plugin manifest v2";
+
+/// In-memory form of the plugin manifest
+struct plugin_manifest
+{
+  // plugin search directories and their modification times
+  std::map<std::string, long> directories;
+  // plugin libraries and their modification times
+  std::map<std::string, long> libraries;
+  // algorithm implementation names and the libraries that provide them
+  std::multimap<std::string, std::string> implementations;
+  // libraries that provide no algorithms, which are always loaded since
+  // they may install other services (e.g. the geographic conversion)
+  std::set<std::string> support_libraries;
+  // whether a geographic conversion was installed with all plugins loaded
+  bool has_geo_conversion = false;
+};
+
+/// Guards the loading state below
+std::mutex load_mutex;
+/// Libraries loaded individually from the manifest
+std::set<std::string> loaded_libraries;
+/// Set once all plugins have been loaded
+bool all_plugins_loaded = false;
+
+
+/// Read a manifest file, returning false if it is missing or malformed
+bool
+read_manifest(vital::path_t const& path, plugin_manifest& manifest)
+{
+  std::ifstream ifs(path.c_str());
+  std::string line;
+  if (!ifs || !std::getline(ifs, line) || line != MANIFEST_HEADER)
+  {
+    return false;
+  }
+
+  while (std::getline(ifs, line))
+  {
+    std::istringstream ss(line);
+    std::string kind;
+    ss >> kind;
+    if (kind == "directory" || kind == "library")
+    {
+      long mtime;
+      std::string file;
+      if (!(ss >> mtime))
+      {
+        return false;
+      }
+      std::getline(ss >> std::ws, file);
+      auto& target = (kind == "directory" ? manifest.directories
+                                          : manifest.libraries);
+      target[file] = mtime;
+    }
+    else if (kind == "algorithm")
+    {
+      std::string impl, file;
+      ss >> impl;
+      std::getline(ss >> std::ws, file);
+      manifest.implementations.emplace(impl, file);
+    }
+    else if (kind == "support")
+    {
+      std::string file;
+      std::getline(ss >> std::ws, file);
+      manifest.support_libraries.insert(file);
+    }
+    else if (kind == "geo_conversion")
+    {
+      if (!(ss >> manifest.has_geo_conversion))
+      {
+        return false;
+      }
+    }
+    else if (!kind.empty())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/// Write a manifest file, replacing any existing file
+void
+write_manifest(vital::path_t const& path, plugin_manifest const& manifest)
+{
+  auto const dir = ST::GetFilenamePath(path);
+  if (!dir.empty() && !ST::FileIsDirectory(dir) && !ST::MakeDirectory(dir))
+  {
+    return;
+  }
+
+  // Write to a temporary file first so that concurrent processes never see
+  // a partially written manifest
+  auto const tmp_path = path + ".tmp" + std::to_string(ST::GetTime());
+  {
+    std::ofstream ofs(tmp_path.c_str());
+    if (!ofs)
+    {
+      return;
+    }
+    ofs << MANIFEST_HEADER << "\n";
+    for (auto const& d : manifest.directories)
+    {
+      ofs << "directory " << d.second << " " << d.first << "\n";
+    }
+    for (auto const& l : manifest.libraries)
+    {
+      ofs << "library " << l.second << " " << l.first << "\n";
+    }
+    for (auto const& i : manifest.implementations)
+    {
+      ofs << "algorithm " << i.first << " " << i.second << "\n";
+    }
+    for (auto const& l : manifest.support_libraries)
+    {
+      ofs << "support " << l << "\n";
+    }
+    ofs << "geo_conversion " << manifest.has_geo_conversion << "\n";
+  }
+  if (!ST::RenameFile(tmp_path.c_str(), path.c_str()))
+  {
+    ST::RemoveFile(tmp_path);
+  }
+}
+
+
+/// Check that a manifest still describes the plugins on the search path
+bool
+manifest_is_current(plugin_manifest const& manifest,
+                    vital::path_list_t const& search_path)
+{
+  std::set<std::string> dirs;
+  for (auto const& dir : search_path)
+  {
+    if (ST::FileIsDirectory(dir))
+    {
+      dirs.insert(dir);
+    }
+  }
+  if (dirs.size() != manifest.directories.size())
+  {
+    return false;
+  }
+
+  // Adding or removing a plugin changes the directory modification time
+  for (auto const& d : manifest.directories)
+  {
+    if (!dirs.count(d.first) || ST::ModifiedTime(d.first) != d.second)
+    {
+      return false;
+    }
+  }
+  for (auto const& l : manifest.libraries)
+  {
+    if (!ST::FileExists(l.first) || ST::ModifiedTime(l.first) != l.second)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/// Load all plugins and build a manifest describing them
+plugin_manifest
+build_manifest(vital::plugin_manager& vpm)
+{
+  vpm.load_all_plugins();
+  all_plugins_loaded = true;
+
+  plugin_manifest manifest;
+  for (auto const& dir : vpm.search_path())
+  {
+    if (ST::FileIsDirectory(dir))
+    {
+      manifest.directories[dir] = ST::ModifiedTime(dir);
+    }
+  }
+  for (auto const& file : vpm.file_list())
+  {
+    manifest.libraries[file] = ST::ModifiedTime(file);
+  }
+
+  for (auto const& iface : vpm.plugin_map())
+  {
+    for (auto const& fact : iface.second)
+    {
+      std::string category, impl, file;
+      if (fact->get_attribute(vital::plugin_factory::PLUGIN_CATEGORY,
+                              category) &&
+          category == "algorithm" &&
+          fact->get_attribute(vital::plugin_factory::PLUGIN_NAME, impl) &&
+          fact->get_attribute(vital::plugin_factory::PLUGIN_FILE_NAME, file))
+      {
+        manifest.implementations.emplace(impl, file);
+      }
+    }
+  }
+
+  std::set<std::string> algorithm_libraries;
+  for (auto const& i : manifest.implementations)
+  {
+    algorithm_libraries.insert(i.second);
+  }
+  for (auto const& l : manifest.libraries)
+  {
+    if (!algorithm_libraries.count(l.first))
+    {
+      manifest.support_libraries.insert(l.first);
+    }
+  }
+  manifest.has_geo_conversion = (vital::get_geo_conv() != nullptr);
+  return manifest;
+}
+
+
+/// Collect the implementation names of all nested algorithms in a config
+std::set<std::string>
+configured_implementations(vital::config_block_sptr const& config)
+{
+  static std::string const type_key =
+    vital::config_block::block_sep + std::string("type");
+
+  std::set<std::string> impls;
+  if (!config)
+  {
+    return impls;
+  }
+  for (auto const& key : config->available_values())
+  {
+    if (key == "type" ||
+        (key.size() > type_key.size() &&
+         key.compare(key.size() - type_key.size(), type_key.size(),
+                     type_key) == 0))
+    {
+      auto const impl = config->get_value<std::string>(key, "");
+      if (!impl.empty())
+      {
+        impls.insert(impl);
+      }
+    }
+  }
+  return impls;
+}
+
+} // end anonymous namespace
+
+
+/// Get the default path of the plugin manifest cache
+vital::path_t
+default_plugin_manifest_file()
+{
+  std::string path;
+  if (ST::GetEnv("TELESCULPTOR_PLUGIN_MANIFEST", path) && !path.empty())
+  {
+    return path;
+  }
+
+#ifdef _WIN32
+  if (!ST::GetEnv("LOCALAPPDATA", path) || path.empty())
+  {
+    path = ST::GetCurrentWorkingDirectory();
+  }
+#else
+  if (!ST::GetEnv("XDG_CACHE_HOME", path) || path.empty())
+  {
+    if (ST::GetEnv("HOME", path) && !path.empty())
+    {
+      path += "/.cache";
+    }
+    else
+    {
+      path = ST::GetCurrentWorkingDirectory();
+    }
+  }
+#endif
+  return path + "/telesculptor/plugin_manifest.txt";
+}
+
+
+/// Load all plugins on the plugin search path
+void
+load_all_plugins()
+{
+  std::lock_guard<std::mutex> lock(load_mutex);
+  if (!all_plugins_loaded)
+  {
+    vital::plugin_manager::instance().load_all_plugins();
+    all_plugins_loaded = true;
+  }
+}
+
+
+/// Load the plugins that provide the algorithms named in a configuration
+bool
+load_plugins_for_config(vital::config_block_sptr const& config,
+                        std::vector<std::string> const& impl_names,
+                        vital::path_t const& manifest_file)
+{
+  vital::logger_handle_t logger(vital::get_logger("maptk.plugin_manifest"));
+  auto& vpm = vital::plugin_manager::instance();
+
+  std::lock_guard<std::mutex> lock(load_mutex);
+  if (all_plugins_loaded)
+  {
+    return false;
+  }
+
+  plugin_manifest manifest;
+  if (manifest_file.empty() ||
+      !read_manifest(manifest_file, manifest) ||
+      !manifest_is_current(manifest, vpm.search_path()))
+  {
+    LOG_DEBUG(logger, "Rebuilding plugin manifest " << manifest_file);
+    manifest = build_manifest(vpm);
+    if (!manifest_file.empty())
+    {
+      write_manifest(manifest_file, manifest);
+    }
+    return false;
+  }
+
+  auto impls = configured_implementations(config);
+  impls.insert(impl_names.begin(), impl_names.end());
+
+  // Resolve every implementation before loading anything so that a missing
+  // implementation falls back to a full load
+  std::set<std::string> libraries = manifest.support_libraries;
+  for (auto const& impl : impls)
+  {
+    auto const range = manifest.implementations.equal_range(impl);
+    if (range.first == range.second)
+    {
+      LOG_DEBUG(logger, "Implementation \"" << impl << "\" not found in "
+                        "plugin manifest; loading all plugins");
+      vpm.load_all_plugins();
+      all_plugins_loaded = true;
+      return false;
+    }
+    for (auto i = range.first; i != range.second; ++i)
+    {
+      libraries.insert(i->second);
+    }
+  }
+
+  for (auto const& lib : libraries)
+  {
+    if (loaded_libraries.insert(lib).second)
+    {
+      LOG_DEBUG(logger, "Loading plugin " << lib);
+      vpm.get_loader()->load_plugin(lib);
+    }
+  }
+
+  // The geographic conversion is installed as a side effect of loading a
+  // library rather than registered as a factory; if the selected libraries
+  // did not install it, fall back to a full load
+  if (manifest.has_geo_conversion && !vital::get_geo_conv())
+  {
+    LOG_DEBUG(logger, "No geographic conversion after loading plugins from "
+                      "manifest; loading all plugins");
+    vpm.load_all_plugins();
+    all_plugins_loaded = true;
+    return false;
+  }
+  return true;
+}
+
+} // end namespace maptk
+} // end namespace kwiver
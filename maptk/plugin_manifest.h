@@ -0,0 +1,105 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for maptk plugin manifest functions
+ */
+
+#ifndef MAPTK_PLUGIN_MANIFEST_H_
+#define MAPTK_PLUGIN_MANIFEST_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/config/config_block.h>
+#include <vital/vital_types.h>
+
+#include <string>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Get the default path of the plugin manifest cache
+/**
+ * This is the file named by the \c TELESCULPTOR_PLUGIN_MANIFEST environment
+ * variable if it is set.  Otherwise it is \c telesculptor/plugin_manifest.txt
+ * in the user's cache directory.
+ */
+MAPTK_EXPORT
+vital::path_t default_plugin_manifest_file();
+
+/// Load all plugins on the plugin search path
+/**
+ * After this is called, load_plugins_for_config has no further effect.
+ */
+MAPTK_EXPORT
+void load_all_plugins();
+
+/// Load the plugins that provide the algorithms named in a configuration
+/**
+ * Rather than loading every plugin on the search path, this function loads
+ * only the plugin libraries that provide the algorithm implementations named
+ * by the \c type entries of \p config, plus any implementations named in
+ * \p impl_names.  Libraries are located using a manifest that maps
+ * implementation names to the plugin libraries providing them.
+ *
+ * The manifest is cached in \p manifest_file.  It is rebuilt, by loading all
+ * plugins, if it is missing or if the plugin search path, the contents of the
+ * search directories, or any plugin library has changed since it was written.
+ * If any requested implementation is not listed in the manifest, all plugins
+ * are loaded.
+ *
+ * Plugin libraries that provide no algorithms are always loaded, since they
+ * may install services such as the geographic conversion when they load.
+ * If a geographic conversion was available when the manifest was built but
+ * is not after the selected libraries are loaded, all plugins are loaded.
+ *
+ * Plugin search paths must be added to the vital plugin manager before this
+ * function is called.
+ *
+ *  \param [in] config configuration naming the algorithms that will be created
+ *  \param [in] impl_names additional implementation names that will be created
+ *  \param [in] manifest_file path of the plugin manifest cache
+ *  \return \c true if only the required plugins were loaded, \c false if all
+ *          plugins were loaded
+ */
+MAPTK_EXPORT
+bool load_plugins_for_config(vital::config_block_sptr const& config,
+                             std::vector<std::string> const& impl_names = {},
+                             vital::path_t const& manifest_file =
+                               default_plugin_manifest_file());
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif
@@ -0,0 +1,135 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of the parallel PCA canonical transform estimator
+ */
+
+#include "estimate_canonical_transform_pca.h"
+
+#include <maptk/canonical_transform.h>
+
+using namespace kwiver::vital;
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Private implementation class
+class estimate_canonical_transform_pca::priv
+{
+public:
+  priv()
+    : estimate_scale(true),
+      height_percentile(0.05),
+      num_threads(0)
+  {
+  }
+
+  bool estimate_scale;
+  double height_percentile;
+  unsigned num_threads;
+};
+
+
+/// Constructor
+estimate_canonical_transform_pca
+::estimate_canonical_transform_pca()
+  : d_(new priv)
+{
+  attach_logger("maptk.estimate_canonical_transform_pca");
+}
+
+
+/// Destructor
+estimate_canonical_transform_pca
+::~estimate_canonical_transform_pca()
+{
+}
+
+
+/// Get this algorithm's \link vital::config_block configuration block \endlink
+vital::config_block_sptr
+estimate_canonical_transform_pca
+::get_configuration() const
+{
+  vital::config_block_sptr config = vital::algorithm::get_configuration();
+
+  config->set_value("estimate_scale", d_->estimate_scale,
+                    "Estimate the scale to normalize the data. "
+                    "If disabled the estimated transform is rigid");
+  config->set_value("height_percentile", d_->height_percentile,
+                    "Shift the ground plane along the normal axis such that "
+                    "this percentage of landmarks are below the ground. "
+                    "Values are in the range [0.0, 1.0).  If the value is "
+                    "outside this range use the mean height instead.");
+  config->set_value("num_threads", d_->num_threads,
+                    "Number of threads, or zero for one per core.");
+  return config;
+}
+
+
+/// Set this algorithm's properties via a config block
+void
+estimate_canonical_transform_pca
+::set_configuration(vital::config_block_sptr in_config)
+{
+  vital::config_block_sptr config = this->get_configuration();
+  config->merge_config(in_config);
+
+  d_->estimate_scale = config->get_value<bool>("estimate_scale");
+  d_->height_percentile = config->get_value<double>("height_percentile");
+  d_->num_threads = config->get_value<unsigned>("num_threads");
+}
+
+
+/// Check that the algorithm's currently configuration is valid
+bool
+estimate_canonical_transform_pca
+::check_configuration(vital::config_block_sptr /*config*/) const
+{
+  return true;
+}
+
+
+/// Estimate a canonical similarity transform for cameras and points
+similarity_d
+estimate_canonical_transform_pca
+::estimate_transform(camera_map_sptr const cameras,
+                     landmark_map_sptr const landmarks) const
+{
+  return maptk::estimate_canonical_transform(
+    cameras, landmarks, d_->estimate_scale, d_->height_percentile,
+    d_->num_threads);
+}
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,92 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for the parallel PCA canonical transform estimator
+ */
+
+#ifndef MAPTK_PLUGINS_ESTIMATE_CANONICAL_TRANSFORM_PCA_H_
+#define MAPTK_PLUGINS_ESTIMATE_CANONICAL_TRANSFORM_PCA_H_
+
+#include <vital/algo/estimate_canonical_transform.h>
+
+#include <memory>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Estimate a canonical transform from the principal axes of the landmarks
+/**
+ * This has the same parameters as the core PCA estimator, but summarizes
+ * the landmarks in a single parallel pass.  See
+ * maptk::estimate_canonical_transform for the details.
+ */
+class estimate_canonical_transform_pca
+  : public vital::algorithm_impl<estimate_canonical_transform_pca,
+                                 vital::algo::estimate_canonical_transform>
+{
+public:
+  /// Constructor
+  estimate_canonical_transform_pca();
+
+  /// Destructor
+  virtual ~estimate_canonical_transform_pca();
+
+  /// Get this algorithm's \link vital::config_block configuration block \endlink
+  virtual vital::config_block_sptr get_configuration() const;
+  /// Set this algorithm's properties via a config block
+  virtual void set_configuration(vital::config_block_sptr config);
+  /// Check that the algorithm's currently configuration is valid
+  virtual bool check_configuration(vital::config_block_sptr config) const;
+
+  /// Estimate a canonical similarity transform for cameras and points
+  /**
+   * \param cameras The camera map containing all the cameras
+   * \param landmarks The landmark map containing all the 3D landmarks
+   * \throws vital::invalid_value When there are fewer than three landmarks.
+   * \returns An estimated similarity transform mapping the data to the
+   *          canonical space.
+   */
+  virtual vital::similarity_d
+  estimate_transform(vital::camera_map_sptr const cameras,
+                     vital::landmark_map_sptr const landmarks) const;
+
+private:
+  class priv;
+  std::unique_ptr<priv> const d_;
+};
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif // MAPTK_PLUGINS_ESTIMATE_CANONICAL_TRANSFORM_PCA_H_
@@ -0,0 +1,257 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of Hamming distance kernels
+ */
+
+#include "hamming_distance.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define MAPTK_HAMMING_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  endif
+#endif
+
+#if defined(MAPTK_HAMMING_X86) && defined(_MSC_VER)
+#  define MAPTK_TARGET(t)
+#elif defined(MAPTK_HAMMING_X86)
+#  define MAPTK_TARGET(t) __attribute__((target(t)))
+#endif
+
+
+namespace kwiver {
+namespace maptk {
+namespace hamming {
+
+namespace {
+
+/// Count the set bits of a word without processor support
+inline unsigned
+popcount_portable(uint64_t x)
+{
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<unsigned>((x * 0x0101010101010101ULL) >> 56);
+}
+
+
+/// Distance kernel using only portable integer arithmetic
+unsigned
+distance_scalar(uint64_t const* a, uint64_t const* b, size_t words)
+{
+  unsigned d = 0;
+  for (size_t i = 0; i < words; ++i)
+  {
+    d += popcount_portable(a[i] ^ b[i]);
+  }
+  return d;
+}
+
+
+#ifdef MAPTK_HAMMING_X86
+
+/// Distance kernel using the POPCNT instruction
+MAPTK_TARGET("popcnt")
+unsigned
+distance_popcnt(uint64_t const* a, uint64_t const* b, size_t words)
+{
+  // Four independent accumulators hide the latency of the instruction
+  uint64_t d0 = 0, d1 = 0, d2 = 0, d3 = 0;
+  for (size_t i = 0; i < words; i += 4)
+  {
+#ifdef _MSC_VER
+    d0 += __popcnt64(a[i] ^ b[i]);
+    d1 += __popcnt64(a[i + 1] ^ b[i + 1]);
+    d2 += __popcnt64(a[i + 2] ^ b[i + 2]);
+    d3 += __popcnt64(a[i + 3] ^ b[i + 3]);
+#else
+    d0 += __builtin_popcountll(a[i] ^ b[i]);
+    d1 += __builtin_popcountll(a[i + 1] ^ b[i + 1]);
+    d2 += __builtin_popcountll(a[i + 2] ^ b[i + 2]);
+    d3 += __builtin_popcountll(a[i + 3] ^ b[i + 3]);
+#endif
+  }
+  return static_cast<unsigned>(d0 + d1 + d2 + d3);
+}
+
+
+/// Distance kernel using AVX2 nibble lookup tables
+/**
+ * Each byte of the XOR is split into two nibbles whose bit counts are looked
+ * up with a byte shuffle, and the byte counts are summed into 64-bit lanes
+ * with a sum of absolute differences against zero.
+ */
+MAPTK_TARGET("avx2")
+unsigned
+distance_avx2(uint64_t const* a, uint64_t const* b, size_t words)
+{
+  __m256i const lookup = _mm256_setr_epi8(
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  __m256i const low_mask = _mm256_set1_epi8(0x0f);
+  __m256i const zero = _mm256_setzero_si256();
+
+  __m256i acc = zero;
+  for (size_t i = 0; i < words; i += 4)
+  {
+    __m256i const x = _mm256_xor_si256(
+      _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i)),
+      _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + i)));
+    __m256i const lo = _mm256_and_si256(x, low_mask);
+    __m256i const hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask);
+    __m256i const counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                           _mm256_shuffle_epi8(lookup, hi));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(counts, zero));
+  }
+
+  __m128i const sum = _mm_add_epi64(_mm256_castsi256_si128(acc),
+                                    _mm256_extracti128_si256(acc, 1));
+  return static_cast<unsigned>(_mm_cvtsi128_si64(sum) +
+                               _mm_extract_epi64(sum, 1));
+}
+
+
+/// Processor features relevant to the kernels
+struct cpu_features
+{
+  bool popcnt = false;
+  bool avx2 = false;
+
+  cpu_features()
+  {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    int const max_leaf = info[0];
+    __cpuid(info, 1);
+    popcnt = (info[2] & (1 << 23)) != 0;
+    bool const osxsave = (info[2] & (1 << 27)) != 0;
+    if (max_leaf >= 7 && osxsave &&
+        (_xgetbv(0) & 0x6) == 0x6)
+    {
+      __cpuidex(info, 7, 0);
+      avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    popcnt = __builtin_cpu_supports("popcnt");
+    avx2 = __builtin_cpu_supports("avx2");
+#endif
+  }
+};
+
+
+cpu_features const&
+get_cpu_features()
+{
+  static cpu_features const features;
+  return features;
+}
+
+#endif
+
+} // end anonymous namespace
+
+
+/// Names of the kernels, from slowest to fastest
+std::vector<std::string>
+kernel_names()
+{
+  return { "scalar", "popcnt", "avx2" };
+}
+
+
+/// Return true if the named kernel runs on this processor
+bool
+kernel_supported(std::string const& name)
+{
+  if (name == "scalar")
+  {
+    return true;
+  }
+#ifdef MAPTK_HAMMING_X86
+  if (name == "popcnt")
+  {
+    return get_cpu_features().popcnt;
+  }
+  if (name == "avx2")
+  {
+    return get_cpu_features().avx2;
+  }
+#endif
+  return false;
+}
+
+
+/// Return the named kernel, or the fastest supported kernel for "auto"
+distance_kernel
+select_kernel(std::string const& name, std::string* selected_name)
+{
+  std::string selected = name;
+  if (name == "auto")
+  {
+    for (auto const& n : kernel_names())
+    {
+      if (kernel_supported(n))
+      {
+        selected = n;
+      }
+    }
+  }
+  if (!kernel_supported(selected))
+  {
+    return nullptr;
+  }
+  if (selected_name)
+  {
+    *selected_name = selected;
+  }
+
+#ifdef MAPTK_HAMMING_X86
+  if (selected == "avx2")
+  {
+    return &distance_avx2;
+  }
+  if (selected == "popcnt")
+  {
+    return &distance_popcnt;
+  }
+#endif
+  return &distance_scalar;
+}
+
+} // end namespace hamming
+} // end namespace maptk
+} // end namespace kwiver
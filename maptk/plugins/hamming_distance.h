@@ -0,0 +1,85 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for Hamming distance kernels on packed binary descriptors
+ */
+
+#ifndef MAPTK_PLUGINS_HAMMING_DISTANCE_H_
+#define MAPTK_PLUGINS_HAMMING_DISTANCE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+namespace hamming {
+
+/// Number of 64-bit words each packed descriptor is padded to a multiple of
+/**
+ * Padding words are zero in every descriptor and so do not change the
+ * distance, but let the vector kernels run without a scalar tail.
+ */
+constexpr size_t word_alignment = 4;
+
+/// Signature of a kernel computing the distance between two descriptors
+/**
+ * \param [in] a      First descriptor, \p words 64-bit words long.
+ * \param [in] b      Second descriptor, \p words 64-bit words long.
+ * \param [in] words  Length of the descriptors, a multiple of
+ *                    \c word_alignment.
+ * \returns the number of bits that differ between \p a and \p b.
+ */
+typedef unsigned (*distance_kernel)(uint64_t const* a, uint64_t const* b,
+                                    size_t words);
+
+/// Names of the kernels, from slowest to fastest
+std::vector<std::string> kernel_names();
+
+/// Return true if the named kernel runs on this processor
+bool kernel_supported(std::string const& name);
+
+/// Return the named kernel, or the fastest supported kernel for "auto"
+/**
+ * \returns nullptr if the kernel is unknown or not supported.
+ */
+distance_kernel select_kernel(std::string const& name,
+                              std::string* selected_name = nullptr);
+
+} // end namespace hamming
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif // MAPTK_PLUGINS_HAMMING_DISTANCE_H_
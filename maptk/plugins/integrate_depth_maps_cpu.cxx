@@ -0,0 +1,216 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of CPU integration of depth maps
+ */
+
+#include "integrate_depth_maps_cpu.h"
+
+#include <maptk/depth_fusion.h>
+
+#include <vital/exceptions.h>
+#include <vital/io/eigen_io.h>
+#include <vital/types/image_container.h>
+
+#include <sstream>
+
+using namespace kwiver::vital;
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Private implementation class
+class integrate_depth_maps_cpu::priv
+{
+public:
+  priv()
+    : grid_spacing(1.0, 1.0, 1.0),
+      voxel_spacing_factor(2.0),
+      num_threads(0)
+  {
+  }
+
+  ray_potential potential;
+  vector_3d grid_spacing;
+  double voxel_spacing_factor;
+  unsigned num_threads;
+};
+
+
+/// Constructor
+integrate_depth_maps_cpu
+::integrate_depth_maps_cpu()
+  : d_(new priv)
+{
+  attach_logger("maptk.integrate_depth_maps_cpu");
+}
+
+
+/// Destructor
+integrate_depth_maps_cpu
+::~integrate_depth_maps_cpu()
+{
+}
+
+
+/// Get this algorithm's \link vital::config_block configuration block \endlink
+vital::config_block_sptr
+integrate_depth_maps_cpu
+::get_configuration() const
+{
+  vital::config_block_sptr config = vital::algorithm::get_configuration();
+
+  config->set_value("ray_potential_thickness", d_->potential.thickness,
+                    "Distance from the surface, in voxels, over which the "
+                    "ray potential ramps linearly.");
+  config->set_value("ray_potential_rho", d_->potential.rho,
+                    "Maximum magnitude of the ray potential.");
+  config->set_value("ray_potential_eta", d_->potential.eta,
+                    "Fraction of rho used in front of the surface "
+                    "(0 < eta <= 1).");
+  config->set_value("ray_potential_delta", d_->potential.delta,
+                    "Distance from the surface, in voxels, beyond which the "
+                    "ray potential is zero. Must exceed the thickness.");
+
+  std::ostringstream ss;
+  ss << d_->grid_spacing.transpose();
+  config->set_value("grid_spacing", ss.str(),
+                    "Relative spacing of the voxels along each axis.");
+  config->set_value("voxel_spacing_factor", d_->voxel_spacing_factor,
+                    "Size of a voxel in units of the world size of a pixel "
+                    "near the center of the volume.");
+  config->set_value("num_threads", d_->num_threads,
+                    "Number of threads, or zero for one per core.");
+  return config;
+}
+
+
+/// Set this algorithm's properties via a config block
+void
+integrate_depth_maps_cpu
+::set_configuration(vital::config_block_sptr in_config)
+{
+  vital::config_block_sptr config = this->get_configuration();
+  config->merge_config(in_config);
+
+  d_->potential.thickness = config->get_value<double>("ray_potential_thickness");
+  d_->potential.rho = config->get_value<double>("ray_potential_rho");
+  d_->potential.eta = config->get_value<double>("ray_potential_eta");
+  d_->potential.delta = config->get_value<double>("ray_potential_delta");
+  d_->grid_spacing = config->get_value<vector_3d>("grid_spacing");
+  d_->voxel_spacing_factor = config->get_value<double>("voxel_spacing_factor");
+  d_->num_threads = config->get_value<unsigned>("num_threads");
+}
+
+
+/// Check that the algorithm's currently configuration is valid
+bool
+integrate_depth_maps_cpu
+::check_configuration(vital::config_block_sptr config) const
+{
+  bool valid = true;
+
+  double const thickness = config->get_value<double>(
+    "ray_potential_thickness", d_->potential.thickness);
+  double const delta = config->get_value<double>(
+    "ray_potential_delta", d_->potential.delta);
+  if (thickness <= 0.0 || delta <= thickness)
+  {
+    LOG_ERROR(logger(), "ray_potential_thickness must be positive and "
+              "less than ray_potential_delta");
+    valid = false;
+  }
+
+  if (config->get_value<double>("voxel_spacing_factor",
+                                d_->voxel_spacing_factor) <= 0.0)
+  {
+    LOG_ERROR(logger(), "voxel_spacing_factor must be positive");
+    valid = false;
+  }
+
+  return valid;
+}
+
+
+/// Integrate multiple depth maps into a common volume
+void
+integrate_depth_maps_cpu
+::integrate(vector_3d const& minpt_bound, vector_3d const& maxpt_bound,
+            std::vector<image_container_sptr> const& depth_maps,
+            std::vector<camera_perspective_sptr> const& cameras,
+            image_container_sptr& volume, vector_3d& spacing) const
+{
+  double const voxel_size = d_->voxel_spacing_factor *
+    pixel_to_world_scale(minpt_bound, maxpt_bound, cameras);
+  if (voxel_size <= 0.0)
+  {
+    throw vital::invalid_value("No camera sees the center of the volume");
+  }
+
+  // The potential parameters are given in voxels
+  ray_potential potential = d_->potential;
+  potential.thickness *= voxel_size;
+  potential.delta *= voxel_size;
+
+  // Callers treat voxel (i, j, k) as the cell spanning
+  // minpt_bound + [i, i+1] * spacing, so sample the cell centers rather than
+  // centering the voxels in the region
+  spacing = d_->grid_spacing * voxel_size;
+  auto grid = make_voxel_grid(minpt_bound, maxpt_bound, spacing);
+  grid.origin = minpt_bound + 0.5 * spacing;
+  LOG_DEBUG(logger(), "Integrating " << depth_maps.size() << " depth maps "
+            << "into " << grid.dims[0] << " x " << grid.dims[1] << " x "
+            << grid.dims[2] << " voxels");
+
+  std::vector<double> values;
+  integrate_depth_maps(grid, potential, depth_maps, cameras, values,
+                       d_->num_threads);
+
+  image vol(grid.dims[0], grid.dims[1], grid.dims[2], false,
+            image_pixel_traits_of<double>());
+  auto const* src = values.data();
+  for (size_t k = 0; k < grid.dims[2]; ++k)
+  {
+    for (size_t j = 0; j < grid.dims[1]; ++j)
+    {
+      for (size_t i = 0; i < grid.dims[0]; ++i)
+      {
+        vol.at<double>(i, j, k) = *src++;
+      }
+    }
+  }
+  volume = std::make_shared<simple_image_container>(vol);
+}
+
+} // end namespace maptk
+} // end namespace kwiver
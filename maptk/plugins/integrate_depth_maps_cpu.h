@@ -0,0 +1,99 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for CPU integration of depth maps
+ */
+
+#ifndef MAPTK_PLUGINS_INTEGRATE_DEPTH_MAPS_CPU_H_
+#define MAPTK_PLUGINS_INTEGRATE_DEPTH_MAPS_CPU_H_
+
+#include <vital/algo/integrate_depth_maps.h>
+
+#include <memory>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Fuse depth maps into a volume of ray potentials on the CPU
+/**
+ * This is a multithreaded CPU counterpart of the CUDA implementation with
+ * the same parameters.  See maptk::integrate_depth_maps for the details.
+ */
+class integrate_depth_maps_cpu
+  : public vital::algorithm_impl<integrate_depth_maps_cpu,
+                                 vital::algo::integrate_depth_maps>
+{
+public:
+  /// Constructor
+  integrate_depth_maps_cpu();
+
+  /// Destructor
+  virtual ~integrate_depth_maps_cpu();
+
+  /// Get this algorithm's \link vital::config_block configuration block \endlink
+  virtual vital::config_block_sptr get_configuration() const;
+  /// Set this algorithm's properties via a config block
+  virtual void set_configuration(vital::config_block_sptr config);
+  /// Check that the algorithm's currently configuration is valid
+  virtual bool check_configuration(vital::config_block_sptr config) const;
+
+  /// Integrate multiple depth maps into a common volume
+  /**
+   * \param [in]     minpt_bound the min point of the bounding region
+   * \param [in]     maxpt_bound the max point of the bounding region
+   * \param [in]     depth_maps  the set of floating point depth map images
+   * \param [in]     cameras     the set of cameras, one for each depth map
+   * \param [in,out] volume      the fused volume; voxel (i, j, k) is the
+   *                             cell spanning minpt_bound + [i, i+1] *
+   *                             spacing along each axis, sampled at its
+   *                             center, with i varying fastest
+   * \param [out]    spacing     the spacing between voxels in each dimension
+   */
+  virtual void
+  integrate(vital::vector_3d const& minpt_bound,
+            vital::vector_3d const& maxpt_bound,
+            std::vector<vital::image_container_sptr> const& depth_maps,
+            std::vector<vital::camera_perspective_sptr> const& cameras,
+            vital::image_container_sptr& volume,
+            vital::vector_3d& spacing) const;
+
+private:
+  class priv;
+  std::unique_ptr<priv> const d_;
+};
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif // MAPTK_PLUGINS_INTEGRATE_DEPTH_MAPS_CPU_H_
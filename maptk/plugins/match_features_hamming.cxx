@@ -0,0 +1,596 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of a Hamming distance matcher of binary descriptors
+ */
+
+#include "match_features_hamming.h"
+
+#include "hamming_distance.h"
+
+#include <maptk/parallel_for.h>
+
+#include <vital/logger/logger.h>
+#include <vital/types/descriptor.h>
+#include <vital/types/match_set.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <sstream>
+
+using namespace kwiver::vital;
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+static unsigned const NO_DISTANCE = std::numeric_limits<unsigned>::max();
+static uint64_t const NO_MATCH = std::numeric_limits<uint64_t>::max();
+
+
+/// Descriptors packed into zero padded rows of 64-bit words
+struct packed_descriptors
+{
+  size_t rows = 0;
+  size_t words = 0;
+  std::vector<uint64_t> data;
+  std::vector<char> valid;
+
+  uint64_t const* row(size_t i) const { return data.data() + i * words; }
+};
+
+
+/// Find the size in bytes of the largest binary descriptor in a set
+/**
+ * \returns false if the set contains a descriptor that is not binary.
+ */
+bool
+binary_descriptor_bytes(std::vector<descriptor_sptr> const& descriptors,
+                        size_t& bytes)
+{
+  for (auto const& d : descriptors)
+  {
+    if (!d)
+    {
+      continue;
+    }
+    auto const* bd = dynamic_cast<descriptor_array_of<uint8_t> const*>(d.get());
+    if (!bd)
+    {
+      return false;
+    }
+    bytes = std::max(bytes, bd->size());
+  }
+  return true;
+}
+
+
+/// Pack a set of binary descriptors into rows of \p words words
+packed_descriptors
+pack_descriptors(std::vector<descriptor_sptr> const& descriptors, size_t words)
+{
+  packed_descriptors packed;
+  packed.rows = descriptors.size();
+  packed.words = words;
+  packed.data.assign(packed.rows * words, 0);
+  packed.valid.assign(packed.rows, 0);
+  for (size_t i = 0; i < packed.rows; ++i)
+  {
+    auto const* bd = dynamic_cast<descriptor_array_of<uint8_t> const*>(
+      descriptors[i].get());
+    if (bd && bd->size() > 0)
+    {
+      std::memcpy(packed.data.data() + i * words, bd->raw_data(), bd->size());
+      packed.valid[i] = 1;
+    }
+  }
+  return packed;
+}
+
+
+/// Features bucketed into a regular grid of square cells
+/**
+ * The cells are at least as large as the search radius, so every feature
+ * within the radius of a point lies in the cell of the point or one of its
+ * eight neighbors.
+ */
+class location_grid
+{
+public:
+  location_grid(std::vector<vector_2d> const& locations,
+                std::vector<char> const& valid, double radius)
+    : locations_(locations), radius_sqr_(radius * radius)
+  {
+    vector_2d lo(std::numeric_limits<double>::max(),
+                 std::numeric_limits<double>::max());
+    vector_2d hi = -lo;
+    for (size_t i = 0; i < locations.size(); ++i)
+    {
+      if (valid[i])
+      {
+        lo = lo.cwiseMin(locations[i]);
+        hi = hi.cwiseMax(locations[i]);
+      }
+    }
+    if (lo.x() > hi.x())
+    {
+      lo = hi = vector_2d(0, 0);
+    }
+
+    // Bound the number of cells when the radius is small for the extent
+    static double const max_cells_per_side = 1024.0;
+    double const extent = std::max(hi.x() - lo.x(), hi.y() - lo.y());
+    double const cell = std::max(radius, extent / max_cells_per_side);
+
+    origin_ = lo;
+    inv_cell_ = cell > 0.0 ? 1.0 / cell : 0.0;
+    cols_ = static_cast<int>((hi.x() - lo.x()) * inv_cell_) + 1;
+    rows_ = static_cast<int>((hi.y() - lo.y()) * inv_cell_) + 1;
+
+    // Counting sort of the features by cell
+    cell_start_.assign(static_cast<size_t>(cols_) * rows_ + 1, 0);
+    std::vector<size_t> cell_of(locations.size(), 0);
+    for (size_t i = 0; i < locations.size(); ++i)
+    {
+      if (valid[i])
+      {
+        cell_of[i] = cell_index(cell_coord(locations[i].x(), origin_.x(), cols_),
+                                cell_coord(locations[i].y(), origin_.y(), rows_));
+        ++cell_start_[cell_of[i] + 1];
+      }
+    }
+    for (size_t c = 1; c < cell_start_.size(); ++c)
+    {
+      cell_start_[c] += cell_start_[c - 1];
+    }
+    items_.resize(cell_start_.back());
+    std::vector<unsigned> fill(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t i = 0; i < locations.size(); ++i)
+    {
+      if (valid[i])
+      {
+        items_[fill[cell_of[i]]++] = static_cast<unsigned>(i);
+      }
+    }
+  }
+
+  /// Call \p visit with the index of each feature within the radius of \p pt
+  template <typename Visitor>
+  void for_each_near(vector_2d const& pt, Visitor visit) const
+  {
+    int const cx = cell_coord(pt.x(), origin_.x(), cols_);
+    int const cy = cell_coord(pt.y(), origin_.y(), rows_);
+    for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, rows_ - 1); ++y)
+    {
+      for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, cols_ - 1); ++x)
+      {
+        size_t const c = cell_index(x, y);
+        for (unsigned k = cell_start_[c]; k < cell_start_[c + 1]; ++k)
+        {
+          unsigned const j = items_[k];
+          if ((locations_[j] - pt).squaredNorm() <= radius_sqr_)
+          {
+            visit(j);
+          }
+        }
+      }
+    }
+  }
+
+private:
+  int cell_coord(double v, double origin, int count) const
+  {
+    double const c = std::floor((v - origin) * inv_cell_);
+    return static_cast<int>(std::min(std::max(c, -1.0),
+                                     static_cast<double>(count)));
+  }
+
+  size_t cell_index(int x, int y) const
+  {
+    return static_cast<size_t>(y) * cols_ + x;
+  }
+
+  std::vector<vector_2d> const& locations_;
+  double radius_sqr_;
+  vector_2d origin_;
+  double inv_cell_;
+  int cols_;
+  int rows_;
+  std::vector<unsigned> cell_start_;
+  std::vector<unsigned> items_;
+};
+
+
+/// Extract the locations of a feature set
+/**
+ * \returns false if there is not exactly one feature per descriptor.
+ */
+bool
+feature_locations(feature_set_sptr feat, size_t count,
+                  std::vector<vector_2d>& locations)
+{
+  if (!feat || feat->size() != count)
+  {
+    return false;
+  }
+  locations.clear();
+  locations.reserve(count);
+  for (auto const& f : feat->features())
+  {
+    if (!f)
+    {
+      return false;
+    }
+    locations.push_back(f->loc());
+  }
+  return true;
+}
+
+} // end anonymous namespace
+
+
+/// Private implementation class
+class match_features_hamming::priv
+{
+public:
+  priv()
+    : ratio_threshold(0.8),
+      max_distance(64),
+      cross_check(true),
+      search_radius(0.0),
+      num_threads(0),
+      block_size(256),
+      kernel("auto"),
+      distance(hamming::select_kernel("auto"))
+  {
+  }
+
+  /// Best and second best distance of a query descriptor
+  struct row_result
+  {
+    unsigned best = NO_DISTANCE;
+    unsigned second = NO_DISTANCE;
+    unsigned index = 0;
+  };
+
+  /// Find the best candidates of a block of query descriptors
+  void match_block(size_t first, size_t last,
+                   packed_descriptors const& query,
+                   packed_descriptors const& train,
+                   std::vector<vector_2d> const* query_locations,
+                   location_grid const* grid,
+                   std::vector<row_result>& rows,
+                   std::vector<uint64_t>& cols) const
+  {
+    size_t const words = query.words;
+    for (size_t i = first; i < last; ++i)
+    {
+      if (!query.valid[i])
+      {
+        continue;
+      }
+      uint64_t const* q = query.row(i);
+      row_result r;
+      auto visit = [&](unsigned j)
+      {
+        unsigned const d = distance(q, train.row(j), words);
+        if (d < r.best)
+        {
+          r.second = r.best;
+          r.best = d;
+          r.index = j;
+        }
+        else if (d < r.second)
+        {
+          r.second = d;
+        }
+        if (!cols.empty())
+        {
+          uint64_t const key = (static_cast<uint64_t>(d) << 32) | i;
+          cols[j] = std::min(cols[j], key);
+        }
+      };
+
+      if (grid)
+      {
+        grid->for_each_near((*query_locations)[i], visit);
+      }
+      else
+      {
+        for (unsigned j = 0; j < train.rows; ++j)
+        {
+          if (train.valid[j])
+          {
+            visit(j);
+          }
+        }
+      }
+      rows[i] = r;
+    }
+  }
+
+  /// Return true if the best match of a query passes the configured tests
+  bool accept(row_result const& r) const
+  {
+    if (r.best == NO_DISTANCE)
+    {
+      return false;
+    }
+    if (max_distance >= 0 && r.best > static_cast<unsigned>(max_distance))
+    {
+      return false;
+    }
+    if (ratio_threshold < 1.0 && r.second != NO_DISTANCE &&
+        r.best >= ratio_threshold * r.second)
+    {
+      return false;
+    }
+    return true;
+  }
+
+  double ratio_threshold;
+  int max_distance;
+  bool cross_check;
+  double search_radius;
+  unsigned num_threads;
+  unsigned block_size;
+  std::string kernel;
+  hamming::distance_kernel distance;
+};
+
+
+/// Constructor
+match_features_hamming
+::match_features_hamming()
+  : d_(new priv)
+{
+  attach_logger("maptk.match_features_hamming");
+}
+
+
+/// Destructor
+match_features_hamming
+::~match_features_hamming()
+{
+}
+
+
+/// Get this algorithm's \link vital::config_block configuration block \endlink
+vital::config_block_sptr
+match_features_hamming
+::get_configuration() const
+{
+  vital::config_block_sptr config = vital::algorithm::get_configuration();
+
+  config->set_value("ratio_threshold", d_->ratio_threshold,
+                    "Keep a match only if its distance is less than this "
+                    "fraction of the distance to the second best candidate. "
+                    "A value of 1 or more disables the ratio test.");
+  config->set_value("max_distance", d_->max_distance,
+                    "Largest Hamming distance, in bits, of a match. "
+                    "A negative value disables the threshold.");
+  config->set_value("cross_check", d_->cross_check,
+                    "Keep a match only if each descriptor is the best match "
+                    "of the other.");
+  config->set_value("search_radius", d_->search_radius,
+                    "If positive, only match features whose image locations "
+                    "are within this many pixels of each other, found by "
+                    "bucketing the features into a grid. If zero, every "
+                    "pair of descriptors is compared.");
+  config->set_value("num_threads", d_->num_threads,
+                    "Number of threads matching blocks of query descriptors. "
+                    "Zero uses every thread of the vital thread pool.");
+  config->set_value("block_size", d_->block_size,
+                    "Number of query descriptors in a block of work.");
+
+  std::ostringstream kernels;
+  for (auto const& k : hamming::kernel_names())
+  {
+    kernels << k << (hamming::kernel_supported(k) ? "" : " (unsupported)")
+            << ", ";
+  }
+  config->set_value("kernel", d_->kernel,
+                    "Distance kernel to use: auto, " + kernels.str() +
+                    "where auto picks the fastest kernel supported by the "
+                    "processor.");
+  return config;
+}
+
+
+/// Set this algorithm's properties via a config block
+void
+match_features_hamming
+::set_configuration(vital::config_block_sptr in_config)
+{
+  vital::config_block_sptr config = this->get_configuration();
+  config->merge_config(in_config);
+
+  d_->ratio_threshold = config->get_value<double>("ratio_threshold");
+  d_->max_distance = config->get_value<int>("max_distance");
+  d_->cross_check = config->get_value<bool>("cross_check");
+  d_->search_radius = config->get_value<double>("search_radius");
+  d_->num_threads = config->get_value<unsigned>("num_threads");
+  d_->block_size = std::max(config->get_value<unsigned>("block_size"), 1u);
+  d_->kernel = config->get_value<std::string>("kernel");
+
+  std::string selected;
+  d_->distance = hamming::select_kernel(d_->kernel, &selected);
+  if (!d_->distance)
+  {
+    LOG_WARN(logger(), "Distance kernel \"" << d_->kernel << "\" is not "
+             "supported; using the fastest supported kernel");
+    d_->distance = hamming::select_kernel("auto", &selected);
+  }
+  LOG_DEBUG(logger(), "Using the " << selected << " distance kernel");
+}
+
+
+/// Check that the algorithm's currently configuration is valid
+bool
+match_features_hamming
+::check_configuration(vital::config_block_sptr config) const
+{
+  bool valid = true;
+
+  double const ratio = config->get_value<double>("ratio_threshold",
+                                                 d_->ratio_threshold);
+  if (ratio <= 0.0)
+  {
+    LOG_ERROR(logger(), "ratio_threshold must be positive");
+    valid = false;
+  }
+
+  double const radius = config->get_value<double>("search_radius",
+                                                  d_->search_radius);
+  if (radius < 0.0)
+  {
+    LOG_ERROR(logger(), "search_radius must not be negative");
+    valid = false;
+  }
+
+  std::string const kernel = config->get_value<std::string>("kernel",
+                                                            d_->kernel);
+  if (!hamming::select_kernel(kernel))
+  {
+    LOG_ERROR(logger(), "Distance kernel \"" << kernel << "\" is unknown "
+              "or not supported by this processor");
+    valid = false;
+  }
+
+  return valid;
+}
+
+
+/// Match one set of features and corresponding descriptors to another
+vital::match_set_sptr
+match_features_hamming
+::match(vital::feature_set_sptr feat1, vital::descriptor_set_sptr desc1,
+        vital::feature_set_sptr feat2, vital::descriptor_set_sptr desc2) const
+{
+  std::vector<vital::match> matches;
+  if (!desc1 || !desc2 || desc1->size() == 0 || desc2->size() == 0)
+  {
+    return std::make_shared<simple_match_set>(matches);
+  }
+
+  auto const descriptors1 = desc1->descriptors();
+  auto const descriptors2 = desc2->descriptors();
+
+  size_t bytes = 0;
+  if (!binary_descriptor_bytes(descriptors1, bytes) ||
+      !binary_descriptor_bytes(descriptors2, bytes))
+  {
+    LOG_ERROR(logger(), "Hamming matching requires binary descriptors "
+              "of type uint8_t");
+    return std::make_shared<simple_match_set>(matches);
+  }
+  size_t const words =
+    ((bytes + 7) / 8 + hamming::word_alignment - 1) /
+    hamming::word_alignment * hamming::word_alignment;
+
+  auto const query = pack_descriptors(descriptors1, words);
+  auto const train = pack_descriptors(descriptors2, words);
+
+  // Bucket the second set by location when matching within a radius
+  std::vector<vector_2d> locations1, locations2;
+  std::unique_ptr<location_grid> grid;
+  if (d_->search_radius > 0.0)
+  {
+    if (feature_locations(feat1, query.rows, locations1) &&
+        feature_locations(feat2, train.rows, locations2))
+    {
+      grid.reset(new location_grid(locations2, train.valid,
+                                   d_->search_radius));
+    }
+    else
+    {
+      LOG_WARN(logger(), "Features do not correspond to descriptors; "
+               "comparing every pair of descriptors");
+    }
+  }
+
+  // Each block keeps its own best query for every train descriptor, which
+  // is folded into the shared column minima for the cross check
+  std::vector<priv::row_result> rows(query.rows);
+  std::vector<uint64_t> cols;
+  if (d_->cross_check)
+  {
+    cols.assign(train.rows, NO_MATCH);
+  }
+  std::mutex cols_mutex;
+
+  parallel_for_blocks(query.rows, d_->block_size,
+                      [&](size_t first, size_t last)
+  {
+    std::vector<uint64_t> block_cols;
+    if (d_->cross_check)
+    {
+      block_cols.assign(train.rows, NO_MATCH);
+    }
+    d_->match_block(first, last, query, train, &locations1, grid.get(),
+                    rows, block_cols);
+    if (d_->cross_check)
+    {
+      std::lock_guard<std::mutex> lock(cols_mutex);
+      for (size_t j = 0; j < train.rows; ++j)
+      {
+        cols[j] = std::min(cols[j], block_cols[j]);
+      }
+    }
+  }, d_->num_threads);
+
+  for (size_t i = 0; i < query.rows; ++i)
+  {
+    auto const& r = rows[i];
+    if (!d_->accept(r))
+    {
+      continue;
+    }
+    if (d_->cross_check && (cols[r.index] & 0xffffffffu) != i)
+    {
+      continue;
+    }
+    matches.push_back(vital::match(static_cast<unsigned>(i), r.index));
+  }
+
+  LOG_DEBUG(logger(), "Matched " << matches.size() << " of "
+            << query.rows << " descriptors");
+  return std::make_shared<simple_match_set>(matches);
+}
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,100 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for a Hamming distance matcher of binary descriptors
+ */
+
+#ifndef MAPTK_PLUGINS_MATCH_FEATURES_HAMMING_H_
+#define MAPTK_PLUGINS_MATCH_FEATURES_HAMMING_H_
+
+#include <vital/algo/match_features.h>
+
+#include <memory>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Match binary descriptors by Hamming distance
+/**
+ * Descriptors must hold packed bits as \c uint8_t values, as produced by
+ * ORB, BRISK, FREAK and similar detectors.  Every query descriptor is
+ * compared with the candidates using vectorized popcount kernels, selected
+ * at run time for the processor.  Candidates are either all descriptors of
+ * the second set or, with a positive search radius, those whose features
+ * lie within the radius of the query feature, found by bucketing the
+ * features of the second set into a grid.
+ *
+ * A match is kept if it passes the optional distance threshold, ratio test
+ * and cross check.  Query descriptors are processed in blocks on the vital
+ * thread pool.
+ */
+class match_features_hamming
+  : public vital::algorithm_impl<match_features_hamming,
+                                 vital::algo::match_features>
+{
+public:
+  /// Constructor
+  match_features_hamming();
+
+  /// Destructor
+  virtual ~match_features_hamming();
+
+  /// Get this algorithm's \link vital::config_block configuration block \endlink
+  virtual vital::config_block_sptr get_configuration() const;
+  /// Set this algorithm's properties via a config block
+  virtual void set_configuration(vital::config_block_sptr config);
+  /// Check that the algorithm's currently configuration is valid
+  virtual bool check_configuration(vital::config_block_sptr config) const;
+
+  /// Match one set of features and corresponding descriptors to another
+  /**
+   * \param [in] feat1 the first set of features to match
+   * \param [in] desc1 the descriptors corresponding to \a feat1
+   * \param [in] feat2 the second set of features to match
+   * \param [in] desc2 the descriptors corresponding to \a feat2
+   * \returns a set of matching indices from \a feat1 to \a feat2
+   */
+  virtual vital::match_set_sptr
+  match(vital::feature_set_sptr feat1, vital::descriptor_set_sptr desc1,
+        vital::feature_set_sptr feat2, vital::descriptor_set_sptr desc2) const;
+
+private:
+  class priv;
+  std::unique_ptr<priv> const d_;
+};
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif // MAPTK_PLUGINS_MATCH_FEATURES_HAMMING_H_
@@ -0,0 +1,88 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Register MAP-Tk algorithms with the plugin loader
+ */
+
+#include <maptk/plugins/maptk_plugins_export.h>
+
+#include <vital/algo/algorithm_factory.h>
+
+#include "estimate_canonical_transform_pca.h"
+#include "integrate_depth_maps_cpu.h"
+#include "match_features_hamming.h"
+
+
+extern "C"
+MAPTK_PLUGINS_EXPORT
+void
+register_factories(kwiver::vital::plugin_loader& vpm)
+{
+  static auto const module_name = std::string("maptk.plugins");
+  if (vpm.is_module_loaded(module_name))
+  {
+    return;
+  }
+
+  auto fact = vpm.ADD_ALGORITHM("maptk_hamming",
+                                kwiver::maptk::match_features_hamming);
+  fact->add_attribute(kwiver::vital::plugin_factory::PLUGIN_DESCRIPTION,
+                      "Brute force or grid bucketed matching of binary "
+                      "descriptors by Hamming distance, with ratio test and "
+                      "cross check, using vectorized popcount kernels.")
+    .add_attribute(kwiver::vital::plugin_factory::PLUGIN_MODULE_NAME, module_name)
+    .add_attribute(kwiver::vital::plugin_factory::PLUGIN_VERSION, "1.0")
+    .add_attribute(kwiver::vital::plugin_factory::PLUGIN_ORGANIZATION, "Kitware Inc.")
+    ;
+
+  fact = vpm.ADD_ALGORITHM("maptk_cpu",
+                           kwiver::maptk::integrate_depth_maps_cpu);
+  fact->add_attribute(kwiver::vital::plugin_factory::PLUGIN_DESCRIPTION,
+                      "Multithreaded CPU fusion of depth maps into a volume "
+                      "of ray potentials.")
+    .add_attribute(kwiver::vital::plugin_factory::PLUGIN_MODULE_NAME, module_name)
+    .add_attribute(kwiver::vital::plugin_factory::PLUGIN_VERSION, "1.0")
+    .add_attribute(kwiver::vital::plugin_factory::PLUGIN_ORGANIZATION, "Kitware Inc.")
+    ;
+
+  fact = vpm.ADD_ALGORITHM("maptk_pca",
+                           kwiver::maptk::estimate_canonical_transform_pca);
+  fact->add_attribute(kwiver::vital::plugin_factory::PLUGIN_DESCRIPTION,
+                      "Canonical transform from the principal axes of the "
+                      "landmarks, computed in a single parallel pass.")
+    .add_attribute(kwiver::vital::plugin_factory::PLUGIN_MODULE_NAME, module_name)
+    .add_attribute(kwiver::vital::plugin_factory::PLUGIN_VERSION, "1.0")
+    .add_attribute(kwiver::vital::plugin_factory::PLUGIN_ORGANIZATION, "Kitware Inc.")
+    ;
+
+  vpm.mark_module_as_loaded(module_name);
+}
@@ -0,0 +1,320 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of projection kernels specialized by lens distortion
+ */
+
+#include "projection_kernels.h"
+
+#include <maptk/distortion_map.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+/// Normalized points at which specialized distortion is checked
+double const check_points[][2] = {
+  { 0.0, 0.0 }, { 0.4, 0.3 }, { -0.5, 0.2 }, { 0.3, -0.6 }, { -0.7, -0.5 } };
+
+/// Largest relative difference accepted by the check
+double const check_tolerance = 1e-9;
+
+
+/// The parameters of a camera, unpacked for the kernels
+struct projection
+{
+  explicit projection(vital::camera_intrinsics const& intrinsics)
+    : R(vital::matrix_3x3d::Identity()),
+      t(vital::vector_3d::Zero())
+  {
+    auto const K = intrinsics.as_matrix();
+    fx = K(0, 0);
+    skew = K(0, 1);
+    cx = K(0, 2);
+    fy = K(1, 1);
+    cy = K(1, 2);
+    auto const d = intrinsics.dist_coeffs();
+    double* c[] = { &k1, &k2, &p1, &p2, &k3 };
+    for (size_t i = 0; i < 5; ++i)
+    {
+      *c[i] = i < d.size() ? d[i] : 0.0;
+    }
+  }
+
+  explicit projection(vital::camera_perspective const& camera)
+    : projection(*camera.intrinsics())
+  {
+    R = camera.rotation().matrix();
+    t = camera.translation();
+  }
+
+  vital::matrix_3x3d R;
+  vital::vector_3d t;
+  double fx, skew, cx, fy, cy;
+  double k1, k2, p1, p2, k3;
+};
+
+
+/// Apply lens distortion of model \p M to a normalized point
+template <distortion_model M>
+inline void distort(projection const&, double&, double&);
+
+template <>
+inline void
+distort<distortion_model::none>(projection const&, double&, double&)
+{
+}
+
+template <>
+inline void
+distort<distortion_model::radial>(projection const& p, double& x, double& y)
+{
+  double const r2 = x * x + y * y;
+  double const s = 1.0 + r2 * (p.k1 + r2 * (p.k2 + r2 * p.k3));
+  x *= s;
+  y *= s;
+}
+
+template <>
+inline void
+distort<distortion_model::brown>(projection const& p, double& x, double& y)
+{
+  double const x2 = x * x;
+  double const y2 = y * y;
+  double const xy = x * y;
+  double const r2 = x2 + y2;
+  double const s = 1.0 + r2 * (p.k1 + r2 * (p.k2 + r2 * p.k3));
+  double const dx = 2.0 * p.p1 * xy + p.p2 * (r2 + 2.0 * x2);
+  double const dy = p.p1 * (r2 + 2.0 * y2) + 2.0 * p.p2 * xy;
+  x = x * s + dx;
+  y = y * s + dy;
+}
+
+
+/// Map a normalized point to the image with distortion model \p M
+template <distortion_model M>
+inline vital::vector_2d
+map(projection const& p, vital::camera_intrinsics const&, double x, double y)
+{
+  distort<M>(p, x, y);
+  return vital::vector_2d(p.fx * x + p.skew * y + p.cx, p.fy * y + p.cy);
+}
+
+template <>
+inline vital::vector_2d
+map<distortion_model::other>(projection const&,
+                             vital::camera_intrinsics const& intrinsics,
+                             double x, double y)
+{
+  return intrinsics.map(vital::vector_2d(x, y));
+}
+
+
+/// Check that model \p M reproduces the mapping of the intrinsics
+template <distortion_model M>
+bool
+agrees(projection const& p, vital::camera_intrinsics const& intrinsics)
+{
+  for (auto const& c : check_points)
+  {
+    vital::vector_2d const norm_pt(c[0], c[1]);
+    vital::vector_2d const expected = intrinsics.map(norm_pt);
+    vital::vector_2d const actual = map<M>(p, intrinsics, c[0], c[1]);
+    if (!((actual - expected).norm() <=
+          check_tolerance * (1.0 + expected.norm())))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/// Project a block of points with distortion model \p M
+template <distortion_model M>
+size_t
+project_block(projection const& p, vital::camera_intrinsics const& intrinsics,
+              vital::vector_3d const* points, size_t num_points,
+              vital::vector_2d* image_points, double* depths)
+{
+  double const inf = std::numeric_limits<double>::infinity();
+  size_t num_in_front = 0;
+  for (size_t i = 0; i < num_points; ++i)
+  {
+    vital::vector_3d const q = p.R * points[i] + p.t;
+    if (depths)
+    {
+      depths[i] = q[2];
+    }
+    if (q[2] <= 0.0)
+    {
+      image_points[i] = vital::vector_2d(inf, inf);
+      continue;
+    }
+    ++num_in_front;
+    double const w = 1.0 / q[2];
+    image_points[i] = map<M>(p, intrinsics, q[0] * w, q[1] * w);
+  }
+  return num_in_front;
+}
+
+
+/// Return the model of the intrinsics, as unpacked in \p p
+distortion_model
+classify(projection const& p, vital::camera_intrinsics const& intrinsics)
+{
+  auto const d = intrinsics.dist_coeffs();
+  for (size_t i = 5; i < d.size(); ++i)
+  {
+    if (d[i] != 0.0)
+    {
+      return distortion_model::other;
+    }
+  }
+
+  if (p.k1 == 0.0 && p.k2 == 0.0 && p.k3 == 0.0 &&
+      p.p1 == 0.0 && p.p2 == 0.0)
+  {
+    return agrees<distortion_model::none>(p, intrinsics)
+      ? distortion_model::none : distortion_model::other;
+  }
+  if (p.p1 == 0.0 && p.p2 == 0.0)
+  {
+    return agrees<distortion_model::radial>(p, intrinsics)
+      ? distortion_model::radial : distortion_model::other;
+  }
+  return agrees<distortion_model::brown>(p, intrinsics)
+    ? distortion_model::brown : distortion_model::other;
+}
+
+} // end anonymous namespace
+
+
+/// Return the distortion model of camera intrinsics
+distortion_model
+get_distortion_model(vital::camera_intrinsics const& intrinsics)
+{
+  return classify(projection(intrinsics), intrinsics);
+}
+
+
+/// Project a block of points into one camera
+size_t
+project_points(vital::camera_perspective const& camera,
+               vital::vector_3d const* points, size_t num_points,
+               vital::vector_2d* image_points, double* depths)
+{
+  auto const& intrinsics = *camera.intrinsics();
+  projection const p(camera);
+  switch (classify(p, intrinsics))
+  {
+    case distortion_model::none:
+      return project_block<distortion_model::none>(
+        p, intrinsics, points, num_points, image_points, depths);
+    case distortion_model::radial:
+      return project_block<distortion_model::radial>(
+        p, intrinsics, points, num_points, image_points, depths);
+    case distortion_model::brown:
+      return project_block<distortion_model::brown>(
+        p, intrinsics, points, num_points, image_points, depths);
+    default:
+      return project_block<distortion_model::other>(
+        p, intrinsics, points, num_points, image_points, depths);
+  }
+}
+
+
+/// Unproject a block of image points at known depths from one camera
+void
+unproject_points(vital::camera_perspective const& camera,
+                 vital::vector_2d const* image_points, double const* depths,
+                 size_t num_points, vital::vector_3d* points)
+{
+  auto const& intrinsics = *camera.intrinsics();
+  projection const p(camera);
+  vital::matrix_3x3d const Rt = p.R.transpose();
+
+  if (classify(p, intrinsics) == distortion_model::none)
+  {
+    for (size_t i = 0; i < num_points; ++i)
+    {
+      double const y = (image_points[i][1] - p.cy) / p.fy;
+      double const x = (image_points[i][0] - p.cx - p.skew * y) / p.fx;
+      points[i] =
+        Rt * (vital::vector_3d(x, y, 1.0) * depths[i] - p.t);
+    }
+    return;
+  }
+
+  auto const dmap = distortion_map::shared(intrinsics);
+  for (size_t i = 0; i < num_points; ++i)
+  {
+    vital::vector_2d const norm_pt = dmap->unmap(image_points[i]);
+    points[i] =
+      Rt * (vital::vector_3d(norm_pt[0], norm_pt[1], 1.0) * depths[i] - p.t);
+  }
+}
+
+
+/// Mark the points of a block that project near an image
+size_t
+cull_points(vital::camera_perspective const& camera,
+            vital::vector_3d const* points, size_t num_points,
+            double width, double height, double margin,
+            vital::vector_2d* image_points, unsigned char* visible)
+{
+  std::vector<double> depths(num_points);
+  project_points(camera, points, num_points, image_points, depths.data());
+
+  double const x0 = -margin * width;
+  double const y0 = -margin * height;
+  double const x1 = (1.0 + margin) * width;
+  double const y1 = (1.0 + margin) * height;
+  size_t num_visible = 0;
+  for (size_t i = 0; i < num_points; ++i)
+  {
+    auto const& ip = image_points[i];
+    visible[i] = depths[i] > 0.0 &&
+                 ip[0] >= x0 && ip[0] < x1 && ip[1] >= y0 && ip[1] < y1;
+    num_visible += visible[i];
+  }
+  return num_visible;
+}
+
+} // end namespace maptk
+} // end namespace kwiver
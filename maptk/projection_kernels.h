@@ -0,0 +1,144 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for projection kernels specialized by lens distortion model
+ */
+
+#ifndef MAPTK_PROJECTION_KERNELS_H_
+#define MAPTK_PROJECTION_KERNELS_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/camera_intrinsics.h>
+#include <vital/types/camera_perspective.h>
+
+#include <cstddef>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Lens distortion models with specialized projection kernels
+/**
+ * The coefficients follow the vital (OpenCV) order k1, k2, p1, p2, k3.
+ */
+enum class distortion_model
+{
+  /// No distortion; projection is linear in homogeneous coordinates
+  none,
+  /// Radial distortion only (k1, k2, k3)
+  radial,
+  /// Radial and tangential (Brown-Conrady) distortion (k1, k2, p1, p2, k3)
+  brown,
+  /// Any other model; projection goes through the intrinsics
+  other,
+};
+
+
+/// Return the distortion model of camera intrinsics
+/**
+ * The model is only reported as one of the specialized models if the
+ * specialized distortion agrees with the intrinsics at a few sample
+ * points, so intrinsics with a different convention use the generic path.
+ */
+MAPTK_EXPORT
+distortion_model
+get_distortion_model(vital::camera_intrinsics const& intrinsics);
+
+
+/// Project a block of points into one camera
+/**
+ * The distortion model of the camera is found once, and all points are
+ * projected by a kernel specialized for it.  Points at or behind the
+ * camera are given infinite image coordinates.
+ *
+ *  \param [in] camera the camera to project into
+ *  \param [in] points the world points to project
+ *  \param [in] num_points the number of points
+ *  \param [out] image_points the image coordinates of each point
+ *  \param [out] depths if not null, the depth of each point
+ *  \return the number of points in front of the camera
+ */
+MAPTK_EXPORT
+size_t
+project_points(vital::camera_perspective const& camera,
+               vital::vector_3d const* points, size_t num_points,
+               vital::vector_2d* image_points, double* depths = nullptr);
+
+
+/// Unproject a block of image points at known depths from one camera
+/**
+ * Without distortion, the unprojection is exact and closed form.
+ * Otherwise it uses the shared lookup grids of distortion_map, and so is
+ * within their error bound of the exact unprojection.
+ *
+ *  \param [in] camera the camera to unproject from
+ *  \param [in] image_points the image coordinates to unproject
+ *  \param [in] depths the depth of each point along the optical axis
+ *  \param [in] num_points the number of points
+ *  \param [out] points the world points
+ */
+MAPTK_EXPORT
+void
+unproject_points(vital::camera_perspective const& camera,
+                 vital::vector_2d const* image_points, double const* depths,
+                 size_t num_points, vital::vector_3d* points);
+
+
+/// Mark the points of a block that project near an image
+/**
+ * A point is kept if it is in front of the camera and projects within
+ * \p margin times the image size of the image, in every direction.  A
+ * margin of zero keeps only points that project into the image.
+ *
+ *  \param [in] camera the camera to project into
+ *  \param [in] points the world points to test
+ *  \param [in] num_points the number of points
+ *  \param [in] width the width of the image, in pixels
+ *  \param [in] height the height of the image, in pixels
+ *  \param [in] margin extra range accepted, as a multiple of the image size
+ *  \param [out] image_points the image coordinates of each point
+ *  \param [out] visible set to nonzero for the points kept
+ *  \return the number of points kept
+ */
+MAPTK_EXPORT
+size_t
+cull_points(vital::camera_perspective const& camera,
+            vital::vector_3d const* points, size_t num_points,
+            double width, double height, double margin,
+            vital::vector_2d* image_points, unsigned char* visible);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif
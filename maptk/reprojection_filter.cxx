@@ -0,0 +1,181 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of filtering feature tracks by reprojection error
+ */
+
+#include "reprojection_filter.h"
+#include "parallel_for.h"
+
+#include <vital/types/camera_perspective.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Remove feature track states with a large reprojection error
+vital::feature_track_set_sptr
+filter_tracks_by_reprojection_error(
+  vital::feature_track_set_sptr tracks,
+  vital::camera_map_sptr cameras,
+  vital::landmark_map_sptr landmarks,
+  double max_error,
+  unsigned min_track_length,
+  unsigned num_threads,
+  reprojection_filter_stats* stats)
+{
+  if (stats)
+  {
+    *stats = reprojection_filter_stats();
+  }
+  if (!tracks || !cameras || !landmarks)
+  {
+    return tracks;
+  }
+
+  // Look up cameras and landmarks once rather than per state
+  std::map<vital::frame_id_t, vital::camera_perspective const*> cams;
+  auto const all_cams = cameras->cameras();
+  for (auto const& p : all_cams)
+  {
+    auto const cam =
+      dynamic_cast<vital::camera_perspective const*>(p.second.get());
+    if (cam)
+    {
+      cams.emplace(p.first, cam);
+    }
+  }
+  auto const lms = landmarks->landmarks();
+
+  auto const in_tracks = tracks->tracks();
+  std::vector<vital::track_sptr> out_tracks(in_tracks.size());
+  double const max_sq_error = max_error * max_error;
+
+  reprojection_filter_stats totals;
+  std::mutex totals_mutex;
+
+  // Work is handed out a block of tracks at a time; each track is written to
+  // its own slot so the output keeps the input order
+  static size_t const tracks_per_task = 256;
+  parallel_for_blocks(in_tracks.size(), tracks_per_task,
+                      [&](size_t i0, size_t i1)
+  {
+    reprojection_filter_stats counts;
+    std::vector<bool> keep;
+    for (size_t i = i0; i < i1; ++i)
+    {
+      auto const& t = in_tracks[i];
+      out_tracks[i] = t;
+
+      auto const li = lms.find(static_cast<vital::landmark_id_t>(t->id()));
+      if (li == lms.end() || !li->second)
+      {
+        continue;
+      }
+      vital::vector_3d const X = li->second->loc();
+
+      keep.assign(t->size(), true);
+      size_t num_kept = t->size();
+      size_t k = 0;
+      for (auto const& ts : *t)
+      {
+        auto const fts =
+          std::dynamic_pointer_cast<vital::feature_track_state>(ts);
+        auto const ci = cams.find(ts->frame());
+        if (fts && fts->feature && ci != cams.end())
+        {
+          ++counts.states_checked;
+          auto const cam = ci->second;
+          if (cam->depth(X) <= 0.0 ||
+              (cam->project(X) - fts->feature->loc()).squaredNorm() >
+                max_sq_error)
+          {
+            keep[k] = false;
+            --num_kept;
+          }
+        }
+        ++k;
+      }
+
+      if (num_kept == t->size())
+      {
+        continue;
+      }
+      counts.states_removed += t->size() - num_kept;
+      if (num_kept < min_track_length)
+      {
+        ++counts.tracks_removed;
+        out_tracks[i] = nullptr;
+        continue;
+      }
+
+      // Copy only the tracks that lost states
+      ++counts.tracks_modified;
+      auto const new_track = vital::track::create(t->data());
+      new_track->set_id(t->id());
+      k = 0;
+      for (auto const& ts : *t)
+      {
+        if (keep[k++])
+        {
+          new_track->append(ts->clone());
+        }
+      }
+      out_tracks[i] = new_track;
+    }
+
+    std::lock_guard<std::mutex> lock(totals_mutex);
+    totals.states_checked += counts.states_checked;
+    totals.states_removed += counts.states_removed;
+    totals.tracks_modified += counts.tracks_modified;
+    totals.tracks_removed += counts.tracks_removed;
+  }, num_threads);
+
+  out_tracks.erase(std::remove(out_tracks.begin(), out_tracks.end(), nullptr),
+                   out_tracks.end());
+  auto result = std::make_shared<vital::feature_track_set>(out_tracks);
+  result->set_frame_data(tracks->all_frame_data());
+
+  if (stats)
+  {
+    *stats = totals;
+  }
+  return result;
+}
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,99 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for filtering feature tracks by reprojection error
+ */
+
+#ifndef MAPTK_REPROJECTION_FILTER_H_
+#define MAPTK_REPROJECTION_FILTER_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/camera_map.h>
+#include <vital/types/feature_track_set.h>
+#include <vital/types/landmark_map.h>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Counts of what a reprojection error filter removed
+struct MAPTK_EXPORT reprojection_filter_stats
+{
+  /// Number of track states that were checked against a camera
+  size_t states_checked = 0;
+  /// Number of track states removed
+  size_t states_removed = 0;
+  /// Number of tracks that lost some but not all of their states
+  size_t tracks_modified = 0;
+  /// Number of tracks removed
+  size_t tracks_removed = 0;
+};
+
+
+/// Remove feature track states with a large reprojection error
+/**
+ * Each state of a track with a landmark, on a frame with a perspective
+ * camera, is checked by projecting the landmark into that camera.  States
+ * where the landmark is behind the camera, or projects farther than
+ * \p max_error pixels from the feature, are removed.  Tracks left with
+ * fewer than \p min_track_length states are removed entirely.  States that
+ * cannot be checked are kept.
+ *
+ * The tracks are checked in parallel.  Tracks that lose no states are shared
+ * with the input set rather than copied.
+ *
+ *  \param [in] tracks the feature tracks to filter
+ *  \param [in] cameras the cameras used to project landmarks
+ *  \param [in] landmarks the landmarks, with IDs matching the track IDs
+ *  \param [in] max_error the largest reprojection error kept, in pixels
+ *  \param [in] min_track_length the fewest states a modified track may keep
+ *  \param [in] num_threads number of threads to use, or 0 for one per core
+ *  \param [out] stats if not null, set to the counts of what was removed
+ *  \return the filtered track set
+ */
+MAPTK_EXPORT
+vital::feature_track_set_sptr
+filter_tracks_by_reprojection_error(
+  vital::feature_track_set_sptr tracks,
+  vital::camera_map_sptr cameras,
+  vital::landmark_map_sptr landmarks,
+  double max_error,
+  unsigned min_track_length = 2,
+  unsigned num_threads = 0,
+  reprojection_filter_stats* stats = nullptr);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif
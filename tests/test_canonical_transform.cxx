@@ -0,0 +1,140 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Tests of the point statistics used by the canonical transform
+ */
+
+#include <maptk/canonical_transform.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace kwiver;
+using maptk::point_statistics;
+
+namespace {
+
+/// Random points far from the origin, where a naive variance loses accuracy
+std::vector<vital::vector_3d>
+make_points(size_t count)
+{
+  std::mt19937 rng(7);
+  std::normal_distribution<double> x(1e5, 3.0), y(-2e4, 0.5), z(10.0, 20.0);
+  std::vector<vital::vector_3d> points;
+  for (size_t i = 0; i < count; ++i)
+  {
+    double const xi = x(rng);
+    points.push_back(vital::vector_3d(xi, y(rng) + 0.1 * xi, z(rng)));
+  }
+  return points;
+}
+
+
+/// Check statistics against a two pass mean and covariance
+void
+expect_statistics(std::vector<vital::vector_3d> const& points,
+                  point_statistics const& stats)
+{
+  vital::vector_3d mean = vital::vector_3d::Zero();
+  for (auto const& p : points)
+  {
+    mean += p;
+  }
+  mean /= static_cast<double>(points.size());
+
+  vital::matrix_3x3d covar = vital::matrix_3x3d::Zero();
+  for (auto const& p : points)
+  {
+    covar += (p - mean) * (p - mean).transpose();
+  }
+  covar /= static_cast<double>(points.size());
+
+  ASSERT_EQ(points.size(), stats.count());
+  EXPECT_TRUE(stats.mean().isApprox(mean, 1e-12))
+    << stats.mean().transpose() << " != " << mean.transpose();
+  EXPECT_TRUE(stats.covariance().isApprox(covar, 1e-9))
+    << stats.covariance() << "\n!=\n" << covar;
+}
+
+} // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+TEST(point_statistics, add)
+{
+  auto const points = make_points(1000);
+  point_statistics stats;
+  for (auto const& p : points)
+  {
+    stats.add(p);
+  }
+  expect_statistics(points, stats);
+}
+
+
+// ----------------------------------------------------------------------------
+TEST(point_statistics, merge)
+{
+  auto const points = make_points(1000);
+
+  // Merge subsets of uneven sizes, including empty ones
+  std::vector<size_t> const splits = { 0, 0, 1, 17, 500, 999, 1000, 1000 };
+  point_statistics merged;
+  for (size_t s = 0; s + 1 < splits.size(); ++s)
+  {
+    point_statistics part;
+    for (size_t i = splits[s]; i < splits[s + 1]; ++i)
+    {
+      part.add(points[i]);
+    }
+    merged.merge(part);
+  }
+  expect_statistics(points, merged);
+
+  // Merging into empty statistics copies them
+  point_statistics copy;
+  copy.merge(merged);
+  EXPECT_EQ(merged.count(), copy.count());
+  EXPECT_EQ(merged.mean(), copy.mean());
+  EXPECT_EQ(merged.covariance(), copy.covariance());
+}
+
+
+// ----------------------------------------------------------------------------
+TEST(point_statistics, compute_in_parallel)
+{
+  auto const points = make_points(100000);
+  expect_statistics(points, maptk::compute_point_statistics(points, 1));
+  expect_statistics(points, maptk::compute_point_statistics(points, 4));
+  EXPECT_EQ(0u, maptk::compute_point_statistics({}).count());
+}
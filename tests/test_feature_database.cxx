@@ -0,0 +1,331 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Tests of the feature and descriptor database
+ */
+
+#include <maptk/feature_database.h>
+
+#include <vital/exceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+using namespace kwiver;
+using maptk::feature_database;
+
+namespace {
+
+/// Remove a file when the test ends
+struct scoped_file
+{
+  explicit scoped_file(std::string const& p) : path(p)
+  { std::remove(path.c_str()); }
+  ~scoped_file() { std::remove(path.c_str()); }
+
+  std::string path;
+};
+
+
+/// Make a descriptor set of float descriptors from rows of values
+vital::descriptor_set_sptr
+make_descriptors(std::vector<std::vector<float>> const& rows)
+{
+  std::vector<vital::descriptor_sptr> descriptors;
+  for (auto const& r : rows)
+  {
+    auto d = std::make_shared<vital::descriptor_dynamic<float>>(r.size());
+    std::copy(r.begin(), r.end(), d->raw_data());
+    descriptors.push_back(d);
+  }
+  return std::make_shared<vital::simple_descriptor_set>(descriptors);
+}
+
+
+/// Make a feature set of one feature per row, at the row index
+vital::feature_set_sptr
+make_features(size_t count)
+{
+  std::vector<vital::feature_sptr> features;
+  for (size_t i = 0; i < count; ++i)
+  {
+    features.push_back(std::make_shared<vital::feature_d>(
+      vital::vector_2d(static_cast<double>(i), 0.0)));
+  }
+  return std::make_shared<vital::simple_feature_set>(features);
+}
+
+
+/// Store descriptor values with an encoding and load them back
+std::vector<double>
+round_trip(std::string const& path, std::vector<float> const& values,
+           feature_database::descriptor_encoding encoding)
+{
+  scoped_file file(path);
+  {
+    feature_database db(path, true);
+    db.set_descriptor_encoding(encoding);
+    db.append("frame", 0, make_features(1), make_descriptors({ values }));
+  }
+  feature_database db(path);
+  vital::feature_set_sptr feat;
+  vital::descriptor_set_sptr desc;
+  EXPECT_TRUE(db.load(0, feat, desc));
+  if (!desc || desc->size() != 1)
+  {
+    ADD_FAILURE() << "Descriptor was not loaded";
+    return {};
+  }
+  return desc->descriptors()[0]->as_double();
+}
+
+} // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+TEST(feature_database, round_trip_features)
+{
+  scoped_file file("test_round_trip.tsfdb");
+
+  std::vector<vital::feature_sptr> float_features;
+  std::vector<vital::feature_sptr> double_features;
+  std::vector<std::vector<float>> values;
+  for (int i = 0; i < 10; ++i)
+  {
+    auto ff = std::make_shared<vital::feature_f>(
+      vital::vector_2f(1.5f * i, -0.25f * i), 0.5f * i, 2.0f + i, 0.1f * i,
+      vital::rgb_color(i, 2 * i, 3 * i));
+    Eigen::Matrix2f cf;
+    cf << 2.0f + i, 0.5f, 0.5f, 3.0f;
+    ff->set_covar(vital::covariance_2f(cf));
+    float_features.push_back(ff);
+
+    auto fd = std::make_shared<vital::feature_d>(
+      vital::vector_2d(1.0 / (i + 1), 3.0 * i), 0.25 * i, 1.0 + i, -0.3 * i,
+      vital::rgb_color(255 - i, 0, i));
+    Eigen::Matrix2d cd;
+    cd << 1.0 + i, -0.125, -0.125, 4.0;
+    fd->set_covar(vital::covariance_2d(cd));
+    double_features.push_back(fd);
+
+    values.push_back({ 0.1f * i, -2.0f, 1e3f, static_cast<float>(i) });
+  }
+
+  {
+    feature_database db(file.path, true);
+    db.append("float", 4,
+              std::make_shared<vital::simple_feature_set>(float_features),
+              make_descriptors(values));
+    db.append("double", 7,
+              std::make_shared<vital::simple_feature_set>(double_features),
+              nullptr);
+  }
+
+  feature_database db(file.path);
+  EXPECT_TRUE(db.contains(4));
+  EXPECT_TRUE(db.contains("double"));
+  EXPECT_FALSE(db.contains(5));
+
+  vital::feature_set_sptr feat;
+  vital::descriptor_set_sptr desc;
+  ASSERT_TRUE(db.load(4, feat, desc));
+  ASSERT_EQ(float_features.size(), feat->size());
+  ASSERT_EQ(values.size(), desc->size());
+  auto const loaded = feat->features();
+  auto const descriptors = desc->descriptors();
+  for (size_t i = 0; i < loaded.size(); ++i)
+  {
+    auto const f = std::dynamic_pointer_cast<vital::feature_f>(loaded[i]);
+    ASSERT_NE(nullptr, f) << "feature " << i << " lost single precision";
+    auto const& expected =
+      static_cast<vital::feature_f const&>(*float_features[i]);
+    EXPECT_EQ(expected.get_loc(), f->get_loc());
+    EXPECT_EQ(expected.magnitude(), f->magnitude());
+    EXPECT_EQ(expected.scale(), f->scale());
+    EXPECT_EQ(expected.angle(), f->angle());
+    EXPECT_EQ(expected.color(), f->color());
+    EXPECT_EQ(expected.covar().matrix(), f->covar().matrix());
+
+    auto const d = std::dynamic_pointer_cast<
+      vital::descriptor_dynamic<float>>(descriptors[i]);
+    ASSERT_NE(nullptr, d);
+    ASSERT_EQ(values[i].size(), d->size());
+    for (size_t j = 0; j < values[i].size(); ++j)
+    {
+      EXPECT_EQ(values[i][j], d->raw_data()[j]);
+    }
+  }
+
+  ASSERT_TRUE(db.load("double", feat, desc));
+  ASSERT_EQ(double_features.size(), feat->size());
+  for (size_t i = 0; i < double_features.size(); ++i)
+  {
+    auto const f =
+      std::dynamic_pointer_cast<vital::feature_d>(feat->features()[i]);
+    ASSERT_NE(nullptr, f);
+    EXPECT_EQ(double_features[i]->loc(), f->loc());
+    EXPECT_EQ(double_features[i]->angle(), f->angle());
+    EXPECT_EQ(double_features[i]->covar().matrix(), f->covar().matrix());
+  }
+}
+
+
+// ----------------------------------------------------------------------------
+TEST(feature_database, reject_byte_order)
+{
+  scoped_file file("test_byte_order.tsfdb");
+  {
+    feature_database db(file.path, true);
+    db.append("frame", 0, make_features(2), nullptr);
+  }
+
+  // Reverse the byte order mark, which follows the magic and the version
+  {
+    std::fstream f(file.path,
+                   std::ios::in | std::ios::out | std::ios::binary);
+    char mark[4];
+    f.seekg(12);
+    f.read(mark, 4);
+    std::reverse(mark, mark + 4);
+    f.seekp(12);
+    f.write(mark, 4);
+  }
+
+  EXPECT_THROW(feature_database db(file.path), vital::invalid_file);
+}
+
+
+// ----------------------------------------------------------------------------
+TEST(feature_database, reject_mixed_descriptor_sizes)
+{
+  scoped_file file("test_mixed_sizes.tsfdb");
+  feature_database db(file.path, true);
+  EXPECT_THROW(db.append("frame", 0, make_features(2),
+                         make_descriptors({ { 1.0f, 2.0f, 3.0f, 4.0f },
+                                            { 1.0f, 2.0f, 3.0f } })),
+               vital::invalid_value);
+  EXPECT_FALSE(db.contains(0));
+}
+
+
+// ----------------------------------------------------------------------------
+TEST(feature_database, float16_rounding)
+{
+  float const inf = std::numeric_limits<float>::infinity();
+  float const min_subnormal = std::ldexp(1.0f, -24);
+  std::vector<std::pair<float, float>> const cases = {
+    { 1.0f, 1.0f },
+    { -2.5f, -2.5f },
+    { 0.1f, 0.0999755859375f },
+    { 65504.0f, 65504.0f },
+    // halfway cases round to even
+    { 65520.0f, inf },
+    { 1.0f + std::ldexp(1.0f, -11), 1.0f },
+    { 1.0f + std::ldexp(3.0f, -11), 1.0f + std::ldexp(1.0f, -9) },
+    // subnormal and underflowing values
+    { min_subnormal, min_subnormal },
+    { std::ldexp(3.0f, -26), min_subnormal },
+    { 1e-8f, 0.0f },
+    { -inf, -inf },
+  };
+
+  std::vector<float> values;
+  for (auto const& c : cases)
+  {
+    values.push_back(c.first);
+  }
+  auto const loaded = round_trip("test_float16.tsfdb", values,
+    feature_database::descriptor_encoding::float16);
+  ASSERT_EQ(cases.size(), loaded.size());
+  for (size_t i = 0; i < cases.size(); ++i)
+  {
+    EXPECT_EQ(cases[i].second, loaded[i]) << "value " << cases[i].first;
+  }
+
+  auto const nan = round_trip("test_float16.tsfdb",
+    { std::numeric_limits<float>::quiet_NaN() },
+    feature_database::descriptor_encoding::float16);
+  ASSERT_EQ(1u, nan.size());
+  EXPECT_TRUE(std::isnan(nan[0]));
+}
+
+
+// ----------------------------------------------------------------------------
+TEST(feature_database, quantization)
+{
+  scoped_file file("test_quantization.tsfdb");
+  feature_database::quantization const q = { -1.0f, 0.01f };
+  std::vector<float> const values = { -1.0f, -0.5f, 0.0f, 0.123f, 1.54f,
+                                      -3.0f, 5.0f };
+
+  {
+    feature_database db(file.path, true);
+    db.set_descriptor_encoding(
+      feature_database::descriptor_encoding::quantized8);
+    db.set_quantization(q);
+    db.append("frame", 0, make_features(1), make_descriptors({ values }));
+
+    feature_database::quantization other = { 0.0f, 1.0f };
+    EXPECT_THROW(db.set_quantization(other), vital::invalid_value);
+  }
+
+  feature_database db(file.path);
+  feature_database::quantization stored;
+  ASSERT_TRUE(db.get_quantization(stored));
+  EXPECT_EQ(q.offset, stored.offset);
+  EXPECT_EQ(q.scale, stored.scale);
+
+  vital::feature_set_sptr feat;
+  vital::descriptor_set_sptr desc;
+  ASSERT_TRUE(db.load(0, feat, desc));
+  auto const expanded = desc->descriptors()[0]->as_double();
+
+  ASSERT_TRUE(db.load(0, feat, desc, true));
+  auto const compact = std::dynamic_pointer_cast<
+    vital::descriptor_dynamic<uint8_t>>(desc->descriptors()[0]);
+  ASSERT_NE(nullptr, compact);
+
+  // Values outside the 256 codes covered by the quantization are clamped
+  std::vector<uint8_t> const codes = { 0, 50, 100, 112, 254, 0, 255 };
+  ASSERT_EQ(codes.size(), expanded.size());
+  ASSERT_EQ(codes.size(), compact->size());
+  for (size_t i = 0; i < codes.size(); ++i)
+  {
+    EXPECT_EQ(codes[i], compact->raw_data()[i]) << "value " << values[i];
+    EXPECT_NEAR(q.offset + codes[i] * q.scale, expanded[i], 1e-6);
+  }
+}
@@ -0,0 +1,160 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Tests of the frame index of a feature track pool
+ */
+
+#include <maptk/feature_track_frame_index.h>
+
+#include <gtest/gtest.h>
+
+using namespace kwiver;
+using maptk::feature_track_frame_index;
+using maptk::feature_track_pool;
+
+namespace {
+
+/// A pool of tracks with overlapping, irregular frame ranges
+feature_track_pool
+make_pool(std::vector<feature_track_frame_index::entry>& added)
+{
+  feature_track_pool pool;
+  for (vital::track_id_t id = 0; id < 200; ++id)
+  {
+    for (vital::frame_id_t f = id % 13; f < 40 + id % 7; f += 1 + id % 3)
+    {
+      feature_track_pool::state s = feature_track_pool::state();
+      s.frame = f;
+      s.loc = vital::vector_2d(static_cast<double>(id), f);
+      EXPECT_TRUE(pool.append(id, s));
+      added.push_back({ id, pool.num_states() - 1 });
+    }
+  }
+  return pool;
+}
+
+
+/// Check that two indices have the same entries in the same order
+void
+expect_same_index(feature_track_frame_index const& expected,
+                  feature_track_frame_index const& actual)
+{
+  ASSERT_EQ(expected.size(), actual.size());
+  ASSERT_EQ(expected.first_frame(), actual.first_frame());
+  ASSERT_EQ(expected.last_frame(), actual.last_frame());
+  for (auto f = expected.first_frame(); f <= expected.last_frame(); ++f)
+  {
+    auto const e = expected.frame_states(f);
+    auto const a = actual.frame_states(f);
+    ASSERT_EQ(e.size(), a.size()) << "frame " << f;
+    for (size_t i = 0; i < e.size(); ++i)
+    {
+      EXPECT_EQ(e[i].track_id, a[i].track_id) << "frame " << f;
+      EXPECT_EQ(e[i].state, a[i].state) << "frame " << f;
+    }
+  }
+}
+
+} // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+TEST(feature_track_frame_index, build)
+{
+  std::vector<feature_track_frame_index::entry> added;
+  auto const pool = make_pool(added);
+
+  feature_track_frame_index const index(pool, 1);
+  ASSERT_EQ(pool.num_states(), index.size());
+  EXPECT_EQ(0, index.first_frame());
+  EXPECT_EQ(pool.last_frame(), index.last_frame());
+  EXPECT_TRUE(index.frame_states(index.last_frame() + 1).empty());
+  EXPECT_TRUE(index.frame_states(-1).empty());
+
+  size_t total = 0;
+  for (auto f = index.first_frame(); f <= index.last_frame(); ++f)
+  {
+    vital::track_id_t prev_id = -1;
+    for (auto const& e : index.frame_states(f))
+    {
+      EXPECT_EQ(f, pool.state_at(e.state).frame);
+      EXPECT_EQ(&pool.state_at(e.state), pool.find_track(e.track_id).find(f));
+      EXPECT_LT(prev_id, e.track_id) << "entries are not in track order";
+      prev_id = e.track_id;
+      ++total;
+    }
+  }
+  EXPECT_EQ(pool.num_states(), total);
+
+  // The index does not depend on the number of threads building it
+  expect_same_index(index, feature_track_frame_index(pool, 4));
+}
+
+
+// ----------------------------------------------------------------------------
+TEST(feature_track_frame_index, append_matches_build)
+{
+  std::vector<feature_track_frame_index::entry> added;
+  auto const pool = make_pool(added);
+
+  // The states were added track by track, so most appends go to a frame
+  // before the last frame of the index
+  feature_track_frame_index index;
+  EXPECT_TRUE(index.empty());
+  for (auto const& a : added)
+  {
+    index.append(pool.state_at(a.state).frame, a.track_id, a.state);
+  }
+  expect_same_index(feature_track_frame_index(pool), index);
+}
+
+
+// ----------------------------------------------------------------------------
+TEST(feature_track_frame_index, append_new_frames)
+{
+  std::vector<feature_track_frame_index::entry> added;
+  auto const pool = make_pool(added);
+
+  // Appending frame by frame, as a tracker does, only adds at the end
+  feature_track_frame_index index;
+  for (auto f = vital::frame_id_t{ 0 }; f <= pool.last_frame(); ++f)
+  {
+    for (auto const& a : added)
+    {
+      if (pool.state_at(a.state).frame == f)
+      {
+        index.append(f, a.track_id, a.state);
+      }
+    }
+  }
+  expect_same_index(feature_track_frame_index(pool), index);
+}
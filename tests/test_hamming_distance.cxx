@@ -0,0 +1,116 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Tests of the Hamming distance kernels
+ */
+
+#include <maptk/plugins/hamming_distance.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace kwiver::maptk;
+
+namespace {
+
+/// Count the differing bits of two descriptors one bit at a time
+unsigned
+scalar_distance(uint64_t const* a, uint64_t const* b, size_t words)
+{
+  unsigned count = 0;
+  for (size_t w = 0; w < words; ++w)
+  {
+    for (uint64_t x = a[w] ^ b[w]; x; x >>= 1)
+    {
+      count += static_cast<unsigned>(x & 1);
+    }
+  }
+  return count;
+}
+
+} // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+TEST(hamming_distance, kernels_match_scalar_count)
+{
+  std::mt19937_64 rng(42);
+  for (auto const& name : hamming::kernel_names())
+  {
+    if (!hamming::kernel_supported(name))
+    {
+      continue;
+    }
+    auto const kernel = hamming::select_kernel(name);
+    ASSERT_NE(nullptr, kernel) << name;
+
+    for (size_t words = hamming::word_alignment; words <= 16;
+         words += hamming::word_alignment)
+    {
+      std::vector<uint64_t> a(words), b(words);
+      for (int trial = 0; trial < 100; ++trial)
+      {
+        for (size_t w = 0; w < words; ++w)
+        {
+          a[w] = rng();
+          b[w] = rng();
+        }
+        // include identical and complementary descriptors
+        if (trial == 0)
+        {
+          b = a;
+        }
+        else if (trial == 1)
+        {
+          for (size_t w = 0; w < words; ++w)
+          {
+            b[w] = ~a[w];
+          }
+        }
+        EXPECT_EQ(scalar_distance(a.data(), b.data(), words),
+                  kernel(a.data(), b.data(), words))
+          << name << " kernel, " << words << " words";
+      }
+    }
+  }
+}
+
+
+// ----------------------------------------------------------------------------
+TEST(hamming_distance, select_kernel)
+{
+  std::string selected;
+  EXPECT_NE(nullptr, hamming::select_kernel("auto", &selected));
+  EXPECT_TRUE(hamming::kernel_supported(selected));
+  EXPECT_EQ(nullptr, hamming::select_kernel("no_such_kernel"));
+}
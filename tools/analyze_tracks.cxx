@@ -28,6 +28,8 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "tool_common.h"
+
 #include <iostream>
 #include <fstream>
 #include <exception>
@@ -175,10 +177,8 @@ static int maptk_main(int argc, char const* argv[])
     return EXIT_SUCCESS;
   }
 
-  // register the algorithm implementations
-  std::string rel_plugin_path = kwiver::vital::get_executable_path() + "/../lib/kwiver/modules";
-  kwiver::vital::plugin_manager::instance().add_search_path(rel_plugin_path);
-  kwiver::vital::plugin_manager::instance().load_all_plugins();
+  // register the algorithm implementations used by the configuration
+  kwiver::maptk::load_tool_plugins(opt_config);
 
   // Set config to algo chain
   // Get config from algo chain after set
@@ -198,8 +198,8 @@ static int maptk_main(int argc, char const* argv[])
   if( ! opt_config.empty() )
   {
     const std::string prefix = kwiver::vital::get_executable_path() + "/..";
-    config->merge_config(kwiver::vital::read_config_file(opt_config, "telesculptor",
-                                                         TELESCULPTOR_VERSION, prefix));
+    config->merge_config(kwiver::maptk::read_config_file_cached(opt_config, "telesculptor",
+                                                                TELESCULPTOR_VERSION, prefix));
   }
 
   // Load all input images if they are specified
@@ -347,7 +347,7 @@ static int maptk_main(int argc, char const* argv[])
 
 
 // ------------------------------------------------------------------
-int main( int argc, char const* argv[] )
+MAPTK_TOOL_MAIN( int argc, char const* argv[] )
 {
   try
   {
@@ -39,6 +39,7 @@
 #include <fstream>
 #include <sstream>
 #include <exception>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -70,8 +71,8 @@
 #include <arrows/core/metrics.h>
 #include <arrows/core/match_matrix.h>
 #include <arrows/core/necker_reverse.h>
-#include <arrows/core/transform.h>
 
+#include <maptk/canonical_transform.h>
 #include <maptk/colorize.h>
 #include <maptk/geo_reference_points_io.h>
 #include <vital/types/local_geo_cs.h>
@@ -159,6 +160,16 @@ static kwiver::vital::config_block_sptr default_config()
   config->set_value("output_krtd_dir", "output/krtd",
                     "A directory in which to write the output KRTD files.");
 
+  config->set_value("warm_start", "false",
+                    "Start from the cameras and landmarks written to "
+                    "output_krtd_dir and output_ply_file by a previous run, "
+                    "when they exist, instead of from the input cameras.\n"
+                    "\n"
+                    "The initializer then only initializes the cameras and "
+                    "landmarks missing from the previous solution, and "
+                    "bundle adjustment refines that solution rather than "
+                    "starting over.");
+
   config->set_value("camera_sample_rate", "1",
                     "Sub-sample the cameras for by this rate.\n"
                     "Set to 1 to use all cameras, "
@@ -398,6 +409,60 @@ bool load_input_cameras(kwiver::vital::config_block_sptr config,
 }
 
 
+// Load the solution written by a previous run of this tool.
+//
+// The previous cameras replace the corresponding entries of cameras, and
+// landmarks is set to the previous landmarks of the given tracks.
+//
+// Returns true if a previous solution was found, otherwise false and the
+// outputs are left unchanged.
+bool load_previous_solution(kwiver::vital::config_block_sptr config,
+                            std::map<kwiver::vital::frame_id_t, std::string> const& basename_map,
+                            kwiver::vital::feature_track_set_sptr tracks,
+                            kwiver::vital::camera_map::map_camera_t & cameras,
+                            kwiver::vital::landmark_map_sptr & landmarks)
+{
+  std::string krtd_dir = config->get_value<std::string>("output_krtd_dir", "");
+  std::string ply_file = config->get_value<std::string>("output_ply_file", "");
+  if (krtd_dir == "" || ply_file == "" ||
+      !ST::FileIsDirectory(krtd_dir) || !ST::FileExists(ply_file, true))
+  {
+    return false;
+  }
+
+  kwiver::vital::camera_map::map_camera_t prev_cameras =
+    kwiver::maptk::load_input_cameras_krtd(krtd_dir, basename_map);
+  if (prev_cameras.empty())
+  {
+    return false;
+  }
+
+  // Drop landmarks of tracks that no longer exist (e.g. after changing the
+  // track filter)
+  std::set<kwiver::vital::track_id_t> track_ids = tracks->all_track_ids();
+  kwiver::vital::landmark_map::map_landmark_t prev_landmarks;
+  for (auto const& p : kwiver::vital::read_ply_file(ply_file)->landmarks())
+  {
+    if (p.second && track_ids.count(p.first))
+    {
+      prev_landmarks.insert(p);
+    }
+  }
+  if (prev_landmarks.empty())
+  {
+    return false;
+  }
+
+  for (auto const& p : prev_cameras)
+  {
+    cameras[p.first] = p.second;
+  }
+  landmarks = kwiver::vital::landmark_map_sptr(
+    new kwiver::vital::simple_landmark_map(prev_landmarks));
+  return true;
+}
+
+
 static int maptk_main(int argc, char const* argv[])
 {
   static bool        opt_help(false);
@@ -432,10 +497,8 @@ static int maptk_main(int argc, char const* argv[])
     return EXIT_SUCCESS;
   }
 
-  // register the algorithm implementations
-  std::string rel_plugin_path = kwiver::vital::get_executable_path() + "/../lib/kwiver/modules";
-  kwiver::vital::plugin_manager::instance().add_search_path(rel_plugin_path);
-  kwiver::vital::plugin_manager::instance().load_all_plugins();
+  // register the algorithm implementations used by the configuration
+  kwiver::maptk::load_tool_plugins(opt_config, { "pos" });
 
   // Tell PROJ where to find its data files
   std::string rel_proj_path = kwiver::vital::get_executable_path() + "/../share/proj";
@@ -467,8 +530,8 @@ static int maptk_main(int argc, char const* argv[])
   if( ! opt_config.empty() )
   {
     const std::string prefix = kwiver::vital::get_executable_path() + "/..";
-    config->merge_config(kwiver::vital::read_config_file(opt_config, "telesculptor",
-                                                         TELESCULPTOR_VERSION, prefix));
+    config->merge_config(kwiver::maptk::read_config_file_cached(opt_config, "telesculptor",
+                                                                TELESCULPTOR_VERSION, prefix));
   }
 
 
@@ -625,6 +688,25 @@ static int maptk_main(int argc, char const* argv[])
       cameras[v.first] = v.second->clone();
     }
   }
+
+  // Warm start from the previous solution if requested and available
+  bool warm_started = false;
+  if (config->get_value<bool>("warm_start", false))
+  {
+    warm_started = load_previous_solution(config, basename_map, tracks,
+                                          cameras, lm_map);
+    if (warm_started)
+    {
+      LOG_INFO(main_logger, "Warm starting from " << cameras.size()
+                            << " cameras and " << lm_map->size()
+                            << " landmarks of the previous solution");
+    }
+    else
+    {
+      LOG_INFO(main_logger, "No previous solution found; starting from "
+                            << "the input cameras");
+    }
+  }
   kwiver::vital::camera_map_sptr cam_map;
   if(!cameras.empty())
   {
@@ -654,7 +736,11 @@ static int maptk_main(int argc, char const* argv[])
 
   // apply necker reversal if requested
   bool necker_reverse_input = config->get_value<bool>("necker_reverse_input", false);
-  if (necker_reverse_input)
+  if (necker_reverse_input && warm_started)
+  {
+    LOG_INFO(main_logger, "Not applying Necker reversal to the previous solution");
+  }
+  else if (necker_reverse_input)
   {
     LOG_INFO(main_logger, "Applying Necker reversal");
     kwiver::arrows::core::necker_reverse(cam_map, lm_map);
@@ -817,8 +903,8 @@ static int maptk_main(int argc, char const* argv[])
 
     // apply to cameras and landmarks
     LOG_INFO(main_logger, "Applying transform to cameras and landmarks");
-    cam_map = kwiver::arrows::core::transform(cam_map, sim_transform);
-    lm_map = kwiver::arrows::core::transform(lm_map, sim_transform);
+    kwiver::maptk::transform_inplace(*cam_map, sim_transform);
+    kwiver::maptk::transform_inplace(*lm_map, sim_transform);
   }
 
   //
@@ -908,7 +994,7 @@ static int maptk_main(int argc, char const* argv[])
 }
 
 
-int main(int argc, char const* argv[])
+MAPTK_TOOL_MAIN(int argc, char const* argv[])
 {
   try
   {
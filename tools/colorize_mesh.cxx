@@ -0,0 +1,968 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Mesh colorization utility
+ */
+
+#include "tool_common.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vital/config/config_block.h>
+#include <vital/config/config_block_io.h>
+#include <vital/exceptions.h>
+#include <vital/io/metadata_io.h>
+#include <vital/logger/logger.h>
+#include <vital/types/camera_perspective.h>
+#include <vital/types/image.h>
+#include <vital/util/get_paths.h>
+#include <vital/vital_types.h>
+
+#include <vital/algo/video_input.h>
+
+#include <kwiversys/CommandLineArguments.hxx>
+#include <kwiversys/SystemTools.hxx>
+
+#include <maptk/projection_kernels.h>
+#include <maptk/version.h>
+
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPLYReader.h>
+#include <vtkPLYWriter.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkSmartPointer.h>
+#include <vtkTriangleFilter.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkXMLPolyDataReader.h>
+
+typedef kwiversys::SystemTools     ST;
+
+using kwiver::vital::algo::video_input;
+using kwiver::vital::algo::video_input_sptr;
+using kwiver::vital::camera_perspective_sptr;
+using kwiver::vital::frame_id_t;
+using kwiver::vital::vector_3d;
+
+static kwiver::vital::logger_handle_t main_logger( kwiver::vital::get_logger( "colorize_mesh_tool" ) );
+
+static char const* const BLOCK_VR = "video_reader";
+
+
+static kwiver::vital::config_block_sptr default_config()
+{
+  kwiver::vital::config_block_sptr config = kwiver::vital::config_block::empty_config("colorize_mesh_tool");
+
+  config->set_value("video_source", "",
+                    "Path to an input file to be opened as a video. "
+                    "This could be either a video file or a text file "
+                    "containing new-line separated paths to sequential "
+                    "image files.");
+
+  config->set_value("input_krtd_files", "",
+                    "A directory containing input KRTD camera files, named "
+                    "after the frames of the video.");
+
+  config->set_value("input_mesh_file", "",
+                    "Mesh to colorize, as PLY or VTK poly data.");
+
+  config->set_value("output_mesh_file", "results/colored_mesh.ply",
+                    "Path of the colored PLY mesh to write.");
+
+  config->set_value("coloring", "mean",
+                    "How the colors seen in each frame are combined at a "
+                    "vertex: \"mean\", \"median\", or \"best\" to take the "
+                    "color from the frame that sees the vertex most "
+                    "directly and closely.");
+
+  config->set_value("frame_sampling", 1,
+                    "Use every Nth frame that has a camera.");
+
+  config->set_value("median_samples", 15,
+                    "Number of colors kept per vertex for the median. A "
+                    "vertex seen in more frames keeps a uniform random "
+                    "sample of its colors, which bounds the memory used.");
+
+  config->set_value("occlusion_tolerance", 0.01,
+                    "A vertex is hidden in a frame if it lies farther than "
+                    "the nearest surface along its ray by more than this "
+                    "fraction of the depth.");
+
+  config->set_value("occlusion_scale", 0.5,
+                    "Resolution of the depth buffer used to find hidden "
+                    "vertices, relative to the frame images.");
+
+  config->set_value("num_threads", 0,
+                    "Number of frames processed in parallel. Zero uses one "
+                    "per processor core.");
+
+  kwiver::vital::algo::video_input::get_nested_algo_configuration(BLOCK_VR, config,
+                                                                  kwiver::vital::algo::video_input_sptr());
+  return config;
+}
+
+
+// ------------------------------------------------------------------
+static bool check_config(kwiver::vital::config_block_sptr config)
+{
+  bool config_valid = true;
+
+#define MAPTK_CONFIG_FAIL(msg) \
+  LOG_ERROR(main_logger, "Config Check Fail: " << msg); \
+  config_valid = false
+
+  std::string const video_source = config->get_value<std::string>("video_source", "");
+  if (video_source.empty())
+  {
+    MAPTK_CONFIG_FAIL("Config needs value video_source");
+  }
+  else if ( ! ST::FileExists( kwiver::vital::path_t(video_source) ) )
+  {
+    MAPTK_CONFIG_FAIL("video_source path, " << video_source << ", does not exist");
+  }
+
+  std::string const krtd_dir = config->get_value<std::string>("input_krtd_files", "");
+  if (krtd_dir.empty() || ! ST::FileIsDirectory(krtd_dir))
+  {
+    MAPTK_CONFIG_FAIL("input_krtd_files must be an existing directory");
+  }
+
+  std::string const mesh = config->get_value<std::string>("input_mesh_file", "");
+  if (mesh.empty() || ! ST::FileExists(mesh, true))
+  {
+    MAPTK_CONFIG_FAIL("input_mesh_file must be an existing file");
+  }
+
+  if (config->get_value<std::string>("output_mesh_file", "").empty())
+  {
+    MAPTK_CONFIG_FAIL("Config needs value output_mesh_file");
+  }
+
+  std::string const coloring = config->get_value<std::string>("coloring", "");
+  if (coloring != "mean" && coloring != "median" && coloring != "best")
+  {
+    MAPTK_CONFIG_FAIL("coloring must be mean, median or best");
+  }
+
+  if (config->get_value<int>("frame_sampling", 0) < 1 ||
+      config->get_value<int>("median_samples", 0) < 1)
+  {
+    MAPTK_CONFIG_FAIL("frame_sampling and median_samples must be positive");
+  }
+
+  double const scale = config->get_value<double>("occlusion_scale", 0.0);
+  if (scale <= 0.0 || scale > 1.0)
+  {
+    MAPTK_CONFIG_FAIL("occlusion_scale must be in (0, 1]");
+  }
+
+  if (config->get_value<int>("num_threads", 0) < 0)
+  {
+    MAPTK_CONFIG_FAIL("num_threads must not be negative");
+  }
+
+  if (!video_input::check_nested_algo_configuration(BLOCK_VR, config))
+  {
+    MAPTK_CONFIG_FAIL("video_reader configuration check failed");
+  }
+
+#undef MAPTK_CONFIG_FAIL
+
+  return config_valid;
+}
+
+
+namespace {
+
+/// A decoded frame and its camera
+struct frame_data
+{
+  frame_id_t frame;
+  kwiver::vital::image image;
+  camera_perspective_sptr camera;
+};
+
+
+/// A bounded queue handing decoded frames from the reader to the workers
+class frame_queue
+{
+public:
+  explicit frame_queue(size_t capacity) : capacity_(capacity) {}
+
+  /// Add a frame, waiting while the queue is full
+  void push(frame_data&& data)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return queue_.size() < capacity_; });
+    queue_.push_back(std::move(data));
+    not_empty_.notify_one();
+  }
+
+  /// Take a frame, waiting while the queue is empty and open
+  /**
+   * \returns false once the queue is closed and empty.
+   */
+  bool pop(frame_data& data)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return !queue_.empty() || closed_; });
+    if (queue_.empty())
+    {
+      return false;
+    }
+    data = std::move(queue_.front());
+    queue_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  /// Signal that no more frames will be added
+  void close()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+private:
+  size_t capacity_;
+  bool closed_ = false;
+  std::deque<frame_data> queue_;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+};
+
+
+enum class color_method { mean, median, best };
+
+
+/// Per vertex color statistics, updated concurrently by the workers
+/**
+ * Vertices are grouped into blocks, each guarded by one of a fixed set of
+ * mutexes, and a worker adds the observations of a frame one block at a
+ * time.  The memory used depends only on the number of vertices.
+ */
+class color_accumulator
+{
+public:
+  static size_t const block_size = 4096;
+
+  color_accumulator(size_t num_points, color_method method, unsigned samples)
+    : method_(method), samples_(samples), count_(num_points, 0),
+      locks_(256)
+  {
+    switch (method_)
+    {
+      case color_method::mean:
+        sum_.assign(3 * num_points, 0);
+        break;
+      case color_method::median:
+        reservoir_.assign(3 * samples_ * num_points, 0);
+        break;
+      case color_method::best:
+        best_score_.assign(num_points, -std::numeric_limits<float>::max());
+        best_color_.assign(3 * num_points, 0);
+        break;
+    }
+  }
+
+  /// Return the mutex guarding the block of a vertex
+  std::mutex& lock_for(size_t point)
+  {
+    return locks_[(point / block_size) % locks_.size()];
+  }
+
+  /// Add an observation of a vertex; its block must be locked
+  void add(size_t point, uint8_t const* rgb, float score)
+  {
+    uint32_t const n = count_[point]++;
+    switch (method_)
+    {
+      case color_method::mean:
+        for (int c = 0; c < 3; ++c)
+        {
+          sum_[3 * point + c] += rgb[c];
+        }
+        break;
+
+      case color_method::median:
+      {
+        // Reservoir sampling keeps a uniform sample of the observations
+        size_t slot = n;
+        if (n >= samples_)
+        {
+          slot = mix(point, n) % (static_cast<uint64_t>(n) + 1);
+          if (slot >= samples_)
+          {
+            break;
+          }
+        }
+        std::copy(rgb, rgb + 3, &reservoir_[3 * (samples_ * point + slot)]);
+        break;
+      }
+
+      case color_method::best:
+        if (score > best_score_[point])
+        {
+          best_score_[point] = score;
+          std::copy(rgb, rgb + 3, &best_color_[3 * point]);
+        }
+        break;
+    }
+  }
+
+  /// Compute the final color and observation count of every vertex
+  void finish(vtkUnsignedCharArray* colors, vtkIntArray* counts) const
+  {
+    size_t const num_points = count_.size();
+    std::vector<uint8_t> values;
+    for (size_t p = 0; p < num_points; ++p)
+    {
+      uint32_t const n = count_[p];
+      counts->SetValue(static_cast<vtkIdType>(p), static_cast<int>(n));
+      for (int c = 0; c < 3; ++c)
+      {
+        double v = 0.0;
+        if (n == 0)
+        {
+          // Unseen vertices are left black
+        }
+        else if (method_ == color_method::mean)
+        {
+          v = static_cast<double>(sum_[3 * p + c]) / n;
+        }
+        else if (method_ == color_method::best)
+        {
+          v = best_color_[3 * p + c];
+        }
+        else
+        {
+          size_t const m = std::min<size_t>(n, samples_);
+          values.resize(m);
+          for (size_t s = 0; s < m; ++s)
+          {
+            values[s] = reservoir_[3 * (samples_ * p + s) + c];
+          }
+          std::sort(values.begin(), values.end());
+          v = m % 2 ? values[m / 2]
+                    : 0.5 * (values[m / 2 - 1] + values[m / 2]);
+        }
+        colors->SetTypedComponent(static_cast<vtkIdType>(p), c,
+                                  static_cast<unsigned char>(v + 0.5));
+      }
+    }
+  }
+
+private:
+  static uint64_t mix(uint64_t a, uint64_t b)
+  {
+    uint64_t z = (a << 32) ^ b;
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  color_method method_;
+  size_t samples_;
+  std::vector<uint32_t> count_;
+  std::vector<uint32_t> sum_;
+  std::vector<uint8_t> reservoir_;
+  std::vector<float> best_score_;
+  std::vector<uint8_t> best_color_;
+  std::vector<std::mutex> locks_;
+};
+
+
+/// A triangle mesh with unit vertex normals
+struct mesh_data
+{
+  vtkSmartPointer<vtkPolyData> poly_data;
+  std::vector<vector_3d> points;
+  std::vector<vector_3d> normals;
+  std::vector<std::array<vtkIdType, 3>> triangles;
+};
+
+
+/// Load a mesh, triangulating it and computing normals if it has none
+bool
+load_mesh(std::string const& path, mesh_data& mesh, bool& computed_normals)
+{
+  vtkSmartPointer<vtkPolyData> input;
+  if (ST::LowerCase(ST::GetFilenameLastExtension(path)) == ".ply")
+  {
+    vtkNew<vtkPLYReader> reader;
+    reader->SetFileName(path.c_str());
+    reader->Update();
+    input = reader->GetOutput();
+  }
+  else
+  {
+    vtkNew<vtkXMLPolyDataReader> reader;
+    reader->SetFileName(path.c_str());
+    reader->Update();
+    input = reader->GetOutput();
+  }
+  if (!input || input->GetNumberOfPoints() == 0)
+  {
+    return false;
+  }
+
+  vtkNew<vtkTriangleFilter> triangulate;
+  triangulate->SetInputData(input);
+  triangulate->PassVertsOff();
+  triangulate->PassLinesOff();
+  triangulate->Update();
+  vtkSmartPointer<vtkPolyData> tris = triangulate->GetOutput();
+
+  computed_normals = tris->GetPointData()->GetNormals() == nullptr;
+  if (computed_normals)
+  {
+    vtkNew<vtkPolyDataNormals> normals;
+    normals->SetInputData(tris);
+    normals->ComputePointNormalsOn();
+    normals->SplittingOff();
+    normals->ConsistencyOn();
+    normals->Update();
+    tris = normals->GetOutput();
+  }
+  mesh.poly_data = tris;
+
+  vtkIdType const num_pts = tris->GetNumberOfPoints();
+  vtkDataArray* normals = tris->GetPointData()->GetNormals();
+  mesh.points.resize(static_cast<size_t>(num_pts));
+  mesh.normals.resize(static_cast<size_t>(num_pts));
+  for (vtkIdType i = 0; i < num_pts; ++i)
+  {
+    tris->GetPoint(i, mesh.points[i].data());
+    normals->GetTuple(i, mesh.normals[i].data());
+    mesh.normals[i].normalize();
+  }
+
+  vtkCellArray* polys = tris->GetPolys();
+  vtkIdType npts;
+  vtkIdType* ids;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, ids);)
+  {
+    if (npts == 3)
+    {
+      mesh.triangles.push_back({{ ids[0], ids[1], ids[2] }});
+    }
+  }
+  return true;
+}
+
+
+/// Flip the normals if most vertices face away from the cameras
+/**
+ * Normals computed from the triangles are consistent across the mesh but
+ * may all point into the surface.  The cameras observe the outside of the
+ * surface, so the sign is chosen to face them.
+ */
+void
+orient_normals(mesh_data& mesh,
+               std::vector<camera_perspective_sptr> const& cameras)
+{
+  if (cameras.empty())
+  {
+    return;
+  }
+  size_t const step = std::max<size_t>(mesh.points.size() / 10000, 1);
+  long long facing = 0;
+  for (size_t i = 0; i < mesh.points.size(); i += step)
+  {
+    auto const& cam = cameras[(i / step) % cameras.size()];
+    facing += (cam->center() - mesh.points[i]).dot(mesh.normals[i]) > 0.0
+              ? 1 : -1;
+  }
+  if (facing < 0)
+  {
+    for (auto& n : mesh.normals)
+    {
+      n = -n;
+    }
+  }
+}
+
+
+/// Find the vertices of a mesh seen in a frame and add their colors
+/**
+ * The mesh is rasterized into a reduced resolution depth buffer, with
+ * depth interpolated in perspective, so that vertices hidden behind other
+ * parts of the surface are excluded.  Vertices facing away from the camera
+ * are excluded as well.
+ */
+class frame_colorizer
+{
+public:
+  frame_colorizer(mesh_data const& mesh, double occlusion_scale,
+                  double occlusion_tolerance)
+    : mesh_(mesh), scale_(occlusion_scale), tolerance_(occlusion_tolerance)
+  {
+  }
+
+  void process(frame_data const& frame, color_accumulator& colors)
+  {
+    auto const& cam = *frame.camera;
+    auto const& img = frame.image;
+    size_t const num_pts = mesh_.points.size();
+
+    // Project every vertex with the kernel for the camera's distortion
+    uv_.resize(num_pts);
+    depth_.resize(num_pts);
+    kwiver::maptk::project_points(cam, mesh_.points.data(), num_pts,
+                                  uv_.data(), depth_.data());
+
+    // Rasterize the depth buffer
+    int const bw = std::max(static_cast<int>(std::ceil(img.width() * scale_)), 1);
+    int const bh = std::max(static_cast<int>(std::ceil(img.height() * scale_)), 1);
+    zbuf_.assign(static_cast<size_t>(bw) * bh,
+                 std::numeric_limits<float>::infinity());
+    for (auto const& t : mesh_.triangles)
+    {
+      rasterize(t, bw, bh);
+    }
+
+    // Sample the colors of visible vertices, one block at a time
+    size_t const depth_channels = img.depth();
+    for (size_t b0 = 0; b0 < num_pts; b0 += color_accumulator::block_size)
+    {
+      size_t const b1 = std::min(b0 + color_accumulator::block_size, num_pts);
+      std::unique_lock<std::mutex> lock(colors.lock_for(b0), std::defer_lock);
+      for (size_t i = b0; i < b1; ++i)
+      {
+        double const d = depth_[i];
+        if (d <= 0.0)
+        {
+          continue;
+        }
+        auto const& uv = uv_[i];
+        if (uv[0] < 0.0 || uv[1] < 0.0 ||
+            uv[0] >= img.width() || uv[1] >= img.height())
+        {
+          continue;
+        }
+        vector_3d const ray = mesh_.points[i] - cam.center();
+        double const facing = -ray.dot(mesh_.normals[i]);
+        if (facing <= 0.0)
+        {
+          continue;
+        }
+        int const bx = std::min(static_cast<int>(uv[0] * scale_), bw - 1);
+        int const by = std::min(static_cast<int>(uv[1] * scale_), bh - 1);
+        if (d > zbuf_[static_cast<size_t>(by) * bw + bx] * (1.0 + tolerance_))
+        {
+          continue;
+        }
+
+        size_t const x = static_cast<size_t>(uv[0]);
+        size_t const y = static_cast<size_t>(uv[1]);
+        uint8_t rgb[3];
+        for (size_t c = 0; c < 3; ++c)
+        {
+          rgb[c] = img.at<uint8_t>(x, y, std::min(c, depth_channels - 1));
+        }
+        // Prefer views that see the surface head on and from close by
+        float const score = static_cast<float>(facing / (ray.norm() * d));
+
+        if (!lock.owns_lock())
+        {
+          lock.lock();
+        }
+        colors.add(i, rgb, score);
+      }
+    }
+  }
+
+private:
+  void rasterize(std::array<vtkIdType, 3> const& t, int bw, int bh)
+  {
+    double x[3], y[3], iz[3];
+    for (int k = 0; k < 3; ++k)
+    {
+      double const d = depth_[t[k]];
+      if (d <= 0.0)
+      {
+        return;
+      }
+      x[k] = uv_[t[k]][0] * scale_;
+      y[k] = uv_[t[k]][1] * scale_;
+      iz[k] = 1.0 / d;
+    }
+    double const area = (x[1] - x[0]) * (y[2] - y[0]) -
+                        (x[2] - x[0]) * (y[1] - y[0]);
+    if (area == 0.0)
+    {
+      return;
+    }
+
+    int const x0 = std::max(static_cast<int>(std::floor(std::min({x[0], x[1], x[2]}))), 0);
+    int const x1 = std::min(static_cast<int>(std::ceil(std::max({x[0], x[1], x[2]}))), bw - 1);
+    int const y0 = std::max(static_cast<int>(std::floor(std::min({y[0], y[1], y[2]}))), 0);
+    int const y1 = std::min(static_cast<int>(std::ceil(std::max({y[0], y[1], y[2]}))), bh - 1);
+    for (int py = y0; py <= y1; ++py)
+    {
+      double const cy = py + 0.5;
+      for (int px = x0; px <= x1; ++px)
+      {
+        double const cx = px + 0.5;
+        double const w0 = ((x[1] - cx) * (y[2] - cy) - (x[2] - cx) * (y[1] - cy)) / area;
+        double const w1 = ((x[2] - cx) * (y[0] - cy) - (x[0] - cx) * (y[2] - cy)) / area;
+        double const w2 = 1.0 - w0 - w1;
+        if (w0 < 0.0 || w1 < 0.0 || w2 < 0.0)
+        {
+          continue;
+        }
+        float const z = static_cast<float>(1.0 / (w0 * iz[0] + w1 * iz[1] + w2 * iz[2]));
+        float& zb = zbuf_[static_cast<size_t>(py) * bw + px];
+        zb = std::min(zb, z);
+      }
+    }
+  }
+
+  mesh_data const& mesh_;
+  double scale_;
+  double tolerance_;
+  std::vector<kwiver::vital::vector_2d> uv_;
+  std::vector<double> depth_;
+  std::vector<float> zbuf_;
+};
+
+} // end anonymous namespace
+
+
+static int maptk_main(int argc, char const* argv[])
+{
+  static bool        opt_help(false);
+  static std::string opt_config;
+  static std::string opt_out_config;
+
+  kwiversys::CommandLineArguments arg;
+
+  arg.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  arg.AddArgument( "--help",        argT::NO_ARGUMENT, &opt_help, "Display usage information" );
+  arg.AddArgument( "--config",      argT::SPACE_ARGUMENT, &opt_config, "Configuration file for tool" );
+  arg.AddArgument( "-c",            argT::SPACE_ARGUMENT, &opt_config, "Configuration file for tool" );
+  arg.AddArgument( "--output-config", argT::SPACE_ARGUMENT, &opt_out_config,
+                   "Output a configuration. This may be seeded with a configuration file from -c/--config." );
+  arg.AddArgument( "-o",            argT::SPACE_ARGUMENT, &opt_out_config,
+                   "Output a configuration. This may be seeded with a configuration file from -c/--config." );
+
+  if ( ! arg.Parse() )
+  {
+    LOG_ERROR(main_logger, "Problem parsing arguments");
+    return EXIT_FAILURE;
+  }
+
+  if ( opt_help )
+  {
+    std::cout
+      << "USAGE: " << argv[0] << " [OPTS]\n\n"
+      << "Options:"
+      << arg.GetHelp() << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  // register the algorithm implementations used by the configuration
+  kwiver::maptk::load_tool_plugins(opt_config);
+
+  // Set up top level configuration w/ defaults where applicable.
+  kwiver::vital::config_block_sptr config = kwiver::vital::config_block::empty_config();
+  video_input_sptr video_reader;
+
+  // If -c/--config given, read in confg file, merge in with default just generated
+  if( ! opt_config.empty() )
+  {
+    const std::string prefix = kwiver::vital::get_executable_path() + "/..";
+    config->merge_config(kwiver::maptk::read_config_file_cached(opt_config, "telesculptor",
+                                                                TELESCULPTOR_VERSION, prefix));
+  }
+
+  video_input::set_nested_algo_configuration(BLOCK_VR, config, video_reader);
+
+  kwiver::vital::config_block_sptr dflt_config = default_config();
+  dflt_config->merge_config(config);
+  config = dflt_config;
+
+  bool valid_config = check_config(config);
+
+  if( ! opt_out_config.empty() )
+  {
+    video_input::get_nested_algo_configuration(BLOCK_VR, config, video_reader);
+
+    write_config_file(config, opt_out_config );
+    if(valid_config)
+    {
+      LOG_INFO(main_logger, "Configuration file contained valid parameters"
+                            << " and may be used for running");
+    }
+    else
+    {
+      LOG_WARN(main_logger, "Configuration deemed not valid.");
+    }
+    return EXIT_SUCCESS;
+  }
+  else if(!valid_config)
+  {
+    LOG_ERROR(main_logger, "Configuration not valid.");
+    return EXIT_FAILURE;
+  }
+
+  //
+  // Read the video metadata to name the frames, and load the cameras
+  //
+  std::map<frame_id_t, std::string> basename_map;
+  std::string const video_source = config->get_value<std::string>("video_source");
+  LOG_INFO(main_logger, "Reading video metadata");
+  video_reader->open(video_source);
+  {
+    kwiver::vital::timestamp ts;
+    while (video_reader->next_frame(ts))
+    {
+      auto const md_vec = video_reader->frame_metadata();
+      auto const md = md_vec.empty() ? nullptr : md_vec[0];
+      basename_map[ts.get_frame()] =
+        kwiver::vital::basename_from_metadata(md, ts.get_frame());
+    }
+  }
+  video_reader->close();
+
+  auto const krtd_dir = config->get_value<std::string>("input_krtd_files");
+  auto const camera_map = kwiver::maptk::load_input_cameras_krtd(krtd_dir, basename_map);
+
+  int const sampling = config->get_value<int>("frame_sampling");
+  std::map<frame_id_t, camera_perspective_sptr> cameras;
+  std::vector<camera_perspective_sptr> camera_list;
+  int counter = 0;
+  for (auto const& c : camera_map)
+  {
+    auto const cam =
+      std::dynamic_pointer_cast<kwiver::vital::camera_perspective>(c.second);
+    if (cam && (counter++) % sampling == 0)
+    {
+      cameras[c.first] = cam;
+      camera_list.push_back(cam);
+    }
+  }
+  if (cameras.empty())
+  {
+    LOG_ERROR(main_logger, "No cameras to colorize with");
+    return EXIT_FAILURE;
+  }
+
+  //
+  // Load the mesh
+  //
+  mesh_data mesh;
+  bool computed_normals = false;
+  auto const mesh_file = config->get_value<std::string>("input_mesh_file");
+  if (!load_mesh(mesh_file, mesh, computed_normals))
+  {
+    LOG_ERROR(main_logger, "Unable to read a mesh from " << mesh_file);
+    return EXIT_FAILURE;
+  }
+  if (computed_normals)
+  {
+    orient_normals(mesh, camera_list);
+  }
+  LOG_INFO(main_logger, "Colorizing " << mesh.points.size() << " vertices with "
+                        << cameras.size() << " frames");
+
+  //
+  // Stream the frames through the workers
+  //
+  auto const coloring = config->get_value<std::string>("coloring");
+  color_method const method =
+    coloring == "median" ? color_method::median :
+    coloring == "best" ? color_method::best : color_method::mean;
+  color_accumulator colors(mesh.points.size(), method,
+                           config->get_value<unsigned>("median_samples"));
+
+  unsigned num_threads = config->get_value<unsigned>("num_threads");
+  if (num_threads == 0)
+  {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  num_threads = static_cast<unsigned>(
+    std::min<size_t>(num_threads, cameras.size()));
+
+  // Each worker holds one frame and at most as many again wait decoded
+  frame_queue queue(num_threads);
+  double const occlusion_scale = config->get_value<double>("occlusion_scale");
+  double const occlusion_tolerance = config->get_value<double>("occlusion_tolerance");
+  std::atomic<size_t> num_done(0);
+  auto worker = [&]()
+  {
+    frame_colorizer colorizer(mesh, occlusion_scale, occlusion_tolerance);
+    frame_data frame;
+    while (queue.pop(frame))
+    {
+      colorizer.process(frame, colors);
+      size_t const done = ++num_done;
+      if (done % 10 == 0 || done == cameras.size())
+      {
+        LOG_INFO(main_logger, "Processed " << done << " of "
+                              << cameras.size() << " frames");
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < num_threads; ++t)
+  {
+    workers.emplace_back(worker);
+  }
+
+  // Read the frames in order on this thread, seeking over long gaps
+  try
+  {
+    static frame_id_t const max_step = 16;
+    bool const can_seek = video_reader->get_implementation_capabilities()
+      .capability(video_input::SUPPORTS_FRAME_SEEK);
+    video_reader->open(video_source);
+    kwiver::vital::timestamp ts;
+    bool have_ts = false;
+    for (auto const& c : cameras)
+    {
+      if (can_seek && (!have_ts || c.first < ts.get_frame() ||
+                       c.first - ts.get_frame() > max_step))
+      {
+        have_ts = video_reader->seek_frame(ts, c.first);
+      }
+      while (!have_ts || ts.get_frame() < c.first)
+      {
+        have_ts = video_reader->next_frame(ts);
+        if (!have_ts)
+        {
+          break;
+        }
+      }
+      if (!have_ts)
+      {
+        break;
+      }
+      auto const image = video_reader->frame_image();
+      if (ts.get_frame() != c.first || !image ||
+          image->get_image().pixel_traits() !=
+            kwiver::vital::image_pixel_traits_of<uint8_t>())
+      {
+        LOG_WARN(main_logger, "No 8-bit image for frame " << c.first);
+        continue;
+      }
+      queue.push(frame_data{ c.first, image->get_image(), c.second });
+    }
+  }
+  catch (...)
+  {
+    queue.close();
+    for (auto& w : workers)
+    {
+      w.join();
+    }
+    throw;
+  }
+  queue.close();
+  for (auto& w : workers)
+  {
+    w.join();
+  }
+
+  //
+  // Write the colored mesh
+  //
+  vtkNew<vtkUnsignedCharArray> rgb;
+  rgb->SetName("RGB");
+  rgb->SetNumberOfComponents(3);
+  rgb->SetNumberOfTuples(static_cast<vtkIdType>(mesh.points.size()));
+  vtkNew<vtkIntArray> counts;
+  counts->SetName("NbProjectedDepthMap");
+  counts->SetNumberOfValues(static_cast<vtkIdType>(mesh.points.size()));
+  colors.finish(rgb.Get(), counts.Get());
+  mesh.poly_data->GetPointData()->AddArray(rgb.Get());
+  mesh.poly_data->GetPointData()->AddArray(counts.Get());
+
+  auto const out_file = config->get_value<std::string>("output_mesh_file");
+  ST::MakeDirectory(ST::GetFilenamePath(ST::CollapseFullPath(out_file)));
+  vtkNew<vtkPLYWriter> writer;
+  writer->SetFileName(out_file.c_str());
+  writer->SetFileTypeToBinary();
+  writer->SetArrayName("RGB");
+  writer->SetColorModeToDefault();
+  writer->SetInputData(mesh.poly_data);
+  if (!writer->Write())
+  {
+    LOG_ERROR(main_logger, "Failed to write " << out_file);
+    return EXIT_FAILURE;
+  }
+  LOG_INFO(main_logger, "Wrote " << out_file);
+  return EXIT_SUCCESS;
+}
+
+
+MAPTK_TOOL_MAIN(int argc, char const* argv[])
+{
+  try
+  {
+    return maptk_main(argc, argv);
+  }
+  catch (std::exception const& e)
+  {
+    LOG_ERROR(main_logger, "Exception caught: " << e.what());
+
+    return EXIT_FAILURE;
+  }
+  catch (...)
+  {
+    LOG_ERROR(main_logger, "Unknown exception caught");
+
+    return EXIT_FAILURE;
+  }
+}
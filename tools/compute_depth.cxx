@@ -0,0 +1,816 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Batch depth map estimation utility
+ */
+
+#include "tool_common.h"
+#include "depth_common.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vital/config/config_block.h>
+#include <vital/config/config_block_io.h>
+#include <vital/exceptions.h>
+#include <vital/io/landmark_map_io.h>
+#include <vital/io/metadata_io.h>
+#include <vital/logger/logger.h>
+#include <vital/types/camera_perspective.h>
+#include <vital/util/get_paths.h>
+#include <vital/vital_types.h>
+
+#include <vital/algo/compute_depth.h>
+#include <vital/algo/video_input.h>
+
+#include <arrows/core/depth_utils.h>
+
+#include <kwiversys/CommandLineArguments.hxx>
+#include <kwiversys/SystemTools.hxx>
+
+#include <maptk/version.h>
+
+typedef kwiversys::SystemTools     ST;
+
+using kwiver::vital::algo::compute_depth;
+using kwiver::vital::algo::compute_depth_sptr;
+using kwiver::vital::algo::video_input;
+using kwiver::vital::algo::video_input_sptr;
+using kwiver::vital::frame_id_t;
+using kwiver::vital::image_container_sptr;
+
+static kwiver::vital::logger_handle_t main_logger( kwiver::vital::get_logger( "compute_depth_tool" ) );
+
+static char const* const BLOCK_VR = "video_reader";
+static char const* const BLOCK_CD = "compute_depth";
+
+static size_t const MEGABYTE = 1 << 20;
+
+
+static kwiver::vital::config_block_sptr default_config()
+{
+  kwiver::vital::config_block_sptr config = kwiver::vital::config_block::empty_config("compute_depth_tool");
+
+  config->set_value("video_source", "",
+                    "Path to an input file to be opened as a video. "
+                    "This could be either a video file or a text file "
+                    "containing new-line separated paths to sequential "
+                    "image files.");
+
+  config->set_value("input_krtd_files", "",
+                    "A directory containing input KRTD camera files, named "
+                    "after the frames of the video.");
+
+  config->set_value("input_landmarks_file", "",
+                    "Path to a PLY file of landmarks, used to estimate the "
+                    "region of interest when roi is not set.");
+
+  config->set_value("roi", "",
+                    "Region of interest as \"xmin ymin zmin xmax ymax zmax\", "
+                    "in the format of the ROI entry of a project file. If "
+                    "empty, it is estimated from the landmarks as in the "
+                    "GUI.");
+
+  config->set_value("output_depth_dir", "results/depth",
+                    "Directory in which to write the depth maps, as VTK "
+                    "image files named after their reference frames.");
+
+  config->set_value("resume", true,
+                    "Skip reference frames whose depth map already exists "
+                    "in output_depth_dir, so an interrupted run can be "
+                    "continued.");
+
+  config->set_value("batch_depth:first_frame", 0,
+                    "First frame that may be used.");
+  config->set_value("batch_depth:end_frame", -1,
+                    "Last frame that may be used, or -1 for the last frame "
+                    "with a camera.");
+  config->set_value("batch_depth:num_depth", 20,
+                    "Number of depth maps to compute, from reference frames "
+                    "spread evenly over the frames with cameras. A value "
+                    "of -1 uses every frame.");
+
+  config->set_value("compute_depth:num_support", 10,
+                    "Number of support images on each side of the reference "
+                    "frame. The total number of images used is "
+                    "2 * num_support + 1.");
+
+  config->set_value("num_threads", 0,
+                    "Number of depth maps computed in parallel. Zero uses one "
+                    "per processor core, within the memory budget.");
+
+  config->set_value("memory_budget_mb", 0,
+                    "Memory, in megabytes, that the frame cache and the depth "
+                    "computations may use together. The number of parallel "
+                    "computations is reduced to fit. Zero sets no limit "
+                    "and caches two windows of frames per computation.");
+
+  config->set_value("worker_memory_mb", 1024,
+                    "Estimated memory, in megabytes, used by one depth "
+                    "computation in addition to its frames.");
+
+  kwiver::vital::algo::video_input::get_nested_algo_configuration(BLOCK_VR, config,
+                                                                  kwiver::vital::algo::video_input_sptr());
+  kwiver::vital::algo::compute_depth::get_nested_algo_configuration(BLOCK_CD, config,
+                                                                    kwiver::vital::algo::compute_depth_sptr());
+  return config;
+}
+
+
+// ------------------------------------------------------------------
+static bool check_config(kwiver::vital::config_block_sptr config)
+{
+  bool config_valid = true;
+
+#define MAPTK_CONFIG_FAIL(msg) \
+  LOG_ERROR(main_logger, "Config Check Fail: " << msg); \
+  config_valid = false
+
+  std::string const video_source = config->get_value<std::string>("video_source", "");
+  if (video_source.empty())
+  {
+    MAPTK_CONFIG_FAIL("Config needs value video_source");
+  }
+  else if ( ! ST::FileExists( kwiver::vital::path_t(video_source) ) )
+  {
+    MAPTK_CONFIG_FAIL("video_source path, " << video_source << ", does not exist");
+  }
+
+  std::string const krtd_dir = config->get_value<std::string>("input_krtd_files", "");
+  if (krtd_dir.empty() || ! ST::FileIsDirectory(krtd_dir))
+  {
+    MAPTK_CONFIG_FAIL("input_krtd_files must be an existing directory");
+  }
+
+  std::string const roi = config->get_value<std::string>("roi", "");
+  std::string const landmarks = config->get_value<std::string>("input_landmarks_file", "");
+  kwiver::vital::vector_3d min_pt, max_pt;
+  if (!roi.empty() && !kwiver::maptk::parse_roi(roi, min_pt, max_pt))
+  {
+    MAPTK_CONFIG_FAIL("roi must hold six numbers describing a non-empty box");
+  }
+  if (roi.empty())
+  {
+    if (landmarks.empty())
+    {
+      MAPTK_CONFIG_FAIL("Either roi or input_landmarks_file must be given");
+    }
+    else if ( ! ST::FileExists(landmarks, true) )
+    {
+      MAPTK_CONFIG_FAIL("input_landmarks_file, " << landmarks << ", does not exist");
+    }
+  }
+
+  if (config->get_value<std::string>("output_depth_dir", "").empty())
+  {
+    MAPTK_CONFIG_FAIL("Config needs value output_depth_dir");
+  }
+
+  if (config->get_value<int>("compute_depth:num_support", 0) < 0)
+  {
+    MAPTK_CONFIG_FAIL("compute_depth:num_support must not be negative");
+  }
+
+  if (config->get_value<int>("num_threads", 0) < 0 ||
+      config->get_value<int>("memory_budget_mb", 0) < 0 ||
+      config->get_value<int>("worker_memory_mb", 0) < 0)
+  {
+    MAPTK_CONFIG_FAIL("num_threads, memory_budget_mb and worker_memory_mb "
+                      "must not be negative");
+  }
+
+  if (!video_input::check_nested_algo_configuration(BLOCK_VR, config))
+  {
+    MAPTK_CONFIG_FAIL("video_reader configuration check failed");
+  }
+
+  if (!compute_depth::check_nested_algo_configuration(BLOCK_CD, config))
+  {
+    MAPTK_CONFIG_FAIL("compute_depth configuration check failed");
+  }
+
+#undef MAPTK_CONFIG_FAIL
+
+  return config_valid;
+}
+
+
+namespace {
+
+/// A depth map to compute
+struct depth_job
+{
+  /// The reference frame
+  frame_id_t ref_frame;
+  /// The frames used, including the reference frame, in order
+  std::vector<frame_id_t> frames;
+  /// Index of the reference frame in \c frames
+  size_t ref_index;
+  /// Path of the depth map file
+  std::string output_path;
+};
+
+
+/// Plan the depth maps to compute
+/**
+ * Reference frames are spread evenly over the frames with cameras, leaving
+ * room for the support frames at each end, and each gets a window of
+ * 2 * num_support + 1 frames, shifted inward at the ends of the range.
+ */
+std::vector<depth_job>
+plan_depth_jobs(std::vector<frame_id_t> const& frames, int num_depth,
+                int num_support)
+{
+  std::vector<depth_job> jobs;
+  if (frames.empty())
+  {
+    return jobs;
+  }
+
+  size_t const half = static_cast<size_t>(num_support);
+  size_t const window = std::min(2 * half + 1, frames.size());
+  size_t const first_ref = std::min(half, (frames.size() - 1) / 2);
+  size_t const num_refs = frames.size() - 2 * first_ref;
+  size_t const num_jobs = num_depth < 0
+    ? num_refs : std::min(static_cast<size_t>(num_depth), num_refs);
+
+  for (size_t c = 0; c < num_jobs; ++c)
+  {
+    size_t const ref = first_ref +
+      (num_jobs > 1 ? c * (num_refs - 1) / (num_jobs - 1) : (num_refs - 1) / 2);
+    size_t const begin = std::min(ref > half ? ref - half : 0,
+                                  frames.size() - window);
+
+    depth_job job;
+    job.ref_frame = frames[ref];
+    job.frames.assign(frames.begin() + begin, frames.begin() + begin + window);
+    job.ref_index = ref - begin;
+    jobs.push_back(job);
+  }
+  return jobs;
+}
+
+
+/// A least recently used cache of video frames bounded in bytes
+/**
+ * Frames are read from a single video reader shared by every worker.  A
+ * worker asks for all of the frames it needs at once, and the missing ones
+ * are read in order so that neighbouring windows are read sequentially.
+ */
+class frame_cache
+{
+public:
+  frame_cache(video_input_sptr reader, std::string const& source)
+    : reader_(reader), source_(source)
+  {
+    can_seek_ = reader_->get_implementation_capabilities()
+      .capability(video_input::SUPPORTS_FRAME_SEEK);
+  }
+
+  /// Set the number of bytes the cached frames may use
+  void set_capacity(size_t bytes)
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    capacity_ = bytes;
+    evict();
+  }
+
+  /// Return the images of the given frames, in order
+  /**
+   * A frame that could not be read is returned as a null image.
+   */
+  std::vector<image_container_sptr> get(std::vector<frame_id_t> const& frames)
+  {
+    std::vector<image_container_sptr> images(frames.size());
+    std::vector<size_t> missing;
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      for (size_t i = 0; i < frames.size(); ++i)
+      {
+        if (!lookup(frames[i], images[i]))
+        {
+          missing.push_back(i);
+        }
+      }
+    }
+    if (missing.empty())
+    {
+      return images;
+    }
+
+    std::sort(missing.begin(), missing.end(),
+              [&frames](size_t a, size_t b) { return frames[a] < frames[b]; });
+
+    std::lock_guard<std::mutex> reader_lock(reader_mutex_);
+    for (auto const i : missing)
+    {
+      {
+        // Another worker may have read the frame while this one waited
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (lookup(frames[i], images[i]))
+        {
+          continue;
+        }
+      }
+      images[i] = read_frame(frames[i]);
+      if (images[i])
+      {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        insert(frames[i], images[i]);
+      }
+    }
+    return images;
+  }
+
+private:
+  struct entry
+  {
+    image_container_sptr image;
+    size_t last_use;
+  };
+
+  /// Find a cached frame; the cache mutex must be held
+  bool lookup(frame_id_t frame, image_container_sptr& image)
+  {
+    auto const itr = entries_.find(frame);
+    if (itr == entries_.end())
+    {
+      return false;
+    }
+    itr->second.last_use = ++clock_;
+    image = itr->second.image;
+    return true;
+  }
+
+  /// Add a frame to the cache; the cache mutex must be held
+  void insert(frame_id_t frame, image_container_sptr const& image)
+  {
+    entries_[frame] = { image, ++clock_ };
+    bytes_ += image->size();
+    evict();
+  }
+
+  /// Drop the least recently used frames over capacity
+  void evict()
+  {
+    while (bytes_ > capacity_ && !entries_.empty())
+    {
+      auto oldest = entries_.begin();
+      for (auto itr = entries_.begin(); itr != entries_.end(); ++itr)
+      {
+        if (itr->second.last_use < oldest->second.last_use)
+        {
+          oldest = itr;
+        }
+      }
+      bytes_ -= oldest->second.image->size();
+      entries_.erase(oldest);
+    }
+  }
+
+  /// Read a frame from the video; the reader mutex must be held
+  image_container_sptr read_frame(frame_id_t frame)
+  {
+    // Step forward over short gaps, which is cheaper than seeking in most
+    // video formats, and when seeking is not supported at all
+    static frame_id_t const max_step = 16;
+    bool const at_frame = have_ts_ && ts_.get_frame() == frame;
+    bool const step = have_ts_ && ts_.get_frame() < frame &&
+                      (!can_seek_ || frame - ts_.get_frame() <= max_step);
+    if (!at_frame && !step)
+    {
+      if (can_seek_)
+      {
+        have_ts_ = reader_->seek_frame(ts_, frame);
+      }
+      else
+      {
+        reader_->close();
+        reader_->open(source_);
+        have_ts_ = false;
+      }
+    }
+    while (!have_ts_ || ts_.get_frame() < frame)
+    {
+      if (!reader_->next_frame(ts_))
+      {
+        have_ts_ = false;
+        return nullptr;
+      }
+      have_ts_ = true;
+    }
+    if (ts_.get_frame() != frame)
+    {
+      return nullptr;
+    }
+    return reader_->frame_image();
+  }
+
+  video_input_sptr reader_;
+  std::string source_;
+  bool can_seek_ = false;
+  kwiver::vital::timestamp ts_;
+  bool have_ts_ = false;
+  std::mutex reader_mutex_;
+
+  std::mutex cache_mutex_;
+  std::map<frame_id_t, entry> entries_;
+  size_t bytes_ = 0;
+  size_t capacity_ = 0;
+  size_t clock_ = 0;
+};
+
+} // end anonymous namespace
+
+
+static int maptk_main(int argc, char const* argv[])
+{
+  static bool        opt_help(false);
+  static std::string opt_config;
+  static std::string opt_out_config;
+
+  kwiversys::CommandLineArguments arg;
+
+  arg.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  arg.AddArgument( "--help",        argT::NO_ARGUMENT, &opt_help, "Display usage information" );
+  arg.AddArgument( "--config",      argT::SPACE_ARGUMENT, &opt_config, "Configuration file for tool" );
+  arg.AddArgument( "-c",            argT::SPACE_ARGUMENT, &opt_config, "Configuration file for tool" );
+  arg.AddArgument( "--output-config", argT::SPACE_ARGUMENT, &opt_out_config,
+                   "Output a configuration. This may be seeded with a configuration file from -c/--config." );
+  arg.AddArgument( "-o",            argT::SPACE_ARGUMENT, &opt_out_config,
+                   "Output a configuration. This may be seeded with a configuration file from -c/--config." );
+
+  if ( ! arg.Parse() )
+  {
+    LOG_ERROR(main_logger, "Problem parsing arguments");
+    return EXIT_FAILURE;
+  }
+
+  if ( opt_help )
+  {
+    std::cout
+      << "USAGE: " << argv[0] << " [OPTS]\n\n"
+      << "Options:"
+      << arg.GetHelp() << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  // register the algorithm implementations used by the configuration
+  kwiver::maptk::load_tool_plugins(opt_config);
+
+  // Set up top level configuration w/ defaults where applicable.
+  kwiver::vital::config_block_sptr config = kwiver::vital::config_block::empty_config();
+  video_input_sptr video_reader;
+  compute_depth_sptr depth_algo;
+
+  // If -c/--config given, read in confg file, merge in with default just generated
+  if( ! opt_config.empty() )
+  {
+    const std::string prefix = kwiver::vital::get_executable_path() + "/..";
+    config->merge_config(kwiver::maptk::read_config_file_cached(opt_config, "telesculptor",
+                                                                TELESCULPTOR_VERSION, prefix));
+  }
+
+  video_input::set_nested_algo_configuration(BLOCK_VR, config, video_reader);
+  compute_depth::set_nested_algo_configuration(BLOCK_CD, config, depth_algo);
+
+  kwiver::vital::config_block_sptr dflt_config = default_config();
+  dflt_config->merge_config(config);
+  config = dflt_config;
+
+  bool valid_config = check_config(config);
+
+  if( ! opt_out_config.empty() )
+  {
+    video_input::get_nested_algo_configuration(BLOCK_VR, config, video_reader);
+    compute_depth::get_nested_algo_configuration(BLOCK_CD, config, depth_algo);
+
+    write_config_file(config, opt_out_config );
+    if(valid_config)
+    {
+      LOG_INFO(main_logger, "Configuration file contained valid parameters"
+                            << " and may be used for running");
+    }
+    else
+    {
+      LOG_WARN(main_logger, "Configuration deemed not valid.");
+    }
+    return EXIT_SUCCESS;
+  }
+  else if(!valid_config)
+  {
+    LOG_ERROR(main_logger, "Configuration not valid.");
+    return EXIT_FAILURE;
+  }
+
+  //
+  // Read the video metadata to name the frames
+  //
+  std::map<frame_id_t, std::string> basename_map;
+  std::string const video_source = config->get_value<std::string>("video_source");
+  LOG_INFO(main_logger, "Reading video metadata");
+  video_reader->open(video_source);
+  {
+    kwiver::vital::timestamp ts;
+    while (video_reader->next_frame(ts))
+    {
+      auto const md_vec = video_reader->frame_metadata();
+      auto const md = md_vec.empty() ? nullptr : md_vec[0];
+      basename_map[ts.get_frame()] =
+        kwiver::vital::basename_from_metadata(md, ts.get_frame());
+    }
+  }
+
+  //
+  // Load the cameras and the region of interest
+  //
+  auto const krtd_dir = config->get_value<std::string>("input_krtd_files");
+  auto const cameras = kwiver::maptk::load_input_cameras_krtd(krtd_dir, basename_map);
+  if (cameras.empty())
+  {
+    return EXIT_FAILURE;
+  }
+
+  kwiver::vital::vector_3d min_pt, max_pt;
+  auto const roi = config->get_value<std::string>("roi");
+  if (!roi.empty())
+  {
+    kwiver::maptk::parse_roi(roi, min_pt, max_pt);
+  }
+  else
+  {
+    auto const lm_file = config->get_value<std::string>("input_landmarks_file");
+    auto const landmarks = kwiver::vital::read_ply_file(lm_file);
+    if (!landmarks || !kwiver::maptk::robust_roi(*landmarks, min_pt, max_pt))
+    {
+      LOG_ERROR(main_logger, "Too few landmarks to estimate the region of interest");
+      return EXIT_FAILURE;
+    }
+  }
+  LOG_INFO(main_logger, "Region of interest: " << min_pt.transpose()
+                        << " to " << max_pt.transpose());
+
+  double height_min, height_max;
+  kwiver::arrows::core::height_range_from_3d_bounds(min_pt, max_pt,
+                                                    height_min, height_max);
+
+  //
+  // Plan the depth maps, skipping those already computed
+  //
+  int const first_frame = config->get_value<int>("batch_depth:first_frame");
+  int const end_frame = config->get_value<int>("batch_depth:end_frame");
+  std::vector<frame_id_t> frames_in_range;
+  for (auto const& c : cameras)
+  {
+    if (c.first >= first_frame && (end_frame < 0 || c.first <= end_frame) &&
+        std::dynamic_pointer_cast<kwiver::vital::camera_perspective>(c.second))
+    {
+      frames_in_range.push_back(c.first);
+    }
+  }
+
+  auto const output_dir = config->get_value<std::string>("output_depth_dir");
+  if (!ST::MakeDirectory(output_dir))
+  {
+    LOG_ERROR(main_logger, "Unable to create output directory " << output_dir);
+    return EXIT_FAILURE;
+  }
+
+  bool const resume = config->get_value<bool>("resume");
+  auto all_jobs = plan_depth_jobs(frames_in_range,
+                                  config->get_value<int>("batch_depth:num_depth"),
+                                  config->get_value<int>("compute_depth:num_support"));
+  std::vector<depth_job> jobs;
+  for (auto& job : all_jobs)
+  {
+    job.output_path = output_dir + "/" + basename_map[job.ref_frame] + ".vti";
+    if (resume && ST::FileExists(job.output_path, true))
+    {
+      LOG_DEBUG(main_logger, "Skipping frame " << job.ref_frame
+                             << ", depth map exists");
+      continue;
+    }
+    jobs.push_back(job);
+  }
+  LOG_INFO(main_logger, "Computing " << jobs.size() << " of "
+                        << all_jobs.size() << " depth maps");
+  if (jobs.empty())
+  {
+    return EXIT_SUCCESS;
+  }
+
+  //
+  // Size the worker pool and frame cache to the memory budget
+  //
+  frame_cache cache(video_reader, video_source);
+  size_t frame_bytes = 0;
+  {
+    auto const first = cache.get({ jobs.front().ref_frame });
+    if (!first[0])
+    {
+      LOG_ERROR(main_logger, "Unable to read frame " << jobs.front().ref_frame);
+      return EXIT_FAILURE;
+    }
+    frame_bytes = first[0]->size();
+  }
+
+  size_t const window = jobs.front().frames.size();
+  size_t const window_bytes = window * frame_bytes;
+  size_t const worker_bytes =
+    window_bytes + config->get_value<size_t>("worker_memory_mb") * MEGABYTE;
+  size_t const budget = config->get_value<size_t>("memory_budget_mb") * MEGABYTE;
+
+  size_t num_workers = config->get_value<size_t>("num_threads");
+  if (num_workers == 0)
+  {
+    num_workers = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  num_workers = std::min(num_workers, jobs.size());
+
+  size_t cache_bytes = 2 * num_workers * window_bytes;
+  if (budget > 0)
+  {
+    // Keep room to cache at least one window beyond the working frames
+    size_t const fit = budget > window_bytes
+                       ? (budget - window_bytes) / worker_bytes : 0;
+    if (fit == 0)
+    {
+      LOG_WARN(main_logger, "The memory budget is too small for one depth "
+                            "computation; running one anyway");
+    }
+    num_workers = std::max<size_t>(std::min(num_workers, fit), 1);
+    cache_bytes = budget > num_workers * worker_bytes
+                  ? std::max(budget - num_workers * worker_bytes, window_bytes)
+                  : window_bytes;
+  }
+  cache.set_capacity(cache_bytes);
+  LOG_INFO(main_logger, "Using " << num_workers << " workers and a "
+                        << cache_bytes / MEGABYTE << " MB frame cache");
+
+  //
+  // Compute the depth maps
+  //
+  std::atomic<size_t> next_job(0);
+  std::atomic<size_t> num_done(0);
+  std::atomic<size_t> num_failed(0);
+
+  auto compute_job = [&](compute_depth& algo, depth_job const& job)
+  {
+    auto const images = cache.get(job.frames);
+
+    std::vector<image_container_sptr> frames_out;
+    std::vector<kwiver::vital::camera_perspective_sptr> cameras_out;
+    int ref_index = -1;
+    for (size_t i = 0; i < job.frames.size(); ++i)
+    {
+      if (!images[i])
+      {
+        LOG_WARN(main_logger, "Could not read frame " << job.frames[i]);
+        continue;
+      }
+      if (i == job.ref_index)
+      {
+        ref_index = static_cast<int>(frames_out.size());
+      }
+      frames_out.push_back(images[i]);
+      cameras_out.push_back(
+        std::dynamic_pointer_cast<kwiver::vital::camera_perspective>(
+          cameras.at(job.frames[i])));
+    }
+    if (ref_index < 0)
+    {
+      ++num_failed;
+      return;
+    }
+
+    auto const& ref_img = frames_out[ref_index];
+    auto const crop = kwiver::arrows::core::project_3d_bounds(
+      min_pt, max_pt, *cameras_out[ref_index],
+      static_cast<int>(ref_img->width()), static_cast<int>(ref_img->height()));
+    if (crop.width() <= 0 || crop.height() <= 0)
+    {
+      LOG_WARN(main_logger, "Region of interest is not visible in frame "
+                            << job.ref_frame);
+      return;
+    }
+
+    auto const depth = algo.compute(frames_out, cameras_out,
+                                    height_min, height_max,
+                                    ref_index, crop);
+    if (!depth)
+    {
+      LOG_WARN(main_logger, "No depth computed for frame " << job.ref_frame);
+      ++num_failed;
+      return;
+    }
+
+    auto const image_data = kwiver::maptk::depth_to_vtk(
+      depth, ref_img, crop.min_x(), crop.width(), crop.min_y(), crop.height());
+    if (!kwiver::maptk::write_depth_map(image_data, job.output_path))
+    {
+      LOG_ERROR(main_logger, "Failed to write depth map for frame "
+                             << job.ref_frame << " to " << job.output_path);
+      ++num_failed;
+      return;
+    }
+    LOG_INFO(main_logger, "[" << ++num_done << "/" << jobs.size()
+                          << "] Wrote " << job.output_path);
+  };
+
+  auto worker = [&]()
+  {
+    // Each worker has its own instance of the algorithm
+    compute_depth_sptr algo;
+    compute_depth::set_nested_algo_configuration(BLOCK_CD, config, algo);
+
+    for (size_t j = next_job++; j < jobs.size(); j = next_job++)
+    {
+      try
+      {
+        compute_job(*algo, jobs[j]);
+      }
+      catch (std::exception const& e)
+      {
+        LOG_ERROR(main_logger, "Depth map for frame " << jobs[j].ref_frame
+                               << " failed: " << e.what());
+        ++num_failed;
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t w = 1; w < num_workers; ++w)
+  {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (auto& w : workers)
+  {
+    w.join();
+  }
+
+  if (num_failed > 0)
+  {
+    LOG_ERROR(main_logger, num_failed << " depth maps failed");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+
+MAPTK_TOOL_MAIN(int argc, char const* argv[])
+{
+  try
+  {
+    return maptk_main(argc, argv);
+  }
+  catch (std::exception const& e)
+  {
+    LOG_ERROR(main_logger, "Exception caught: " << e.what());
+
+    return EXIT_FAILURE;
+  }
+  catch (...)
+  {
+    LOG_ERROR(main_logger, "Unknown exception caught");
+
+    return EXIT_FAILURE;
+  }
+}
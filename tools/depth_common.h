@@ -0,0 +1,156 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Helper functions shared by the depth map tools
+ */
+
+#ifndef MAPTK_TOOL_DEPTH_COMMON_H_
+#define MAPTK_TOOL_DEPTH_COMMON_H_
+
+#include <maptk/depth_map_io.h>
+
+#include <vital/types/landmark_map.h>
+#include <vital/types/vector.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkXMLImageDataWriter.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+
+/// Parse a region of interest written as "xmin ymin zmin xmax ymax zmax"
+/**
+ * This is the format of the ROI entry of a TeleSculptor project file.
+ *
+ * \returns false if the string does not hold six numbers describing a
+ *          non-empty box.
+ */
+bool
+parse_roi(std::string const& roi, vital::vector_3d& min_pt,
+          vital::vector_3d& max_pt)
+{
+  std::istringstream stream(roi);
+  stream >> min_pt[0] >> min_pt[1] >> min_pt[2]
+         >> max_pt[0] >> max_pt[1] >> max_pt[2];
+  return !stream.fail() && (max_pt - min_pt).minCoeff() > 0.0;
+}
+
+
+/// Estimate a region of interest containing most of the landmarks
+/**
+ * This matches the default region of interest of the GUI: the 10th to 90th
+ * percentile of the landmark positions along each axis (99th for the top,
+ * where thin structures have few points), padded by half its size on every
+ * side.
+ *
+ * \returns false if there are fewer than two landmarks.
+ */
+bool
+robust_roi(vital::landmark_map const& landmarks, vital::vector_3d& min_pt,
+           vital::vector_3d& max_pt)
+{
+  constexpr double percentile = 0.1;
+  constexpr double zmax_percentile = 0.01;
+  constexpr double margin = 0.5;
+
+  auto const lms = landmarks.landmarks();
+  size_t const num_pts = lms.size();
+  if (num_pts < 2)
+  {
+    return false;
+  }
+
+  std::vector<double> coords[3];
+  for (auto const& lm : lms)
+  {
+    auto const& pt = lm.second->loc();
+    for (int i = 0; i < 3; ++i)
+    {
+      coords[i].push_back(pt[i]);
+    }
+  }
+
+  size_t const min_idx = static_cast<size_t>(percentile * (num_pts - 1));
+  size_t const max_idx = num_pts - 1 - min_idx;
+  size_t const zmax_idx =
+    static_cast<size_t>((num_pts - 1) * (1.0 - zmax_percentile));
+  for (int i = 0; i < 3; ++i)
+  {
+    std::sort(coords[i].begin(), coords[i].end());
+    min_pt[i] = coords[i][min_idx];
+    max_pt[i] = coords[i][i == 2 ? zmax_idx : max_idx];
+    double const offset = (max_pt[i] - min_pt[i]) * margin;
+    min_pt[i] -= offset;
+    max_pt[i] += offset;
+  }
+  return true;
+}
+
+
+/// Write a depth map as a compressed VTK image file
+/**
+ * The file is written under a temporary name and renamed when complete, so
+ * a depth map that exists on disk is never partially written.
+ */
+bool
+write_depth_map(vtkImageData* depth, std::string const& path)
+{
+  std::string const tmp_path = path + ".part";
+  vtkNew<vtkXMLImageDataWriter> writer;
+  writer->SetFileName(tmp_path.c_str());
+  writer->SetInputData(depth);
+  writer->SetDataModeToAppended();
+  writer->EncodeAppendedDataOff();
+  writer->SetCompressorTypeToZLib();
+  if (!writer->Write())
+  {
+    kwiversys::SystemTools::RemoveFile(tmp_path);
+    return false;
+  }
+  return kwiversys::SystemTools::RenameFile(tmp_path, path);
+}
+
+} // end namespace maptk
+} // end namespace kwiver
+
+
+#endif // MAPTK_TOOL_DEPTH_COMMON_H_
@@ -36,7 +36,11 @@
 
 #include "tool_common.h"
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
+#include <limits>
+#include <memory>
 #include <iostream>
 #include <fstream>
 #include <exception>
@@ -44,6 +48,8 @@
 #include <vector>
 
 #include <maptk/colorize.h>
+#include <maptk/feature_database.h>
+#include <maptk/frame_range_queue.h>
 
 #include <vital/config/config_block.h>
 #include <vital/config/config_block_io.h>
@@ -113,6 +119,36 @@ static kwiver::vital::config_block_sptr default_config()
                     "file can load sucessfully before deciding to skip "
                     "computation on this frame.  If this option is disabled "
                     "then skip if the file exists, without loading it");
+  config->set_value("features_database", "",
+                    "Optional path to a single feature database file in which "
+                    "to store the features and descriptors of all frames, "
+                    "instead of writing one file per frame to features_dir. "
+                    "Use maptk_feature_database to convert between the two "
+                    "layouts.");
+  config->set_value("features_database_encoding", "native",
+                    "How floating point descriptors are stored in the "
+                    "features_database. Options are \"native\" to keep the "
+                    "extractor's type, \"float16\" for 16-bit floats, or "
+                    "\"quantized8\" for 8-bit values with an offset and "
+                    "scale shared by the database, taken from the range of "
+                    "the first frame. Byte descriptors holding one bit per "
+                    "byte are always bit-packed.");
+  config->set_value("work_queue_dir", "",
+                    "Optional path to a directory, on a file system shared by "
+                    "all workers, through which several processes or machines "
+                    "running this tool with the same configuration divide the "
+                    "frames among themselves. Each worker repeatedly claims a "
+                    "range of frames, and a range claimed by a worker that "
+                    "stopped responding is reclaimed by another. When all "
+                    "ranges are done, manifest.txt in this directory lists "
+                    "the features file of every frame. Leave blank to "
+                    "process all frames in this process.");
+  config->set_value("work_range_size", 100,
+                    "Number of frames in each range claimed from the work "
+                    "queue.");
+  config->set_value("work_claim_timeout", 600.0,
+                    "Seconds after which a claim on a range that has not been "
+                    "refreshed by its worker is considered abandoned.");
 
   kwiver::vital::algo::video_input::get_nested_algo_configuration("video_reader", config,
                                       kwiver::vital::algo::video_input_sptr());
@@ -158,6 +194,20 @@ static bool check_config(kwiver::vital::config_block_sptr config)
     }
   }
 
+  if ( config->get_value<std::string>("features_database", "") != "" &&
+       config->get_value<std::string>("work_queue_dir", "") != "" )
+  {
+    MAPTK_CONFIG_FAIL("features_database cannot be written by several workers; "
+                      "leave either it or work_queue_dir blank");
+  }
+
+  auto const encoding = config->get_value<std::string>("features_database_encoding", "native");
+  if ( encoding != "native" && encoding != "float16" && encoding != "quantized8" )
+  {
+    MAPTK_CONFIG_FAIL("features_database_encoding must be one of native, float16, "
+                      "or quantized8 (Given: " << encoding << ")");
+  }
+
   if ( ! config->has_value("video_source") ||
       config->get_value<std::string>("video_source") == "")
   {
@@ -326,10 +376,8 @@ static int maptk_main(int argc, char const* argv[])
     return EXIT_SUCCESS;
   }
 
-  // register the algorithm implementations
-  std::string rel_plugin_path = kwiver::vital::get_executable_path() + "/../lib/kwiver/modules";
-  kwiver::vital::plugin_manager::instance().add_search_path(rel_plugin_path);
-  kwiver::vital::plugin_manager::instance().load_all_plugins();
+  // register the algorithm implementations used by the configuration
+  kwiver::maptk::load_tool_plugins(opt_config);
 
   // Set config to algo chain
   // Get config from algo chain after set
@@ -351,8 +399,8 @@ static int maptk_main(int argc, char const* argv[])
   if( ! opt_config.empty() )
   {
     const std::string prefix = kwiver::vital::get_executable_path() + "/..";
-    config->merge_config(kwiver::vital::read_config_file(opt_config, "telesculptor",
-                                                         TELESCULPTOR_VERSION, prefix));
+    config->merge_config(kwiver::maptk::read_config_file_cached(opt_config, "telesculptor",
+                                                                TELESCULPTOR_VERSION, prefix));
   }
 
   kwiver::vital::algo::video_input::
@@ -408,6 +456,7 @@ static int maptk_main(int argc, char const* argv[])
   bool invert_masks = config->get_value<bool>("invert_masks");
   bool expect_multichannel_masks = config->get_value<bool>("expect_multichannel_masks");
   std::string features_dir = config->get_value<std::string>("features_dir");
+  std::string features_database = config->get_value<std::string>("features_database");
   bool validate_existing_features = config->get_value<bool>("validate_existing_features");
 
 
@@ -461,6 +510,20 @@ static int maptk_main(int argc, char const* argv[])
                "Validated " << mask_files.size() << " mask image files." );
   }
 
+  // Open the feature database if one is used instead of per-frame files
+  std::unique_ptr<kwiver::maptk::feature_database> db;
+  if( !features_database.empty() )
+  {
+    LOG_INFO( main_logger, "Writing features to database " << features_database );
+    db.reset( new kwiver::maptk::feature_database( features_database, true ) );
+
+    typedef kwiver::maptk::feature_database::descriptor_encoding encoding_t;
+    auto const encoding = config->get_value<std::string>("features_database_encoding");
+    db->set_descriptor_encoding( encoding == "float16" ? encoding_t::float16 :
+                                 encoding == "quantized8" ? encoding_t::quantized8 :
+                                 encoding_t::native );
+  }
+
   // Verify that the output directory exists, or make it
   // If the given path is a directory, we obviously can't write to it.
   if( ST::FileExists( features_dir )  && !ST::FileIsDirectory( features_dir ) )
@@ -470,7 +533,7 @@ static int maptk_main(int argc, char const* argv[])
 
   // Check that the directory of the given filepath exists, creating necessary
   // directories where needed.
-  if( ! ST::FileIsDirectory( features_dir ) )
+  if( !db && ! ST::FileIsDirectory( features_dir ) )
   {
     if( ! ST::MakeDirectory( features_dir ) )
     {
@@ -481,6 +544,18 @@ static int maptk_main(int argc, char const* argv[])
 
   std::mutex video_mutex;
 
+  // frames outside this range are skipped; the whole video by default
+  kwiver::vital::frame_id_t range_first = std::numeric_limits<kwiver::vital::frame_id_t>::min();
+  kwiver::vital::frame_id_t range_last = std::numeric_limits<kwiver::vital::frame_id_t>::max();
+
+  // features files known to be complete, and whether any frame failed
+  std::vector<kwiver::vital::path_t> outputs;
+  std::mutex outputs_mutex;
+  std::atomic<bool> failed(false);
+
+  // distinguishes temporary files written by this process
+  std::string tmp_token = "tmp";
+
   // This lambda function runs in a thread to read the video and launch processing jobs
   auto handle_frame = [&] ()
   {
@@ -490,7 +565,14 @@ static int maptk_main(int argc, char const* argv[])
     {
       // lock the video mutex while incrementing the video and getting a frame
       std::lock_guard<std::mutex> vlock(video_mutex);
-      if( !video_reader->next_frame(ts) )
+      do
+      {
+        if( !video_reader->next_frame(ts) )
+        {
+          return false;
+        }
+      } while( ts.get_frame() < range_first );
+      if( ts.get_frame() > range_last )
       {
         return false;
       }
@@ -509,9 +591,21 @@ static int maptk_main(int argc, char const* argv[])
     kwiver::vital::path_t kwfd_file = features_dir + "/" + basename + ".kwfd";
 
     // if the features file already exists then test loading it and skip
-    if( valid_feature_file_exists( kwfd_file, ts.get_frame(),
-                                   validate_existing_features ? fd_io : nullptr ) )
+    auto record_output = [&] ()
+    {
+      std::lock_guard<std::mutex> olock(outputs_mutex);
+      outputs.push_back(kwfd_file);
+    };
+    if( db && db->contains( basename ) )
+    {
+      LOG_INFO( main_logger, "Skipping frame " << ts.get_frame() <<
+                             ", features are in the database" );
+      return true;
+    }
+    if( !db && valid_feature_file_exists( kwfd_file, ts.get_frame(),
+                                          validate_existing_features ? fd_io : nullptr ) )
     {
+      record_output();
       return true;
     }
 
@@ -527,6 +621,7 @@ static int maptk_main(int argc, char const* argv[])
 
       if( !validate_mask_image( mask, expect_multichannel_masks ) )
       {
+        failed = true;
         return false;
       }
 
@@ -554,6 +649,12 @@ static int maptk_main(int argc, char const* argv[])
     kwiver::vital::descriptor_set_sptr curr_desc =
       descriptor_extractor->extract(converted_image, curr_feat, converted_mask);
 
+    if( db )
+    {
+      db->append( basename, ts.get_frame(), curr_feat, curr_desc );
+      return true;
+    }
+
     LOG_DEBUG( main_logger, "Saving features to " << kwfd_file );
     // make the enclosing directory if it does not already exist
     const kwiver::vital::path_t fd_dir = ST::GetFilenamePath( kwfd_file );
@@ -562,45 +663,117 @@ static int maptk_main(int argc, char const* argv[])
       if( !ST::MakeDirectory( fd_dir ) )
       {
         LOG_ERROR( main_logger, "Unable to create directory: " << fd_dir );
+        failed = true;
         return false;
       }
     }
-    fd_io->save(kwfd_file, curr_feat, curr_desc);
+    // write to a temporary file and move it into place so that a partially
+    // written features file is never mistaken for a complete one
+    const kwiver::vital::path_t tmp_file =
+      fd_dir + "/." + basename + "." + tmp_token + ".kwfd";
+    fd_io->save(tmp_file, curr_feat, curr_desc);
+    if( !ST::RenameFile( tmp_file.c_str(), kwfd_file.c_str() ) )
+    {
+      LOG_ERROR( main_logger, "Unable to write features file: " << kwfd_file );
+      ST::RemoveFile( tmp_file );
+      failed = true;
+      return false;
+    }
+    record_output();
 
     return true;
   };
 
 
 
-  // access the thread pool
-  auto& pool = kwiver::vital::thread_pool::instance();
+  // process frames until the end of the video or the range, or a failure
+  auto process_frames = [&] ()
+  {
+    // access the thread pool
+    auto& pool = kwiver::vital::thread_pool::instance();
+
+    // queue of future returns from jobs
+    std::deque<std::future<bool> > frame_status_queue;
+
+    // number of jobs to keep in the queue
+    // this has 1.5 times the number of threads as a heuristic to make sure
+    // we keep threads busy but don't lag too far in checking for errors
+    size_t buffer = pool.num_threads() * 3 / 2;
+    bool not_failed = true;
+    while(not_failed)
+    {
+      // enqueue a task to process one frame
+      frame_status_queue.push_back(pool.enqueue(handle_frame));
+      // if we have the specified number of frames queued up
+      if( frame_status_queue.size() > buffer )
+      {
+        // wait for a job to complete and get the status
+        not_failed = frame_status_queue.front().get();
+        frame_status_queue.pop_front();
+      }
+    }
+
+    // wait for all remaining jobs to complete
+    while( !frame_status_queue.empty() )
+    {
+      frame_status_queue.front().wait();
+      frame_status_queue.pop_front();
+    }
+  };
+
+  auto const work_queue_dir = config->get_value<std::string>("work_queue_dir");
+  if( work_queue_dir.empty() )
+  {
+    process_frames();
+    return EXIT_SUCCESS;
+  }
+
+  // Claim ranges of frames from the shared work queue until none are left
+  std::vector<kwiver::vital::frame_id_t> frames;
+  for( auto const& t : timestamps )
+  {
+    frames.push_back( t.get_frame() );
+  }
+  kwiver::maptk::frame_range_queue queue(
+    work_queue_dir, frames, config->get_value<size_t>("work_range_size"),
+    config->get_value<double>("work_claim_timeout") );
+  tmp_token = queue.worker_id();
+  std::replace( tmp_token.begin(), tmp_token.end(), ':', '.' );
 
-  // queue of future returns from jobs
-  std::deque<std::future<bool> > frame_status_queue;
+  bool const can_seek = video_reader->get_implementation_capabilities().capability(
+    kwiver::vital::algo::video_input::SUPPORTS_FRAME_SEEK );
 
-  // number of jobs to keep in the queue
-  // this has 1.5 times the number of threads as a heuristic to make sure
-  // we keep threads busy but don't lag too far in checking for errors
-  size_t buffer = pool.num_threads() * 3 / 2;
-  bool not_failed = true;
-  while(not_failed)
+  kwiver::maptk::frame_range range;
+  while( queue.claim(range) )
   {
-    // enqueue a task to process one frame
-    frame_status_queue.push_back(pool.enqueue(handle_frame));
-    // if we have the specified number of frames queued up
-    if( frame_status_queue.size() > buffer )
+    range_first = range.frames.front();
+    range_last = range.frames.back();
+    outputs.clear();
+
+    // position the video just before the first frame of the range
+    auto const first = std::find( frames.begin(), frames.end(), range_first );
+    if( !can_seek || first == frames.begin() ||
+        !video_reader->seek_frame( ts, *(first - 1) ) )
     {
-      // wait for a job to complete and get the status
-      not_failed = frame_status_queue.front().get();
-      frame_status_queue.pop_front();
+      video_reader->close();
+      video_reader->open(video_source);
     }
+
+    process_frames();
+    if( failed )
+    {
+      queue.release(range);
+      return EXIT_FAILURE;
+    }
+
+    std::sort( outputs.begin(), outputs.end() );
+    queue.complete(range, outputs);
   }
 
-  // wait for all remaining jobs to complete
-  while( !frame_status_queue.empty() )
+  if( queue.write_manifest() )
   {
-    frame_status_queue.front().wait();
-    frame_status_queue.pop_front();
+    LOG_INFO( main_logger, "All frame ranges are complete, manifest written to "
+                           << work_queue_dir << "/manifest.txt" );
   }
 
   return EXIT_SUCCESS;
@@ -608,7 +781,7 @@ static int maptk_main(int argc, char const* argv[])
 
 
 // ------------------------------------------------------------------
-int main(int argc, char const* argv[])
+MAPTK_TOOL_MAIN(int argc, char const* argv[])
 {
   try
   {
@@ -33,6 +33,8 @@
  * \brief Image homography estimation utility
  */
 
+#include "tool_common.h"
+
 #include <fstream>
 #include <string>
 #include <vector>
@@ -250,10 +252,9 @@ static int maptk_main(int argc, char const* argv[])
     homog_output_path = pos_argv[3];
   }
 
-  // register the algorithm implementations
-  std::string rel_plugin_path = kwiver::vital::get_executable_path() + "/../lib/kwiver/modules";
-  kwiver::vital::plugin_manager::instance().add_search_path(rel_plugin_path);
-  kwiver::vital::plugin_manager::instance().load_all_plugins();
+  // register the algorithm implementations used by the configuration
+  kwiver::maptk::load_tool_plugins(opt_config, { "vxl", "bypass", "ocv_SURF",
+                                                 "ocv_flann_based" });
 
   // Set config to algo chain
   // Get config from algo chain after set
@@ -281,8 +282,8 @@ static int maptk_main(int argc, char const* argv[])
   if( ! opt_config.empty() )
   {
     const std::string prefix = kwiver::vital::get_executable_path() + "/..";
-    config->merge_config(kwiver::vital::read_config_file(opt_config, "telesculptor",
-                                                         TELESCULPTOR_VERSION, prefix));
+    config->merge_config(kwiver::maptk::read_config_file_cached(opt_config, "telesculptor",
+                                                                TELESCULPTOR_VERSION, prefix));
   }
 
   // Set current configuration to algorithms and extract refined configuration.
@@ -411,7 +412,7 @@ static int maptk_main(int argc, char const* argv[])
 }
 
 
-int main(int argc, char const* argv[])
+MAPTK_TOOL_MAIN(int argc, char const* argv[])
 {
   try
   {
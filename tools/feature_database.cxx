@@ -0,0 +1,282 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Convert between per-frame feature files and a feature database
+ */
+
+#include "tool_common.h"
+
+#include <exception>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <maptk/feature_database.h>
+
+#include <vital/config/config_block.h>
+#include <vital/config/config_block_io.h>
+#include <vital/logger/logger.h>
+
+#include <vital/exceptions.h>
+#include <vital/io/metadata_io.h>
+#include <vital/algo/feature_descriptor_io.h>
+#include <vital/algo/video_input.h>
+#include <vital/util/get_paths.h>
+
+#include <kwiversys/SystemTools.hxx>
+#include <kwiversys/CommandLineArguments.hxx>
+
+#include <maptk/version.h>
+
+typedef kwiversys::SystemTools ST;
+typedef kwiversys::CommandLineArguments argT;
+
+static kwiver::vital::logger_handle_t main_logger( kwiver::vital::get_logger( "feature_database_tool" ) );
+
+// ------------------------------------------------------------------
+static kwiver::vital::config_block_sptr default_config()
+{
+  kwiver::vital::config_block_sptr config = kwiver::vital::config_block::empty_config("feature_database_tool");
+
+  config->set_value("video_source", "",
+                    "Path to an input file to be opened as a video. "
+                    "This could be either a video file or a text file "
+                    "containing new-line separated paths to sequential "
+                    "image files. It is used to find the frame number of "
+                    "each features file when importing.");
+  config->set_value("features_dir", "",
+                    "Path to the directory of per-frame feature files");
+  config->set_value("features_database", "",
+                    "Path to the feature database file");
+
+  kwiver::vital::algo::video_input::get_nested_algo_configuration("video_reader", config,
+                                      kwiver::vital::algo::video_input_sptr());
+  kwiver::vital::algo::feature_descriptor_io::get_nested_algo_configuration("fd_io", config,
+                                      kwiver::vital::algo::feature_descriptor_io_sptr());
+  return config;
+}
+
+
+// ------------------------------------------------------------------
+static bool check_config(kwiver::vital::config_block_sptr config, bool importing)
+{
+  bool config_valid = true;
+
+#define MAPTK_CONFIG_FAIL(msg) \
+  LOG_ERROR(main_logger, "Config Check Fail: " << msg); \
+  config_valid = false
+
+  if ( config->get_value<std::string>("features_dir", "") == "" )
+  {
+    MAPTK_CONFIG_FAIL("Config needs value features_dir");
+  }
+
+  if ( config->get_value<std::string>("features_database", "") == "" )
+  {
+    MAPTK_CONFIG_FAIL("Config needs value features_database");
+  }
+
+  if ( importing )
+  {
+    std::string path = config->get_value<std::string>("video_source", "");
+    if ( ! ST::FileExists( kwiver::vital::path_t(path), true ) )
+    {
+      MAPTK_CONFIG_FAIL("video_source path, " << path << ", does not exist or is not a regular file");
+    }
+
+    if (!kwiver::vital::algo::video_input::check_nested_algo_configuration("video_reader", config))
+    {
+      MAPTK_CONFIG_FAIL("video_reader configuration check failed");
+    }
+  }
+
+  if (!kwiver::vital::algo::feature_descriptor_io::check_nested_algo_configuration("fd_io", config))
+  {
+    MAPTK_CONFIG_FAIL("fd_io configuration check failed");
+  }
+
+#undef MAPTK_CONFIG_FAIL
+
+  return config_valid;
+}
+
+
+// ------------------------------------------------------------------
+static int maptk_main(int argc, char const* argv[])
+{
+  static bool        opt_help(false);
+  static bool        opt_import(false);
+  static bool        opt_export(false);
+  static std::string opt_config;
+  static std::string opt_out_config;
+
+  kwiversys::CommandLineArguments arg;
+
+  arg.Initialize( argc, argv );
+
+  arg.AddArgument( "--help",        argT::NO_ARGUMENT, &opt_help, "Display usage information" );
+  arg.AddArgument( "-h",            argT::NO_ARGUMENT, &opt_help, "Display usage information" );
+  arg.AddArgument( "--config",      argT::SPACE_ARGUMENT, &opt_config, "Configuration file for tool" );
+  arg.AddArgument( "-c",            argT::SPACE_ARGUMENT, &opt_config, "Configuration file for tool" );
+  arg.AddArgument( "--output-config", argT::SPACE_ARGUMENT, &opt_out_config,
+                   "Output a configuration. This may be seeded with a configuration file from -c/--config." );
+  arg.AddArgument( "-o",            argT::SPACE_ARGUMENT, &opt_out_config,
+                   "Output a configuration. This may be seeded with a configuration file from -c/--config." );
+  arg.AddArgument( "--import",      argT::NO_ARGUMENT, &opt_import,
+                   "Append the feature files in features_dir to the database" );
+  arg.AddArgument( "--export",      argT::NO_ARGUMENT, &opt_export,
+                   "Write every frame of the database to a file in features_dir" );
+
+  if ( ! arg.Parse() )
+  {
+    LOG_ERROR(main_logger, "Problem parsing arguments");
+    return EXIT_FAILURE;
+  }
+
+  if ( opt_help )
+  {
+    std::cout
+      << "USAGE: " << argv[0] << " [OPTS] --import|--export\n\n"
+      << "Convert between a directory of per-frame feature files, as\n"
+      << "written by maptk_detect_and_describe, and a feature database.\n\n"
+      << "Options:"
+      << arg.GetHelp() << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  // register the algorithm implementations used by the configuration
+  kwiver::maptk::load_tool_plugins(opt_config, { "core" });
+
+  kwiver::vital::config_block_sptr config = default_config();
+  kwiver::vital::algo::video_input_sptr video_reader;
+  kwiver::vital::algo::feature_descriptor_io_sptr fd_io;
+
+  // If -c/--config given, read in confg file, merge in with default just generated
+  if( ! opt_config.empty() )
+  {
+    const std::string prefix = kwiver::vital::get_executable_path() + "/..";
+    config->merge_config(kwiver::maptk::read_config_file_cached(opt_config, "telesculptor",
+                                                                TELESCULPTOR_VERSION, prefix));
+  }
+
+  kwiver::vital::algo::video_input::
+    set_nested_algo_configuration("video_reader", config, video_reader);
+  kwiver::vital::algo::video_input::
+    get_nested_algo_configuration("video_reader", config, video_reader);
+  kwiver::vital::algo::feature_descriptor_io::
+    set_nested_algo_configuration("fd_io", config, fd_io);
+  kwiver::vital::algo::feature_descriptor_io::
+    get_nested_algo_configuration("fd_io", config, fd_io);
+
+  bool valid_config = check_config(config, opt_import);
+
+  if( ! opt_out_config.empty() )
+  {
+    write_config_file(config, opt_out_config );
+    if(valid_config)
+    {
+      LOG_INFO(main_logger, "Configuration file contained valid parameters and may be used for running");
+    }
+    else
+    {
+      LOG_WARN(main_logger, "Configuration deemed not valid.");
+    }
+    return EXIT_SUCCESS;
+  }
+  else if(!valid_config)
+  {
+    LOG_ERROR(main_logger, "Configuration not valid.");
+    return EXIT_FAILURE;
+  }
+
+  if( opt_import == opt_export )
+  {
+    LOG_ERROR(main_logger, "Exactly one of --import and --export must be given");
+    return EXIT_FAILURE;
+  }
+
+  std::string features_dir = config->get_value<std::string>("features_dir");
+  std::string features_database = config->get_value<std::string>("features_database");
+
+  if( opt_export )
+  {
+    kwiver::maptk::feature_database db(features_database);
+    auto const count = kwiver::maptk::export_feature_files(db, features_dir, fd_io);
+    LOG_INFO(main_logger, "Wrote " << count << " feature files to " << features_dir);
+    return EXIT_SUCCESS;
+  }
+
+  // Find the features file of each frame, named as by detect_and_describe
+  std::string video_source = config->get_value<std::string>("video_source");
+  LOG_INFO( main_logger, "Reading Video" );
+  video_reader->open(video_source);
+
+  std::map<kwiver::vital::frame_id_t, kwiver::vital::path_t> files;
+  kwiver::vital::timestamp ts;
+  while( video_reader->next_frame(ts) )
+  {
+    auto const md_vec = video_reader->frame_metadata();
+    auto const md = md_vec.empty() ? nullptr : md_vec[0];
+    auto const basename = kwiver::vital::basename_from_metadata(md, ts.get_frame());
+    files[ts.get_frame()] = features_dir + "/" + basename + ".kwfd";
+  }
+  video_reader->close();
+
+  kwiver::maptk::feature_database db(features_database, true);
+  auto const count = kwiver::maptk::import_feature_files(db, files, fd_io);
+  LOG_INFO(main_logger, "Imported " << count << " of " << files.size()
+                        << " frames into " << features_database);
+
+  return EXIT_SUCCESS;
+}
+
+
+// ------------------------------------------------------------------
+MAPTK_TOOL_MAIN(int argc, char const* argv[])
+{
+  try
+  {
+    return maptk_main(argc, argv);
+  }
+  catch (std::exception const& e)
+  {
+    LOG_ERROR(main_logger, "Exception caught: " << e.what());
+
+    return EXIT_FAILURE;
+  }
+  catch (...)
+  {
+    LOG_ERROR(main_logger, "Unknown exception caught");
+
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,355 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Feature track reprojection error filtering utility
+ */
+
+#include "tool_common.h"
+
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <vital/config/config_block.h>
+#include <vital/config/config_block_io.h>
+#include <vital/exceptions.h>
+#include <vital/io/landmark_map_io.h>
+#include <vital/io/metadata_io.h>
+#include <vital/io/track_set_io.h>
+#include <vital/logger/logger.h>
+#include <vital/util/cpu_timer.h>
+#include <vital/util/get_paths.h>
+#include <vital/vital_types.h>
+
+#include <vital/algo/video_input.h>
+
+#include <kwiversys/CommandLineArguments.hxx>
+#include <kwiversys/SystemTools.hxx>
+
+#include <arrows/core/metrics.h>
+
+#include <maptk/reprojection_filter.h>
+#include <maptk/version.h>
+
+typedef kwiversys::SystemTools     ST;
+
+using kwiver::vital::algo::video_input;
+using kwiver::vital::algo::video_input_sptr;
+using kwiver::vital::frame_id_t;
+
+static kwiver::vital::logger_handle_t main_logger( kwiver::vital::get_logger( "filter_reprojection_tool" ) );
+
+static char const* const BLOCK_VR = "video_reader";
+
+
+static kwiver::vital::config_block_sptr default_config()
+{
+  kwiver::vital::config_block_sptr config = kwiver::vital::config_block::empty_config("filter_reprojection_tool");
+
+  config->set_value("video_source", "",
+                    "Path to an input file to be opened as a video. "
+                    "This could be either a video file or a text file "
+                    "containing new-line separated paths to sequential "
+                    "image files.");
+
+  config->set_value("input_track_file", "",
+                    "Path to an input file containing feature tracks.");
+
+  config->set_value("input_krtd_files", "",
+                    "A directory containing input KRTD camera files, named "
+                    "after the frames of the video.");
+
+  config->set_value("input_ply_file", "",
+                    "Path to an input PLY file containing the landmarks of "
+                    "the tracks.");
+
+  config->set_value("output_track_file", "results/filtered_tracks.txt",
+                    "Path to write the filtered feature tracks.");
+
+  config->set_value("max_reprojection_error", 4.0,
+                    "Track states where the landmark projects farther than "
+                    "this many pixels from the feature are removed.");
+
+  config->set_value("min_track_length", 2,
+                    "Tracks left with fewer states than this are removed.");
+
+  config->set_value("num_threads", 0,
+                    "Number of threads used to check the tracks. Zero uses "
+                    "one per processor core.");
+
+  kwiver::vital::algo::video_input::get_nested_algo_configuration(BLOCK_VR, config,
+                                                                  kwiver::vital::algo::video_input_sptr());
+  return config;
+}
+
+
+// ------------------------------------------------------------------
+static bool check_config(kwiver::vital::config_block_sptr config)
+{
+  bool config_valid = true;
+
+#define MAPTK_CONFIG_FAIL(msg) \
+  LOG_ERROR(main_logger, "Config Check Fail: " << msg); \
+  config_valid = false
+
+  std::string const video_source = config->get_value<std::string>("video_source", "");
+  if (video_source.empty())
+  {
+    MAPTK_CONFIG_FAIL("Config needs value video_source");
+  }
+  else if ( ! ST::FileExists( kwiver::vital::path_t(video_source) ) )
+  {
+    MAPTK_CONFIG_FAIL("video_source path, " << video_source << ", does not exist");
+  }
+
+  std::string const track_file = config->get_value<std::string>("input_track_file", "");
+  if (track_file.empty() || ! ST::FileExists(track_file, true))
+  {
+    MAPTK_CONFIG_FAIL("input_track_file must be an existing file");
+  }
+
+  std::string const krtd_dir = config->get_value<std::string>("input_krtd_files", "");
+  if (krtd_dir.empty() || ! ST::FileIsDirectory(krtd_dir))
+  {
+    MAPTK_CONFIG_FAIL("input_krtd_files must be an existing directory");
+  }
+
+  std::string const ply_file = config->get_value<std::string>("input_ply_file", "");
+  if (ply_file.empty() || ! ST::FileExists(ply_file, true))
+  {
+    MAPTK_CONFIG_FAIL("input_ply_file must be an existing file");
+  }
+
+  if (config->get_value<std::string>("output_track_file", "").empty())
+  {
+    MAPTK_CONFIG_FAIL("Config needs value output_track_file");
+  }
+
+  if (config->get_value<double>("max_reprojection_error", 0.0) <= 0.0)
+  {
+    MAPTK_CONFIG_FAIL("max_reprojection_error must be positive");
+  }
+
+  if (config->get_value<int>("min_track_length", 0) < 1)
+  {
+    MAPTK_CONFIG_FAIL("min_track_length must be positive");
+  }
+
+  if (config->get_value<int>("num_threads", 0) < 0)
+  {
+    MAPTK_CONFIG_FAIL("num_threads must not be negative");
+  }
+
+  if (!video_input::check_nested_algo_configuration(BLOCK_VR, config))
+  {
+    MAPTK_CONFIG_FAIL("video_reader configuration check failed");
+  }
+
+#undef MAPTK_CONFIG_FAIL
+
+  return config_valid;
+}
+
+
+static int maptk_main(int argc, char const* argv[])
+{
+  static bool        opt_help(false);
+  static std::string opt_config;
+  static std::string opt_out_config;
+
+  kwiversys::CommandLineArguments arg;
+
+  arg.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  arg.AddArgument( "--help",        argT::NO_ARGUMENT, &opt_help, "Display usage information" );
+  arg.AddArgument( "--config",      argT::SPACE_ARGUMENT, &opt_config, "Configuration file for tool" );
+  arg.AddArgument( "-c",            argT::SPACE_ARGUMENT, &opt_config, "Configuration file for tool" );
+  arg.AddArgument( "--output-config", argT::SPACE_ARGUMENT, &opt_out_config,
+                   "Output a configuration. This may be seeded with a configuration file from -c/--config." );
+  arg.AddArgument( "-o",            argT::SPACE_ARGUMENT, &opt_out_config,
+                   "Output a configuration. This may be seeded with a configuration file from -c/--config." );
+
+  if ( ! arg.Parse() )
+  {
+    LOG_ERROR(main_logger, "Problem parsing arguments");
+    return EXIT_FAILURE;
+  }
+
+  if ( opt_help )
+  {
+    std::cout
+      << "USAGE: " << argv[0] << " [OPTS]\n\n"
+      << "Options:"
+      << arg.GetHelp() << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  // register the algorithm implementations used by the configuration
+  kwiver::maptk::load_tool_plugins(opt_config);
+
+  // Set up top level configuration w/ defaults where applicable.
+  kwiver::vital::config_block_sptr config = kwiver::vital::config_block::empty_config();
+  video_input_sptr video_reader;
+
+  // If -c/--config given, read in confg file, merge in with default just generated
+  if( ! opt_config.empty() )
+  {
+    const std::string prefix = kwiver::vital::get_executable_path() + "/..";
+    config->merge_config(kwiver::maptk::read_config_file_cached(opt_config, "telesculptor",
+                                                                TELESCULPTOR_VERSION, prefix));
+  }
+
+  video_input::set_nested_algo_configuration(BLOCK_VR, config, video_reader);
+
+  kwiver::vital::config_block_sptr dflt_config = default_config();
+  dflt_config->merge_config(config);
+  config = dflt_config;
+
+  bool valid_config = check_config(config);
+
+  if( ! opt_out_config.empty() )
+  {
+    video_input::get_nested_algo_configuration(BLOCK_VR, config, video_reader);
+
+    write_config_file(config, opt_out_config );
+    if(valid_config)
+    {
+      LOG_INFO(main_logger, "Configuration file contained valid parameters"
+                            << " and may be used for running");
+    }
+    else
+    {
+      LOG_WARN(main_logger, "Configuration deemed not valid.");
+    }
+    return EXIT_SUCCESS;
+  }
+  else if(!valid_config)
+  {
+    LOG_ERROR(main_logger, "Configuration not valid.");
+    return EXIT_FAILURE;
+  }
+
+  //
+  // Read the video metadata to name the frames, and load the cameras
+  //
+  std::map<frame_id_t, std::string> basename_map;
+  std::string const video_source = config->get_value<std::string>("video_source");
+  LOG_INFO(main_logger, "Reading video metadata");
+  video_reader->open(video_source);
+  {
+    kwiver::vital::timestamp ts;
+    while (video_reader->next_frame(ts))
+    {
+      auto const md_vec = video_reader->frame_metadata();
+      auto const md = md_vec.empty() ? nullptr : md_vec[0];
+      basename_map[ts.get_frame()] =
+        kwiver::vital::basename_from_metadata(md, ts.get_frame());
+    }
+  }
+  video_reader->close();
+
+  auto const krtd_dir = config->get_value<std::string>("input_krtd_files");
+  kwiver::vital::camera_map_sptr cameras(new kwiver::vital::simple_camera_map(
+    kwiver::maptk::load_input_cameras_krtd(krtd_dir, basename_map)));
+  if (cameras->size() == 0)
+  {
+    LOG_ERROR(main_logger, "No cameras loaded.");
+    return EXIT_FAILURE;
+  }
+
+  //
+  // Read the landmarks and tracks
+  //
+  auto const ply_file = config->get_value<std::string>("input_ply_file");
+  auto const landmarks = kwiver::vital::read_ply_file(ply_file);
+
+  auto const track_file = config->get_value<std::string>("input_track_file");
+  LOG_INFO(main_logger, "loading track file: " << track_file);
+  auto const tracks = kwiver::vital::read_feature_track_file(track_file);
+  LOG_DEBUG(main_logger, "loaded " << tracks->size() << " tracks");
+
+  //
+  // Filter the tracks
+  //
+  kwiver::vital::feature_track_set_sptr filtered;
+  kwiver::maptk::reprojection_filter_stats stats;
+  {
+    kwiver::vital::scoped_cpu_timer t( "reprojection error filtering" );
+    filtered = kwiver::maptk::filter_tracks_by_reprojection_error(
+      tracks, cameras, landmarks,
+      config->get_value<double>("max_reprojection_error"),
+      config->get_value<unsigned>("min_track_length"),
+      config->get_value<unsigned>("num_threads"),
+      &stats);
+  }
+
+  LOG_INFO(main_logger, "Removed " << stats.states_removed << " of "
+                        << stats.states_checked << " checked track states; "
+                        << stats.tracks_modified << " tracks shortened, "
+                        << stats.tracks_removed << " tracks removed");
+  LOG_DEBUG(main_logger, "reprojection RMSE before: "
+            << kwiver::arrows::reprojection_rmse(cameras->cameras(),
+                                                 landmarks->landmarks(),
+                                                 tracks->tracks())
+            << ", after: "
+            << kwiver::arrows::reprojection_rmse(cameras->cameras(),
+                                                 landmarks->landmarks(),
+                                                 filtered->tracks()));
+
+  auto const out_file = config->get_value<std::string>("output_track_file");
+  ST::MakeDirectory(ST::GetFilenamePath(ST::CollapseFullPath(out_file)));
+  kwiver::vital::write_feature_track_file(filtered, out_file);
+
+  return EXIT_SUCCESS;
+}
+
+
+MAPTK_TOOL_MAIN(int argc, char const* argv[])
+{
+  try
+  {
+    return maptk_main(argc, argv);
+  }
+  catch (std::exception const& e)
+  {
+    LOG_ERROR(main_logger, "Exception caught: " << e.what());
+
+    return EXIT_FAILURE;
+  }
+  catch (...)
+  {
+    LOG_ERROR(main_logger, "Unknown exception caught");
+
+    return EXIT_FAILURE;
+  }
+}
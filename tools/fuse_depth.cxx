@@ -0,0 +1,643 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Depth map fusion and meshing utility
+ */
+
+#include "tool_common.h"
+#include "depth_common.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vital/config/config_block.h>
+#include <vital/config/config_block_io.h>
+#include <vital/exceptions.h>
+#include <vital/io/camera_io.h>
+#include <vital/io/eigen_io.h>
+#include <vital/io/landmark_map_io.h>
+#include <vital/logger/logger.h>
+#include <vital/types/camera_perspective.h>
+#include <vital/types/local_geo_cs.h>
+#include <vital/util/get_paths.h>
+
+#include <kwiversys/CommandLineArguments.hxx>
+#include <kwiversys/SystemTools.hxx>
+
+#include <maptk/depth_fusion.h>
+#include <maptk/parallel_for.h>
+#include <maptk/version.h>
+#include <maptk/write_pdal.h>
+
+#include <vtkAppendPolyData.h>
+#include <vtkCleanPolyData.h>
+#include <vtkFlyingEdges3D.h>
+#include <vtkPLYWriter.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkXMLPolyDataWriter.h>
+
+typedef kwiversys::SystemTools     ST;
+
+using kwiver::vital::camera_perspective_sptr;
+using kwiver::vital::image_container_sptr;
+using kwiver::vital::vector_3d;
+
+static kwiver::vital::logger_handle_t main_logger( kwiver::vital::get_logger( "fuse_depth_tool" ) );
+
+static char const* const BLOCK_FUSE = "integrate_depth_maps:maptk_cpu:";
+
+
+static kwiver::vital::config_block_sptr default_config()
+{
+  kwiver::vital::config_block_sptr config = kwiver::vital::config_block::empty_config("fuse_depth_tool");
+
+  config->set_value("input_depth_dir", "results/depth",
+                    "Directory of depth maps, as written by the GUI or by "
+                    "maptk_compute_depth.");
+
+  config->set_value("input_krtd_files", "",
+                    "A directory containing the KRTD camera of each depth "
+                    "map, with the same name as the depth map file.");
+
+  config->set_value("input_landmarks_file", "",
+                    "Path to a PLY file of landmarks, used to estimate the "
+                    "region of interest when roi is not set.");
+
+  config->set_value("roi", "",
+                    "Region of interest as \"xmin ymin zmin xmax ymax zmax\", "
+                    "in the format of the ROI entry of a project file. If "
+                    "empty, it is estimated from the landmarks as in the "
+                    "GUI.");
+
+  config->set_value("output_mesh_file", "results/fused_mesh.ply",
+                    "Path of the fused mesh. The format is chosen by the "
+                    "extension: .ply, .las (requires geo_origin_file), or "
+                    "VTK poly data for any other extension.");
+
+  config->set_value("geo_origin_file", "",
+                    "File containing the geographic origin of the local "
+                    "coordinates, required to write LAS files.");
+
+  config->set_value("iso_value", 0.0,
+                    "Value of the fused volume at which to extract the "
+                    "surface.");
+
+  config->set_value("num_threads", 0,
+                    "Number of threads used to load depth maps, fuse them, "
+                    "and extract the surface. Zero uses one per core.");
+
+  config->set_value("max_tile_voxels", 64000000,
+                    "Largest number of voxels fused at once. Larger regions "
+                    "are split into tiles that are fused and meshed "
+                    "independently, in parallel, and merged.");
+
+  kwiver::maptk::ray_potential const potential;
+  std::string const block = BLOCK_FUSE;
+  config->set_value(block + "ray_potential_thickness", potential.thickness,
+                    "Distance from the surface, in voxels, over which the "
+                    "ray potential ramps linearly.");
+  config->set_value(block + "ray_potential_rho", potential.rho,
+                    "Maximum magnitude of the ray potential.");
+  config->set_value(block + "ray_potential_eta", potential.eta,
+                    "Fraction of rho used in front of the surface "
+                    "(0 < eta <= 1).");
+  config->set_value(block + "ray_potential_delta", potential.delta,
+                    "Distance from the surface, in voxels, beyond which the "
+                    "ray potential is zero. Must exceed the thickness.");
+  config->set_value(block + "grid_spacing", "1 1 1",
+                    "Relative spacing of the voxels along each axis.");
+  config->set_value(block + "voxel_spacing_factor", 2.0,
+                    "Size of a voxel in units of the world size of a pixel "
+                    "near the center of the volume.");
+
+  return config;
+}
+
+
+// ------------------------------------------------------------------
+static bool check_config(kwiver::vital::config_block_sptr config)
+{
+  bool config_valid = true;
+
+#define MAPTK_CONFIG_FAIL(msg) \
+  LOG_ERROR(main_logger, "Config Check Fail: " << msg); \
+  config_valid = false
+
+  std::string const depth_dir = config->get_value<std::string>("input_depth_dir", "");
+  if (depth_dir.empty() || ! ST::FileIsDirectory(depth_dir))
+  {
+    MAPTK_CONFIG_FAIL("input_depth_dir must be an existing directory");
+  }
+
+  std::string const krtd_dir = config->get_value<std::string>("input_krtd_files", "");
+  if (krtd_dir.empty() || ! ST::FileIsDirectory(krtd_dir))
+  {
+    MAPTK_CONFIG_FAIL("input_krtd_files must be an existing directory");
+  }
+
+  std::string const roi = config->get_value<std::string>("roi", "");
+  std::string const landmarks = config->get_value<std::string>("input_landmarks_file", "");
+  vector_3d min_pt, max_pt;
+  if (!roi.empty() && !kwiver::maptk::parse_roi(roi, min_pt, max_pt))
+  {
+    MAPTK_CONFIG_FAIL("roi must hold six numbers describing a non-empty box");
+  }
+  if (roi.empty())
+  {
+    if (landmarks.empty())
+    {
+      MAPTK_CONFIG_FAIL("Either roi or input_landmarks_file must be given");
+    }
+    else if ( ! ST::FileExists(landmarks, true) )
+    {
+      MAPTK_CONFIG_FAIL("input_landmarks_file, " << landmarks << ", does not exist");
+    }
+  }
+
+  std::string const mesh_file = config->get_value<std::string>("output_mesh_file", "");
+  if (mesh_file.empty())
+  {
+    MAPTK_CONFIG_FAIL("Config needs value output_mesh_file");
+  }
+  else if (ST::LowerCase(ST::GetFilenameLastExtension(mesh_file)) == ".las" &&
+           ! ST::FileExists(config->get_value<std::string>("geo_origin_file", ""), true))
+  {
+    MAPTK_CONFIG_FAIL("Writing LAS requires an existing geo_origin_file");
+  }
+
+  std::string const block = BLOCK_FUSE;
+  double const thickness = config->get_value<double>(block + "ray_potential_thickness");
+  double const delta = config->get_value<double>(block + "ray_potential_delta");
+  if (thickness <= 0.0 || delta <= thickness)
+  {
+    MAPTK_CONFIG_FAIL("ray_potential_thickness must be positive and less "
+                      "than ray_potential_delta");
+  }
+  if (config->get_value<double>(block + "voxel_spacing_factor") <= 0.0)
+  {
+    MAPTK_CONFIG_FAIL("voxel_spacing_factor must be positive");
+  }
+
+  if (config->get_value<int>("num_threads", 0) < 0)
+  {
+    MAPTK_CONFIG_FAIL("num_threads must not be negative");
+  }
+  if (config->get_value<size_t>("max_tile_voxels", 0) < 8)
+  {
+    MAPTK_CONFIG_FAIL("max_tile_voxels must be at least 8");
+  }
+
+  std::string const type =
+    config->get_value<std::string>("integrate_depth_maps:type", "maptk_cpu");
+  if (type != "maptk_cpu")
+  {
+    LOG_WARN(main_logger, "integrate_depth_maps:type is " << type << "; "
+                          "this tool always fuses with the maptk_cpu "
+                          "parameters");
+  }
+
+#undef MAPTK_CONFIG_FAIL
+
+  return config_valid;
+}
+
+
+namespace {
+
+/// A block of voxels fused and meshed independently
+struct volume_tile
+{
+  std::array<size_t, 3> first;
+  std::array<size_t, 3> dims;
+};
+
+
+/// Split a grid into tiles of at most \p max_voxels voxels
+/**
+ * Neighboring tiles share a layer of voxels, so the surfaces extracted from
+ * them meet exactly.
+ */
+std::vector<volume_tile>
+make_tiles(kwiver::maptk::voxel_grid const& grid, size_t max_voxels)
+{
+  std::array<size_t, 3> counts = {{ 1, 1, 1 }};
+  std::array<size_t, 3> step;
+  auto update_steps = [&]()
+  {
+    size_t voxels = 1;
+    for (int a = 0; a < 3; ++a)
+    {
+      size_t const cells = std::max<size_t>(grid.dims[a], 2) - 1;
+      step[a] = (cells + counts[a] - 1) / counts[a];
+      voxels *= step[a] + 1;
+    }
+    return voxels;
+  };
+  while (update_steps() > max_voxels)
+  {
+    // Split the axis along which the tiles are longest
+    int const a = static_cast<int>(
+      std::max_element(step.begin(), step.end()) - step.begin());
+    if (step[a] <= 1)
+    {
+      break;
+    }
+    ++counts[a];
+  }
+
+  std::vector<volume_tile> tiles;
+  for (size_t tk = 0; tk < counts[2]; ++tk)
+  {
+    for (size_t tj = 0; tj < counts[1]; ++tj)
+    {
+      for (size_t ti = 0; ti < counts[0]; ++ti)
+      {
+        std::array<size_t, 3> const t = {{ ti, tj, tk }};
+        volume_tile tile;
+        bool empty = false;
+        for (int a = 0; a < 3; ++a)
+        {
+          tile.first[a] = t[a] * step[a];
+          size_t const last = std::min(tile.first[a] + step[a],
+                                       grid.dims[a] - 1);
+          empty = empty || tile.first[a] > last ||
+                  (t[a] > 0 && tile.first[a] == last);
+          tile.dims[a] = last - tile.first[a] + 1;
+        }
+        if (!empty)
+        {
+          tiles.push_back(tile);
+        }
+      }
+    }
+  }
+  return tiles;
+}
+
+
+/// Extract the iso-surface of a block of fused voxels
+vtkSmartPointer<vtkPolyData>
+extract_surface(kwiver::maptk::voxel_grid const& grid,
+                std::vector<double> const& values, double iso_value)
+{
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("reconstruction_scalar");
+  scalars->SetNumberOfValues(static_cast<vtkIdType>(values.size()));
+  std::copy(values.begin(), values.end(), scalars->GetPointer(0));
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(static_cast<int>(grid.dims[0]),
+                       static_cast<int>(grid.dims[1]),
+                       static_cast<int>(grid.dims[2]));
+  image->SetOrigin(grid.origin.data());
+  image->SetSpacing(grid.spacing.data());
+  image->GetPointData()->SetScalars(scalars.Get());
+
+  vtkNew<vtkFlyingEdges3D> contour;
+  contour->SetInputData(image.Get());
+  contour->SetNumberOfContours(1);
+  contour->SetValue(0, iso_value);
+  contour->ComputeScalarsOff();
+  contour->Update();
+  return contour->GetOutput();
+}
+
+
+/// Write a mesh in the format given by the file extension
+bool
+write_mesh(vtkPolyData* mesh, std::string const& path,
+           std::string const& geo_origin_file)
+{
+  std::string const ext = ST::LowerCase(ST::GetFilenameLastExtension(path));
+  if (ext == ".ply")
+  {
+    vtkNew<vtkPLYWriter> writer;
+    writer->SetFileName(path.c_str());
+    writer->SetFileTypeToBinary();
+    writer->SetInputData(mesh);
+    return writer->Write() != 0;
+  }
+  else if (ext == ".las")
+  {
+    kwiver::vital::local_geo_cs lgcs;
+    read_local_geo_cs_from_file(lgcs, geo_origin_file);
+    std::vector<vector_3d> points;
+    vtkPoints* pts = mesh->GetPoints();
+    vtkIdType const num_pts = pts ? pts->GetNumberOfPoints() : 0;
+    points.reserve(static_cast<size_t>(num_pts));
+    for (vtkIdType i = 0; i < num_pts; ++i)
+    {
+      vector_3d pt;
+      pts->GetPoint(i, pt.data());
+      points.push_back(pt);
+    }
+    kwiver::maptk::write_pdal(path, lgcs, points);
+    return true;
+  }
+
+  vtkNew<vtkXMLPolyDataWriter> writer;
+  writer->SetFileName(path.c_str());
+  writer->SetDataModeToBinary();
+  writer->SetCompressorTypeToZLib();
+  writer->SetInputData(mesh);
+  return writer->Write() != 0;
+}
+
+} // end anonymous namespace
+
+
+static int maptk_main(int argc, char const* argv[])
+{
+  static bool        opt_help(false);
+  static std::string opt_config;
+  static std::string opt_out_config;
+
+  kwiversys::CommandLineArguments arg;
+
+  arg.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  arg.AddArgument( "--help",        argT::NO_ARGUMENT, &opt_help, "Display usage information" );
+  arg.AddArgument( "--config",      argT::SPACE_ARGUMENT, &opt_config, "Configuration file for tool" );
+  arg.AddArgument( "-c",            argT::SPACE_ARGUMENT, &opt_config, "Configuration file for tool" );
+  arg.AddArgument( "--output-config", argT::SPACE_ARGUMENT, &opt_out_config,
+                   "Output a configuration. This may be seeded with a configuration file from -c/--config." );
+  arg.AddArgument( "-o",            argT::SPACE_ARGUMENT, &opt_out_config,
+                   "Output a configuration. This may be seeded with a configuration file from -c/--config." );
+
+  if ( ! arg.Parse() )
+  {
+    LOG_ERROR(main_logger, "Problem parsing arguments");
+    return EXIT_FAILURE;
+  }
+
+  if ( opt_help )
+  {
+    std::cout
+      << "USAGE: " << argv[0] << " [OPTS]\n\n"
+      << "Options:"
+      << arg.GetHelp() << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  // Set up top level configuration w/ defaults where applicable.
+  kwiver::vital::config_block_sptr config = default_config();
+
+  // If -c/--config given, read in confg file, merge in with default just generated
+  if( ! opt_config.empty() )
+  {
+    const std::string prefix = kwiver::vital::get_executable_path() + "/..";
+    config->merge_config(kwiver::maptk::read_config_file_cached(opt_config, "telesculptor",
+                                                                TELESCULPTOR_VERSION, prefix));
+  }
+
+  bool valid_config = check_config(config);
+
+  if( ! opt_out_config.empty() )
+  {
+    write_config_file(config, opt_out_config );
+    if(valid_config)
+    {
+      LOG_INFO(main_logger, "Configuration file contained valid parameters"
+                            << " and may be used for running");
+    }
+    else
+    {
+      LOG_WARN(main_logger, "Configuration deemed not valid.");
+    }
+    return EXIT_SUCCESS;
+  }
+  else if(!valid_config)
+  {
+    LOG_ERROR(main_logger, "Configuration not valid.");
+    return EXIT_FAILURE;
+  }
+
+  unsigned num_threads = config->get_value<unsigned>("num_threads");
+  if (num_threads == 0)
+  {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  //
+  // Load the depth maps and their cameras in parallel
+  //
+  auto const depth_dir = config->get_value<std::string>("input_depth_dir");
+  auto const krtd_dir = config->get_value<std::string>("input_krtd_files");
+  std::vector<std::string> depth_files;
+  for (auto const& f : kwiver::maptk::files_in_dir(depth_dir))
+  {
+    if (ST::LowerCase(ST::GetFilenameLastExtension(f)) == ".vti")
+    {
+      depth_files.push_back(f);
+    }
+  }
+  LOG_INFO(main_logger, "Loading " << depth_files.size() << " depth maps");
+
+  std::vector<image_container_sptr> depth_maps(depth_files.size());
+  std::vector<camera_perspective_sptr> cameras(depth_files.size());
+  kwiver::maptk::parallel_for_blocks(depth_files.size(), 1,
+                                     [&](size_t i, size_t)
+  {
+    auto const name = ST::GetFilenameWithoutLastExtension(depth_files[i]);
+    auto const krtd_file = krtd_dir + "/" + name + ".krtd";
+    try
+    {
+      auto const cam = std::dynamic_pointer_cast<kwiver::vital::camera_perspective>(
+        kwiver::vital::read_krtd_file(krtd_file));
+      int i0, j0;
+      auto const depth = kwiver::maptk::load_depth_map(depth_files[i], i0, j0);
+      if (!cam || !depth)
+      {
+        LOG_WARN(main_logger, "Skipping unreadable depth map " << depth_files[i]);
+        return;
+      }
+      depth_maps[i] = depth;
+      cameras[i] = kwiver::maptk::crop_camera(*cam, i0, j0);
+    }
+    catch (kwiver::vital::vital_exception const& e)
+    {
+      LOG_WARN(main_logger, "Skipping depth map " << depth_files[i]
+                            << ": " << e.what());
+    }
+  }, num_threads);
+
+  // Drop the depth maps that failed to load
+  size_t num_loaded = 0;
+  for (size_t i = 0; i < depth_maps.size(); ++i)
+  {
+    if (depth_maps[i])
+    {
+      depth_maps[num_loaded] = depth_maps[i];
+      cameras[num_loaded] = cameras[i];
+      ++num_loaded;
+    }
+  }
+  depth_maps.resize(num_loaded);
+  cameras.resize(num_loaded);
+  if (depth_maps.empty())
+  {
+    LOG_ERROR(main_logger, "No depth maps could be loaded");
+    return EXIT_FAILURE;
+  }
+
+  //
+  // Choose the voxel grid over the region of interest
+  //
+  vector_3d min_pt, max_pt;
+  auto const roi = config->get_value<std::string>("roi");
+  if (!roi.empty())
+  {
+    kwiver::maptk::parse_roi(roi, min_pt, max_pt);
+  }
+  else
+  {
+    auto const lm_file = config->get_value<std::string>("input_landmarks_file");
+    auto const landmarks = kwiver::vital::read_ply_file(lm_file);
+    if (!landmarks || !kwiver::maptk::robust_roi(*landmarks, min_pt, max_pt))
+    {
+      LOG_ERROR(main_logger, "Too few landmarks to estimate the region of interest");
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::string const block = BLOCK_FUSE;
+  double const voxel_size =
+    config->get_value<double>(block + "voxel_spacing_factor") *
+    kwiver::maptk::pixel_to_world_scale(min_pt, max_pt, cameras);
+  if (voxel_size <= 0.0)
+  {
+    LOG_ERROR(main_logger, "No camera sees the center of the region of interest");
+    return EXIT_FAILURE;
+  }
+
+  kwiver::maptk::ray_potential potential;
+  potential.thickness = voxel_size *
+    config->get_value<double>(block + "ray_potential_thickness");
+  potential.rho = config->get_value<double>(block + "ray_potential_rho");
+  potential.eta = config->get_value<double>(block + "ray_potential_eta");
+  potential.delta = voxel_size *
+    config->get_value<double>(block + "ray_potential_delta");
+
+  vector_3d const spacing = voxel_size *
+    config->get_value<vector_3d>(block + "grid_spacing");
+  auto const grid = kwiver::maptk::make_voxel_grid(min_pt, max_pt, spacing);
+  auto const tiles = make_tiles(
+    grid, config->get_value<size_t>("max_tile_voxels"));
+  LOG_INFO(main_logger, "Fusing " << depth_maps.size() << " depth maps into "
+                        << grid.dims[0] << " x " << grid.dims[1] << " x "
+                        << grid.dims[2] << " voxels in " << tiles.size()
+                        << " tiles");
+
+  //
+  // Fuse and mesh the tiles, several at once when there are many
+  //
+  unsigned const tile_workers = static_cast<unsigned>(
+    std::min<size_t>(num_threads, tiles.size()));
+  unsigned const threads_per_tile = std::max(num_threads / tile_workers, 1u);
+  double const iso_value = config->get_value<double>("iso_value");
+
+  std::vector<vtkSmartPointer<vtkPolyData>> surfaces(tiles.size());
+  std::atomic<size_t> tiles_done(0);
+  kwiver::maptk::parallel_for_blocks(tiles.size(), 1,
+                                     [&](size_t t, size_t)
+  {
+    auto const tile_grid = kwiver::maptk::sub_grid(grid, tiles[t].first,
+                                                   tiles[t].dims);
+    std::vector<double> values;
+    kwiver::maptk::integrate_depth_maps(tile_grid, potential, depth_maps,
+                                        cameras, values, threads_per_tile);
+    surfaces[t] = extract_surface(tile_grid, values, iso_value);
+    LOG_DEBUG(main_logger, "Finished tile " << ++tiles_done << " of "
+                           << tiles.size());
+  }, tile_workers);
+
+  vtkSmartPointer<vtkPolyData> mesh = surfaces[0];
+  if (surfaces.size() > 1)
+  {
+    vtkNew<vtkAppendPolyData> append;
+    for (auto const& s : surfaces)
+    {
+      append->AddInputData(s);
+    }
+
+    // Merge the points duplicated along the shared faces of the tiles
+    vtkNew<vtkCleanPolyData> clean;
+    clean->SetInputConnection(append->GetOutputPort());
+    clean->ToleranceIsAbsoluteOn();
+    clean->SetAbsoluteTolerance(1e-3 * spacing.minCoeff());
+    clean->Update();
+    mesh = clean->GetOutput();
+  }
+  LOG_INFO(main_logger, "Extracted a surface of " << mesh->GetNumberOfPoints()
+                        << " points and " << mesh->GetNumberOfPolys()
+                        << " triangles");
+
+  auto const mesh_file = config->get_value<std::string>("output_mesh_file");
+  ST::MakeDirectory(ST::GetFilenamePath(ST::CollapseFullPath(mesh_file)));
+  if (!write_mesh(mesh, mesh_file,
+                  config->get_value<std::string>("geo_origin_file")))
+  {
+    LOG_ERROR(main_logger, "Failed to write " << mesh_file);
+    return EXIT_FAILURE;
+  }
+  LOG_INFO(main_logger, "Wrote " << mesh_file);
+  return EXIT_SUCCESS;
+}
+
+
+MAPTK_TOOL_MAIN(int argc, char const* argv[])
+{
+  try
+  {
+    return maptk_main(argc, argv);
+  }
+  catch (std::exception const& e)
+  {
+    LOG_ERROR(main_logger, "Exception caught: " << e.what());
+
+    return EXIT_FAILURE;
+  }
+  catch (...)
+  {
+    LOG_ERROR(main_logger, "Unknown exception caught");
+
+    return EXIT_FAILURE;
+  }
+}
@@ -33,6 +33,8 @@
  * \brief compute a match matrix from a track file
  */
 
+#include "tool_common.h"
+
 #include <iostream>
 #include <fstream>
 #include <exception>
@@ -212,7 +214,7 @@ static int maptk_main(int argc, char const* argv[])
 
 
 // ------------------------------------------------------------------
-int main(int argc, char const* argv[])
+MAPTK_TOOL_MAIN(int argc, char const* argv[])
 {
   try
   {
@@ -227,10 +227,8 @@ static int maptk_main(int argc, char const* argv[])
   }
 
 
-  // register the algorithm implementations
-  std::string rel_plugin_path = kwiver::vital::get_executable_path() + "/../lib/kwiver/modules";
-  kwiver::vital::plugin_manager::instance().add_search_path(rel_plugin_path);
-  kwiver::vital::plugin_manager::instance().load_all_plugins();
+  // register the algorithm implementations used by the configuration
+  kwiver::maptk::load_tool_plugins(opt_config, { "pos" });
 
   // Tell PROJ where to find its data files
   std::string rel_proj_path = kwiver::vital::get_executable_path() + "/../share/proj";
@@ -250,8 +248,8 @@ static int maptk_main(int argc, char const* argv[])
   if ( ! opt_config.empty())
   {
     const std::string prefix = kwiver::vital::get_executable_path() + "/..";
-    config->merge_config(kwiver::vital::read_config_file(opt_config, "telesculptor",
-                                                         TELESCULPTOR_VERSION, prefix));
+    config->merge_config(kwiver::maptk::read_config_file_cached(opt_config, "telesculptor",
+                                                                TELESCULPTOR_VERSION, prefix));
   }
 
   kwiver::vital::algo::video_input::
@@ -378,7 +376,7 @@ static int maptk_main(int argc, char const* argv[])
 
 
 // ------------------------------------------------------------------
-int main(int argc, char const* argv[])
+MAPTK_TOOL_MAIN(int argc, char const* argv[])
 {
   try
   {
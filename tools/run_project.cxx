@@ -0,0 +1,837 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Incremental project pipeline runner
+ *
+ * Runs the stages of a reconstruction project described in a configuration
+ * file.  Each stage is a command with declared input and output files;
+ * a stage that reads the output of another runs after it.  A stage is
+ * skipped when its command and the contents of its inputs hash to the same
+ * value as its last successful run and its outputs still exist.  Stages
+ * that do not depend on each other run concurrently.
+ */
+
+#include "tool_common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vital/config/config_block.h>
+#include <vital/config/config_block_io.h>
+#include <vital/logger/logger.h>
+#include <vital/util/get_paths.h>
+
+#include <kwiversys/CommandLineArguments.hxx>
+#include <kwiversys/Directory.hxx>
+#include <kwiversys/SystemTools.hxx>
+
+#include <maptk/version.h>
+
+typedef kwiversys::SystemTools     ST;
+
+static kwiver::vital::logger_handle_t main_logger( kwiver::vital::get_logger( "run_project_tool" ) );
+
+static char const* const STATE_HEADER = "# maptk project state v1";
+
+
+static kwiver::vital::config_block_sptr default_config()
+{
+  kwiver::vital::config_block_sptr config = kwiver::vital::config_block::empty_config("run_project_tool");
+
+  config->set_value("project_dir", ".",
+                    "Directory in which the stage commands run.  Relative "
+                    "paths in the stages are relative to this directory.  "
+                    "A relative project_dir is relative to the directory "
+                    "of the configuration file.");
+
+  config->set_value("state_file", "results/project_state.txt",
+                    "File recording the input hash and run time of each "
+                    "stage, relative to the project directory.");
+
+  config->set_value("log_dir", "results/logs",
+                    "Directory receiving the output of each stage command, "
+                    "relative to the project directory.");
+
+  config->set_value("max_parallel", 0,
+                    "Maximum number of stages run at once.  Zero runs one "
+                    "per processor core.");
+
+  return config;
+}
+
+
+// ------------------------------------------------------------------
+static bool check_config(kwiver::vital::config_block_sptr config)
+{
+  bool config_valid = true;
+
+#define MAPTK_CONFIG_FAIL(msg) \
+  LOG_ERROR(main_logger, "Config Check Fail: " << msg); \
+  config_valid = false
+
+  if (config->get_value<int>("max_parallel", 0) < 0)
+  {
+    MAPTK_CONFIG_FAIL("max_parallel must not be negative");
+  }
+
+  auto const stages = config->subblock("stage");
+  if (stages->available_values().empty())
+  {
+    MAPTK_CONFIG_FAIL("No stages defined; add stage:<name>:command entries");
+  }
+  for (auto const& key : stages->available_values())
+  {
+    auto const sep = key.find(':');
+    auto const field = key.substr(sep == std::string::npos ? 0 : sep + 1);
+    if (sep == std::string::npos ||
+        (field != "command" && field != "inputs" && field != "outputs"))
+    {
+      MAPTK_CONFIG_FAIL("Unknown stage setting stage:" << key);
+    }
+  }
+
+#undef MAPTK_CONFIG_FAIL
+
+  return config_valid;
+}
+
+
+namespace {
+
+/// A command with the files it reads and writes
+struct stage
+{
+  std::string name;
+  std::string command;
+  // absolute paths of the files or directories read and written
+  std::vector<std::string> inputs;
+  std::vector<std::string> outputs;
+  // stages reading an output of this stage
+  std::vector<size_t> dependents;
+  // number of stages this stage reads outputs of
+  size_t num_dependencies = 0;
+};
+
+
+enum class stage_status { pending, skipped, ran, failed, blocked };
+
+
+/// Previous results of the stages and the content hashes of files
+class project_state
+{
+public:
+  struct file_record
+  {
+    uint64_t hash;
+    unsigned long size;
+    long mtime;
+  };
+
+  struct stage_record
+  {
+    uint64_t hash;
+    double seconds;
+  };
+
+  std::map<std::string, file_record> files;
+  std::map<std::string, stage_record> stages;
+
+  /// Read a state file, leaving the state empty if it is missing or invalid
+  void read(std::string const& path)
+  {
+    std::ifstream ifs(path.c_str());
+    std::string line;
+    if (!ifs || !std::getline(ifs, line) || line != STATE_HEADER)
+    {
+      return;
+    }
+    while (std::getline(ifs, line))
+    {
+      std::istringstream ss(line);
+      std::string kind;
+      ss >> kind;
+      if (kind == "file")
+      {
+        file_record r;
+        std::string file;
+        if (ss >> std::hex >> r.hash >> std::dec >> r.size >> r.mtime)
+        {
+          std::getline(ss >> std::ws, file);
+          files[file] = r;
+        }
+      }
+      else if (kind == "stage")
+      {
+        stage_record r;
+        std::string name;
+        if (ss >> name >> std::hex >> r.hash >> std::dec >> r.seconds)
+        {
+          stages[name] = r;
+        }
+      }
+    }
+  }
+
+  /// Write the state file, replacing any existing file
+  void write(std::string const& path) const
+  {
+    auto const dir = ST::GetFilenamePath(path);
+    if (!dir.empty() && !ST::FileIsDirectory(dir) && !ST::MakeDirectory(dir))
+    {
+      LOG_WARN(main_logger, "Unable to create directory " << dir);
+      return;
+    }
+
+    // Write to a temporary file first so that an interrupted run never
+    // leaves a partially written state
+    auto const tmp_path = path + ".tmp";
+    {
+      std::ofstream ofs(tmp_path.c_str());
+      if (!ofs)
+      {
+        LOG_WARN(main_logger, "Unable to write " << tmp_path);
+        return;
+      }
+      ofs << STATE_HEADER << "\n";
+      for (auto const& s : stages)
+      {
+        ofs << "stage " << s.first << " " << std::hex << s.second.hash
+            << std::dec << " " << s.second.seconds << "\n";
+      }
+      for (auto const& f : files)
+      {
+        ofs << "file " << std::hex << f.second.hash << std::dec << " "
+            << f.second.size << " " << f.second.mtime << " " << f.first
+            << "\n";
+      }
+    }
+    if (!ST::RenameFile(tmp_path.c_str(), path.c_str()))
+    {
+      ST::RemoveFile(tmp_path);
+    }
+  }
+};
+
+
+/// Update a 64-bit FNV-1a hash with a block of data
+uint64_t
+hash_bytes(uint64_t h, void const* data, size_t size)
+{
+  auto const* p = static_cast<unsigned char const*>(data);
+  for (size_t i = 0; i < size; ++i)
+  {
+    h = (h ^ p[i]) * 0x100000001b3ULL;
+  }
+  return h;
+}
+
+
+/// Update a hash with a string, including its length
+uint64_t
+hash_string(uint64_t h, std::string const& s)
+{
+  uint64_t const n = s.size();
+  h = hash_bytes(h, &n, sizeof(n));
+  return hash_bytes(h, s.data(), s.size());
+}
+
+
+uint64_t const hash_seed = 0xcbf29ce484222325ULL;
+
+
+/// Check whether \p path is \p dir or lies inside it
+bool
+is_within(std::string const& path, std::string const& dir)
+{
+  return path.size() >= dir.size() &&
+         path.compare(0, dir.size(), dir) == 0 &&
+         (path.size() == dir.size() || path[dir.size()] == '/');
+}
+
+
+/// Runs the stages of a project, skipping those that are up to date
+class project_runner
+{
+public:
+  project_runner(std::vector<stage>& stages, std::string const& project_dir,
+                 std::string const& state_file, std::string const& log_dir,
+                 bool force)
+    : stages_(stages), status_(stages.size(), stage_status::pending),
+      seconds_(stages.size(), 0.0), project_dir_(project_dir),
+      state_file_(state_file), log_dir_(log_dir), force_(force)
+  {
+    state_.read(state_file_);
+  }
+
+  /// Run all stages with at most \p max_parallel at once
+  /**
+   * \returns true if every stage ran successfully or was up to date.
+   */
+  bool run(unsigned max_parallel)
+  {
+    unresolved_ = stages_.size();
+    remaining_.resize(stages_.size());
+    for (size_t i = 0; i < stages_.size(); ++i)
+    {
+      remaining_[i] = stages_[i].num_dependencies;
+      if (remaining_[i] == 0)
+      {
+        ready_.push_back(i);
+      }
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < max_parallel; ++t)
+    {
+      workers.emplace_back(&project_runner::work, this);
+    }
+    work();
+    for (auto& w : workers)
+    {
+      w.join();
+    }
+
+    bool success = true;
+    LOG_INFO(main_logger, "Stage summary:");
+    for (size_t i = 0; i < stages_.size(); ++i)
+    {
+      static char const* const names[] =
+        { "pending", "up to date", "ran", "FAILED", "blocked" };
+      std::ostringstream line;
+      line << "  " << std::left << std::setw(24) << stages_[i].name
+           << std::setw(12) << names[static_cast<int>(status_[i])];
+      if (status_[i] == stage_status::ran ||
+          status_[i] == stage_status::failed)
+      {
+        line << std::fixed << std::setprecision(1) << seconds_[i] << " s";
+      }
+      LOG_INFO(main_logger, line.str());
+      success = success && (status_[i] == stage_status::ran ||
+                            status_[i] == stage_status::skipped);
+    }
+    return success;
+  }
+
+private:
+  /// Take ready stages and run them until every stage is resolved
+  void work()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+      cond_.wait(lock, [this] { return !ready_.empty() || unresolved_ == 0; });
+      if (ready_.empty())
+      {
+        return;
+      }
+      size_t const i = ready_.front();
+      ready_.pop_front();
+
+      lock.unlock();
+      stage_status const result = run_stage(i);
+      lock.lock();
+
+      status_[i] = result;
+      --unresolved_;
+      for (size_t d : stages_[i].dependents)
+      {
+        if (result == stage_status::failed)
+        {
+          block(d);
+        }
+        else if (--remaining_[d] == 0 &&
+                 status_[d] == stage_status::pending)
+        {
+          ready_.push_back(d);
+        }
+      }
+      cond_.notify_all();
+    }
+  }
+
+  /// Mark a stage and everything downstream of it as unable to run
+  void block(size_t i)
+  {
+    if (status_[i] != stage_status::pending)
+    {
+      return;
+    }
+    LOG_WARN(main_logger, "Stage " << stages_[i].name
+                          << " blocked by a failed dependency");
+    status_[i] = stage_status::blocked;
+    --unresolved_;
+    for (size_t d : stages_[i].dependents)
+    {
+      block(d);
+    }
+  }
+
+  /// Hash the contents of a file, reusing the hash if it is unchanged
+  bool hash_file(std::string const& path, uint64_t& hash)
+  {
+    unsigned long const size = ST::FileLength(path);
+    long const mtime = ST::ModifiedTime(path);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto const it = state_.files.find(path);
+      if (it != state_.files.end() &&
+          it->second.size == size && it->second.mtime == mtime)
+      {
+        hash = it->second.hash;
+        return true;
+      }
+    }
+
+    std::ifstream ifs(path.c_str(), std::ios::binary);
+    if (!ifs)
+    {
+      return false;
+    }
+    uint64_t h = hash_seed;
+    std::vector<char> buffer(1 << 16);
+    while (ifs)
+    {
+      ifs.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      h = hash_bytes(h, buffer.data(), static_cast<size_t>(ifs.gcount()));
+    }
+    hash = h;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_.files[path] = { h, size, mtime };
+    return true;
+  }
+
+  /// Hash a file, or the names and contents of the files in a directory
+  bool hash_path(std::string const& path, uint64_t& hash)
+  {
+    if (!ST::FileIsDirectory(path))
+    {
+      return hash_file(path, hash);
+    }
+
+    kwiversys::Directory dir;
+    if (!dir.Load(path))
+    {
+      return false;
+    }
+    std::vector<std::string> names;
+    for (unsigned long i = 0; i < dir.GetNumberOfFiles(); ++i)
+    {
+      std::string const name = dir.GetFile(i);
+      if (name != "." && name != "..")
+      {
+        names.push_back(name);
+      }
+    }
+    std::sort(names.begin(), names.end());
+
+    uint64_t h = hash_seed;
+    for (auto const& name : names)
+    {
+      uint64_t entry;
+      if (!hash_path(path + "/" + name, entry))
+      {
+        return false;
+      }
+      h = hash_string(h, name);
+      h = hash_bytes(h, &entry, sizeof(entry));
+    }
+    hash = h;
+    return true;
+  }
+
+  /// Run one stage unless it is up to date
+  stage_status run_stage(size_t i)
+  {
+    auto const& s = stages_[i];
+
+    // The hash covers the command, the output locations, and the input
+    // contents, so changing any of them reruns the stage
+    uint64_t h = hash_string(hash_seed, s.command);
+    for (auto const& out : s.outputs)
+    {
+      h = hash_string(h, ST::RelativePath(project_dir_, out));
+    }
+    for (auto const& in : s.inputs)
+    {
+      uint64_t content;
+      if (!ST::FileExists(in) || !hash_path(in, content))
+      {
+        LOG_ERROR(main_logger, "Stage " << s.name << " is missing input " << in);
+        return stage_status::failed;
+      }
+      h = hash_string(h, ST::RelativePath(project_dir_, in));
+      h = hash_bytes(h, &content, sizeof(content));
+    }
+
+    bool const outputs_exist =
+      std::all_of(s.outputs.begin(), s.outputs.end(),
+                  [](std::string const& out) { return ST::FileExists(out); });
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto const it = state_.stages.find(s.name);
+      if (!force_ && outputs_exist &&
+          it != state_.stages.end() && it->second.hash == h)
+      {
+        LOG_INFO(main_logger, "Stage " << s.name << " is up to date");
+        return stage_status::skipped;
+      }
+      // Forget the previous result until this run succeeds
+      state_.stages.erase(s.name);
+    }
+
+    for (auto const& out : s.outputs)
+    {
+      ST::MakeDirectory(ST::GetFilenamePath(out));
+    }
+    auto const log_file = log_dir_ + "/" + s.name + ".log";
+    std::string const command =
+      "cd \"" + project_dir_ + "\" && (" + s.command + ") > \"" +
+      log_file + "\" 2>&1";
+
+    LOG_INFO(main_logger, "Running stage " << s.name << ": " << s.command);
+    auto const start = std::chrono::steady_clock::now();
+    int const exit_code = std::system(command.c_str());
+    std::chrono::duration<double> const elapsed =
+      std::chrono::steady_clock::now() - start;
+    seconds_[i] = elapsed.count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Outputs may have been rewritten within the file time resolution
+    for (auto it = state_.files.begin(); it != state_.files.end();)
+    {
+      bool const written = std::any_of(
+        s.outputs.begin(), s.outputs.end(),
+        [&it](std::string const& out) { return is_within(it->first, out); });
+      it = written ? state_.files.erase(it) : std::next(it);
+    }
+    if (exit_code != 0)
+    {
+      LOG_ERROR(main_logger, "Stage " << s.name << " failed after "
+                             << seconds_[i] << " s; see " << log_file);
+      state_.write(state_file_);
+      return stage_status::failed;
+    }
+    LOG_INFO(main_logger, "Stage " << s.name << " finished in "
+                          << seconds_[i] << " s");
+    state_.stages[s.name] = { h, seconds_[i] };
+    state_.write(state_file_);
+    return stage_status::ran;
+  }
+
+  std::vector<stage>& stages_;
+  std::vector<stage_status> status_;
+  std::vector<double> seconds_;
+  std::vector<size_t> remaining_;
+  std::deque<size_t> ready_;
+  size_t unresolved_ = 0;
+  std::string project_dir_;
+  std::string state_file_;
+  std::string log_dir_;
+  bool force_;
+  project_state state_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+};
+
+
+/// Read the stages from the configuration and connect them into a graph
+/**
+ * A stage depends on another if one of its inputs is, contains, or lies
+ * inside one of the other's outputs.  The configuration file passed to a
+ * command with -c or --config is an implicit input.
+ *
+ * \returns false if two stages write the same output or the stages form
+ *          a cycle.
+ */
+bool
+build_stage_graph(kwiver::vital::config_block_sptr const& config,
+                  std::string const& project_dir, std::vector<stage>& stages)
+{
+  auto const block = config->subblock("stage");
+  std::set<std::string> names;
+  for (auto const& key : block->available_values())
+  {
+    names.insert(key.substr(0, key.find(':')));
+  }
+
+  auto const abs_paths = [&project_dir](std::string const& list)
+  {
+    std::vector<std::string> paths;
+    std::istringstream ss(list);
+    std::string token;
+    while (ss >> token)
+    {
+      paths.push_back(ST::CollapseFullPath(token, project_dir));
+    }
+    return paths;
+  };
+
+  for (auto const& name : names)
+  {
+    stage s;
+    s.name = name;
+    s.command = block->get_value<std::string>(name + ":command", "");
+    if (s.command.empty())
+    {
+      LOG_ERROR(main_logger, "Stage " << name << " has no command");
+      return false;
+    }
+    s.inputs = abs_paths(block->get_value<std::string>(name + ":inputs", ""));
+    s.outputs = abs_paths(block->get_value<std::string>(name + ":outputs", ""));
+
+    std::istringstream ss(s.command);
+    std::vector<std::string> args{ std::istream_iterator<std::string>(ss),
+                                   std::istream_iterator<std::string>() };
+    for (size_t a = 0; a + 1 < args.size(); ++a)
+    {
+      if (args[a] == "-c" || args[a] == "--config")
+      {
+        s.inputs.push_back(ST::CollapseFullPath(args[a + 1], project_dir));
+      }
+    }
+    std::sort(s.inputs.begin(), s.inputs.end());
+    s.inputs.erase(std::unique(s.inputs.begin(), s.inputs.end()),
+                   s.inputs.end());
+    stages.push_back(std::move(s));
+  }
+
+  for (size_t a = 0; a < stages.size(); ++a)
+  {
+    for (size_t b = 0; b < stages.size(); ++b)
+    {
+      if (a == b)
+      {
+        continue;
+      }
+      bool reads = false;
+      for (auto const& out : stages[a].outputs)
+      {
+        if (a < b && std::any_of(stages[b].outputs.begin(), stages[b].outputs.end(),
+              [&out](std::string const& o)
+              { return is_within(o, out) || is_within(out, o); }))
+        {
+          LOG_ERROR(main_logger, "Stages " << stages[a].name << " and "
+                                 << stages[b].name << " both write " << out);
+          return false;
+        }
+        reads = reads || std::any_of(
+          stages[b].inputs.begin(), stages[b].inputs.end(),
+          [&out](std::string const& in)
+          { return is_within(in, out) || is_within(out, in); });
+      }
+      if (reads)
+      {
+        stages[a].dependents.push_back(b);
+        ++stages[b].num_dependencies;
+      }
+    }
+  }
+
+  // Check for cycles by repeatedly removing stages with no dependencies
+  std::vector<size_t> remaining(stages.size());
+  std::vector<size_t> order;
+  for (size_t i = 0; i < stages.size(); ++i)
+  {
+    remaining[i] = stages[i].num_dependencies;
+    if (remaining[i] == 0)
+    {
+      order.push_back(i);
+    }
+  }
+  for (size_t k = 0; k < order.size(); ++k)
+  {
+    for (size_t d : stages[order[k]].dependents)
+    {
+      if (--remaining[d] == 0)
+      {
+        order.push_back(d);
+      }
+    }
+  }
+  if (order.size() != stages.size())
+  {
+    LOG_ERROR(main_logger, "The project stages form a dependency cycle");
+    return false;
+  }
+  return true;
+}
+
+} // end anonymous namespace
+
+
+static int maptk_main(int argc, char const* argv[])
+{
+  static bool        opt_help(false);
+  static bool        opt_force(false);
+  static std::string opt_config;
+  static std::string opt_out_config;
+
+  kwiversys::CommandLineArguments arg;
+
+  arg.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  arg.AddArgument( "--help",        argT::NO_ARGUMENT, &opt_help, "Display usage information" );
+  arg.AddArgument( "--config",      argT::SPACE_ARGUMENT, &opt_config, "Project configuration file" );
+  arg.AddArgument( "-c",            argT::SPACE_ARGUMENT, &opt_config, "Project configuration file" );
+  arg.AddArgument( "--output-config", argT::SPACE_ARGUMENT, &opt_out_config,
+                   "Output a configuration. This may be seeded with a configuration file from -c/--config." );
+  arg.AddArgument( "-o",            argT::SPACE_ARGUMENT, &opt_out_config,
+                   "Output a configuration. This may be seeded with a configuration file from -c/--config." );
+  arg.AddArgument( "--force",       argT::NO_ARGUMENT, &opt_force,
+                   "Run every stage even if it is up to date" );
+
+  if ( ! arg.Parse() )
+  {
+    LOG_ERROR(main_logger, "Problem parsing arguments");
+    return EXIT_FAILURE;
+  }
+
+  if ( opt_help )
+  {
+    std::cout
+      << "USAGE: " << argv[0] << " [OPTS]\n\n"
+      << "Options:"
+      << arg.GetHelp() << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  // Set up top level configuration w/ defaults where applicable.
+  kwiver::vital::config_block_sptr config = default_config();
+
+  // If -c/--config given, read in confg file, merge in with default just generated
+  if( ! opt_config.empty() )
+  {
+    const std::string prefix = kwiver::vital::get_executable_path() + "/..";
+    config->merge_config(kwiver::maptk::read_config_file_cached(opt_config, "telesculptor",
+                                                                TELESCULPTOR_VERSION, prefix));
+  }
+
+  bool valid_config = check_config(config);
+
+  if( ! opt_out_config.empty() )
+  {
+    write_config_file(config, opt_out_config );
+    if(valid_config)
+    {
+      LOG_INFO(main_logger, "Configuration file contained valid parameters"
+                            << " and may be used for running");
+    }
+    else
+    {
+      LOG_WARN(main_logger, "Configuration deemed not valid.");
+    }
+    return EXIT_SUCCESS;
+  }
+  else if(!valid_config)
+  {
+    LOG_ERROR(main_logger, "Configuration not valid.");
+    return EXIT_FAILURE;
+  }
+
+  auto const config_dir = opt_config.empty()
+    ? ST::GetCurrentWorkingDirectory()
+    : ST::GetFilenamePath(ST::CollapseFullPath(opt_config));
+  auto const project_dir =
+    ST::CollapseFullPath(config->get_value<std::string>("project_dir"), config_dir);
+  auto const state_file =
+    ST::CollapseFullPath(config->get_value<std::string>("state_file"), project_dir);
+  auto const log_dir =
+    ST::CollapseFullPath(config->get_value<std::string>("log_dir"), project_dir);
+  if (!ST::MakeDirectory(log_dir))
+  {
+    LOG_ERROR(main_logger, "Unable to create log directory " << log_dir);
+    return EXIT_FAILURE;
+  }
+
+  std::vector<stage> stages;
+  if (!build_stage_graph(config, project_dir, stages))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Let stage commands name the tools installed beside this one
+  std::string path;
+  ST::GetEnv("PATH", path);
+#ifdef _WIN32
+  char const path_sep = ';';
+#else
+  char const path_sep = ':';
+#endif
+  ST::PutEnv("PATH=" + kwiver::vital::get_executable_path() + path_sep + path);
+
+  unsigned max_parallel = config->get_value<unsigned>("max_parallel");
+  if (max_parallel == 0)
+  {
+    max_parallel = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  project_runner runner(stages, project_dir, state_file, log_dir, opt_force);
+  return runner.run(max_parallel) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+MAPTK_TOOL_MAIN(int argc, char const* argv[])
+{
+  try
+  {
+    return maptk_main(argc, argv);
+  }
+  catch (std::exception const& e)
+  {
+    LOG_ERROR(main_logger, "Exception caught: " << e.what());
+
+    return EXIT_FAILURE;
+  }
+  catch (...)
+  {
+    LOG_ERROR(main_logger, "Unknown exception caught");
+
+    return EXIT_FAILURE;
+  }
+}
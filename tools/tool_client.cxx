@@ -0,0 +1,211 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Run a MAP-Tk tool through the tool server
+ *
+ * Usage: maptk_tool_client [--socket PATH] TOOL [ARGS...]
+ *
+ * The tool output is printed as it arrives and the client exits with the
+ * exit status of the tool.  If no server is running the tool executable is
+ * run directly instead.
+ */
+
+#include "tool_server_protocol.h"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <vital/logger/logger.h>
+#include <vital/util/get_paths.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+typedef kwiversys::SystemTools ST;
+namespace ts = kwiver::maptk::tool_server;
+
+static kwiver::vital::logger_handle_t main_logger( kwiver::vital::get_logger( "tool_client" ) );
+
+
+// ------------------------------------------------------------------
+/// Connect to the server socket
+static int connect_to_server(std::string const& path)
+{
+  sockaddr_un addr;
+  if (!ts::make_address(path, addr))
+  {
+    return -1;
+  }
+
+  int const fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+  {
+    return -1;
+  }
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+  {
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+
+// ------------------------------------------------------------------
+/// Run the tool executable directly when there is no server
+static int run_directly(std::string const& tool,
+                        std::vector<std::string> const& args)
+{
+  auto exe = kwiver::vital::get_executable_path() + "/" + tool;
+  if (tool.compare(0, 6, "maptk_") != 0)
+  {
+    exe = kwiver::vital::get_executable_path() + "/maptk_" + tool;
+  }
+
+  std::vector<char*> argv;
+  argv.push_back(const_cast<char*>(exe.c_str()));
+  for (auto const& a : args)
+  {
+    argv.push_back(const_cast<char*>(a.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  ::execv(exe.c_str(), argv.data());
+  LOG_ERROR(main_logger, "Unable to run " << exe << ": " << std::strerror(errno));
+  return EXIT_FAILURE;
+}
+
+
+// ------------------------------------------------------------------
+static int maptk_main(int argc, char const* argv[])
+{
+  std::string socket_path = ts::default_socket_path();
+
+  int i = 1;
+  for (; i < argc && argv[i][0] == '-'; ++i)
+  {
+    std::string const opt = argv[i];
+    if ((opt == "--socket" || opt == "-s") && i + 1 < argc)
+    {
+      socket_path = argv[++i];
+    }
+    else if (opt == "--help" || opt == "-h")
+    {
+      std::cout
+        << "USAGE: " << argv[0] << " [OPTS] TOOL [TOOL ARGS...]\n\n"
+        << "Run a MAP-Tk tool through maptk_tool_server, falling back to\n"
+        << "running the tool directly if the server is not available.\n\n"
+        << "Options:\n"
+        << "  --socket, -s PATH  Path of the server socket\n"
+        << "  --help, -h         Display usage information" << std::endl;
+      return EXIT_SUCCESS;
+    }
+    else
+    {
+      std::cerr << "Unknown option: " << opt << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (i >= argc)
+  {
+    std::cerr << "No tool given; see --help" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::string const tool = argv[i++];
+  std::vector<std::string> const args(argv + i, argv + argc);
+
+  int const fd = connect_to_server(socket_path);
+  if (fd < 0)
+  {
+    LOG_DEBUG(main_logger, "No tool server at " << socket_path
+                           << "; running " << tool << " directly");
+    return run_directly(tool, args);
+  }
+
+  std::vector<std::string> fields;
+  fields.push_back(tool);
+  fields.push_back(ST::GetCurrentWorkingDirectory());
+  fields.insert(fields.end(), args.begin(), args.end());
+  if (!ts::write_frame(fd, ts::FRAME_REQUEST, ts::encode_request(fields)))
+  {
+    LOG_ERROR(main_logger, "Unable to send request to " << socket_path);
+    ::close(fd);
+    return EXIT_FAILURE;
+  }
+
+  char type;
+  std::string payload;
+  while (ts::read_frame(fd, type, payload))
+  {
+    if (type == ts::FRAME_OUTPUT)
+    {
+      std::fwrite(payload.data(), 1, payload.size(), stdout);
+      std::fflush(stdout);
+    }
+    else if (type == ts::FRAME_EXIT)
+    {
+      ::close(fd);
+      return std::atoi(payload.c_str());
+    }
+  }
+
+  ::close(fd);
+  LOG_ERROR(main_logger, "Lost connection to the tool server");
+  return EXIT_FAILURE;
+}
+
+
+// ------------------------------------------------------------------
+int main(int argc, char const* argv[])
+{
+  try
+  {
+    return maptk_main(argc, argv);
+  }
+  catch (std::exception const& e)
+  {
+    LOG_ERROR(main_logger, "Exception caught: " << e.what());
+
+    return EXIT_FAILURE;
+  }
+  catch (...)
+  {
+    LOG_ERROR(main_logger, "Unknown exception caught");
+
+    return EXIT_FAILURE;
+  }
+}
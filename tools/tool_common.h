@@ -38,19 +38,67 @@
 
 #include <cstdio>
 
+#include <vital/config/config_block_io.h>
 #include <vital/exceptions.h>
 #include <vital/io/camera_io.h>
 #include <vital/logger/logger.h>
+#include <vital/plugin_loader/plugin_manager.h>
 #include <vital/types/camera_map.h>
+#include <vital/util/get_paths.h>
 #include <vital/vital_types.h>
 
+#include <maptk/config_cache.h>
+#include <maptk/plugin_manifest.h>
+#include <maptk/version.h>
+
 #include <kwiversys/Directory.hxx>
 #include <kwiversys/SystemTools.hxx>
 
+/// Declare the entry point of a tool
+/**
+ * Tools are built as executables and, for the tool server, as loadable
+ * modules.  A module exports its entry point under a common name so that the
+ * server can find it.
+ */
+#ifdef MAPTK_TOOL_MODULE
+#define MAPTK_TOOL_MAIN \
+  extern "C" __attribute__((visibility("default"))) int maptk_tool_main
+#else
+#define MAPTK_TOOL_MAIN int main
+#endif
+
 namespace kwiver {
 namespace maptk {
 
 
+/// Load the plugins required to run a tool
+/**
+ * Adds the plugin search path relative to the executable.  If a tool
+ * configuration file is given, only the plugins providing the algorithm
+ * implementations it names, plus those in \p default_impls, are loaded (see
+ * load_plugins_for_config).  Otherwise all plugins are loaded.
+ */
+void
+load_tool_plugins(std::string const& config_file,
+                  std::vector<std::string> const& default_impls = {})
+{
+  auto& vpm = vital::plugin_manager::instance();
+  std::string rel_plugin_path = vital::get_executable_path() + "/../lib/kwiver/modules";
+  vpm.add_search_path(rel_plugin_path);
+
+  if ( config_file.empty() )
+  {
+    load_all_plugins();
+    return;
+  }
+
+  const std::string prefix = vital::get_executable_path() + "/..";
+  auto const config = read_config_file_cached(config_file, "telesculptor",
+                                              TELESCULPTOR_VERSION, prefix);
+  load_plugins_for_config(config, default_impls);
+}
+
+
 /// Return a sorted list of files in a directory
 std::vector< kwiver::vital::path_t >
 files_in_dir(kwiver::vital::path_t const& vdir)
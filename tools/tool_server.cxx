@@ -0,0 +1,722 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Persistent server that runs MAP-Tk tools on request
+ *
+ * The server loads the algorithm plugins and the tool modules once and then
+ * listens on a Unix socket.  Each request runs a tool in a process forked
+ * from the server, so the tool starts with everything already loaded and
+ * with its own copy of the process state that tools expect to own.  Only
+ * the plugins and tool modules are shared; each tool still reads its
+ * configuration and creates its algorithms.
+ */
+
+#include "tool_common.h"
+#include "tool_server_protocol.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <list>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <vital/logger/logger.h>
+#include <vital/util/get_paths.h>
+
+#include <kwiversys/CommandLineArguments.hxx>
+#include <kwiversys/Directory.hxx>
+#include <kwiversys/DynamicLoader.hxx>
+#include <kwiversys/SystemTools.hxx>
+
+typedef kwiversys::SystemTools ST;
+typedef kwiversys::CommandLineArguments argT;
+namespace ts = kwiver::maptk::tool_server;
+
+static kwiver::vital::logger_handle_t main_logger( kwiver::vital::get_logger( "tool_server" ) );
+
+namespace {
+
+/// Signature of the entry point exported by a tool module
+typedef int (*tool_entry_t)(int, char const*[]);
+
+/// Prefix of the tool module file names
+std::string const module_prefix = "maptk_tool_";
+
+/// Set by the signal handler to request shutdown
+volatile std::sig_atomic_t stop_requested = 0;
+
+extern "C" void handle_stop_signal(int)
+{
+  stop_requested = 1;
+}
+
+
+/// How long a client may take to send its request
+int const request_timeout_ms = 5000;
+
+
+/// A connection whose request has not been read completely
+struct pending_request
+{
+  int fd = -1;
+  std::string data;
+  std::chrono::steady_clock::time_point deadline;
+};
+
+
+/// Result of reading part of a request
+enum request_status
+{
+  REQUEST_INCOMPLETE,
+  REQUEST_READY,
+  REQUEST_FAILED
+};
+
+
+/// A request to run a tool and the process running it
+struct tool_job
+{
+  std::string tool;
+  std::string cwd;
+  std::vector<std::string> args;
+  int client_fd = -1;
+  int output_fd = -1;
+  pid_t pid = -1;
+};
+
+
+// ------------------------------------------------------------------
+/// Load every tool module in a directory
+std::map<std::string, tool_entry_t>
+load_tool_modules(std::string const& module_dir)
+{
+  std::map<std::string, tool_entry_t> tools;
+
+  kwiversys::Directory dir;
+  if (!dir.Load(module_dir))
+  {
+    LOG_ERROR(main_logger, "Unable to read tool module directory: " << module_dir);
+    return tools;
+  }
+
+  std::string const ext = kwiversys::DynamicLoader::LibExtension();
+  for (unsigned long i = 0; i < dir.GetNumberOfFiles(); ++i)
+  {
+    std::string const file = dir.GetFile(i);
+    if (file.compare(0, module_prefix.size(), module_prefix) != 0 ||
+        ST::GetFilenameLastExtension(file) != ext)
+    {
+      continue;
+    }
+
+    auto const path = module_dir + "/" + file;
+    auto handle = kwiversys::DynamicLoader::OpenLibrary(path);
+    if (!handle)
+    {
+      LOG_WARN(main_logger, "Unable to load tool module " << path << ": "
+                            << kwiversys::DynamicLoader::LastError());
+      continue;
+    }
+    auto entry = reinterpret_cast<tool_entry_t>(
+      kwiversys::DynamicLoader::GetSymbolAddress(handle, "maptk_tool_main"));
+    if (!entry)
+    {
+      LOG_WARN(main_logger, "Tool module " << path << " has no entry point");
+      continue;
+    }
+
+    auto const name = ST::GetFilenameWithoutLastExtension(file)
+                        .substr(module_prefix.size());
+    LOG_DEBUG(main_logger, "Loaded tool " << name << " from " << path);
+    tools[name] = entry;
+  }
+
+  return tools;
+}
+
+
+// ------------------------------------------------------------------
+/// Create the listening socket
+int
+open_server_socket(std::string const& path)
+{
+  sockaddr_un addr;
+  if (!ts::make_address(path, addr))
+  {
+    LOG_ERROR(main_logger, "Socket path is too long: " << path);
+    return -1;
+  }
+
+  int const fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+  {
+    LOG_ERROR(main_logger, "Unable to create socket: " << std::strerror(errno));
+    return -1;
+  }
+
+  // replace a socket left behind by a server that did not shut down cleanly
+  ::unlink(path.c_str());
+
+  // create the socket with permissions for the current user only
+  auto const old_mask = ::umask(0077);
+  auto const bound =
+    ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+  ::umask(old_mask);
+
+  if (!bound || ::listen(fd, 16) != 0)
+  {
+    LOG_ERROR(main_logger, "Unable to listen on " << path << ": "
+                           << std::strerror(errno));
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+
+// ------------------------------------------------------------------
+/// Accept a connection whose request will be read as it arrives
+bool
+accept_request(int listen_fd, pending_request& request)
+{
+  int const fd =
+    ::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  request.fd = fd;
+  request.deadline = std::chrono::steady_clock::now() +
+                     std::chrono::milliseconds(request_timeout_ms);
+  return true;
+}
+
+
+// ------------------------------------------------------------------
+/// Read the available part of a request
+/**
+ * Once the whole request frame has arrived, \p job is filled in and takes
+ * over the connection, which is made blocking again for relaying output.
+ */
+request_status
+read_request(pending_request& request, tool_job& job)
+{
+  // read until the frame is complete, so that no more than the largest
+  // frame a client may send is buffered
+  char type;
+  uint32_t size;
+  char buffer[4096];
+  while (true)
+  {
+    if (request.data.size() >= ts::HEADER_SIZE)
+    {
+      auto const* header =
+        reinterpret_cast<unsigned char const*>(request.data.data());
+      if (!ts::decode_header(header, type, size) ||
+          type != ts::FRAME_REQUEST)
+      {
+        return REQUEST_FAILED;
+      }
+      if (request.data.size() >= ts::HEADER_SIZE + size)
+      {
+        break;
+      }
+    }
+
+    auto const n = ::read(request.fd, buffer, sizeof(buffer));
+    if (n < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+      return REQUEST_INCOMPLETE;
+    }
+    if (n <= 0)
+    {
+      return REQUEST_FAILED;
+    }
+    request.data.append(buffer, static_cast<size_t>(n));
+  }
+
+  auto const fields =
+    ts::decode_request(request.data.substr(ts::HEADER_SIZE, size));
+  if (fields.size() < 2)
+  {
+    return REQUEST_FAILED;
+  }
+
+  job.tool = fields[0];
+  if (job.tool.compare(0, 6, "maptk_") == 0)
+  {
+    job.tool.erase(0, 6);
+  }
+  job.cwd = fields[1];
+  job.args.assign(fields.begin() + 2, fields.end());
+
+  // output is relayed with blocking writes
+  ::fcntl(request.fd, F_SETFL, ::fcntl(request.fd, F_GETFL) & ~O_NONBLOCK);
+  job.client_fd = request.fd;
+  request.fd = -1;
+  return REQUEST_READY;
+}
+
+
+// ------------------------------------------------------------------
+/// Send an exit status to the client of a job and close the connection
+void
+finish_job(tool_job& job, int status)
+{
+  if (job.client_fd >= 0)
+  {
+    ts::write_frame(job.client_fd, ts::FRAME_EXIT, std::to_string(status));
+    ::close(job.client_fd);
+    job.client_fd = -1;
+  }
+}
+
+
+// ------------------------------------------------------------------
+/// Fork a process to run the tool of a job
+/**
+ * The child sends its stdout and stderr through a pipe which the server
+ * relays to the client.
+ */
+bool
+start_job(tool_job& job, tool_entry_t entry, int listen_fd)
+{
+  int pipe_fds[2];
+  if (::pipe2(pipe_fds, O_CLOEXEC) != 0)
+  {
+    LOG_ERROR(main_logger, "Unable to create pipe: " << std::strerror(errno));
+    return false;
+  }
+
+  // flush before forking so buffered output is not written twice
+  std::cout.flush();
+  std::cerr.flush();
+
+  pid_t const pid = ::fork();
+  if (pid < 0)
+  {
+    LOG_ERROR(main_logger, "Unable to fork: " << std::strerror(errno));
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+    return false;
+  }
+
+  if (pid == 0)
+  {
+    // all server descriptors are close-on-exec but nothing is exec'd here,
+    // so close the ones that matter explicitly
+    ::close(listen_fd);
+    ::close(job.client_fd);
+    ::close(pipe_fds[0]);
+    ::dup2(pipe_fds[1], STDOUT_FILENO);
+    ::dup2(pipe_fds[1], STDERR_FILENO);
+    ::close(pipe_fds[1]);
+
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    std::signal(SIGPIPE, SIG_DFL);
+
+    if (::chdir(job.cwd.c_str()) != 0)
+    {
+      std::cerr << "Unable to change to directory " << job.cwd << ": "
+                << std::strerror(errno) << std::endl;
+      ::_exit(EXIT_FAILURE);
+    }
+
+    auto const name = "maptk_" + job.tool;
+    std::vector<char const*> argv;
+    argv.push_back(name.c_str());
+    for (auto const& a : job.args)
+    {
+      argv.push_back(a.c_str());
+    }
+    argv.push_back(nullptr);
+
+    int const status = entry(static_cast<int>(argv.size() - 1), argv.data());
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+    ::_exit(status);
+  }
+
+  ::close(pipe_fds[1]);
+  job.output_fd = pipe_fds[0];
+  job.pid = pid;
+  LOG_INFO(main_logger, "Started " << job.tool << " (pid " << pid << ")");
+  return true;
+}
+
+
+// ------------------------------------------------------------------
+/// Relay available output of a job to its client
+/**
+ * \returns false once the tool has closed its output and exited
+ */
+bool
+relay_output(tool_job& job)
+{
+  char buffer[65536];
+  auto const n = ::read(job.output_fd, buffer, sizeof(buffer));
+  if (n < 0 && (errno == EINTR || errno == EAGAIN))
+  {
+    return true;
+  }
+  if (n > 0)
+  {
+    if (job.client_fd >= 0 &&
+        !ts::write_frame(job.client_fd, ts::FRAME_OUTPUT, buffer,
+                         static_cast<size_t>(n)))
+    {
+      // the client went away, so nobody wants the result
+      ::close(job.client_fd);
+      job.client_fd = -1;
+      ::kill(job.pid, SIGTERM);
+    }
+    return true;
+  }
+
+  ::close(job.output_fd);
+  job.output_fd = -1;
+
+  int status = 0;
+  while (::waitpid(job.pid, &status, 0) < 0 && errno == EINTR)
+  {
+  }
+  int const exit_code = WIFEXITED(status) ? WEXITSTATUS(status)
+                                          : 128 + WTERMSIG(status);
+  LOG_INFO(main_logger, "Finished " << job.tool << " (pid " << job.pid
+                        << ") with status " << exit_code);
+  finish_job(job, exit_code);
+  return false;
+}
+
+
+// ------------------------------------------------------------------
+/// Check whether the client of a job has disconnected
+bool
+client_disconnected(int fd)
+{
+  char c;
+  auto const n = ::recv(fd, &c, 1, MSG_DONTWAIT);
+  return n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR);
+}
+
+} // end anonymous namespace
+
+
+// ------------------------------------------------------------------
+static int maptk_main(int argc, char const* argv[])
+{
+  static bool        opt_help(false);
+  static std::string opt_socket;
+  static std::string opt_module_dir;
+  static int         opt_jobs(0);
+
+  kwiversys::CommandLineArguments arg;
+
+  arg.Initialize( argc, argv );
+
+  arg.AddArgument( "--help",       argT::NO_ARGUMENT, &opt_help, "Display usage information" );
+  arg.AddArgument( "-h",           argT::NO_ARGUMENT, &opt_help, "Display usage information" );
+  arg.AddArgument( "--socket",     argT::SPACE_ARGUMENT, &opt_socket,
+                   "Path of the Unix socket on which to listen" );
+  arg.AddArgument( "-s",           argT::SPACE_ARGUMENT, &opt_socket,
+                   "Path of the Unix socket on which to listen" );
+  arg.AddArgument( "--jobs",       argT::SPACE_ARGUMENT, &opt_jobs,
+                   "Maximum number of tools to run at once; "
+                   "defaults to the number of processors" );
+  arg.AddArgument( "-j",           argT::SPACE_ARGUMENT, &opt_jobs,
+                   "Maximum number of tools to run at once; "
+                   "defaults to the number of processors" );
+  arg.AddArgument( "--module-dir", argT::SPACE_ARGUMENT, &opt_module_dir,
+                   "Directory containing the tool modules" );
+
+  if ( ! arg.Parse() )
+  {
+    std::cerr << "Problem parsing arguments" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if ( opt_help )
+  {
+    std::cout
+      << "USAGE: " << argv[0] << " [OPTS]\n\n"
+      << "Run MAP-Tk tools on behalf of maptk_tool_client without paying\n"
+      << "the start up cost of loading plugins for each run.  Only the\n"
+      << "plugins and tool modules stay loaded; each run still reads its\n"
+      << "configuration and creates its algorithms.\n\n"
+      << "Options:"
+      << arg.GetHelp() << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  if ( opt_socket.empty() )
+  {
+    opt_socket = ts::default_socket_path();
+  }
+  if ( opt_module_dir.empty() )
+  {
+    opt_module_dir = kwiver::vital::get_executable_path() +
+                     "/../lib/telesculptor/tools";
+  }
+  size_t max_jobs = opt_jobs > 0 ? static_cast<size_t>(opt_jobs)
+                                 : std::thread::hardware_concurrency();
+  max_jobs = std::max<size_t>(max_jobs, 1);
+
+  // Load everything a tool could need up front.  Nothing here may start a
+  // thread, since threads do not survive into the forked tool processes.
+  kwiver::maptk::load_tool_plugins("");
+  auto const tools = load_tool_modules(opt_module_dir);
+  if ( tools.empty() )
+  {
+    LOG_ERROR(main_logger, "No tool modules found in " << opt_module_dir);
+    return EXIT_FAILURE;
+  }
+
+  int const listen_fd = open_server_socket(opt_socket);
+  if ( listen_fd < 0 )
+  {
+    return EXIT_FAILURE;
+  }
+
+  struct sigaction action = {};
+  action.sa_handler = handle_stop_signal;
+  ::sigaction(SIGINT, &action, nullptr);
+  ::sigaction(SIGTERM, &action, nullptr);
+  std::signal(SIGPIPE, SIG_IGN);
+
+  LOG_INFO(main_logger, "Serving " << tools.size() << " tools on "
+                        << opt_socket << " with up to " << max_jobs
+                        << " concurrent jobs");
+
+  std::list<pending_request> requests;
+  std::list<tool_job> pending;
+  std::list<tool_job> running;
+  while ( !stop_requested )
+  {
+    // start queued jobs while there are free slots
+    while ( !pending.empty() && running.size() < max_jobs )
+    {
+      auto& job = pending.front();
+      auto const t = tools.find(job.tool);
+      if ( t == tools.end() )
+      {
+        ts::write_frame(job.client_fd, ts::FRAME_OUTPUT,
+                        "Unknown tool: " + job.tool + "\n");
+        finish_job(job, EXIT_FAILURE);
+      }
+      else if ( start_job(job, t->second, listen_fd) )
+      {
+        running.splice(running.end(), pending, pending.begin());
+        continue;
+      }
+      else
+      {
+        finish_job(job, EXIT_FAILURE);
+      }
+      pending.pop_front();
+    }
+
+    // wait for a new connection, part of a request, tool output, or a
+    // client to go away, but no longer than until the next request times
+    // out, so that one slow client does not hold up the others
+    std::vector<pollfd> fds;
+    fds.push_back({ listen_fd, POLLIN, 0 });
+    for ( auto const& job : running )
+    {
+      fds.push_back({ job.output_fd, POLLIN, 0 });
+      fds.push_back({ job.client_fd, POLLIN, 0 });
+    }
+    for ( auto const& job : pending )
+    {
+      fds.push_back({ job.client_fd, POLLIN, 0 });
+    }
+    int timeout = -1;
+    auto const now = std::chrono::steady_clock::now();
+    for ( auto const& request : requests )
+    {
+      fds.push_back({ request.fd, POLLIN, 0 });
+      auto const remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+          request.deadline - now).count();
+      auto const ms = static_cast<int>(std::max<decltype(remaining)>(
+        remaining + 1, 0));
+      timeout = timeout < 0 ? ms : std::min(timeout, ms);
+    }
+
+    if ( ::poll(fds.data(), fds.size(), timeout) < 0 )
+    {
+      if ( errno == EINTR )
+      {
+        continue;
+      }
+      LOG_ERROR(main_logger, "poll failed: " << std::strerror(errno));
+      break;
+    }
+
+    auto fd = fds.begin() + 1;
+    for ( auto job = running.begin(); job != running.end(); )
+    {
+      auto const& out_poll = *fd++;
+      auto const& client_poll = *fd++;
+
+      if ( job->client_fd >= 0 && client_poll.revents &&
+           client_disconnected(job->client_fd) )
+      {
+        LOG_INFO(main_logger, "Client of " << job->tool << " (pid "
+                              << job->pid << ") disconnected; stopping");
+        ::close(job->client_fd);
+        job->client_fd = -1;
+        ::kill(job->pid, SIGTERM);
+      }
+
+      if ( out_poll.revents && !relay_output(*job) )
+      {
+        job = running.erase(job);
+        continue;
+      }
+      ++job;
+    }
+    for ( auto job = pending.begin(); job != pending.end(); )
+    {
+      auto const& client_poll = *fd++;
+      if ( client_poll.revents && client_disconnected(job->client_fd) )
+      {
+        ::close(job->client_fd);
+        job = pending.erase(job);
+        continue;
+      }
+      ++job;
+    }
+
+    auto const polled = std::chrono::steady_clock::now();
+    for ( auto request = requests.begin(); request != requests.end(); )
+    {
+      auto const& request_poll = *fd++;
+      if ( request_poll.revents )
+      {
+        tool_job job;
+        auto const status = read_request(*request, job);
+        if ( status == REQUEST_READY )
+        {
+          pending.push_back(job);
+          request = requests.erase(request);
+          continue;
+        }
+        if ( status == REQUEST_FAILED )
+        {
+          LOG_WARN(main_logger, "Discarding malformed request");
+          ::close(request->fd);
+          request = requests.erase(request);
+          continue;
+        }
+      }
+      if ( polled >= request->deadline )
+      {
+        LOG_WARN(main_logger, "Discarding request not received within "
+                              << request_timeout_ms << " ms");
+        ::close(request->fd);
+        request = requests.erase(request);
+        continue;
+      }
+      ++request;
+    }
+
+    if ( fds.front().revents & POLLIN )
+    {
+      pending_request request;
+      if ( accept_request(listen_fd, request) )
+      {
+        requests.push_back(request);
+      }
+    }
+  }
+
+  LOG_INFO(main_logger, "Shutting down");
+  for ( auto& job : running )
+  {
+    ::kill(job.pid, SIGTERM);
+    ::waitpid(job.pid, nullptr, 0);
+    ::close(job.output_fd);
+    finish_job(job, 128 + SIGTERM);
+  }
+  for ( auto& job : pending )
+  {
+    finish_job(job, EXIT_FAILURE);
+  }
+  for ( auto& request : requests )
+  {
+    ::close(request.fd);
+  }
+  ::close(listen_fd);
+  ::unlink(opt_socket.c_str());
+
+  return EXIT_SUCCESS;
+}
+
+
+// ------------------------------------------------------------------
+int main(int argc, char const* argv[])
+{
+  try
+  {
+    return maptk_main(argc, argv);
+  }
+  catch (std::exception const& e)
+  {
+    LOG_ERROR(main_logger, "Exception caught: " << e.what());
+
+    return EXIT_FAILURE;
+  }
+  catch (...)
+  {
+    LOG_ERROR(main_logger, "Unknown exception caught");
+
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,251 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name Kitware, Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Wire protocol shared by the tool server and its client
+ *
+ * Messages are frames made of a one byte type, a four byte big-endian
+ * payload length, and the payload.  A client sends one request frame whose
+ * payload is the NUL separated tool name, working directory, and tool
+ * arguments.  The server replies with any number of output frames carrying
+ * the combined stdout and stderr of the tool, followed by one exit frame
+ * carrying the tool exit status as decimal text.
+ */
+
+#ifndef MAPTK_TOOL_SERVER_PROTOCOL_H_
+#define MAPTK_TOOL_SERVER_PROTOCOL_H_
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace kwiver {
+namespace maptk {
+namespace tool_server {
+
+/// Frame type of a request to run a tool
+static char const FRAME_REQUEST = 'r';
+/// Frame type of a block of tool output
+static char const FRAME_OUTPUT = 'o';
+/// Frame type of the tool exit status
+static char const FRAME_EXIT = 'x';
+
+/// Largest frame payload accepted by either end
+static uint32_t const MAX_PAYLOAD = 64 * 1024 * 1024;
+
+/// Size of a frame header
+static size_t const HEADER_SIZE = 5;
+
+
+/// Write all of a buffer to a file descriptor, retrying on interruption
+inline bool
+write_all(int fd, void const* data, size_t size)
+{
+  auto const* p = static_cast<char const*>(data);
+  while (size > 0)
+  {
+    auto const n = ::send(fd, p, size, MSG_NOSIGNAL);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    p += n;
+    size -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+
+/// Read exactly \p size bytes from a file descriptor
+/**
+ * \returns false on error or if the stream ends first
+ */
+inline bool
+read_all(int fd, void* data, size_t size)
+{
+  auto* p = static_cast<char*>(data);
+  while (size > 0)
+  {
+    auto const n = ::read(fd, p, size);
+    if (n < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (n <= 0)
+    {
+      return false;
+    }
+    p += n;
+    size -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+
+/// Write one frame to a socket
+inline bool
+write_frame(int fd, char type, char const* data, size_t size)
+{
+  unsigned char header[HEADER_SIZE] = {
+    static_cast<unsigned char>(type),
+    static_cast<unsigned char>((size >> 24) & 0xff),
+    static_cast<unsigned char>((size >> 16) & 0xff),
+    static_cast<unsigned char>((size >> 8) & 0xff),
+    static_cast<unsigned char>(size & 0xff) };
+  return write_all(fd, header, sizeof(header)) &&
+         write_all(fd, data, size);
+}
+
+
+/// Write one frame to a socket
+inline bool
+write_frame(int fd, char type, std::string const& payload)
+{
+  return write_frame(fd, type, payload.data(), payload.size());
+}
+
+
+/// Decode a frame header
+/**
+ * \returns false if the payload is larger than MAX_PAYLOAD
+ */
+inline bool
+decode_header(unsigned char const* header, char& type, uint32_t& size)
+{
+  type = static_cast<char>(header[0]);
+  size = (uint32_t{header[1]} << 24) |
+         (uint32_t{header[2]} << 16) |
+         (uint32_t{header[3]} << 8) |
+         uint32_t{header[4]};
+  return size <= MAX_PAYLOAD;
+}
+
+
+/// Read one frame from a socket
+inline bool
+read_frame(int fd, char& type, std::string& payload)
+{
+  unsigned char header[HEADER_SIZE];
+  uint32_t size;
+  if (!read_all(fd, header, sizeof(header)) ||
+      !decode_header(header, type, size))
+  {
+    return false;
+  }
+  payload.resize(size);
+  return size == 0 || read_all(fd, &payload[0], size);
+}
+
+
+/// Join the fields of a request into a frame payload
+inline std::string
+encode_request(std::vector<std::string> const& fields)
+{
+  std::string payload;
+  for (auto const& f : fields)
+  {
+    payload.append(f);
+    payload.push_back('\0');
+  }
+  return payload;
+}
+
+
+/// Split a request frame payload into its fields
+inline std::vector<std::string>
+decode_request(std::string const& payload)
+{
+  std::vector<std::string> fields;
+  size_t start = 0;
+  while (start < payload.size())
+  {
+    auto const end = payload.find('\0', start);
+    if (end == std::string::npos)
+    {
+      fields.push_back(payload.substr(start));
+      break;
+    }
+    fields.push_back(payload.substr(start, end - start));
+    start = end + 1;
+  }
+  return fields;
+}
+
+
+/// Path of the server socket used when none is given
+/**
+ * This is \c TELESCULPTOR_TOOL_SOCKET if set, otherwise a per-user socket in
+ * \c XDG_RUNTIME_DIR or, failing that, in \c /tmp.
+ */
+inline std::string
+default_socket_path()
+{
+  if (auto const* path = std::getenv("TELESCULPTOR_TOOL_SOCKET"))
+  {
+    return path;
+  }
+  if (auto const* dir = std::getenv("XDG_RUNTIME_DIR"))
+  {
+    return std::string(dir) + "/telesculptor-tools.sock";
+  }
+  return "/tmp/telesculptor-tools-" + std::to_string(::getuid()) + ".sock";
+}
+
+
+/// Fill a socket address for a Unix socket path
+inline bool
+make_address(std::string const& path, sockaddr_un& addr)
+{
+  addr = sockaddr_un{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path))
+  {
+    return false;
+  }
+  path.copy(addr.sun_path, path.size());
+  return true;
+}
+
+} // end namespace tool_server
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_TOOL_SERVER_PROTOCOL_H_
@@ -33,10 +33,18 @@
  * \brief Feature tracker utility
  */
 
+#include "tool_common.h"
+
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <cmath>
 #include <exception>
+#include <limits>
+#include <map>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <maptk/colorize.h>
@@ -106,6 +114,23 @@ static kwiver::vital::config_block_sptr default_config()
                     "homographies for each frame. Leave blank to disable this "
                     "output. The output_homography_generator algorithm type "
                     "only needs to be set if this is set.");
+  config->set_value("num_segments", 1,
+                    "Number of segments into which to split the video. Each "
+                    "segment is tracked in its own thread and the resulting "
+                    "tracks are stitched together where the segments "
+                    "overlap. A value of 1 tracks the whole video "
+                    "sequentially. Tracks are not matched across segments "
+                    "except through the overlap frames, so any loop "
+                    "closure by the feature tracker is limited to within "
+                    "a segment.");
+  config->set_value("segment_overlap", 10,
+                    "Number of frames shared by consecutive segments. Tracks "
+                    "are stitched by matching features detected on these "
+                    "frames.");
+  config->set_value("stitch_tolerance", 0.5,
+                    "Maximum distance in pixels between features on an "
+                    "overlap frame for them to be considered the same "
+                    "detection when stitching segments.");
 
   kwiver::vital::algo::video_input::get_nested_algo_configuration("video_reader", config,
                                       kwiver::vital::algo::video_input_sptr());
@@ -192,6 +217,16 @@ static bool check_config(kwiver::vital::config_block_sptr config)
     MAPTK_CONFIG_FAIL("output_tracks_file is not in a valid directory");
   }
 
+  if (config->get_value<int>("num_segments", 1) < 1)
+  {
+    MAPTK_CONFIG_FAIL("num_segments must be at least 1");
+  }
+
+  if (config->get_value<int>("segment_overlap", 10) < 1)
+  {
+    MAPTK_CONFIG_FAIL("segment_overlap must be at least 1");
+  }
+
   if (!kwiver::vital::algo::video_input::check_nested_algo_configuration("video_reader", config))
   {
     MAPTK_CONFIG_FAIL("video_reader configuration check failed");
@@ -218,6 +253,352 @@ static bool check_config(kwiver::vital::config_block_sptr config)
 }
 
 
+// ------------------------------------------------------------------
+/// Options for reading the mask image of each frame
+struct mask_options
+{
+  bool use_masks = false;
+  std::vector<kwiver::vital::path_t> files;
+  bool invert = false;
+  bool expect_multichannel = false;
+};
+
+
+// ------------------------------------------------------------------
+/// A contiguous range of frames tracked with its own algorithm instances
+struct track_segment
+{
+  kwiver::vital::frame_id_t first_frame = 0;
+  kwiver::vital::frame_id_t last_frame = 0;
+  kwiver::vital::algo::video_input_sptr video_reader;
+  kwiver::vital::algo::track_features_sptr feature_tracker;
+  kwiver::vital::algo::image_io_sptr image_reader;
+  kwiver::vital::algo::convert_image_sptr image_converter;
+  kwiver::vital::feature_track_set_sptr tracks;
+  bool success = false;
+};
+
+
+// ------------------------------------------------------------------
+/// Configure a new set of algorithm instances for a segment
+static void configure_segment(kwiver::vital::config_block_sptr config,
+                              track_segment& segment)
+{
+  using namespace kwiver::vital::algo;
+  video_input::set_nested_algo_configuration("video_reader", config, segment.video_reader);
+  track_features::set_nested_algo_configuration("feature_tracker", config, segment.feature_tracker);
+  image_io::set_nested_algo_configuration("image_reader", config, segment.image_reader);
+  convert_image::set_nested_algo_configuration("convert_image", config, segment.image_converter);
+}
+
+
+// ------------------------------------------------------------------
+/// Load and convert the mask image for a frame
+/**
+ * \returns false if the mask is not usable
+ */
+static bool load_mask(track_segment const& segment, mask_options const& masks,
+                      kwiver::vital::frame_id_t frame,
+                      kwiver::vital::image_container_sptr& converted_mask)
+{
+  auto mask = segment.image_reader->load( masks.files[frame] );
+
+  // error out if we are not expecting a multi-channel mask
+  if( !masks.expect_multichannel && mask->depth() > 1 )
+  {
+    LOG_ERROR( main_logger,
+               "Encounted multi-channel mask image!" );
+    return false;
+  }
+  else if( masks.expect_multichannel && mask->depth() == 1 )
+  {
+    LOG_WARN( main_logger,
+              "Expecting multi-channel masks but received one that was "
+              "single-channel." );
+  }
+
+  if( masks.invert )
+  {
+    LOG_DEBUG( main_logger,
+               "Inverting mask image pixels" );
+    kwiver::vital::image_of<bool> mask_image;
+    kwiver::vital::cast_image( mask->get_image(), mask_image );
+    kwiver::vital::transform_image( mask_image, [] (bool b) { return !b; } );
+    LOG_DEBUG( main_logger,
+               "Inverting mask image pixels -- Done" );
+    mask = std::make_shared<kwiver::vital::simple_image_container>( mask_image );
+  }
+
+  converted_mask = segment.image_converter->convert( mask );
+  return true;
+}
+
+
+// ------------------------------------------------------------------
+/// Track the frames of a segment sequentially
+/**
+ * If \p homog_ofs is open, a homography for each frame is written to it
+ * as the frame is tracked.
+ */
+static void track_frames(std::string const& video_source,
+                         mask_options const& masks,
+                         track_segment& segment,
+                         std::ofstream* homog_ofs = nullptr,
+                         kwiver::vital::algo::compute_ref_homography_sptr
+                           out_homog_generator = nullptr)
+{
+  auto& video_reader = *segment.video_reader;
+  video_reader.open(video_source);
+
+  // move to the first frame of the segment
+  kwiver::vital::timestamp ts;
+  bool have_frame = video_reader.next_frame(ts);
+  if( have_frame && ts.get_frame() < segment.first_frame )
+  {
+    if( video_reader.get_implementation_capabilities().capability(
+          kwiver::vital::algo::video_input::SUPPORTS_FRAME_SEEK ) )
+    {
+      have_frame = video_reader.seek_frame(ts, segment.first_frame);
+    }
+    while( have_frame && ts.get_frame() < segment.first_frame )
+    {
+      have_frame = video_reader.next_frame(ts);
+    }
+  }
+
+  // Track features on each frame sequentially
+  kwiver::vital::feature_track_set_sptr tracks;
+  for( ; have_frame && ts.get_frame() <= segment.last_frame;
+       have_frame = video_reader.next_frame(ts) )
+  {
+    LOG_INFO(main_logger, "processing frame "<<ts.get_frame() );
+
+    auto const image = video_reader.frame_image();
+    auto const mdv = video_reader.frame_metadata();
+    auto converted_image = segment.image_converter->convert( image );
+    if( !mdv.empty() )
+    {
+      converted_image->set_metadata( mdv[0] );
+    }
+
+    // Load the mask for this image if we were given a mask image list
+    kwiver::vital::image_container_sptr converted_mask;
+    if( masks.use_masks &&
+        !load_mask( segment, masks, ts.get_frame(), converted_mask ) )
+    {
+      video_reader.close();
+      return;
+    }
+
+    tracks = segment.feature_tracker->track(tracks, ts.get_frame(),
+                                            converted_image, converted_mask);
+    if (tracks)
+    {
+      tracks = kwiver::maptk::extract_feature_colors(tracks, *image, ts.get_frame());
+    }
+
+    // Compute ref homography for current frame with current track set + write to file
+    // -> still doesn't take into account a full shotbreak, which would incur a track reset
+    if ( homog_ofs && homog_ofs->is_open() )
+    {
+      LOG_DEBUG(main_logger, "writing homography");
+      *homog_ofs << *(out_homog_generator->estimate(ts.get_frame(), tracks)) << std::endl;
+    }
+  }
+  video_reader.close();
+
+  segment.tracks = tracks;
+  segment.success = true;
+}
+
+
+// ------------------------------------------------------------------
+/// Match the tracks of a segment to those of the previous segment
+/**
+ * Features detected on the frames shared by both segments are paired by
+ * location.  Each track of \p next is mapped to the track of \p prev with
+ * which it shares the most features, provided no other track of \p next
+ * shares more.
+ *
+ * \returns a map from track IDs in \p next to track IDs in \p prev
+ */
+static std::map<kwiver::vital::track_id_t, kwiver::vital::track_id_t>
+match_segment_tracks(track_segment const& prev, track_segment const& next,
+                     double tolerance)
+{
+  typedef kwiver::vital::track_id_t track_id_t;
+  std::map<std::pair<track_id_t, track_id_t>, unsigned> votes;
+
+  auto const sq_tol = tolerance * tolerance;
+  for( auto f = next.first_frame; f <= prev.last_frame; ++f )
+  {
+    // bin the features of the previous segment on a grid of tolerance size
+    std::multimap<std::pair<long, long>,
+                  std::pair<kwiver::vital::vector_2d, track_id_t>> grid;
+    auto const cell = [tolerance](kwiver::vital::vector_2d const& loc)
+    {
+      return std::make_pair(static_cast<long>(std::floor(loc[0] / tolerance)),
+                            static_cast<long>(std::floor(loc[1] / tolerance)));
+    };
+    for( auto const& state : prev.tracks->frame_states(f) )
+    {
+      auto fts = std::dynamic_pointer_cast<kwiver::vital::feature_track_state>(state);
+      if( fts && fts->feature && fts->track() )
+      {
+        auto const& loc = fts->feature->loc();
+        grid.emplace(cell(loc), std::make_pair(loc, fts->track()->id()));
+      }
+    }
+
+    for( auto const& state : next.tracks->frame_states(f) )
+    {
+      auto fts = std::dynamic_pointer_cast<kwiver::vital::feature_track_state>(state);
+      if( !fts || !fts->feature || !fts->track() )
+      {
+        continue;
+      }
+      auto const& loc = fts->feature->loc();
+      auto const c = cell(loc);
+      for( long dx = -1; dx <= 1; ++dx )
+      {
+        for( long dy = -1; dy <= 1; ++dy )
+        {
+          auto const range = grid.equal_range({ c.first + dx, c.second + dy });
+          for( auto i = range.first; i != range.second; ++i )
+          {
+            if( ( i->second.first - loc ).squaredNorm() <= sq_tol )
+            {
+              ++votes[{ fts->track()->id(), i->second.second }];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // assign matches in order of decreasing support, one to one
+  std::vector<std::pair<unsigned, std::pair<track_id_t, track_id_t>>> ranked;
+  for( auto const& v : votes )
+  {
+    ranked.emplace_back(v.second, v.first);
+  }
+  std::sort(ranked.begin(), ranked.end(),
+            [](decltype(ranked)::value_type const& a,
+               decltype(ranked)::value_type const& b)
+            { return a.first > b.first; });
+
+  std::map<track_id_t, track_id_t> matches;
+  std::set<track_id_t> used;
+  for( auto const& r : ranked )
+  {
+    auto const& ids = r.second;
+    if( !matches.count(ids.first) && !used.count(ids.second) )
+    {
+      matches[ids.first] = ids.second;
+      used.insert(ids.second);
+    }
+  }
+  return matches;
+}
+
+
+// ------------------------------------------------------------------
+/// Stitch the tracks of consecutive overlapping segments into one track set
+/**
+ * Each overlap is split at its middle frame.  A segment contributes its
+ * track states up to the split with the following segment, and tracks that
+ * match across a split are joined under one ID.  Track IDs are renumbered
+ * from zero.
+ */
+static kwiver::vital::feature_track_set_sptr
+stitch_segments(std::vector<track_segment> const& segments, double tolerance)
+{
+  typedef kwiver::vital::track_id_t track_id_t;
+  typedef kwiver::vital::frame_id_t frame_id_t;
+
+  std::map<track_id_t, kwiver::vital::track_sptr> merged;
+  kwiver::vital::track_set_frame_data_map_t frame_data;
+  std::map<track_id_t, track_id_t> prev_ids;
+  track_id_t next_id = 0;
+
+  for( size_t k = 0; k < segments.size(); ++k )
+  {
+    auto const& segment = segments[k];
+    if( !segment.tracks )
+    {
+      prev_ids.clear();
+      continue;
+    }
+
+    // frames [begin, end) of this segment are kept
+    frame_id_t begin = std::numeric_limits<frame_id_t>::min();
+    frame_id_t end = std::numeric_limits<frame_id_t>::max();
+    std::map<track_id_t, track_id_t> matches;
+    if( k > 0 && segments[k - 1].tracks )
+    {
+      auto const& prev = segments[k - 1];
+      begin = segment.first_frame + ( prev.last_frame - segment.first_frame + 1 ) / 2;
+      matches = match_segment_tracks(prev, segment, tolerance);
+      LOG_INFO(main_logger, "Stitched " << matches.size()
+                            << " tracks at frame " << begin);
+    }
+    if( k + 1 < segments.size() )
+    {
+      auto const& next = segments[k + 1];
+      end = next.first_frame + ( segment.last_frame - next.first_frame + 1 ) / 2;
+    }
+
+    std::map<track_id_t, track_id_t> ids;
+    for( auto const& track : segment.tracks->tracks() )
+    {
+      auto m = matches.find(track->id());
+      auto p = ( m == matches.end() ) ? prev_ids.end() : prev_ids.find(m->second);
+
+      kwiver::vital::track_sptr new_track;
+      for( auto const& ts : *track )
+      {
+        if( ts->frame() < begin || ts->frame() >= end ||
+            !std::dynamic_pointer_cast<kwiver::vital::feature_track_state>(ts) )
+        {
+          continue;
+        }
+        if( !new_track )
+        {
+          auto const id = ( p != prev_ids.end() ) ? p->second : next_id++;
+          auto& t = merged[id];
+          if( !t )
+          {
+            t = kwiver::vital::track::create(track->data());
+            t->set_id(id);
+          }
+          new_track = t;
+          ids[track->id()] = id;
+        }
+        new_track->append(ts->clone());
+      }
+    }
+    prev_ids = ids;
+
+    for( auto const& fd : segment.tracks->all_frame_data() )
+    {
+      if( fd.first >= begin && fd.first < end )
+      {
+        frame_data[fd.first] = fd.second;
+      }
+    }
+  }
+
+  std::vector<kwiver::vital::track_sptr> tracks;
+  for( auto const& t : merged )
+  {
+    tracks.push_back(t.second);
+  }
+  auto tracks_out = std::make_shared<kwiver::vital::feature_track_set>(tracks);
+  tracks_out->set_frame_data(frame_data);
+  return tracks_out;
+}
+
+
 // ------------------------------------------------------------------
 static int maptk_main(int argc, char const* argv[])
 {
@@ -254,10 +635,8 @@ static int maptk_main(int argc, char const* argv[])
     return EXIT_SUCCESS;
   }
 
-  // register the algorithm implementations
-  std::string rel_plugin_path = kwiver::vital::get_executable_path() + "/../lib/kwiver/modules";
-  kwiver::vital::plugin_manager::instance().add_search_path(rel_plugin_path);
-  kwiver::vital::plugin_manager::instance().load_all_plugins();
+  // register the algorithm implementations used by the configuration
+  kwiver::maptk::load_tool_plugins(opt_config);
 
   // Set config to algo chain
   // Get config from algo chain after set
@@ -278,8 +657,8 @@ static int maptk_main(int argc, char const* argv[])
   if( ! opt_config.empty() )
   {
     const std::string prefix = kwiver::vital::get_executable_path() + "/..";
-    config->merge_config(kwiver::vital::read_config_file(opt_config, "telesculptor",
-                                                         TELESCULPTOR_VERSION, prefix));
+    config->merge_config(kwiver::maptk::read_config_file_cached(opt_config, "telesculptor",
+                                                                TELESCULPTOR_VERSION, prefix));
   }
 
   kwiver::vital::algo::video_input::set_nested_algo_configuration("video_reader", config, video_reader);
@@ -334,20 +713,19 @@ static int maptk_main(int argc, char const* argv[])
   {
     timestamps.push_back(ts);
   }
-  // close and re-open to return to the video start
   video_reader->close();
-  video_reader->open(video_source);
 
 
   // Create mask image list if a list file was given, else fill list with empty
   // images. Files vector will only be populated if the use_masks bool is true
-  bool use_masks = false;
-  std::vector<kwiver::vital::path_t> mask_files;
+  mask_options masks;
+  masks.invert = invert_masks;
+  masks.expect_multichannel = expect_multichannel_masks;
   if( mask_list_file != "" )
   {
     LOG_DEBUG( main_logger, "Checking paired mask images from list file" );
 
-    use_masks = true;
+    masks.use_masks = true;
     // Load file stream
     std::ifstream mask_ifs(mask_list_file.c_str());
     if( !mask_ifs )
@@ -357,20 +735,20 @@ static int maptk_main(int argc, char const* argv[])
     // load filepaths from file
     for( std::string line; std::getline(mask_ifs, line); )
     {
-      mask_files.push_back(line);
-      if( ! ST::FileExists( mask_files[mask_files.size()-1], true ) )
+      masks.files.push_back(line);
+      if( ! ST::FileExists( masks.files[masks.files.size()-1], true ) )
       {
-        throw kwiver::vital::path_not_exists( mask_files[mask_files.size()-1] );
+        throw kwiver::vital::path_not_exists( masks.files[masks.files.size()-1] );
       }
     }
     // Check that image/mask list sizes are the same
-    if( timestamps.size() != mask_files.size() )
+    if( timestamps.size() != masks.files.size() )
     {
       throw kwiver::vital::invalid_value("video and mask file lists have "
                                          "different frame counts");
     }
     LOG_DEBUG( main_logger,
-               "Validated " << mask_files.size() << " mask image files." );
+               "Validated " << masks.files.size() << " mask image files." );
   }
 
   // verify that we can open the output file for writing
@@ -401,68 +779,86 @@ static int maptk_main(int argc, char const* argv[])
     }
   }
 
-  // Track features on each frame sequentially
+  // Split the video into overlapping segments, at most one per frame
+  size_t const num_segments =
+    std::max<size_t>(1, std::min<size_t>(config->get_value<size_t>("num_segments"),
+                                         timestamps.size()));
+
   kwiver::vital::feature_track_set_sptr tracks;
-  while( video_reader->next_frame(ts) )
+  if( num_segments == 1 )
   {
-    LOG_INFO(main_logger, "processing frame "<<ts.get_frame() );
-
-    auto const image = video_reader->frame_image();
-    auto const mdv = video_reader->frame_metadata();
-    auto converted_image = image_converter->convert( image );
-    if( !mdv.empty() )
+    track_segment segment;
+    segment.first_frame = timestamps.empty() ? 0 : timestamps.front().get_frame();
+    segment.last_frame = timestamps.empty() ? 0 : timestamps.back().get_frame();
+    segment.video_reader = video_reader;
+    segment.feature_tracker = feature_tracker;
+    segment.image_reader = image_reader;
+    segment.image_converter = image_converter;
+    track_frames(video_source, masks, segment, &homog_ofs, out_homog_generator);
+    if( !segment.success )
     {
-      converted_image->set_metadata( mdv[0] );
+      return EXIT_FAILURE;
     }
-
-    // Load the mask for this image if we were given a mask image list
-    kwiver::vital::image_container_sptr mask, converted_mask;
-    if( use_masks )
+    tracks = segment.tracks;
+  }
+  else
+  {
+    auto const overlap = config->get_value<size_t>("segment_overlap");
+    auto const num_frames = timestamps.size();
+    std::vector<track_segment> segments(num_segments);
+    for( size_t k = 0; k < num_segments; ++k )
     {
-      mask = image_reader->load( mask_files[ts.get_frame()] );
+      auto const first = k * num_frames / num_segments;
+      auto const last =
+        std::min(num_frames, (k + 1) * num_frames / num_segments + overlap) - 1;
+      segments[k].first_frame = timestamps[first].get_frame();
+      segments[k].last_frame = timestamps[last].get_frame();
+      configure_segment(config, segments[k]);
+    }
 
-      // error out if we are not expecting a multi-channel mask
-      if( !expect_multichannel_masks && mask->depth() > 1 )
-      {
-        LOG_ERROR( main_logger,
-                   "Encounted multi-channel mask image!" );
-        return EXIT_FAILURE;
-      }
-      else if( expect_multichannel_masks && mask->depth() == 1 )
+    LOG_INFO(main_logger, "Tracking " << num_segments << " segments in parallel");
+    std::vector<std::thread> workers;
+    for( auto& segment : segments )
+    {
+      workers.emplace_back([&video_source, &masks, &segment]()
       {
-        LOG_WARN( main_logger,
-                  "Expecting multi-channel masks but received one that was "
-                  "single-channel." );
-      }
+        try
+        {
+          track_frames(video_source, masks, segment);
+        }
+        catch (std::exception const& e)
+        {
+          LOG_ERROR(main_logger, "Exception caught tracking frames "
+                                 << segment.first_frame << " to "
+                                 << segment.last_frame << ": " << e.what());
+        }
+      });
+    }
+    for( auto& worker : workers )
+    {
+      worker.join();
+    }
 
-      if( invert_masks )
+    for( auto const& segment : segments )
+    {
+      if( !segment.success )
       {
-        LOG_DEBUG( main_logger,
-                   "Inverting mask image pixels" );
-        kwiver::vital::image_of<bool> mask_image;
-        kwiver::vital::cast_image( mask->get_image(), mask_image );
-        kwiver::vital::transform_image( mask_image, [] (bool b) { return !b; } );
-        LOG_DEBUG( main_logger,
-                   "Inverting mask image pixels -- Done" );
-        mask = std::make_shared<kwiver::vital::simple_image_container>( mask_image );
+        LOG_ERROR(main_logger, "Failed to track frames " << segment.first_frame
+                               << " to " << segment.last_frame);
+        return EXIT_FAILURE;
       }
-
-      converted_mask = image_converter->convert( mask );
     }
 
-    tracks = feature_tracker->track(tracks, ts.get_frame(),
-                                    converted_image, converted_mask);
-    if (tracks)
-    {
-      tracks = kwiver::maptk::extract_feature_colors(tracks, *image, ts.get_frame());
-    }
+    tracks = stitch_segments(segments, config->get_value<double>("stitch_tolerance"));
 
-    // Compute ref homography for current frame with current track set + write to file
-    // -> still doesn't take into account a full shotbreak, which would incur a track reset
+    // Compute ref homographies from the stitched tracks
     if ( homog_ofs.is_open() )
     {
-      LOG_DEBUG(main_logger, "writing homography");
-      homog_ofs << *(out_homog_generator->estimate(ts.get_frame(), tracks)) << std::endl;
+      LOG_DEBUG(main_logger, "writing homographies");
+      for( auto const& t : timestamps )
+      {
+        homog_ofs << *(out_homog_generator->estimate(t.get_frame(), tracks)) << std::endl;
+      }
     }
   }
 
@@ -479,7 +875,7 @@ static int maptk_main(int argc, char const* argv[])
 
 
 // ------------------------------------------------------------------
-int main(int argc, char const* argv[])
+MAPTK_TOOL_MAIN(int argc, char const* argv[])
 {
   try
   {